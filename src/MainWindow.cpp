@@ -51,6 +51,7 @@
 #include "exception/LocalStorageVersionTooHighException.h"
 #include "initialization/DefaultAccountFirstNotebookAndNoteCreator.h"
 #include "models/ColumnChangeRerouter.h"
+#include "models/ModelSnapshot.h"
 #include "views/ItemView.h"
 #include "views/DeletedNoteItemView.h"
 #include "views/NotebookItemView.h"
@@ -3874,6 +3875,7 @@ void MainWindow::closeEvent(QCloseEvent * pEvent)
     }
 
     persistGeometryAndState();
+    saveModelSnapshots();
     QMainWindow::closeEvent(pEvent);
 }
 
@@ -4142,8 +4144,18 @@ void MainWindow::setupModels()
 
     clearModels();
 
+    NoteModel::ListingMode::type noteListingMode = NoteModel::ListingMode::Full;
+
+    ApplicationSettings appSettings(*m_pAccount, QUENTIER_UI_SETTINGS);
+    appSettings.beginGroup(LOOK_AND_FEEL_SETTINGS_GROUP_NAME);
+    if (appSettings.value(WINDOWED_NOTE_LIST_SETTINGS_KEY).toBool()) {
+        noteListingMode = NoteModel::ListingMode::Windowed;
+    }
+    appSettings.endGroup();
+
     m_pNoteModel = new NoteModel(*m_pAccount, *m_pLocalStorageManagerAsync, m_noteCache,
-                                 m_notebookCache, this, NoteModel::IncludedNotes::NonDeleted);
+                                 m_notebookCache, this, NoteModel::IncludedNotes::NonDeleted,
+                                 noteListingMode);
     m_pFavoritesModel = new FavoritesModel(*m_pAccount, *m_pNoteModel, *m_pLocalStorageManagerAsync, m_noteCache,
                                            m_notebookCache, m_tagCache, m_savedSearchCache, this);
     m_pNotebookModel = new NotebookModel(*m_pAccount, *m_pNoteModel, *m_pLocalStorageManagerAsync,
@@ -4154,6 +4166,12 @@ void MainWindow::setupModels()
     m_pDeletedNotesModel = new NoteModel(*m_pAccount, *m_pLocalStorageManagerAsync, m_noteCache,
                                          m_notebookCache, this, NoteModel::IncludedNotes::Deleted);
 
+    // Coalesce the bursts of note changes coming from the local storage, i.e. during the synchronization
+    m_pNoteModel->setNoteChangesBatchingEnabled(true);
+    m_pDeletedNotesModel->setNoteChangesBatchingEnabled(true);
+
+    restoreModelSnapshots();
+
     m_pNoteFilterModel = new NoteFilterModel(this);
     m_pNoteFilterModel->setSourceModel(m_pNoteModel);
 
@@ -4169,6 +4187,18 @@ void MainWindow::setupModels()
                                                    *m_pUI->searchQueryLineEdit,
                                                    *m_pLocalStorageManagerAsync, this);
 
+    appSettings.beginGroup(LOOK_AND_FEEL_SETTINGS_GROUP_NAME);
+    m_pNoteFiltersManager->setLiveSearchEnabled(appSettings.value(LIVE_NOTE_SEARCH_SETTINGS_KEY).toBool());
+    if (appSettings.contains(LIVE_NOTE_SEARCH_DELAY_SETTINGS_KEY))
+    {
+        bool conversionResult = false;
+        int liveSearchDelay = appSettings.value(LIVE_NOTE_SEARCH_DELAY_SETTINGS_KEY).toInt(&conversionResult);
+        if (conversionResult) {
+            m_pNoteFiltersManager->setLiveSearchDelay(liveSearchDelay);
+        }
+    }
+    appSettings.endGroup();
+
     m_pUI->favoritesTableView->setModel(m_pFavoritesModel);
     m_pUI->notebooksTreeView->setModel(m_pNotebookModel);
     m_pUI->tagsTreeView->setModel(m_pTagModel);
@@ -4190,6 +4220,7 @@ void MainWindow::clearModels()
 {
     QNDEBUG(QStringLiteral("MainWindow::clearModels"));
 
+    saveModelSnapshots();
     clearViews();
 
     if (m_pNotebookModel) {
@@ -4223,6 +4254,59 @@ void MainWindow::clearModels()
     }
 }
 
+void MainWindow::restoreModelSnapshots()
+{
+    QNDEBUG(QStringLiteral("MainWindow::restoreModelSnapshots"));
+
+    // NOTE: the models restored from the snapshots show the items from the previous session right away
+    // while the items are being listed from the local storage in the background; the missing snapshots
+    // (i.e. on the first start) are not an error, the models are simply populated by listing then
+
+#define RESTORE_MODEL_SNAPSHOT(model, name) \
+    if (model) { \
+        ErrorString errorDescription; \
+        if (!model->restoreFromSnapshot(modelSnapshotFilePath(model->account(), name), errorDescription)) { \
+            QNDEBUG(QStringLiteral("Model snapshot was not restored: ") << name << QStringLiteral(": ") \
+                    << errorDescription); \
+        } \
+    }
+
+    RESTORE_MODEL_SNAPSHOT(m_pNoteModel, QStringLiteral("notes"))
+    RESTORE_MODEL_SNAPSHOT(m_pDeletedNotesModel, QStringLiteral("deletedNotes"))
+    RESTORE_MODEL_SNAPSHOT(m_pNotebookModel, QStringLiteral("notebooks"))
+    RESTORE_MODEL_SNAPSHOT(m_pTagModel, QStringLiteral("tags"))
+    RESTORE_MODEL_SNAPSHOT(m_pSavedSearchModel, QStringLiteral("savedSearches"))
+    RESTORE_MODEL_SNAPSHOT(m_pFavoritesModel, QStringLiteral("favorites"))
+
+#undef RESTORE_MODEL_SNAPSHOT
+}
+
+void MainWindow::saveModelSnapshots()
+{
+    QNDEBUG(QStringLiteral("MainWindow::saveModelSnapshots"));
+
+    // NOTE: using each model's own account rather than the current one as on switching the account the models
+    // are cleared after the current account has already been changed
+
+#define SAVE_MODEL_SNAPSHOT(model, name) \
+    if (model) { \
+        ErrorString errorDescription; \
+        if (!model->saveSnapshot(modelSnapshotFilePath(model->account(), name), errorDescription)) { \
+            QNDEBUG(QStringLiteral("Model snapshot was not saved: ") << name << QStringLiteral(": ") \
+                    << errorDescription); \
+        } \
+    }
+
+    SAVE_MODEL_SNAPSHOT(m_pNoteModel, QStringLiteral("notes"))
+    SAVE_MODEL_SNAPSHOT(m_pDeletedNotesModel, QStringLiteral("deletedNotes"))
+    SAVE_MODEL_SNAPSHOT(m_pNotebookModel, QStringLiteral("notebooks"))
+    SAVE_MODEL_SNAPSHOT(m_pTagModel, QStringLiteral("tags"))
+    SAVE_MODEL_SNAPSHOT(m_pSavedSearchModel, QStringLiteral("savedSearches"))
+    SAVE_MODEL_SNAPSHOT(m_pFavoritesModel, QStringLiteral("favorites"))
+
+#undef SAVE_MODEL_SNAPSHOT
+}
+
 void MainWindow::setupShowHideStartupSettings()
 {
     QNDEBUG(QStringLiteral("MainWindow::setupShowHideStartupSettings"));
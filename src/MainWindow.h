@@ -326,6 +326,9 @@ private:
     void setupModels();
     void clearModels();
 
+    void restoreModelSnapshots();
+    void saveModelSnapshots();
+
     void setupShowHideStartupSettings();
     void setupViews();
     void clearViews();
@@ -28,6 +28,13 @@
 #include <quentier/local_storage/LocalStorageManagerAsync.h>
 #include <QComboBox>
 #include <QLineEdit>
+#include <QTimerEvent>
+
+// The delay after the last note change before the note search query the filter is based on is re-run
+#define NOTE_LOCAL_UIDS_FILTER_UPDATE_DELAY (300)
+
+// The default delay after the last edit of the search string before the live search is performed
+#define DEFAULT_LIVE_SEARCH_DELAY (400)
 
 namespace quentier {
 
@@ -49,7 +56,15 @@ NoteFiltersManager::NoteFiltersManager(FilterByTagWidget & filterByTagWidget,
     m_filteredSavedSearchLocalUid(),
     m_lastSearchString(),
     m_findNoteLocalUidsForSearchStringRequestId(),
-    m_findNoteLocalUidsForSavedSearchQueryRequestId()
+    m_findNoteLocalUidsForSavedSearchQueryRequestId(),
+    m_noteLocalUidsFilterUpdateTimer(),
+    m_liveSearchEnabled(false),
+    m_liveSearchDelay(DEFAULT_LIVE_SEARCH_DELAY),
+    m_liveSearchTimer(),
+    m_pendingLiveSearch(false),
+    m_pendingQuerySearchString(),
+    m_lastQueriedSearchString(),
+    m_lastQueriedSearchStringMatchedNothing(false)
 {
     createConnections();
 }
@@ -85,6 +100,29 @@ const QString & NoteFiltersManager::savedSearchLocalUidInFilter() const
     return m_filteredSavedSearchLocalUid;
 }
 
+void NoteFiltersManager::setLiveSearchEnabled(const bool enabled)
+{
+    QNDEBUG(QStringLiteral("NoteFiltersManager::setLiveSearchEnabled: ") << (enabled ? QStringLiteral("true") : QStringLiteral("false")));
+
+    m_liveSearchEnabled = enabled;
+    if (!m_liveSearchEnabled) {
+        m_liveSearchTimer.stop();
+        m_pendingLiveSearch = false;
+    }
+}
+
+void NoteFiltersManager::setLiveSearchDelay(const int delay)
+{
+    QNDEBUG(QStringLiteral("NoteFiltersManager::setLiveSearchDelay: ") << delay);
+
+    if (Q_UNLIKELY(delay < 0)) {
+        QNWARNING(QStringLiteral("Ignoring negative live search delay: ") << delay);
+        return;
+    }
+
+    m_liveSearchDelay = delay;
+}
+
 bool NoteFiltersManager::isFilterBySearchStringActive() const
 {
     return !m_filterByTagWidget.isEnabled() &&
@@ -239,7 +277,15 @@ void NoteFiltersManager::onSearchStringEdited(const QString & text)
     bool wasEmpty = m_lastSearchString.isEmpty();
     m_lastSearchString = text;
     if (!wasEmpty && m_lastSearchString.isEmpty()) {
+        m_liveSearchTimer.stop();
+        m_pendingLiveSearch = false;
         evaluate();
+        return;
+    }
+
+    if (m_liveSearchEnabled && !m_lastSearchString.isEmpty()) {
+        // Restarting the timer postpones the search until the typing pauses
+        m_liveSearchTimer.start(m_liveSearchDelay, this);
     }
 }
 
@@ -252,6 +298,22 @@ void NoteFiltersManager::onSearchStringChanged()
         return;
     }
 
+    m_liveSearchTimer.stop();
+    m_pendingLiveSearch = false;
+
+    if (m_liveSearchEnabled && isFilterBySearchStringActive())
+    {
+        QString searchString = m_searchLineEdit.text();
+
+        bool alreadyQueried = m_findNoteLocalUidsForSearchStringRequestId.isNull()
+                              ? (searchString == m_lastQueriedSearchString)
+                              : (searchString == m_pendingQuerySearchString);
+        if (alreadyQueried) {
+            QNDEBUG(QStringLiteral("The live search has already been performed for this search string"));
+            return;
+        }
+    }
+
     evaluate();
 }
 
@@ -270,6 +332,14 @@ void NoteFiltersManager::onFindNoteLocalUidsWithSearchQueryCompleted(QStringList
             << noteLocalUids.join(QStringLiteral(", ")) << QStringLiteral(", note search query: ")
             << noteSearchQuery << QStringLiteral("\nRequest id = ") << requestId);
 
+    if (isRequestForSearchString) {
+        m_lastQueriedSearchString = m_pendingQuerySearchString;
+        m_lastQueriedSearchStringMatchedNothing = noteLocalUids.isEmpty();
+        m_noteFilterModel.setNoteLocalUids(noteLocalUids);
+        onSearchStringQueryFinished();
+        return;
+    }
+
     if (Q_UNLIKELY(!isRequestForSearchString && !m_filterBySavedSearchWidget.isEnabled())) {
         QNDEBUG(QStringLiteral("Ignoring the update with note local uids for saved search because the filter "
                                "by saved search widget is disabled which means filtering by saved search is overridden "
@@ -297,6 +367,16 @@ void NoteFiltersManager::onFindNoteLocalUidsWithSearchQueryFailed(NoteSearchQuer
 
     if (isRequestForSearchString)
     {
+        m_findNoteLocalUidsForSearchStringRequestId = QUuid();
+        m_lastQueriedSearchString.clear();
+        m_lastQueriedSearchStringMatchedNothing = false;
+
+        if (m_pendingLiveSearch) {
+            m_pendingLiveSearch = false;
+            evaluate();
+            return;
+        }
+
         ErrorString error(QT_TR_NOOP("Can't set the search string to note filter"));
         error.appendBase(errorDescription.base());
         error.appendBase(errorDescription.additionalBases());
@@ -501,7 +581,14 @@ void NoteFiltersManager::onAddNoteComplete(Note note, QUuid requestId)
     QNDEBUG(QStringLiteral("NoteFiltersManager::onAddNoteComplete: note = ") << note
             << QStringLiteral("\nRequest id = ") << requestId);
 
-    m_noteFilterModel.invalidate();
+    // The new note might match the search string which didn't match any notes before
+    m_lastQueriedSearchStringMatchedNothing = false;
+
+    // NOTE: the filters by notebooks and tags are re-evaluated by the note filter model for the added row only
+    // but it's unknown whether the new note matches the search query the filter by note local uids is based on
+    if (m_noteFilterModel.usingNoteLocalUidsFilter()) {
+        scheduleNoteLocalUidsFilterUpdate();
+    }
 }
 
 void NoteFiltersManager::onUpdateNoteComplete(Note note, bool updateResources, bool updateTags, QUuid requestId)
@@ -511,7 +598,11 @@ void NoteFiltersManager::onUpdateNoteComplete(Note note, bool updateResources, b
             << QStringLiteral(", update tags = ") << (updateTags ? QStringLiteral("true") : QStringLiteral("false"))
             << QStringLiteral(", request id = ") << requestId);
 
-    m_noteFilterModel.invalidate();
+    m_lastQueriedSearchStringMatchedNothing = false;
+
+    if (m_noteFilterModel.usingNoteLocalUidsFilter()) {
+        scheduleNoteLocalUidsFilterUpdate();
+    }
 }
 
 void NoteFiltersManager::onExpungeNoteComplete(Note note, QUuid requestId)
@@ -519,7 +610,38 @@ void NoteFiltersManager::onExpungeNoteComplete(Note note, QUuid requestId)
     QNDEBUG(QStringLiteral("NoteFiltersManager::onExpungeNoteComplete: note = ") << note
             << QStringLiteral("\nRequest id = ") << requestId);
 
-    m_noteFilterModel.invalidate();
+    // NOTE: nothing to do here: the row of the expunged note is removed from the note filter model
+    // along with its removal from the source note model
+}
+
+void NoteFiltersManager::timerEvent(QTimerEvent * pEvent)
+{
+    if (Q_UNLIKELY(!pEvent)) {
+        return;
+    }
+
+    if (pEvent->timerId() == m_noteLocalUidsFilterUpdateTimer.timerId()) {
+        m_noteLocalUidsFilterUpdateTimer.stop();
+        updateNoteLocalUidsFilter();
+        return;
+    }
+
+    if (pEvent->timerId() == m_liveSearchTimer.timerId())
+    {
+        m_liveSearchTimer.stop();
+
+        if (!m_findNoteLocalUidsForSearchStringRequestId.isNull()) {
+            QNDEBUG(QStringLiteral("The previous search string query is still in progress, will perform the live search "
+                                   "once it's finished"));
+            m_pendingLiveSearch = true;
+            return;
+        }
+
+        evaluate();
+        return;
+    }
+
+    QObject::timerEvent(pEvent);
 }
 
 void NoteFiltersManager::createConnections()
@@ -639,6 +761,79 @@ void NoteFiltersManager::evaluate()
     Q_EMIT filterChanged();
 }
 
+void NoteFiltersManager::scheduleNoteLocalUidsFilterUpdate()
+{
+    QNTRACE(QStringLiteral("NoteFiltersManager::scheduleNoteLocalUidsFilterUpdate"));
+
+    // Restarting the timer postpones the update until the burst of note changes is over
+    m_noteLocalUidsFilterUpdateTimer.start(NOTE_LOCAL_UIDS_FILTER_UPDATE_DELAY, this);
+}
+
+bool NoteFiltersManager::searchStringRefinesEmptyResult(const QString & searchString, const NoteSearchQuery & query) const
+{
+    if (!m_lastQueriedSearchStringMatchedNothing || m_lastQueriedSearchString.isEmpty()) {
+        return false;
+    }
+
+    // With "any:" modifier more terms mean more matching notes, not less
+    if (query.hasAnyModifier()) {
+        return false;
+    }
+
+    // The last search string shouldn't end within the quoted phrase: otherwise appending to it
+    // would change the phrase rather than add new terms
+    if ((m_lastQueriedSearchString.count(QChar::fromLatin1('"')) % 2) != 0) {
+        return false;
+    }
+
+    if (searchString.size() <= m_lastQueriedSearchString.size()) {
+        return false;
+    }
+
+    if (!searchString.startsWith(m_lastQueriedSearchString)) {
+        return false;
+    }
+
+    return searchString.at(m_lastQueriedSearchString.size()).isSpace();
+}
+
+void NoteFiltersManager::onSearchStringQueryFinished()
+{
+    m_findNoteLocalUidsForSearchStringRequestId = QUuid();
+
+    if (!m_pendingLiveSearch) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("The search string was changed while the previous query was in progress, "
+                           "performing the live search for the new search string"));
+    m_pendingLiveSearch = false;
+    evaluate();
+}
+
+void NoteFiltersManager::updateNoteLocalUidsFilter()
+{
+    QNDEBUG(QStringLiteral("NoteFiltersManager::updateNoteLocalUidsFilter"));
+
+    if (!m_noteFilterModel.usingNoteLocalUidsFilter()) {
+        QNDEBUG(QStringLiteral("The filter by note local uids is no longer used"));
+        return;
+    }
+
+    bool res = setFilterBySearchString();
+    if (res) {
+        return;
+    }
+
+    res = setFilterBySavedSearch();
+    if (res) {
+        return;
+    }
+
+    // Neither search string nor saved search are valid anymore, need to fall back to other filters
+    evaluate();
+}
+
 bool NoteFiltersManager::setFilterBySearchString()
 {
     QNDEBUG(QStringLiteral("NoteFiltersManager::setFilterBySearchString"));
@@ -661,16 +856,29 @@ bool NoteFiltersManager::setFilterBySearchString()
     // Invalidate the active request to find note local uids per saved search's query (if there was any)
     m_findNoteLocalUidsForSavedSearchQueryRequestId = QUuid();
 
+    m_filterByTagWidget.setDisabled(true);
+    m_filterByNotebookWidget.setDisabled(true);
+    m_filterBySavedSearchWidget.setDisabled(true);
+
+    if (searchStringRefinesEmptyResult(searchString, query)) {
+        QNDEBUG(QStringLiteral("The search string only narrows down the previous search string which matched no notes"));
+        // NOTE: the in-progress request for the previous search string (if any) is superseded
+        m_findNoteLocalUidsForSearchStringRequestId = QUuid();
+        m_lastQueriedSearchString = searchString;
+        m_noteFilterModel.setNoteLocalUids(QStringList());
+        onSearchStringQueryFinished();
+        return true;
+    }
+
+    // NOTE: the new request id supersedes the in-progress request for the previous search string (if any):
+    // its result would be ignored
+    m_pendingQuerySearchString = searchString;
     m_findNoteLocalUidsForSearchStringRequestId = QUuid::createUuid();
     QNTRACE(QStringLiteral("Emitting the request to find note local uids corresponding to the note search query: request id = ")
             << m_findNoteLocalUidsForSearchStringRequestId << QStringLiteral(", query: ") << query
             << QStringLiteral("\nSearch string: ") << searchString);
     Q_EMIT findNoteLocalUidsForNoteSearchQuery(query, m_findNoteLocalUidsForSearchStringRequestId);
 
-    m_filterByTagWidget.setDisabled(true);
-    m_filterByNotebookWidget.setDisabled(true);
-    m_filterBySavedSearchWidget.setDisabled(true);
-
     return true;
 }
 
@@ -930,6 +1138,8 @@ void NoteFiltersManager::clearFilterWidgetsItems()
                         this, QNSLOT(NoteFiltersManager,onSearchStringChanged));
 
     m_searchLineEdit.setText(QString());
+    m_liveSearchTimer.stop();
+    m_pendingLiveSearch = false;
 
     QObject::connect(&m_searchLineEdit, QNSIGNAL(QLineEdit,editingFinished),
                      this, QNSLOT(NoteFiltersManager,onSearchStringChanged),
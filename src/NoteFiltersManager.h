@@ -28,6 +28,7 @@
 #include <quentier/local_storage/NoteSearchQuery.h>
 #include <QObject>
 #include <QUuid>
+#include <QBasicTimer>
 
 QT_FORWARD_DECLARE_CLASS(QLineEdit)
 
@@ -60,6 +61,17 @@ public:
     void clear();
     void resetFilterToNotebookLocalUid(const QString & notebookLocalUid);
 
+    /**
+     * @brief setLiveSearchEnabled - enables or disables the live search mode; in this mode the filter by search
+     * string is updated as the search string is being typed, after the specified delay since the last edit
+     * instead of when the editing is finished
+     */
+    void setLiveSearchEnabled(const bool enabled);
+    bool liveSearchEnabled() const { return m_liveSearchEnabled; }
+
+    void setLiveSearchDelay(const int delay);
+    int liveSearchDelay() const { return m_liveSearchDelay; }
+
 Q_SIGNALS:
     void notifyError(ErrorString errorDescription);
 
@@ -111,10 +123,30 @@ private Q_SLOTS:
     void onUpdateNoteComplete(Note note, bool updateResources, bool updateTags, QUuid requestId);
     void onExpungeNoteComplete(Note note, QUuid requestId);
 
+private:
+    virtual void timerEvent(QTimerEvent * pEvent) Q_DECL_OVERRIDE;
+
 private:
     void createConnections();
     void evaluate();
 
+    /**
+     * @brief scheduleNoteLocalUidsFilterUpdate - schedules the delayed re-run of the note search query
+     * which the current filter by note local uids is based on; the bursts of note changes are coalesced
+     * into a single re-run of the query
+     */
+    void scheduleNoteLocalUidsFilterUpdate();
+    void updateNoteLocalUidsFilter();
+
+    /**
+     * @return true if the search string only appends more terms to the last search string for which the note
+     * local uids were found and that search string has matched no notes: in this case the new search string
+     * is certain to match no notes as well so there's no need to query the local storage
+     */
+    bool searchStringRefinesEmptyResult(const QString & searchString, const NoteSearchQuery & query) const;
+
+    void onSearchStringQueryFinished();
+
     bool setFilterBySearchString();
     bool setFilterBySavedSearch();
     void setFilterByNotebooks();
@@ -139,6 +171,19 @@ private:
 
     QUuid                               m_findNoteLocalUidsForSearchStringRequestId;
     QUuid                               m_findNoteLocalUidsForSavedSearchQueryRequestId;
+
+    QBasicTimer                         m_noteLocalUidsFilterUpdateTimer;
+
+    bool                                m_liveSearchEnabled;
+    int                                 m_liveSearchDelay;
+    QBasicTimer                         m_liveSearchTimer;
+
+    // Set if the live search string was changed while the previous search string query was in progress
+    bool                                m_pendingLiveSearch;
+
+    QString                             m_pendingQuerySearchString;
+    QString                             m_lastQueriedSearchString;
+    bool                                m_lastQueriedSearchStringMatchedNothing;
 };
 
 } // namespace quentier
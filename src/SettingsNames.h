@@ -42,6 +42,9 @@
 #define ICON_THEME_SETTINGS_KEY QStringLiteral("IconTheme")
 #define PANELS_STYLE_SETTINGS_KEY QStringLiteral("PanelStyle")
 #define SHOW_NOTE_THUMBNAILS_SETTINGS_KEY QStringLiteral("ShowNoteThumbnails")
+#define WINDOWED_NOTE_LIST_SETTINGS_KEY QStringLiteral("WindowedNoteList")
+#define LIVE_NOTE_SEARCH_SETTINGS_KEY QStringLiteral("LiveNoteSearch")
+#define LIVE_NOTE_SEARCH_DELAY_SETTINGS_KEY QStringLiteral("LiveNoteSearchDelay")
 
 // ENEX export/import related settings keys
 #define ENEX_EXPORT_IMPORT_SETTINGS_GROUP_NAME QStringLiteral("EnexExportImport")
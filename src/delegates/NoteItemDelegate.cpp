@@ -352,9 +352,11 @@ void NoteItemDelegate::paint(QPainter * pPainter, const QStyleOptionViewItem & o
             pPainter->setPen(option.palette.windowText().color());
         }
 
-        QImage thumbnail;
-        Q_UNUSED(thumbnail.loadFromData(thumbnailData, "PNG"))
-        pPainter->drawImage(thumbnailRect, thumbnail);
+        // NOTE: if the thumbnail is not decoded yet, it would be painted once the note model notifies it is ready
+        QImage thumbnail = pNoteModel->thumbnail(*pItem);
+        if (!thumbnail.isNull()) {
+            pPainter->drawImage(thumbnailRect, thumbnail);
+        }
     }
 
     NoteListView * pNoteListView = qobject_cast<NoteListView*>(pView);
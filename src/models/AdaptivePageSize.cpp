@@ -0,0 +1,44 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AdaptivePageSize.h"
+#include <algorithm>
+
+namespace quentier {
+
+AdaptivePageSize::AdaptivePageSize(const size_t initialPageSize, const size_t minPageSize,
+                                   const size_t maxPageSize, const qint64 targetRoundTripMsec) :
+    m_pageSize(initialPageSize),
+    m_minPageSize(minPageSize),
+    m_maxPageSize(std::max(minPageSize, maxPageSize)),
+    m_targetRoundTripMsec(targetRoundTripMsec)
+{
+    m_pageSize = std::min(std::max(m_pageSize, m_minPageSize), m_maxPageSize);
+}
+
+void AdaptivePageSize::adjust(const qint64 roundTripMsec)
+{
+    if (roundTripMsec > m_targetRoundTripMsec) {
+        m_pageSize = std::max(m_pageSize / 2, m_minPageSize);
+    }
+    else if (roundTripMsec * 2 < m_targetRoundTripMsec) {
+        m_pageSize = std::min(m_pageSize * 2, m_maxPageSize);
+    }
+}
+
+} // namespace quentier
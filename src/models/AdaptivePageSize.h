@@ -0,0 +1,57 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUENTIER_MODELS_ADAPTIVE_PAGE_SIZE_H
+#define QUENTIER_MODELS_ADAPTIVE_PAGE_SIZE_H
+
+#include <quentier/utility/Macros.h>
+#include <QtGlobal>
+#include <cstddef>
+
+namespace quentier {
+
+/**
+ * @brief The AdaptivePageSize class chooses the limit for the paged list requests to the local storage
+ * based on the measured round trip time of the previous requests: the page size grows while the round trips
+ * are well below the target duration, so that the fixed per request overhead is amortized over more items,
+ * and shrinks when the round trips exceed the target duration, so that the processing of each page
+ * doesn't stall the GUI thread for too long
+ */
+class AdaptivePageSize
+{
+public:
+    AdaptivePageSize(const size_t initialPageSize, const size_t minPageSize,
+                     const size_t maxPageSize, const qint64 targetRoundTripMsec);
+
+    size_t pageSize() const { return m_pageSize; }
+
+    /**
+     * @brief adjust - adjusts the page size for the given round trip time of the request of the current page size
+     */
+    void adjust(const qint64 roundTripMsec);
+
+private:
+    size_t          m_pageSize;
+    size_t          m_minPageSize;
+    size_t          m_maxPageSize;
+    qint64          m_targetRoundTripMsec;
+};
+
+} // namespace quentier
+
+#endif // QUENTIER_MODELS_ADAPTIVE_PAGE_SIZE_H
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2016 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Collator.h"
+
+namespace quentier {
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+
+CollationKey::CollationKey() :
+    m_pKey()
+{}
+
+CollationKey::CollationKey(const QCollatorSortKey & key) :
+    m_pKey(new QCollatorSortKey(key))
+{}
+
+bool CollationKey::isNull() const
+{
+    return m_pKey.isNull();
+}
+
+int CollationKey::compare(const CollationKey & other) const
+{
+    if (m_pKey.isNull() || other.m_pKey.isNull()) {
+        return static_cast<int>(!m_pKey.isNull()) - static_cast<int>(!other.m_pKey.isNull());
+    }
+
+    return m_pKey->compare(*other.m_pKey);
+}
+
+Collator::Collator() :
+    m_collator()
+{}
+
+int Collator::compare(const QString & lhs, const QString & rhs) const
+{
+    return m_collator.compare(lhs, rhs);
+}
+
+CollationKey Collator::sortKey(const QString & str) const
+{
+    return CollationKey(m_collator.sortKey(str));
+}
+
+#else
+
+CollationKey::CollationKey() :
+    m_str(),
+    m_isNull(true)
+{}
+
+CollationKey::CollationKey(const QString & str) :
+    m_str(str),
+    m_isNull(false)
+{}
+
+bool CollationKey::isNull() const
+{
+    return m_isNull;
+}
+
+int CollationKey::compare(const CollationKey & other) const
+{
+    if (m_isNull || other.m_isNull) {
+        return static_cast<int>(!m_isNull) - static_cast<int>(!other.m_isNull);
+    }
+
+    return m_str.localeAwareCompare(other.m_str);
+}
+
+Collator::Collator()
+{}
+
+int Collator::compare(const QString & lhs, const QString & rhs) const
+{
+    return lhs.localeAwareCompare(rhs);
+}
+
+CollationKey Collator::sortKey(const QString & str) const
+{
+    return CollationKey(str);
+}
+
+#endif // QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+
+} // namespace quentier
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2016 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUENTIER_MODELS_COLLATOR_H
+#define QUENTIER_MODELS_COLLATOR_H
+
+#include <quentier/utility/Macros.h>
+#include <QString>
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+#include <QCollator>
+#include <QSharedPointer>
+#endif
+
+namespace quentier {
+
+/**
+ * @brief The CollationKey class represents the precomputed locale-aware sort key of a string:
+ * comparing two collation keys gives the same result as the locale-aware comparison of the strings
+ * they were built from but doesn't involve any locale lookups or temporary allocations
+ *
+ * The default constructed collation key is null; null keys compare equal to each other
+ * and less than any non-null key
+ */
+class CollationKey
+{
+public:
+    CollationKey();
+
+    bool isNull() const;
+
+    /**
+     * @return negative value if this key is less than the other one, positive value if it is greater,
+     * zero if keys are equal
+     */
+    int compare(const CollationKey & other) const;
+
+private:
+    friend class Collator;
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+    explicit CollationKey(const QCollatorSortKey & key);
+
+    // NOTE: QCollatorSortKey has no default constructor, hence the indirection
+    QSharedPointer<QCollatorSortKey>    m_pKey;
+#else
+    explicit CollationKey(const QString & str);
+
+    // NOTE: Qt4 has no API for sort keys, the comparison falls back to QString::localeAwareCompare
+    QString     m_str;
+    bool        m_isNull;
+#endif
+};
+
+/**
+ * @brief The Collator class compares strings and builds collation keys for them according to the current locale;
+ * the collation keys pay off when the same strings are compared many times i.e. while sorting many items
+ */
+class Collator
+{
+public:
+    Collator();
+
+    /**
+     * @return negative value if the first string is less than the second one, positive value if it is greater,
+     * zero if the strings are equal
+     */
+    int compare(const QString & lhs, const QString & rhs) const;
+
+    CollationKey sortKey(const QString & str) const;
+
+private:
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+    QCollator   m_collator;
+#endif
+};
+
+} // namespace quentier
+
+#endif // QUENTIER_MODELS_COLLATOR_H
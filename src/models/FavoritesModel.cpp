@@ -18,16 +18,30 @@
 
 #include "FavoritesModel.h"
 #include "NoteModel.h"
+#include "ModelSnapshot.h"
+#include "SortedItemsHelpers.hpp"
 #include <quentier/logging/QuentierLogger.h>
+#include <QThreadPool>
 
-// Limit for the queries to the local storage
+// Initial limits for the queries to the local storage, adjusted then within the min/max bounds
+// depending on the measured timings of the queries
 #define NOTE_LIST_LIMIT (40)
 #define NOTEBOOK_LIST_LIMIT (40)
 #define TAG_LIST_LIMIT (40)
 #define SAVED_SEARCH_LIST_LIMIT (40)
+#define MIN_LIST_LIMIT (20)
+#define MAX_LIST_LIMIT (1000)
+#define LIST_TARGET_ROUND_TRIP_MSEC (100)
+#define MAX_LIST_REQUESTS_IN_FLIGHT (4)
 
 #define NUM_FAVORITES_MODEL_COLUMNS (3)
 
+// The minimal number of items for which the re-sorting is done in the background on the thread pool
+#define FAVORITES_MODEL_ASYNC_SORT_MIN_NUM_ITEMS (10000)
+
+// The version of the format of favorites model items within the model snapshot
+#define FAVORITES_MODEL_SNAPSHOT_VERSION (1)
+
 namespace quentier {
 
 FavoritesModel::FavoritesModel(const Account & account, const NoteModel & noteModel,
@@ -44,14 +58,11 @@ FavoritesModel::FavoritesModel(const Account & account, const NoteModel & noteMo
     m_lowerCaseNotebookNames(),
     m_lowerCaseTagNames(),
     m_lowerCaseSavedSearchNames(),
-    m_listNotesOffset(0),
-    m_listNotesRequestId(),
-    m_listNotebooksOffset(0),
-    m_listNotebooksRequestId(),
-    m_listTagsOffset(0),
-    m_listTagsRequestId(),
-    m_listSavedSearchesOffset(0),
-    m_listSavedSearchesRequestId(),
+    m_listNotesPipeline(NOTE_LIST_LIMIT, MIN_LIST_LIMIT, MAX_LIST_LIMIT, LIST_TARGET_ROUND_TRIP_MSEC, MAX_LIST_REQUESTS_IN_FLIGHT),
+    m_listNotebooksPipeline(NOTEBOOK_LIST_LIMIT, MIN_LIST_LIMIT, MAX_LIST_LIMIT, LIST_TARGET_ROUND_TRIP_MSEC, MAX_LIST_REQUESTS_IN_FLIGHT),
+    m_listTagsPipeline(TAG_LIST_LIMIT, MIN_LIST_LIMIT, MAX_LIST_LIMIT, LIST_TARGET_ROUND_TRIP_MSEC, MAX_LIST_REQUESTS_IN_FLIGHT),
+    m_listSavedSearchesPipeline(SAVED_SEARCH_LIST_LIMIT, MIN_LIST_LIMIT, MAX_LIST_LIMIT,
+                                LIST_TARGET_ROUND_TRIP_MSEC, MAX_LIST_REQUESTS_IN_FLIGHT),
     m_updateNoteRequestIds(),
     m_findNoteToRestoreFailedUpdateRequestIds(),
     m_findNoteToPerformUpdateRequestIds(),
@@ -78,15 +89,28 @@ FavoritesModel::FavoritesModel(const Account & account, const NoteModel & noteMo
     m_tagLocalUidToNoteCountRequestIdBimap(),
     m_sortedColumn(Columns::DisplayName),
     m_sortOrder(Qt::AscendingOrder),
+    m_sortThreadPool(),
+    m_pSortTask(Q_NULLPTR),
+    m_pendingListedItemsByLocalUid(),
+    m_restoredLocalUidsPendingReconciliation(),
     m_allItemsListed(false)
 {
     createConnections(noteModel, localStorageManagerAsync);
 
-    if (noteModel.allNotesListed()) {
+    // NOTE: in Windowed listing mode the note model doesn't have all the notes, the note counts of the favorited
+    // notebooks and tags are then requested from the local storage on every note change affecting them
+    if ((noteModel.listingMode() == NoteModel::ListingMode::Full) && noteModel.allNotesListed()) {
         buildTagLocalUidsByNoteLocalUidsHash(noteModel);
         buildNotebookLocalUidByNoteLocalUidsHash(noteModel);
     }
 
+    // NOTE: all the listings need to be started before any request is sent so that the complete listing of one kind
+    // of items isn't taken for the complete listing of all items
+    m_listNotebooksPipeline.start();
+    m_listTagsPipeline.start();
+    m_listNotesPipeline.start();
+    m_listSavedSearchesPipeline.start();
+
     requestNotebooksList();
     requestTagsList();
     requestNotesList();
@@ -94,7 +118,15 @@ FavoritesModel::FavoritesModel(const Account & account, const NoteModel & noteMo
 }
 
 FavoritesModel::~FavoritesModel()
-{}
+{
+    // NOTE: the sort tasks refer to nothing within the model but they should not outlive it
+    if (m_pSortTask) {
+        m_pSortTask->cancel();
+        m_pSortTask = Q_NULLPTR;
+    }
+
+    m_sortThreadPool.waitForDone();
+}
 
 void FavoritesModel::updateAccount(const Account & account)
 {
@@ -145,6 +177,86 @@ const FavoritesModelItem * FavoritesModel::itemAtRow(const int row) const
     return &(rowIndex[static_cast<size_t>(row)]);
 }
 
+bool FavoritesModel::saveSnapshot(const QString & filePath, ErrorString & errorDescription) const
+{
+    QNDEBUG(QStringLiteral("FavoritesModel::saveSnapshot: ") << filePath);
+
+    if (!m_allItemsListed) {
+        errorDescription.setBase(QT_TR_NOOP("Can't save the snapshot of favorites: not all favorited items have been listed yet"));
+        QNDEBUG(errorDescription);
+        return false;
+    }
+
+    ModelSnapshotWriter writer(FAVORITES_MODEL_SNAPSHOT_VERSION);
+    QDataStream & out = writer.stream();
+
+    const FavoritesDataByIndex & rowIndex = m_data.get<ByIndex>();
+    out << static_cast<qint32>(rowIndex.size());
+    for(auto it = rowIndex.begin(), end = rowIndex.end(); it != end; ++it) {
+        out << *it;
+    }
+
+    return writer.writeToFile(filePath, errorDescription);
+}
+
+bool FavoritesModel::restoreFromSnapshot(const QString & filePath, ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("FavoritesModel::restoreFromSnapshot: ") << filePath);
+
+    if (m_allItemsListed || !m_data.empty() || !m_pendingListedItemsByLocalUid.isEmpty()) {
+        errorDescription.setBase(QT_TR_NOOP("Can't restore the snapshot of favorites: the model already has items"));
+        QNDEBUG(errorDescription);
+        return false;
+    }
+
+    ModelSnapshotReader reader;
+    if (!reader.open(filePath, FAVORITES_MODEL_SNAPSHOT_VERSION, errorDescription)) {
+        return false;
+    }
+
+    QDataStream & in = reader.stream();
+
+    qint32 numItems = 0;
+    in >> numItems;
+
+    // The data container takes care of dropping the duplicate items the corrupted snapshot might have
+    FavoritesData restoredData;
+    for(qint32 i = 0; (i < numItems) && (in.status() == QDataStream::Ok); ++i)
+    {
+        FavoritesModelItem item;
+        in >> item;
+
+        if (item.type() != FavoritesModelItem::Type::Unknown) {
+            Q_UNUSED(restoredData.get<ByIndex>().push_back(item))
+        }
+    }
+
+    if (!reader.checkStatus(errorDescription)) {
+        return false;
+    }
+
+    FavoritesDataByIndex & restoredRowIndex = restoredData.get<ByIndex>();
+    std::vector<boost::reference_wrapper<const FavoritesModelItem> > items(restoredRowIndex.begin(), restoredRowIndex.end());
+    std::sort(items.begin(), items.end(), Comparator(m_sortedColumn, m_sortOrder));
+    restoredRowIndex.rearrange(items.begin());
+
+    for(auto it = restoredRowIndex.begin(), end = restoredRowIndex.end(); it != end; ++it) {
+        Q_UNUSED(m_restoredLocalUidsPendingReconciliation.insert(it->localUid()))
+    }
+
+    QNDEBUG(QStringLiteral("Restored ") << restoredData.size() << QStringLiteral(" favorites model items from the snapshot"));
+
+    if (restoredData.empty()) {
+        return true;
+    }
+
+    beginInsertRows(QModelIndex(), 0, static_cast<int>(restoredData.size()) - 1);
+    m_data.swap(restoredData);
+    endInsertRows();
+
+    return true;
+}
+
 Qt::ItemFlags FavoritesModel::flags(const QModelIndex & index) const
 {
     Qt::ItemFlags indexFlags = QAbstractItemModel::flags(index);
@@ -571,6 +683,19 @@ void FavoritesModel::sort(int column, Qt::SortOrder order)
 
     FavoritesDataByIndex & rowIndex = m_data.get<ByIndex>();
 
+    if (m_pSortTask)
+    {
+        if ((column == m_pSortTask->sortedColumn()) && (order == m_pSortTask->sortOrder())) {
+            QNDEBUG(QStringLiteral("The sorting by this column and order is already in progress"));
+            return;
+        }
+
+        // NOTE: the superseded task would give up the sorting soon and its result would be ignored anyway
+        QNDEBUG(QStringLiteral("Dropping the sorting in progress"));
+        m_pSortTask->cancel();
+        m_pSortTask = Q_NULLPTR;
+    }
+
     if (column == m_sortedColumn)
     {
         if (order == m_sortOrder) {
@@ -589,66 +714,24 @@ void FavoritesModel::sort(int column, Qt::SortOrder order)
         return;
     }
 
+    if (m_data.size() >= FAVORITES_MODEL_ASYNC_SORT_MIN_NUM_ITEMS) {
+        startAsyncSort(static_cast<Columns::type>(column), order);
+        return;
+    }
+
     m_sortedColumn = static_cast<Columns::type>(column);
     m_sortOrder = order;
 
     Q_EMIT layoutAboutToBeChanged();
 
     QModelIndexList persistentIndices = persistentIndexList();
-    QVector<std::pair<QString, int> > localUidsToUpdateWithColumns;
-    localUidsToUpdateWithColumns.reserve(persistentIndices.size());
-
-    QStringList localUidsToUpdate;
-    for(auto it = persistentIndices.begin(), end = persistentIndices.end(); it != end; ++it)
-    {
-        const QModelIndex & modelIndex = *it;
-        int column = modelIndex.column();
-
-        if (!modelIndex.isValid()) {
-            localUidsToUpdateWithColumns << std::pair<QString, int>(QString(), column);
-            continue;
-        }
-
-        int row = modelIndex.row();
-
-        if ((row < 0) || (row >= static_cast<int>(m_data.size())) ||
-            (column < 0) || (column >= NUM_FAVORITES_MODEL_COLUMNS))
-        {
-            localUidsToUpdateWithColumns << std::pair<QString, int>(QString(), column);
-        }
-
-        auto itemIt = rowIndex.begin() + row;
-        const FavoritesModelItem & item = *itemIt;
-        localUidsToUpdateWithColumns << std::pair<QString, int>(item.localUid(), column);
-    }
+    QVector<std::pair<QString, int> > localUidsToUpdateWithColumns = persistentIndexLocalUids(persistentIndices);
 
     std::vector<boost::reference_wrapper<const FavoritesModelItem> > items(rowIndex.begin(), rowIndex.end());
     std::sort(items.begin(), items.end(), Comparator(m_sortedColumn, m_sortOrder));
     rowIndex.rearrange(items.begin());
 
-    QModelIndexList replacementIndices;
-    replacementIndices.reserve(std::max(localUidsToUpdateWithColumns.size(), 0));
-    for(auto it = localUidsToUpdateWithColumns.begin(), end = localUidsToUpdateWithColumns.end(); it != end; ++it)
-    {
-        const QString & localUid = it->first;
-        const int column = it->second;
-
-        if (localUid.isEmpty()) {
-            replacementIndices << QModelIndex();
-            continue;
-        }
-
-        QModelIndex newIndex = indexForLocalUid(localUid);
-        if (!newIndex.isValid()) {
-            replacementIndices << QModelIndex();
-            continue;
-        }
-
-        QModelIndex newIndexWithColumn = createIndex(newIndex.row(), column);
-        replacementIndices << newIndexWithColumn;
-    }
-
-    changePersistentIndexList(persistentIndices, replacementIndices);
+    updatePersistentIndices(persistentIndices, localUidsToUpdateWithColumns);
 
     Q_EMIT layoutChanged();
 }
@@ -791,7 +874,8 @@ void FavoritesModel::onListNotesComplete(LocalStorageManager::ListObjectsOptions
                                          LocalStorageManager::OrderDirection::type orderDirection, QString linkedNotebookGuid,
                                          QList<Note> foundNotes, QUuid requestId)
 {
-    if (requestId != m_listNotesRequestId) {
+    QList<Note> readyNotes;
+    if (!m_listNotesPipeline.onRequestComplete(requestId, foundNotes, readyNotes)) {
         return;
     }
 
@@ -801,15 +885,12 @@ void FavoritesModel::onListNotesComplete(LocalStorageManager::ListObjectsOptions
             << orderDirection << QStringLiteral(", linked notebook guid = ") << linkedNotebookGuid
             << QStringLiteral(", num found notes = ") << foundNotes.size() << QStringLiteral(", request id = ") << requestId);
 
-    for(auto it = foundNotes.begin(), end = foundNotes.end(); it != end; ++it) {
+    for(auto it = readyNotes.constBegin(), end = readyNotes.constEnd(); it != end; ++it) {
         onNoteAddedOrUpdated(*it);
     }
 
-    m_listNotesRequestId = QUuid();
-
-    if (!foundNotes.isEmpty()) {
-        QNTRACE(QStringLiteral("The number of found notes is greater than zero, requesting more notes from the local storage"));
-        m_listNotesOffset += static_cast<size_t>(foundNotes.size());
+    if (m_listNotesPipeline.isActive()) {
+        QNTRACE(QStringLiteral("Not all notes are listed yet, requesting more notes from the local storage"));
         requestNotesList();
         return;
     }
@@ -822,7 +903,7 @@ void FavoritesModel::onListNotesFailed(LocalStorageManager::ListObjectsOptions f
                                        LocalStorageManager::OrderDirection::type orderDirection, QString linkedNotebookGuid,
                                        ErrorString errorDescription, QUuid requestId)
 {
-    if (requestId != m_listNotesRequestId) {
+    if (!m_listNotesPipeline.onRequestFailed(requestId)) {
         return;
     }
 
@@ -832,9 +913,9 @@ void FavoritesModel::onListNotesFailed(LocalStorageManager::ListObjectsOptions f
             << orderDirection << QStringLiteral(", linked notebook guid = ") << linkedNotebookGuid
             << QStringLiteral(", error description = ") << errorDescription << QStringLiteral(", request id = ") << requestId);
 
-    m_listNotesRequestId = QUuid();
-
     Q_EMIT notifyError(errorDescription);
+
+    checkAllItemsListed();
 }
 
 void FavoritesModel::onExpungeNoteComplete(Note note, QUuid requestId)
@@ -963,7 +1044,8 @@ void FavoritesModel::onListNotebooksComplete(LocalStorageManager::ListObjectsOpt
                                              QString linkedNotebookGuid, QList<Notebook> foundNotebooks,
                                              QUuid requestId)
 {
-    if (requestId != m_listNotebooksRequestId) {
+    QList<Notebook> readyNotebooks;
+    if (!m_listNotebooksPipeline.onRequestComplete(requestId, foundNotebooks, readyNotebooks)) {
         return;
     }
 
@@ -973,15 +1055,12 @@ void FavoritesModel::onListNotebooksComplete(LocalStorageManager::ListObjectsOpt
             << (linkedNotebookGuid.isNull() ? QStringLiteral("<null>") : linkedNotebookGuid) << QStringLiteral(", num found notebooks = ")
             << foundNotebooks.size() << QStringLiteral(", request id = ") << requestId);
 
-    for(auto it = foundNotebooks.begin(), end = foundNotebooks.end(); it != end; ++it) {
+    for(auto it = readyNotebooks.constBegin(), end = readyNotebooks.constEnd(); it != end; ++it) {
         onNotebookAddedOrUpdated(*it);
     }
 
-    m_listNotebooksRequestId = QUuid();
-
-    if (!foundNotebooks.isEmpty()) {
-        QNTRACE(QStringLiteral("The number of found notebooks is greater than zero, requesting more notebooks from the local storage"));
-        m_listNotebooksOffset += static_cast<size_t>(foundNotebooks.size());
+    if (m_listNotebooksPipeline.isActive()) {
+        QNTRACE(QStringLiteral("Not all notebooks are listed yet, requesting more notebooks from the local storage"));
         requestNotebooksList();
         return;
     }
@@ -995,7 +1074,7 @@ void FavoritesModel::onListNotebooksFailed(LocalStorageManager::ListObjectsOptio
                                            LocalStorageManager::OrderDirection::type orderDirection,
                                            QString linkedNotebookGuid, ErrorString errorDescription, QUuid requestId)
 {
-    if (requestId != m_listNotebooksRequestId) {
+    if (!m_listNotebooksPipeline.onRequestFailed(requestId)) {
         return;
     }
 
@@ -1005,9 +1084,9 @@ void FavoritesModel::onListNotebooksFailed(LocalStorageManager::ListObjectsOptio
             << (linkedNotebookGuid.isNull() ? QStringLiteral("<null>") : linkedNotebookGuid) << QStringLiteral(", error description = ")
             << errorDescription << QStringLiteral(", request id = ") << requestId);
 
-    m_listNotebooksRequestId = QUuid();
-
     Q_EMIT notifyError(errorDescription);
+
+    checkAllItemsListed();
 }
 
 void FavoritesModel::onExpungeNotebookComplete(Notebook notebook, QUuid requestId)
@@ -1129,7 +1208,8 @@ void FavoritesModel::onListTagsComplete(LocalStorageManager::ListObjectsOptions
                                         LocalStorageManager::OrderDirection::type orderDirection,
                                         QString linkedNotebookGuid, QList<Tag> foundTags, QUuid requestId)
 {
-    if (requestId != m_listTagsRequestId) {
+    QList<Tag> readyTags;
+    if (!m_listTagsPipeline.onRequestComplete(requestId, foundTags, readyTags)) {
         return;
     }
 
@@ -1139,15 +1219,12 @@ void FavoritesModel::onListTagsComplete(LocalStorageManager::ListObjectsOptions
             << (linkedNotebookGuid.isNull() ? QStringLiteral("<null>") : linkedNotebookGuid)
             << QStringLiteral(", num found tags = ") << foundTags.size() << QStringLiteral(", request id = ") << requestId);
 
-    for(auto it = foundTags.begin(), end = foundTags.end(); it != end; ++it) {
+    for(auto it = readyTags.constBegin(), end = readyTags.constEnd(); it != end; ++it) {
         onTagAddedOrUpdated(*it);
     }
 
-    m_listTagsRequestId = QUuid();
-
-    if (!foundTags.isEmpty()) {
-        QNTRACE(QStringLiteral("The number of found tags is greater than zero, requesting more tags from the local storage"));
-        m_listTagsOffset += static_cast<size_t>(foundTags.size());
+    if (m_listTagsPipeline.isActive()) {
+        QNTRACE(QStringLiteral("Not all tags are listed yet, requesting more tags from the local storage"));
         requestTagsList();
         return;
     }
@@ -1161,7 +1238,7 @@ void FavoritesModel::onListTagsFailed(LocalStorageManager::ListObjectsOptions fl
                                       LocalStorageManager::OrderDirection::type orderDirection,
                                       QString linkedNotebookGuid, ErrorString errorDescription, QUuid requestId)
 {
-    if (requestId != m_listTagsRequestId) {
+    if (!m_listTagsPipeline.onRequestFailed(requestId)) {
         return;
     }
 
@@ -1171,9 +1248,9 @@ void FavoritesModel::onListTagsFailed(LocalStorageManager::ListObjectsOptions fl
             << (linkedNotebookGuid.isNull() ? QStringLiteral("<null>") : linkedNotebookGuid)
             << QStringLiteral(", error description = ") << errorDescription << QStringLiteral(", request id = ") << requestId);
 
-    m_listTagsRequestId = QUuid();
-
     Q_EMIT notifyError(errorDescription);
+
+    checkAllItemsListed();
 }
 
 void FavoritesModel::onExpungeTagComplete(Tag tag, QStringList expungedChildTagLocalUids, QUuid requestId)
@@ -1301,7 +1378,8 @@ void FavoritesModel::onListSavedSearchesComplete(LocalStorageManager::ListObject
                                                  LocalStorageManager::OrderDirection::type orderDirection,
                                                  QList<SavedSearch> foundSearches, QUuid requestId)
 {
-    if (requestId != m_listSavedSearchesRequestId) {
+    QList<SavedSearch> readySearches;
+    if (!m_listSavedSearchesPipeline.onRequestComplete(requestId, foundSearches, readySearches)) {
         return;
     }
 
@@ -1310,15 +1388,12 @@ void FavoritesModel::onListSavedSearchesComplete(LocalStorageManager::ListObject
             << QStringLiteral(", direction = ") << orderDirection << QStringLiteral(", num found searches = ")
             << foundSearches.size() << QStringLiteral(", request id = ") << requestId);
 
-    for(auto it = foundSearches.begin(), end = foundSearches.end(); it != end; ++it) {
+    for(auto it = readySearches.constBegin(), end = readySearches.constEnd(); it != end; ++it) {
         onSavedSearchAddedOrUpdated(*it);
     }
 
-    m_listSavedSearchesRequestId = QUuid();
-
-    if (!foundSearches.isEmpty()) {
-        QNTRACE(QStringLiteral("The number of found saved searches is not empty, requesting more saved searches from the local storage"));
-        m_listSavedSearchesOffset += static_cast<size_t>(foundSearches.size());
+    if (m_listSavedSearchesPipeline.isActive()) {
+        QNTRACE(QStringLiteral("Not all saved searches are listed yet, requesting more saved searches from the local storage"));
         requestSavedSearchesList();
         return;
     }
@@ -1332,7 +1407,7 @@ void FavoritesModel::onListSavedSearchesFailed(LocalStorageManager::ListObjectsO
                                                LocalStorageManager::OrderDirection::type orderDirection,
                                                ErrorString errorDescription, QUuid requestId)
 {
-    if (requestId != m_listSavedSearchesRequestId) {
+    if (!m_listSavedSearchesPipeline.onRequestFailed(requestId)) {
         return;
     }
 
@@ -1340,9 +1415,9 @@ void FavoritesModel::onListSavedSearchesFailed(LocalStorageManager::ListObjectsO
             << limit << QStringLiteral(", offset = ") << offset << QStringLiteral(", order = ") << order << QStringLiteral(", direction = ")
             << orderDirection << QStringLiteral(", error: ") << errorDescription << QStringLiteral(", request id = ") << requestId);
 
-    m_listSavedSearchesRequestId = QUuid();
-
     Q_EMIT notifyError(errorDescription);
+
+    checkAllItemsListed();
 }
 
 void FavoritesModel::onExpungeSavedSearchComplete(SavedSearch search, QUuid requestId)
@@ -1438,7 +1513,7 @@ void FavoritesModel::createConnections(const NoteModel & noteModel, LocalStorage
 {
     QNDEBUG(QStringLiteral("FavoritesModel::createConnections"));
 
-    if (!noteModel.allNotesListed()) {
+    if ((noteModel.listingMode() == NoteModel::ListingMode::Full) && !noteModel.allNotesListed()) {
         QObject::connect(&noteModel, QNSIGNAL(NoteModel,notifyAllNotesListed),
                          this, QNSLOT(FavoritesModel,onAllNotesListed));
     }
@@ -1599,20 +1674,26 @@ void FavoritesModel::createConnections(const NoteModel & noteModel, LocalStorage
 
 void FavoritesModel::requestNotesList()
 {
-    QNDEBUG(QStringLiteral("FavoritesModel::requestNotesList: offset = ") << m_listNotesOffset);
+    QNDEBUG(QStringLiteral("FavoritesModel::requestNotesList: offset = ") << m_listNotesPipeline.appliedOffset());
 
     LocalStorageManager::ListObjectsOptions flags = LocalStorageManager::ListFavoritedElements;
     LocalStorageManager::ListNotesOrder::type order = LocalStorageManager::ListNotesOrder::NoOrder;
     LocalStorageManager::OrderDirection::type direction = LocalStorageManager::OrderDirection::Ascending;
 
-    m_listNotesRequestId = QUuid::createUuid();
-    QNTRACE(QStringLiteral("Emitting the request to list notes: offset = ") << m_listNotesOffset << QStringLiteral(", request id = ") << m_listNotesRequestId);
-    Q_EMIT listNotes(flags, /* with resource binary data = */ false, NOTE_LIST_LIMIT, m_listNotesOffset, order, direction, QString(), m_listNotesRequestId);
+    QList<ListNotesPipeline::Request> requests = m_listNotesPipeline.takeRequestsToSend();
+    for(auto it = requests.constBegin(), end = requests.constEnd(); it != end; ++it)
+    {
+        const ListNotesPipeline::Request & request = *it;
+        QNTRACE(QStringLiteral("Emitting the request to list notes: offset = ") << request.m_offset
+                << QStringLiteral(", limit = ") << request.m_limit << QStringLiteral(", request id = ") << request.m_requestId);
+        Q_EMIT listNotes(flags, /* with resource binary data = */ false, request.m_limit, request.m_offset,
+                         order, direction, QString(), request.m_requestId);
+    }
 }
 
 void FavoritesModel::requestNotebooksList()
 {
-    QNDEBUG(QStringLiteral("FavoritesModel::requestNotebooksList: offset = ") << m_listNotebooksOffset);
+    QNDEBUG(QStringLiteral("FavoritesModel::requestNotebooksList: offset = ") << m_listNotebooksPipeline.appliedOffset());
 
     // NOTE: the subscription to all notebooks is necessary in order to receive the information about the restrictions for various notebooks +
     // for the collection of notebook names to forbid any two notebooks within the account to have the same name in a case-insensitive manner
@@ -1620,15 +1701,19 @@ void FavoritesModel::requestNotebooksList()
     LocalStorageManager::ListNotebooksOrder::type order = LocalStorageManager::ListNotebooksOrder::NoOrder;
     LocalStorageManager::OrderDirection::type direction = LocalStorageManager::OrderDirection::Ascending;
 
-    m_listNotebooksRequestId = QUuid::createUuid();
-    QNTRACE(QStringLiteral("Emitting the request to list notebooks: offset = ") << m_listNotebooksOffset
-            << QStringLiteral(", request id = ") << m_listNotebooksRequestId);
-    Q_EMIT listNotebooks(flags, NOTEBOOK_LIST_LIMIT, m_listNotebooksOffset, order, direction, QString(), m_listNotebooksRequestId);
+    QList<ListNotebooksPipeline::Request> requests = m_listNotebooksPipeline.takeRequestsToSend();
+    for(auto it = requests.constBegin(), end = requests.constEnd(); it != end; ++it)
+    {
+        const ListNotebooksPipeline::Request & request = *it;
+        QNTRACE(QStringLiteral("Emitting the request to list notebooks: offset = ") << request.m_offset
+                << QStringLiteral(", limit = ") << request.m_limit << QStringLiteral(", request id = ") << request.m_requestId);
+        Q_EMIT listNotebooks(flags, request.m_limit, request.m_offset, order, direction, QString(), request.m_requestId);
+    }
 }
 
 void FavoritesModel::requestTagsList()
 {
-    QNDEBUG(QStringLiteral("FavoritesModel::requestTagsList: offset = ") << m_listTagsOffset);
+    QNDEBUG(QStringLiteral("FavoritesModel::requestTagsList: offset = ") << m_listTagsPipeline.appliedOffset());
 
     // NOTE: the subscription to all tags is necessary for the collection of tag names to forbid any two tags
     // within the account to have the same name in a case-insensitive manner
@@ -1636,15 +1721,19 @@ void FavoritesModel::requestTagsList()
     LocalStorageManager::ListTagsOrder::type order = LocalStorageManager::ListTagsOrder::NoOrder;
     LocalStorageManager::OrderDirection::type direction = LocalStorageManager::OrderDirection::Ascending;
 
-    m_listTagsRequestId = QUuid::createUuid();
-    QNTRACE(QStringLiteral("Emitting the request to list tags: offset = ") << m_listTagsOffset
-            << QStringLiteral(", request id = ") << m_listTagsRequestId);
-    Q_EMIT listTags(flags, TAG_LIST_LIMIT, m_listTagsOffset, order, direction, QString(), m_listTagsRequestId);
+    QList<ListTagsPipeline::Request> requests = m_listTagsPipeline.takeRequestsToSend();
+    for(auto it = requests.constBegin(), end = requests.constEnd(); it != end; ++it)
+    {
+        const ListTagsPipeline::Request & request = *it;
+        QNTRACE(QStringLiteral("Emitting the request to list tags: offset = ") << request.m_offset
+                << QStringLiteral(", limit = ") << request.m_limit << QStringLiteral(", request id = ") << request.m_requestId);
+        Q_EMIT listTags(flags, request.m_limit, request.m_offset, order, direction, QString(), request.m_requestId);
+    }
 }
 
 void FavoritesModel::requestSavedSearchesList()
 {
-    QNDEBUG(QStringLiteral("FavoritesModel::requestSavedSearchesList: offset = ") << m_listSavedSearchesOffset);
+    QNDEBUG(QStringLiteral("FavoritesModel::requestSavedSearchesList: offset = ") << m_listSavedSearchesPipeline.appliedOffset());
 
     // NOTE: the subscription to all saved searches is necessary for the collection of saved search names to forbid any two saved searches
     // within the account to have the same name in a case-insensitive manner
@@ -1652,11 +1741,14 @@ void FavoritesModel::requestSavedSearchesList()
     LocalStorageManager::ListSavedSearchesOrder::type order = LocalStorageManager::ListSavedSearchesOrder::NoOrder;
     LocalStorageManager::OrderDirection::type direction = LocalStorageManager::OrderDirection::Ascending;
 
-    m_listSavedSearchesRequestId = QUuid::createUuid();
-    QNTRACE(QStringLiteral("Emitting the request to list saved searches: offset = ") << m_listSavedSearchesOffset
-            << QStringLiteral(", request id = ") << m_listSavedSearchesRequestId);
-    Q_EMIT listSavedSearches(flags, SAVED_SEARCH_LIST_LIMIT, m_listSavedSearchesOffset,
-                           order, direction, m_listSavedSearchesRequestId);
+    QList<ListSavedSearchesPipeline::Request> requests = m_listSavedSearchesPipeline.takeRequestsToSend();
+    for(auto it = requests.constBegin(), end = requests.constEnd(); it != end; ++it)
+    {
+        const ListSavedSearchesPipeline::Request & request = *it;
+        QNTRACE(QStringLiteral("Emitting the request to list saved searches: offset = ") << request.m_offset
+                << QStringLiteral(", limit = ") << request.m_limit << QStringLiteral(", request id = ") << request.m_requestId);
+        Q_EMIT listSavedSearches(flags, request.m_limit, request.m_offset, order, direction, request.m_requestId);
+    }
 }
 
 void FavoritesModel::requestNoteCountForNotebook(const QString & notebookLocalUid, const NoteCountRequestOption::type option)
@@ -1904,6 +1996,13 @@ void FavoritesModel::removeItemByLocalUid(const QString & localUid)
 {
     QNDEBUG(QStringLiteral("FavoritesModel::removeItemByLocalUid: local uid = ") << localUid);
 
+    Q_UNUSED(m_restoredLocalUidsPendingReconciliation.remove(localUid))
+
+    if (!m_allItemsListed && (m_pendingListedItemsByLocalUid.remove(localUid) != 0)) {
+        QNDEBUG(QStringLiteral("Removed the item pending the insertion into the model"));
+        return;
+    }
+
     FavoritesDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
     auto itemIt = localUidIndex.find(localUid);
     if (Q_UNLIKELY(itemIt == localUidIndex.end())) {
@@ -2020,6 +2119,76 @@ void FavoritesModel::updateItemRowWithRespectToSorting(const FavoritesModelItem
     endInsertRows();
 }
 
+void FavoritesModel::startAsyncSort(const Columns::type column, const Qt::SortOrder order)
+{
+    QNDEBUG(QStringLiteral("FavoritesModel::startAsyncSort: column = ") << column << QStringLiteral(", order = ") << order
+            << QStringLiteral(", number of items = ") << m_data.size());
+
+    const FavoritesDataByIndex & rowIndex = m_data.get<ByIndex>();
+    std::vector<FavoritesModelItem> snapshot(rowIndex.begin(), rowIndex.end());
+
+    m_pSortTask = new FavoritesSortTask(snapshot, column, order);
+
+    QObject::connect(m_pSortTask, QNSIGNAL(AsyncSortTask,finished),
+                     this, QNSLOT(FavoritesModel,onSortTaskFinished));
+    QObject::connect(m_pSortTask, QNSIGNAL(AsyncSortTask,finished),
+                     m_pSortTask, QNSLOT(AsyncSortTask,deleteLater));
+
+    m_sortThreadPool.start(m_pSortTask);
+}
+
+void FavoritesModel::onSortTaskFinished()
+{
+    QNDEBUG(QStringLiteral("FavoritesModel::onSortTaskFinished"));
+
+    if (!m_pSortTask || (sender() != m_pSortTask)) {
+        QNDEBUG(QStringLiteral("The sorting has been superseded, ignoring its result"));
+        return;
+    }
+
+    const FavoritesSortTask * pSortTask = m_pSortTask;
+    m_pSortTask = Q_NULLPTR;
+
+    applySortedItems(pSortTask->sortedItems(), pSortTask->sortedColumn(), pSortTask->sortOrder());
+}
+
+void FavoritesModel::applySortedItems(const std::vector<const FavoritesModelItem*> & sortedItems,
+                                      const Columns::type column, const Qt::SortOrder order)
+{
+    QNDEBUG(QStringLiteral("FavoritesModel::applySortedItems: column = ") << column << QStringLiteral(", order = ") << order);
+
+    Q_EMIT layoutAboutToBeChanged();
+
+    QModelIndexList persistentIndices = persistentIndexList();
+    QVector<std::pair<QString, int> > localUidsToUpdateWithColumns = persistentIndexLocalUids(persistentIndices);
+
+    m_sortedColumn = column;
+    m_sortOrder = order;
+
+    Comparator comparator(m_sortedColumn, m_sortOrder);
+    size_t numPositionedItems =
+        rearrangeBySortedSnapshot<ByIndex, ByLocalUid>(m_data, sortedItems,
+                                                       ComparatorEquivalence<FavoritesModelItem, Comparator>(comparator),
+                                                       comparator);
+    QNDEBUG(QStringLiteral("Positioned ") << numPositionedItems
+            << QStringLiteral(" items added or changed during the sorting"));
+
+    updatePersistentIndices(persistentIndices, localUidsToUpdateWithColumns);
+
+    Q_EMIT layoutChanged();
+}
+
+QVector<std::pair<QString, int> > FavoritesModel::persistentIndexLocalUids(const QModelIndexList & persistentIndices) const
+{
+    return localUidsForPersistentIndices(*this, persistentIndices);
+}
+
+void FavoritesModel::updatePersistentIndices(const QModelIndexList & persistentIndices,
+                                             const QVector<std::pair<QString, int> > & localUidsWithColumns)
+{
+    changePersistentIndexList(persistentIndices, persistentIndexReplacements(*this, localUidsWithColumns));
+}
+
 void FavoritesModel::updateItemInLocalStorage(const FavoritesModelItem & item)
 {
     switch(item.type())
@@ -2397,6 +2566,8 @@ void FavoritesModel::onNoteAddedOrUpdated(const Note & note, const bool tagsUpda
     QNDEBUG(QStringLiteral("FavoritesModel::onNoteAddedOrUpdated: note local uid = ") << note.localUid()
             << QStringLiteral(", tags updated = ") << (tagsUpdated ? QStringLiteral("true") : QStringLiteral("false")));
 
+    Q_UNUSED(m_restoredLocalUidsPendingReconciliation.remove(note.localUid()))
+
     if (tagsUpdated) {
         m_noteCache.put(note.localUid(), note);
         checkTagsUpdateForNote(note);
@@ -2440,6 +2611,11 @@ void FavoritesModel::onNoteAddedOrUpdated(const Note & note, const bool tagsUpda
     {
         QNDEBUG(QStringLiteral("Detected newly favorited note"));
 
+        if (!m_allItemsListed) {
+            addPendingListedItem(item);
+            return;
+        }
+
         Q_EMIT aboutToAddItem();
 
         int row = static_cast<int>(rowIndex.size());
@@ -2485,6 +2661,8 @@ void FavoritesModel::onNotebookAddedOrUpdated(const Notebook & notebook)
 {
     QNDEBUG(QStringLiteral("FavoritesModel::onNotebookAddedOrUpdated: local uid = ") << notebook.localUid());
 
+    Q_UNUSED(m_restoredLocalUidsPendingReconciliation.remove(notebook.localUid()))
+
     m_notebookCache.put(notebook.localUid(), notebook);
 
     FavoritesDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
@@ -2556,6 +2734,11 @@ void FavoritesModel::onNotebookAddedOrUpdated(const Notebook & notebook)
     {
         QNDEBUG(QStringLiteral("Detected newly favorited notebook"));
 
+        if (!m_allItemsListed) {
+            addPendingListedItem(item);
+            return;
+        }
+
         Q_EMIT aboutToAddItem();
 
         int row = static_cast<int>(rowIndex.size());
@@ -2606,6 +2789,8 @@ void FavoritesModel::onTagAddedOrUpdated(const Tag & tag)
 {
     QNDEBUG(QStringLiteral("FavoritesModel::onTagAddedOrUpdated: local uid = ") << tag.localUid());
 
+    Q_UNUSED(m_restoredLocalUidsPendingReconciliation.remove(tag.localUid()))
+
     m_tagCache.put(tag.localUid(), tag);
 
     FavoritesDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
@@ -2647,6 +2832,11 @@ void FavoritesModel::onTagAddedOrUpdated(const Tag & tag)
     {
         QNDEBUG(QStringLiteral("Detected newly favorited tag"));
 
+        if (!m_allItemsListed) {
+            addPendingListedItem(item);
+            return;
+        }
+
         Q_EMIT aboutToAddItem();
 
         int row = static_cast<int>(rowIndex.size());
@@ -2697,6 +2887,8 @@ void FavoritesModel::onSavedSearchAddedOrUpdated(const SavedSearch & search)
 {
     QNDEBUG(QStringLiteral("FavoritesModel::onSavedSearchAddedOrUpdated: local uid = ") << search.localUid());
 
+    Q_UNUSED(m_restoredLocalUidsPendingReconciliation.remove(search.localUid()))
+
     m_savedSearchCache.put(search.localUid(), search);
 
     FavoritesDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
@@ -2738,6 +2930,11 @@ void FavoritesModel::onSavedSearchAddedOrUpdated(const SavedSearch & search)
     {
         QNDEBUG(QStringLiteral("Detected newly favorited saved search"));
 
+        if (!m_allItemsListed) {
+            addPendingListedItem(item);
+            return;
+        }
+
         Q_EMIT aboutToAddItem();
 
         int row = static_cast<int>(rowIndex.size());
@@ -2968,71 +3165,114 @@ void FavoritesModel::checkAllItemsListed()
         return;
     }
 
-    if (m_listNotesRequestId.isNull() && m_listNotebooksRequestId.isNull() && m_listTagsRequestId.isNull() && m_listSavedSearchesRequestId.isNull()) {
+    // NOTE: the pipeline which request has failed is stopped and won't be resumed, the items of that type
+    // listed before the failure are considered to be all there is so that the pending items get into the model
+    if (!m_listNotesPipeline.isActive() && !m_listNotebooksPipeline.isActive() &&
+        !m_listTagsPipeline.isActive() && !m_listSavedSearchesPipeline.isActive())
+    {
         QNDEBUG(QStringLiteral("Listed all favorites model's items"));
         m_allItemsListed = true;
+        removeUnreconciledRestoredItems();
+        insertPendingListedItems();
+
+        if (!m_data.empty()) {
+            // Need to figure out how many notes the favorited notebooks and tags target
+            requestNoteCountForAllNotebooks(NoteCountRequestOption::IfNotAlreadyRunning);
+            requestNoteCountForAllTags(NoteCountRequestOption::IfNotAlreadyRunning);
+        }
+
         Q_EMIT notifyAllItemsListed();
     }
 }
 
-void FavoritesModel::buildTagLocalUidsByNoteLocalUidsHash(const NoteModel & noteModel)
+void FavoritesModel::addPendingListedItem(const FavoritesModelItem & item)
 {
-    QNDEBUG(QStringLiteral("FavoritesModel::buildTagLocalUidsByNoteLocalUidsHash"));
+    QNTRACE(QStringLiteral("FavoritesModel::addPendingListedItem: ") << item);
+    m_pendingListedItemsByLocalUid[item.localUid()] = item;
+}
+
+void FavoritesModel::insertPendingListedItems()
+{
+    QNDEBUG(QStringLiteral("FavoritesModel::insertPendingListedItems: ") << m_pendingListedItemsByLocalUid.size()
+            << QStringLiteral(" items"));
+
+    if (m_pendingListedItemsByLocalUid.isEmpty()) {
+        return;
+    }
+
+    std::vector<FavoritesModelItem> items;
+    items.reserve(static_cast<size_t>(m_pendingListedItemsByLocalUid.size()));
+    for(auto it = m_pendingListedItemsByLocalUid.constBegin(), end = m_pendingListedItemsByLocalUid.constEnd(); it != end; ++it) {
+        items.push_back(it.value());
+    }
+
+    m_pendingListedItemsByLocalUid.clear();
 
-    m_tagLocalUidsByNoteLocalUid.clear();
+    FavoritesDataByIndex & rowIndex = m_data.get<ByIndex>();
 
-    int numNotes = noteModel.rowCount(QModelIndex());
-    for(int i = 0; i < numNotes; ++i)
+    // NOTE: the items restored from the snapshot are already in the model so the newly favorited ones
+    // have to be put into their positions among them individually
+    if (!rowIndex.empty())
     {
-        const NoteModelItem * pNoteModelItem = noteModel.itemAtRow(i);
-        if (Q_UNLIKELY(!pNoteModelItem)) {
-            QNWARNING(QStringLiteral("Can't find note model item at row ") << i << QStringLiteral(" even though there are ")
-                      << numNotes << QStringLiteral(" rows within the model"));
-            continue;
-        }
+        for(auto it = items.begin(), end = items.end(); it != end; ++it)
+        {
+            int row = static_cast<int>(rowIndex.size());
+            beginInsertRows(QModelIndex(), row, row);
+            rowIndex.push_back(*it);
+            endInsertRows();
 
-        const QStringList & tagLocalUids = pNoteModelItem->tagLocalUids();
-        if (tagLocalUids.isEmpty()) {
-            QNTRACE(QStringLiteral("Note ") << pNoteModelItem->localUid() << QStringLiteral(" has no tags"));
-            continue;
+            updateItemRowWithRespectToSorting(*it);
         }
 
-        QNTRACE(QStringLiteral("Tag local uids for note local uid ") << pNoteModelItem->localUid()
-                << QStringLiteral(": ") << tagLocalUids.join(QStringLiteral(", ")));
-
-        m_tagLocalUidsByNoteLocalUid[pNoteModelItem->localUid()] = tagLocalUids;
+        return;
     }
 
-    m_receivedTagLocalUidsForAllNotes = true;
+    // NOTE: otherwise the model is still empty as before all items are listed the newly favorited items only get here;
+    // the items are sorted once and inserted as a single range of rows instead of positioning each item individually
+    std::sort(items.begin(), items.end(), Comparator(m_sortedColumn, m_sortOrder));
+
+    int lastRow = static_cast<int>(items.size()) - 1;
+
+    beginInsertRows(QModelIndex(), 0, lastRow);
+    for(auto it = items.begin(), end = items.end(); it != end; ++it) {
+        rowIndex.push_back(*it);
+    }
+    endInsertRows();
 }
 
-void FavoritesModel::buildNotebookLocalUidByNoteLocalUidsHash(const NoteModel & noteModel)
+void FavoritesModel::removeUnreconciledRestoredItems()
 {
-    QNDEBUG(QStringLiteral("FavoritesModel::buildNotebookLocalUidByNoteLocalUidsHash"));
+    if (m_restoredLocalUidsPendingReconciliation.isEmpty()) {
+        return;
+    }
 
-    m_notebookLocalUidByNoteLocalUid.clear();
+    QNDEBUG(QStringLiteral("Removing ") << m_restoredLocalUidsPendingReconciliation.size()
+            << QStringLiteral(" restored favorites model items which are no longer favorited within the local storage"));
 
-    int numNotes = noteModel.rowCount(QModelIndex());
-    for(int i = 0; i < numNotes; ++i)
-    {
-        const NoteModelItem * pNoteModelItem = noteModel.itemAtRow(i);
-        if (Q_UNLIKELY(!pNoteModelItem)) {
-            QNWARNING(QStringLiteral("Can't find note model item at row ") << i << QStringLiteral(" even though there are ")
-                      << numNotes << QStringLiteral(" rows within the model"));
-            continue;
-        }
+    QSet<QString> localUids = m_restoredLocalUidsPendingReconciliation;
+    m_restoredLocalUidsPendingReconciliation.clear();
 
-        const QString & notebookLocalUid = pNoteModelItem->notebookLocalUid();
-        if (Q_UNLIKELY(notebookLocalUid.isEmpty())) {
-            QNWARNING(QStringLiteral("Found note model item without notebook local uid: ") << *pNoteModelItem);
-            continue;
-        }
+    for(auto it = localUids.constBegin(), end = localUids.constEnd(); it != end; ++it) {
+        removeItemByLocalUid(*it);
+    }
+}
 
-        QNTRACE(QStringLiteral("Notebook local uid for note local uid ") << pNoteModelItem->localUid()
-                << QStringLiteral(": ") << notebookLocalUid);
+void FavoritesModel::buildTagLocalUidsByNoteLocalUidsHash(const NoteModel & noteModel)
+{
+    QNDEBUG(QStringLiteral("FavoritesModel::buildTagLocalUidsByNoteLocalUidsHash"));
 
-        m_notebookLocalUidByNoteLocalUid[pNoteModelItem->localUid()] = notebookLocalUid;
-    }
+    m_tagLocalUidsByNoteLocalUid = noteModel.tagLocalUidsByNoteLocalUids();
+    QNTRACE(QStringLiteral("Tag local uids are known for ") << m_tagLocalUidsByNoteLocalUid.size() << QStringLiteral(" notes"));
+
+    m_receivedTagLocalUidsForAllNotes = true;
+}
+
+void FavoritesModel::buildNotebookLocalUidByNoteLocalUidsHash(const NoteModel & noteModel)
+{
+    QNDEBUG(QStringLiteral("FavoritesModel::buildNotebookLocalUidByNoteLocalUidsHash"));
+
+    m_notebookLocalUidByNoteLocalUid = noteModel.notebookLocalUidsByNoteLocalUids();
+    QNTRACE(QStringLiteral("Notebook local uids are known for ") << m_notebookLocalUidByNoteLocalUid.size() << QStringLiteral(" notes"));
 
     m_receivedNotebookLocalUidsForAllNotes = true;
 }
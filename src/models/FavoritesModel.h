@@ -24,6 +24,8 @@
 #include "NotebookCache.h"
 #include "TagCache.h"
 #include "SavedSearchCache.h"
+#include "ParallelSort.h"
+#include "ListRequestPipeline.hpp"
 #include <quentier/types/Account.h>
 #include <quentier/types/Notebook.h>
 #include <quentier/types/Note.h>
@@ -87,6 +89,28 @@ public:
      */
     bool allItemsListed() const { return m_allItemsListed; }
 
+    /**
+     * @brief saveSnapshot - writes all the model's items into the snapshot file so that the next instance
+     * of the model for the same account could show them before they are listed from the local storage
+     * @param filePath - the path to the snapshot file
+     * @param errorDescription - the textual description of the error if the snapshot was not saved
+     * @return false if not all items have been listed yet or if the snapshot could not be written
+     */
+    bool saveSnapshot(const QString & filePath, ErrorString & errorDescription) const;
+
+    /**
+     * @brief restoreFromSnapshot - fills the model with the items from the snapshot file written by saveSnapshot
+     *
+     * The restored items are reconciled with the favorited notes, notebooks, tags and saved searches being listed
+     * from the local storage: they are updated as the corresponding objects are listed and the ones not listed
+     * by the end of the listing are removed from the model before notifyAllItemsListed is emitted
+     *
+     * @param filePath - the path to the snapshot file
+     * @param errorDescription - the textual description of the error if the snapshot was not restored
+     * @return false if the model already has some items or if the snapshot could not be read
+     */
+    bool restoreFromSnapshot(const QString & filePath, ErrorString & errorDescription);
+
 public:
     // QAbstractItemModel interface
     virtual Qt::ItemFlags flags(const QModelIndex & index) const Q_DECL_OVERRIDE;
@@ -240,6 +264,8 @@ private Q_SLOTS:
     void onGetNoteCountPerTagComplete(int noteCount, Tag tag, QUuid requestId);
     void onGetNoteCountPerTagFailed(ErrorString errorDescription, Tag tag, QUuid requestId);
 
+    void onSortTaskFinished();
+
 private:
     void createConnections(const NoteModel & noteModel, LocalStorageManagerAsync & localStorageManagerAsync);
     void requestNotesList();
@@ -276,6 +302,19 @@ private:
 
     void removeItemByLocalUid(const QString & localUid);
     void updateItemRowWithRespectToSorting(const FavoritesModelItem & item);
+
+    void startAsyncSort(const Columns::type column, const Qt::SortOrder order);
+
+    /**
+     * @brief applySortedItems - reorders the model's items according to the sorted snapshot of them; the items
+     * added or changed since the snapshot was taken are put into their positions according to the new sorting
+     */
+    void applySortedItems(const std::vector<const FavoritesModelItem*> & sortedItems, const Columns::type column,
+                          const Qt::SortOrder order);
+
+    QVector<std::pair<QString, int> > persistentIndexLocalUids(const QModelIndexList & persistentIndices) const;
+    void updatePersistentIndices(const QModelIndexList & persistentIndices,
+                                 const QVector<std::pair<QString, int> > & localUidsWithColumns);
     void updateItemInLocalStorage(const FavoritesModelItem & item);
     void updateNoteInLocalStorage(const FavoritesModelItem & item);
     void updateNotebookInLocalStorage(const FavoritesModelItem & item);
@@ -305,6 +344,13 @@ private:
 
     void checkAllItemsListed();
 
+    // The newly favorited items found before all the items are listed are collected separately
+    // and inserted into the model in bulk afterwards
+    void addPendingListedItem(const FavoritesModelItem & item);
+    void insertPendingListedItems();
+
+    void removeUnreconciledRestoredItems();
+
     void buildTagLocalUidsByNoteLocalUidsHash(const NoteModel & noteModel);
     void buildNotebookLocalUidByNoteLocalUidsHash(const NoteModel & noteModel);
 
@@ -357,8 +403,31 @@ private:
         Qt::SortOrder   m_sortOrder;
     };
 
+    class FavoritesSortTask: public SnapshotSortTask<FavoritesModelItem, Comparator>
+    {
+    public:
+        FavoritesSortTask(std::vector<FavoritesModelItem> & snapshot, const Columns::type column,
+                          const Qt::SortOrder sortOrder) :
+            SnapshotSortTask<FavoritesModelItem, Comparator>(snapshot, Comparator(column, sortOrder)),
+            m_sortedColumn(column),
+            m_sortOrder(sortOrder)
+        {}
+
+        Columns::type sortedColumn() const { return m_sortedColumn; }
+        Qt::SortOrder sortOrder() const { return m_sortOrder; }
+
+    private:
+        Columns::type   m_sortedColumn;
+        Qt::SortOrder   m_sortOrder;
+    };
+
     typedef boost::bimap<QString, QUuid> LocalUidToRequestIdBimap;
 
+    typedef ListRequestPipeline<Note> ListNotesPipeline;
+    typedef ListRequestPipeline<Notebook> ListNotebooksPipeline;
+    typedef ListRequestPipeline<Tag> ListTagsPipeline;
+    typedef ListRequestPipeline<SavedSearch> ListSavedSearchesPipeline;
+
 private:
     Account                 m_account;
     FavoritesData           m_data;
@@ -371,17 +440,10 @@ private:
     QSet<QString>           m_lowerCaseTagNames;
     QSet<QString>           m_lowerCaseSavedSearchNames;
 
-    size_t                  m_listNotesOffset;
-    QUuid                   m_listNotesRequestId;
-
-    size_t                  m_listNotebooksOffset;
-    QUuid                   m_listNotebooksRequestId;
-
-    size_t                  m_listTagsOffset;
-    QUuid                   m_listTagsRequestId;
-
-    size_t                  m_listSavedSearchesOffset;
-    QUuid                   m_listSavedSearchesRequestId;
+    ListNotesPipeline           m_listNotesPipeline;
+    ListNotebooksPipeline       m_listNotebooksPipeline;
+    ListTagsPipeline            m_listTagsPipeline;
+    ListSavedSearchesPipeline   m_listSavedSearchesPipeline;
 
     QSet<QUuid>             m_updateNoteRequestIds;
     QSet<QUuid>             m_findNoteToRestoreFailedUpdateRequestIds;
@@ -420,6 +482,18 @@ private:
     Columns::type           m_sortedColumn;
     Qt::SortOrder           m_sortOrder;
 
+    // The thread pool running the tasks sorting the snapshot of items in the background; the superseded
+    // tasks are cancelled and the ones still running are waited for on the model's destruction
+    QThreadPool             m_sortThreadPool;
+
+    // The task sorting the snapshot of items in the background, if any
+    FavoritesSortTask *     m_pSortTask;
+
+    QHash<QString, FavoritesModelItem>  m_pendingListedItemsByLocalUid;
+
+    // Local uids of the items restored from the snapshot which have not been listed from the local storage yet
+    QSet<QString>           m_restoredLocalUidsPendingReconciliation;
+
     bool                    m_allItemsListed;
 };
 
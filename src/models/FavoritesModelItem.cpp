@@ -59,4 +59,30 @@ QTextStream & FavoritesModelItem::print(QTextStream & strm) const
     return strm;
 }
 
+QDataStream & operator<<(QDataStream & out, const FavoritesModelItem & item)
+{
+    out << static_cast<qint8>(item.type()) << item.localUid() << item.displayName()
+        << static_cast<qint32>(item.numNotesTargeted());
+    return out;
+}
+
+QDataStream & operator>>(QDataStream & in, FavoritesModelItem & item)
+{
+    qint8 type = 0;
+    QString localUid;
+    QString displayName;
+    qint32 numNotesTargeted = 0;
+    in >> type >> localUid >> displayName >> numNotesTargeted;
+
+    if ((type < 0) || (type > static_cast<qint8>(FavoritesModelItem::Type::Unknown))) {
+        type = static_cast<qint8>(FavoritesModelItem::Type::Unknown);
+    }
+
+    item.setType(static_cast<FavoritesModelItem::Type::type>(type));
+    item.setLocalUid(localUid);
+    item.setDisplayName(displayName);
+    item.setNumNotesTargeted(numNotesTargeted);
+    return in;
+}
+
 } // namespace quentier
@@ -20,6 +20,7 @@
 #define QUENTIER_MODELS_FAVORITES_MODEL_ITEM_H
 
 #include <quentier/utility/Printable.h>
+#include <QDataStream>
 
 namespace quentier {
 
@@ -65,6 +66,9 @@ private:
     int             m_numNotesTargeted;
 };
 
+QDataStream & operator<<(QDataStream & out, const FavoritesModelItem & item);
+QDataStream & operator>>(QDataStream & in, FavoritesModelItem & item);
+
 } // namespace quentier
 
 #endif // QUENTIER_MODELS_FAVORITES_MODEL_ITEM_H
@@ -0,0 +1,294 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUENTIER_MODELS_LIST_REQUEST_PIPELINE_HPP
+#define QUENTIER_MODELS_LIST_REQUEST_PIPELINE_HPP
+
+#include "AdaptivePageSize.h"
+#include <quentier/utility/Macros.h>
+#include <QUuid>
+#include <QList>
+#include <QMap>
+#include <QHash>
+#include <QSet>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <limits>
+
+namespace quentier {
+
+/**
+ * @brief The ListRequestPipeline class template manages the paged listing of objects of type T from the local storage
+ * keeping several list requests in flight at once so that the local storage doesn't stay idle while the results
+ * of the previous page are delivered to the model and the request for the next page is sent.
+ *
+ * The pages received out of order are held back until all the preceding pages are received, so the model
+ * gets the listed objects in the order of offsets. The listing is considered finished after the first page
+ * containing fewer objects than were requested; the requests for the pages beyond it are forgotten
+ * and their results are ignored.
+ *
+ * Both the page size and the number of requests in flight adapt to the measured timings: the page size
+ * follows the time the local storage spends serving a single page while the number of requests in flight
+ * shrinks when the requests wait in the local storage's queue for longer than a couple of pages are served
+ * and grows when they barely wait at all.
+ */
+template <typename T>
+class ListRequestPipeline
+{
+public:
+    struct Request
+    {
+        QUuid   m_requestId;
+        size_t  m_offset;
+        size_t  m_limit;
+    };
+
+    ListRequestPipeline(const size_t initialPageSize, const size_t minPageSize, const size_t maxPageSize,
+                        const qint64 targetPageServiceMsec, const int maxRequestsInFlight) :
+        m_pageSize(initialPageSize, minPageSize, maxPageSize, targetPageServiceMsec),
+        m_maxRequestsInFlight(std::max(maxRequestsInFlight, 1)),
+        m_windowSize(1),
+        m_pages(),
+        m_offsetsByRequestId(),
+        m_nextOffset(0),
+        m_appliedOffset(0),
+        m_active(false),
+        m_exhausted(false),
+        m_clock(),
+        m_lastResponseMsec(-1)
+    {
+        m_clock.start();
+    }
+
+    /**
+     * @brief start - (re)starts the listing from the specified offset forgetting about any requests
+     * which might be still in flight
+     */
+    void start(const size_t offset = 0)
+    {
+        stop();
+        m_nextOffset = offset;
+        m_appliedOffset = offset;
+        m_exhausted = false;
+        m_active = true;
+    }
+
+    /**
+     * @brief stop - stops the listing forgetting about the requests in flight; the offset up to which
+     * the objects were handed out to the model is preserved and can be used for resuming the listing later
+     */
+    void stop()
+    {
+        m_pages.clear();
+        m_offsetsByRequestId.clear();
+        m_active = false;
+    }
+
+    /**
+     * @return true if the listing was started and neither finished nor stopped yet
+     */
+    bool isActive() const { return m_active; }
+
+    /**
+     * @return true if all the objects have been listed and handed out to the model
+     */
+    bool isFinished() const { return m_exhausted && !m_active; }
+
+    /**
+     * @return the offset up to which the listed objects have been handed out to the model
+     */
+    size_t appliedOffset() const { return m_appliedOffset; }
+
+    int numRequestsInFlight() const { return m_offsetsByRequestId.size(); }
+
+    bool hasRequest(const QUuid & requestId) const { return m_offsetsByRequestId.contains(requestId); }
+
+    /**
+     * @brief takeRequestsToSend - registers as many new requests as needed to fill the window of requests in flight;
+     * the caller is expected to actually send all the returned requests to the local storage
+     * @param endOffset - the offset starting from which no requests should be registered for now; allows to list
+     * just the necessary part of objects, the listing can be continued later by calling this method with greater offset
+     */
+    QList<Request> takeRequestsToSend(const size_t endOffset = std::numeric_limits<size_t>::max())
+    {
+        QList<Request> requests;
+        if (!m_active || m_exhausted) {
+            return requests;
+        }
+
+        while((m_offsetsByRequestId.size() < m_windowSize) && (m_nextOffset < endOffset))
+        {
+            Request request;
+            request.m_requestId = QUuid::createUuid();
+            request.m_offset = m_nextOffset;
+            request.m_limit = m_pageSize.pageSize();
+
+            Page page;
+            page.m_limit = request.m_limit;
+            page.m_sentMsec = m_clock.elapsed();
+
+            Q_UNUSED(m_pages.insert(request.m_offset, page))
+            Q_UNUSED(m_offsetsByRequestId.insert(request.m_requestId, request.m_offset))
+            m_nextOffset += request.m_limit;
+
+            requests << request;
+        }
+
+        return requests;
+    }
+
+    /**
+     * @brief onRequestComplete - processes the result of the list request
+     * @param requestId - the id of the completed request
+     * @param items - the objects listed by the completed request
+     * @param readyItems - the objects which are ready to be handed out to the model, in order
+     * @return false if the request doesn't belong to the pipeline, true otherwise
+     */
+    bool onRequestComplete(const QUuid & requestId, const QList<T> & items, QList<T> & readyItems)
+    {
+        auto offsetIt = m_offsetsByRequestId.find(requestId);
+        if (offsetIt == m_offsetsByRequestId.end()) {
+            return false;
+        }
+
+        const size_t offset = offsetIt.value();
+        Q_UNUSED(m_offsetsByRequestId.erase(offsetIt))
+
+        auto pageIt = m_pages.find(offset);
+        if (Q_UNLIKELY(pageIt == m_pages.end())) {
+            return true;
+        }
+
+        Page & page = pageIt.value();
+        page.m_items = items;
+        page.m_received = true;
+
+        adapt(page.m_sentMsec);
+
+        if (static_cast<size_t>(items.size()) < page.m_limit) {
+            onEndReached(offset);
+        }
+
+        while(!m_pages.isEmpty())
+        {
+            auto it = m_pages.begin();
+            if ((it.key() != m_appliedOffset) || !it.value().m_received) {
+                break;
+            }
+
+            readyItems << it.value().m_items;
+            m_appliedOffset += static_cast<size_t>(it.value().m_items.size());
+            Q_UNUSED(m_pages.erase(it))
+        }
+
+        if (m_exhausted && m_pages.isEmpty()) {
+            m_offsetsByRequestId.clear();
+            m_active = false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief onRequestFailed - stops the listing if the failed request belongs to the pipeline
+     * @return false if the request doesn't belong to the pipeline, true otherwise
+     */
+    bool onRequestFailed(const QUuid & requestId)
+    {
+        if (!m_offsetsByRequestId.contains(requestId)) {
+            return false;
+        }
+
+        stop();
+        return true;
+    }
+
+private:
+    struct Page
+    {
+        Page() : m_limit(0), m_sentMsec(0), m_received(false), m_items() {}
+
+        size_t      m_limit;
+        qint64      m_sentMsec;
+        bool        m_received;
+        QList<T>    m_items;
+    };
+
+    void onEndReached(const size_t lastPageOffset)
+    {
+        m_exhausted = true;
+
+        // Forget the requests for the pages beyond the last one
+        auto it = m_pages.upperBound(lastPageOffset);
+        while(it != m_pages.end()) {
+            it = m_pages.erase(it);
+        }
+
+        for(auto requestIt = m_offsetsByRequestId.begin(); requestIt != m_offsetsByRequestId.end(); )
+        {
+            if (requestIt.value() > lastPageOffset) {
+                requestIt = m_offsetsByRequestId.erase(requestIt);
+            }
+            else {
+                ++requestIt;
+            }
+        }
+    }
+
+    void adapt(const qint64 sentMsec)
+    {
+        const qint64 nowMsec = m_clock.elapsed();
+        const qint64 roundTripMsec = nowMsec - sentMsec;
+
+        // If another response arrived after this request was sent, the local storage started serving this request
+        // no earlier than that response
+        const qint64 serviceMsec = nowMsec - std::max(sentMsec, m_lastResponseMsec);
+        const qint64 waitMsec = roundTripMsec - serviceMsec;
+        m_lastResponseMsec = nowMsec;
+
+        m_pageSize.adjust(serviceMsec);
+
+        if ((waitMsec > 2 * serviceMsec) && (m_windowSize > 1)) {
+            --m_windowSize;
+        }
+        else if ((waitMsec * 2 <= serviceMsec) && (m_windowSize < m_maxRequestsInFlight)) {
+            ++m_windowSize;
+        }
+    }
+
+private:
+    AdaptivePageSize        m_pageSize;
+    int                     m_maxRequestsInFlight;
+    int                     m_windowSize;
+
+    QMap<size_t, Page>      m_pages;
+    QHash<QUuid, size_t>    m_offsetsByRequestId;
+
+    size_t                  m_nextOffset;
+    size_t                  m_appliedOffset;
+
+    bool                    m_active;
+    bool                    m_exhausted;
+
+    QElapsedTimer           m_clock;
+    qint64                  m_lastResponseMsec;
+};
+
+} // namespace quentier
+
+#endif // QUENTIER_MODELS_LIST_REQUEST_PIPELINE_HPP
@@ -0,0 +1,242 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LogLineParser.h"
+#include <cstring>
+
+namespace quentier {
+
+static inline bool isLogLineSpace(const char c)
+{
+    return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\v') || (c == '\f');
+}
+
+static inline bool isLogLineDigit(const char c)
+{
+    return (c >= '0') && (c <= '9');
+}
+
+static inline bool isLogLineWordChar(const char c)
+{
+    return isLogLineDigit(c) || ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || (c == '_');
+}
+
+static int skipLogLineSpaces(const char * pLine, const int lineSize, int & pos)
+{
+    int startPos = pos;
+    while((pos < lineSize) && isLogLineSpace(pLine[pos])) {
+        ++pos;
+    }
+
+    return pos - startPos;
+}
+
+static bool skipLogLineDigits(const char * pLine, const int lineSize, int & pos, const int numDigits)
+{
+    for(int i = 0; i < numDigits; ++i, ++pos)
+    {
+        if ((pos >= lineSize) || !isLogLineDigit(pLine[pos])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool skipLogLineChar(const char * pLine, const int lineSize, int & pos, const char c)
+{
+    if ((pos >= lineSize) || (pLine[pos] != c)) {
+        return false;
+    }
+
+    ++pos;
+    return true;
+}
+
+static bool parseLogLevel(const char * pLogLevel, const int size, LogLevel::type & logLevel)
+{
+    if ((size == 5) && (std::memcmp(pLogLevel, "Trace", 5) == 0)) {
+        logLevel = LogLevel::TraceLevel;
+    }
+    else if ((size == 5) && (std::memcmp(pLogLevel, "Debug", 5) == 0)) {
+        logLevel = LogLevel::DebugLevel;
+    }
+    else if ((size == 4) && (std::memcmp(pLogLevel, "Info", 4) == 0)) {
+        logLevel = LogLevel::InfoLevel;
+    }
+    else if ((size == 4) && (std::memcmp(pLogLevel, "Warn", 4) == 0)) {
+        logLevel = LogLevel::WarnLevel;
+    }
+    else if ((size == 5) && (std::memcmp(pLogLevel, "Error", 5) == 0)) {
+        logLevel = LogLevel::ErrorLevel;
+    }
+    else {
+        return false;
+    }
+
+    return true;
+}
+
+// Parses the part of the log line following the '@' character: " <line number> [<log level>]: <message>"
+static bool parseLogLineTail(const char * pLine, const int lineSize, int pos, LogLineParser::Fields & fields)
+{
+    if (skipLogLineSpaces(pLine, lineSize, pos) == 0) {
+        return false;
+    }
+
+    int lineNumberOffset = pos;
+    qint64 lineNumber = 0;
+    while((pos < lineSize) && isLogLineDigit(pLine[pos])) {
+        lineNumber = lineNumber * 10 + (pLine[pos] - '0');
+        ++pos;
+    }
+
+    int lineNumberSize = pos - lineNumberOffset;
+    if ((lineNumberSize == 0) || (lineNumberSize > 18)) {
+        return false;
+    }
+
+    if (skipLogLineSpaces(pLine, lineSize, pos) == 0) {
+        return false;
+    }
+
+    if (!skipLogLineChar(pLine, lineSize, pos, '[')) {
+        return false;
+    }
+
+    int logLevelOffset = pos;
+    while((pos < lineSize) && isLogLineWordChar(pLine[pos])) {
+        ++pos;
+    }
+
+    LogLevel::type logLevel = LogLevel::InfoLevel;
+    if (!parseLogLevel(pLine + logLevelOffset, pos - logLevelOffset, logLevel)) {
+        return false;
+    }
+
+    if (!skipLogLineChar(pLine, lineSize, pos, ']') || !skipLogLineChar(pLine, lineSize, pos, ':')) {
+        return false;
+    }
+
+    // Exactly one whitespace character separates the log level from the non-empty message
+    if ((pos >= lineSize) || !isLogLineSpace(pLine[pos])) {
+        return false;
+    }
+
+    ++pos;
+    if (pos >= lineSize) {
+        return false;
+    }
+
+    fields.m_sourceFileLineNumber = lineNumber;
+    fields.m_logLevel = logLevel;
+    fields.m_messageOffset = pos;
+    fields.m_messageSize = lineSize - pos;
+    return true;
+}
+
+bool LogLineParser::parse(const char * pLine, const int lineSize, Fields & fields)
+{
+    int pos = 0;
+
+    // Timestamp: yyyy-MM-dd hh:mm:ss.zzz
+    if (!skipLogLineDigits(pLine, lineSize, pos, 4) || !skipLogLineChar(pLine, lineSize, pos, '-') ||
+        !skipLogLineDigits(pLine, lineSize, pos, 2) || !skipLogLineChar(pLine, lineSize, pos, '-') ||
+        !skipLogLineDigits(pLine, lineSize, pos, 2))
+    {
+        return false;
+    }
+
+    if (skipLogLineSpaces(pLine, lineSize, pos) == 0) {
+        return false;
+    }
+
+    if (!skipLogLineDigits(pLine, lineSize, pos, 2) || !skipLogLineChar(pLine, lineSize, pos, ':') ||
+        !skipLogLineDigits(pLine, lineSize, pos, 2) || !skipLogLineChar(pLine, lineSize, pos, ':') ||
+        !skipLogLineDigits(pLine, lineSize, pos, 2))
+    {
+        return false;
+    }
+
+    // Any character separates the milliseconds
+    if (pos >= lineSize) {
+        return false;
+    }
+
+    ++pos;
+    if (!skipLogLineDigits(pLine, lineSize, pos, 3)) {
+        return false;
+    }
+
+    fields.m_timestampOffset = 0;
+    fields.m_timestampSize = pos;
+
+    // Timezone
+    if (skipLogLineSpaces(pLine, lineSize, pos) == 0) {
+        return false;
+    }
+
+    int timeZoneOffset = pos;
+    while((pos < lineSize) && isLogLineWordChar(pLine[pos])) {
+        ++pos;
+    }
+
+    if (pos == timeZoneOffset) {
+        return false;
+    }
+
+    fields.m_timeZoneOffset = timeZoneOffset;
+    fields.m_timeZoneSize = pos - timeZoneOffset;
+
+    // Source file name: everything up to the first '@' preceded by whitespace and followed by the valid rest of the line
+    if (skipLogLineSpaces(pLine, lineSize, pos) == 0) {
+        return false;
+    }
+
+    int sourceFileNameOffset = pos;
+    int searchPos = pos;
+    while(searchPos < lineSize)
+    {
+        const void * pAt = std::memchr(pLine + searchPos, '@', static_cast<size_t>(lineSize - searchPos));
+        if (!pAt) {
+            return false;
+        }
+
+        int atPos = static_cast<int>(static_cast<const char*>(pAt) - pLine);
+        searchPos = atPos + 1;
+
+        int sourceFileNameEnd = atPos;
+        while((sourceFileNameEnd > sourceFileNameOffset) && isLogLineSpace(pLine[sourceFileNameEnd - 1])) {
+            --sourceFileNameEnd;
+        }
+
+        if ((sourceFileNameEnd == atPos) || (sourceFileNameEnd == sourceFileNameOffset)) {
+            continue;
+        }
+
+        if (parseLogLineTail(pLine, lineSize, searchPos, fields)) {
+            fields.m_sourceFileNameOffset = sourceFileNameOffset;
+            fields.m_sourceFileNameSize = sourceFileNameEnd - sourceFileNameOffset;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace quentier
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUENTIER_MODELS_LOG_LINE_PARSER_H
+#define QUENTIER_MODELS_LOG_LINE_PARSER_H
+
+#include <quentier/utility/Macros.h>
+#include <quentier/logging/QuentierLogger.h>
+#include <QtGlobal>
+
+namespace quentier {
+
+/**
+ * @brief The LogLineParser class parses the first line of Quentier's log entry having the fixed layout
+ *
+ * <timestamp> <timezone> <source file> @ <line number> [<log level>]: <message>
+ *
+ * within a single pass over the line's UTF-8 bytes; instead of copying the fields the parser
+ * only reports their offsets and sizes within the line, so parsing the line allocates nothing.
+ * Lines which don't have this layout are the continuation lines of multiline log entries.
+ */
+class LogLineParser
+{
+public:
+    struct Fields
+    {
+        Fields() :
+            m_timestampOffset(0),
+            m_timestampSize(0),
+            m_timeZoneOffset(0),
+            m_timeZoneSize(0),
+            m_sourceFileNameOffset(0),
+            m_sourceFileNameSize(0),
+            m_sourceFileLineNumber(-1),
+            m_logLevel(LogLevel::InfoLevel),
+            m_messageOffset(0),
+            m_messageSize(0)
+        {}
+
+        int             m_timestampOffset;
+        int             m_timestampSize;
+        int             m_timeZoneOffset;
+        int             m_timeZoneSize;
+        int             m_sourceFileNameOffset;
+        int             m_sourceFileNameSize;
+        qint64          m_sourceFileLineNumber;
+        LogLevel::type  m_logLevel;
+        int             m_messageOffset;
+        int             m_messageSize;
+    };
+
+    /**
+     * @brief parse - parses the log line
+     *
+     * @param pLine - pointer to the line's bytes, without the trailing line feed
+     * @param lineSize - the number of bytes in the line
+     * @param fields - the offsets and sizes of the parsed fields within the line
+     * @return true if the line starts a log entry, false otherwise
+     */
+    static bool parse(const char * pLine, const int lineSize, Fields & fields);
+};
+
+} // namespace quentier
+
+#endif // QUENTIER_MODELS_LOG_LINE_PARSER_H
@@ -0,0 +1,400 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LogViewerFilterIndex.h"
+#include <QStringList>
+#include <algorithm>
+
+// The initial number of rows the log level bitmaps are allocated for
+#define LOG_VIEWER_FILTER_INDEX_MIN_ROW_CAPACITY (1024)
+
+namespace quentier {
+
+static inline quint64 trigramKey(const QChar & first, const QChar & second, const QChar & third)
+{
+    return (static_cast<quint64>(first.unicode()) << 32) | (static_cast<quint64>(second.unicode()) << 16) |
+           static_cast<quint64>(third.unicode());
+}
+
+LogViewerFilterIndex::LogViewerFilterIndex() :
+    m_numIndexedRows(0),
+    m_textIndexingEnabled(false),
+    m_textIndexedFromRow(0),
+    m_rowsByLogLevel(),
+    m_postingsByTrigram()
+{}
+
+void LogViewerFilterIndex::setTextIndexingEnabled(const bool enabled)
+{
+    if (m_textIndexingEnabled == enabled) {
+        return;
+    }
+
+    m_textIndexingEnabled = enabled;
+
+    if (!enabled) {
+        m_postingsByTrigram.clear();
+        return;
+    }
+
+    // The log levels of the rows before the window stay in the index, these rows are checked by the filter itself
+    int textIndexedFromRow = std::max(m_numIndexedRows - LOG_VIEWER_FILTER_INDEX_MAX_TEXT_INDEXED_ROWS, 0);
+    truncate(textIndexedFromRow);
+    m_textIndexedFromRow = textIndexedFromRow;
+}
+
+void LogViewerFilterIndex::addEntry(const LogLevel::type logLevel, const QString & sourceFileName,
+                                    const QString & logEntry)
+{
+    const int row = m_numIndexedRows;
+    addEntry(logLevel);
+
+    if (!m_textIndexingEnabled) {
+        return;
+    }
+
+    QVector<quint64> trigrams;
+    trigrams.reserve(sourceFileName.size() + logEntry.size());
+    addTrigrams(sourceFileName, trigrams);
+    addTrigrams(logEntry, trigrams);
+
+    std::sort(trigrams.begin(), trigrams.end());
+    auto trigramsEnd = std::unique(trigrams.begin(), trigrams.end());
+
+    for(auto it = trigrams.begin(); it != trigramsEnd; ++it) {
+        m_postingsByTrigram[*it].push_back(row);
+    }
+
+    // NOTE: the window is moved by half of its size at once so that the postings are not walked for every added row
+    if ((m_numIndexedRows - m_textIndexedFromRow) > LOG_VIEWER_FILTER_INDEX_MAX_TEXT_INDEXED_ROWS) {
+        evictPostings(m_numIndexedRows - LOG_VIEWER_FILTER_INDEX_MAX_TEXT_INDEXED_ROWS / 2);
+    }
+}
+
+void LogViewerFilterIndex::addEntry(const LogLevel::type logLevel)
+{
+    const int row = m_numIndexedRows;
+    ensureRowCapacity(row);
+
+    int logLevelIndex = static_cast<int>(logLevel);
+    if ((logLevelIndex >= 0) && (logLevelIndex < LOG_VIEWER_FILTER_INDEX_NUM_LOG_LEVELS)) {
+        m_rowsByLogLevel[logLevelIndex].setBit(row);
+    }
+
+    ++m_numIndexedRows;
+}
+
+void LogViewerFilterIndex::addUnparsedEntry()
+{
+    ensureRowCapacity(m_numIndexedRows);
+    ++m_numIndexedRows;
+}
+
+bool LogViewerFilterIndex::rowHasLogLevel(const int row, const int logLevel) const
+{
+    if ((row < 0) || (row >= m_numIndexedRows) || (logLevel < 0) || (logLevel >= LOG_VIEWER_FILTER_INDEX_NUM_LOG_LEVELS)) {
+        return false;
+    }
+
+    return m_rowsByLogLevel[logLevel].testBit(row);
+}
+
+void LogViewerFilterIndex::truncate(const int numRows)
+{
+    if ((numRows < 0) || (numRows >= m_numIndexedRows)) {
+        return;
+    }
+
+    for(int i = 0; i < LOG_VIEWER_FILTER_INDEX_NUM_LOG_LEVELS; ++i) {
+        m_rowsByLogLevel[i].fill(false, numRows, m_numIndexedRows);
+    }
+
+    // The postings are sorted by row so the truncated rows are at their ends
+    for(auto it = m_postingsByTrigram.begin(); it != m_postingsByTrigram.end(); )
+    {
+        QVector<int> & postings = it.value();
+        while(!postings.isEmpty() && (postings.back() >= numRows)) {
+            postings.pop_back();
+        }
+
+        if (postings.isEmpty()) {
+            it = m_postingsByTrigram.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    m_numIndexedRows = numRows;
+    m_textIndexedFromRow = std::min(m_textIndexedFromRow, numRows);
+}
+
+void LogViewerFilterIndex::clear()
+{
+    m_numIndexedRows = 0;
+    m_textIndexedFromRow = 0;
+
+    for(int i = 0; i < LOG_VIEWER_FILTER_INDEX_NUM_LOG_LEVELS; ++i) {
+        m_rowsByLogLevel[i].clear();
+    }
+
+    m_postingsByTrigram.clear();
+}
+
+void LogViewerFilterIndex::findCandidateRows(const QVector<quint64> & trigrams, const int fromRow,
+                                             QBitArray & candidateRows) const
+{
+    candidateRows.resize(m_numIndexedRows);
+    if ((fromRow < 0) || (fromRow >= m_numIndexedRows)) {
+        return;
+    }
+
+    candidateRows.fill(false, fromRow, m_numIndexedRows);
+
+    if (trigrams.isEmpty()) {
+        candidateRows.fill(true, fromRow, m_numIndexedRows);
+        return;
+    }
+
+    if (Q_UNLIKELY(!m_textIndexingEnabled)) {
+        QNWARNING(QStringLiteral("LogViewerFilterIndex::findCandidateRows: text indexing is disabled, "
+                                 "considering all rows as candidates"));
+        candidateRows.fill(true, fromRow, m_numIndexedRows);
+        return;
+    }
+
+    // The rows which postings were evicted can't be narrowed down
+    const int textIndexedFromRow = std::max(fromRow, m_textIndexedFromRow);
+    if (textIndexedFromRow > fromRow) {
+        candidateRows.fill(true, fromRow, std::min(textIndexedFromRow, m_numIndexedRows));
+    }
+
+    if (textIndexedFromRow >= m_numIndexedRows) {
+        return;
+    }
+
+    // The ranges of postings starting from the specified row; the candidate rows are found by walking
+    // the shortest range and looking up each of its rows within the other ranges
+    QVector<const int*> rangeBegins;
+    QVector<const int*> rangeEnds;
+    rangeBegins.reserve(trigrams.size());
+    rangeEnds.reserve(trigrams.size());
+
+    int shortestRangeIndex = 0;
+    for(int i = 0, numTrigrams = trigrams.size(); i < numTrigrams; ++i)
+    {
+        auto postingsIt = m_postingsByTrigram.constFind(trigrams.at(i));
+        if (postingsIt == m_postingsByTrigram.constEnd()) {
+            return;
+        }
+
+        const QVector<int> & postings = postingsIt.value();
+        const int * pBegin = std::lower_bound(postings.constBegin(), postings.constEnd(), textIndexedFromRow);
+        const int * pEnd = postings.constEnd();
+        if (pBegin == pEnd) {
+            return;
+        }
+
+        rangeBegins.push_back(pBegin);
+        rangeEnds.push_back(pEnd);
+
+        if ((pEnd - pBegin) < (rangeEnds[shortestRangeIndex] - rangeBegins[shortestRangeIndex])) {
+            shortestRangeIndex = i;
+        }
+    }
+
+    const int numRanges = rangeBegins.size();
+    for(const int * pRow = rangeBegins[shortestRangeIndex], * pRowsEnd = rangeEnds[shortestRangeIndex];
+        pRow != pRowsEnd; ++pRow)
+    {
+        const int row = *pRow;
+        bool found = true;
+
+        for(int i = 0; i < numRanges; ++i)
+        {
+            if (i == shortestRangeIndex) {
+                continue;
+            }
+
+            // The rows are walked in the ascending order so the ranges' begins only move forward
+            rangeBegins[i] = std::lower_bound(rangeBegins[i], rangeEnds[i], row);
+            if (rangeBegins[i] == rangeEnds[i]) {
+                return;
+            }
+
+            if (*rangeBegins[i] != row) {
+                found = false;
+                break;
+            }
+        }
+
+        if (found) {
+            candidateRows.setBit(row);
+        }
+    }
+}
+
+QVector<quint64> LogViewerFilterIndex::literalTrigrams(const QRegExp & filter)
+{
+    QVector<quint64> trigrams;
+
+    const QString pattern = filter.pattern();
+    const QRegExp::PatternSyntax syntax = filter.patternSyntax();
+
+    QStringList literals;
+    if (syntax == QRegExp::FixedString)
+    {
+        literals << pattern;
+    }
+    else if ((syntax == QRegExp::Wildcard) || (syntax == QRegExp::WildcardUnix))
+    {
+        QString literal;
+        for(int i = 0, size = pattern.size(); i < size; ++i)
+        {
+            const QChar c = pattern.at(i);
+
+            if ((syntax == QRegExp::WildcardUnix) && (c == QChar::fromLatin1('\\')) && ((i + 1) < size)) {
+                ++i;
+                literal += pattern.at(i);
+                continue;
+            }
+
+            if ((c == QChar::fromLatin1('*')) || (c == QChar::fromLatin1('?'))) {
+                literals << literal;
+                literal.clear();
+                continue;
+            }
+
+            if (c == QChar::fromLatin1('['))
+            {
+                // The character set matches a single character; the closing bracket right after
+                // the opening one (or after the negation) belongs to the set
+                int setStart = i + 1;
+                if ((setStart < size) &&
+                    ((pattern.at(setStart) == QChar::fromLatin1('!')) || (pattern.at(setStart) == QChar::fromLatin1('^'))))
+                {
+                    ++setStart;
+                }
+
+                int setEnd = pattern.indexOf(QChar::fromLatin1(']'), std::min(setStart + 1, size));
+
+                if (setEnd < 0) {
+                    // Can't tell for sure how the unterminated set is treated, won't narrow by trigrams
+                    return QVector<quint64>();
+                }
+
+                literals << literal;
+                literal.clear();
+                i = setEnd;
+                continue;
+            }
+
+            literal += c;
+        }
+
+        literals << literal;
+    }
+    else
+    {
+        // Extracting the literals from the regular expression is not worth the effort for the log viewer's filter
+        return trigrams;
+    }
+
+    const QChar lineFeed = QChar::fromLatin1('\n');
+    for(auto it = literals.constBegin(), end = literals.constEnd(); it != end; ++it)
+    {
+        QString literal = it->toCaseFolded();
+        for(int i = 0, size = literal.size(); (i + 2) < size; ++i)
+        {
+            const QChar first = literal.at(i);
+            const QChar second = literal.at(i + 1);
+            const QChar third = literal.at(i + 2);
+
+            // Trigrams with line feeds are not indexed
+            if ((first == lineFeed) || (second == lineFeed) || (third == lineFeed)) {
+                continue;
+            }
+
+            trigrams.push_back(trigramKey(first, second, third));
+        }
+    }
+
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+
+void LogViewerFilterIndex::ensureRowCapacity(const int row)
+{
+    int capacity = m_rowsByLogLevel[0].size();
+    if (row < capacity) {
+        return;
+    }
+
+    capacity = std::max(capacity, LOG_VIEWER_FILTER_INDEX_MIN_ROW_CAPACITY);
+    while(capacity <= row) {
+        capacity *= 2;
+    }
+
+    for(int i = 0; i < LOG_VIEWER_FILTER_INDEX_NUM_LOG_LEVELS; ++i) {
+        m_rowsByLogLevel[i].resize(capacity);
+    }
+}
+
+void LogViewerFilterIndex::evictPostings(const int textIndexedFromRow)
+{
+    for(auto it = m_postingsByTrigram.begin(); it != m_postingsByTrigram.end(); )
+    {
+        QVector<int> & postings = it.value();
+        auto postingsEnd = std::lower_bound(postings.begin(), postings.end(), textIndexedFromRow);
+        if (postingsEnd == postings.end()) {
+            it = m_postingsByTrigram.erase(it);
+            continue;
+        }
+
+        Q_UNUSED(postings.erase(postings.begin(), postingsEnd))
+        ++it;
+    }
+
+    m_textIndexedFromRow = textIndexedFromRow;
+}
+
+void LogViewerFilterIndex::addTrigrams(const QString & text, QVector<quint64> & trigrams) const
+{
+    if (text.size() < 3) {
+        return;
+    }
+
+    const QString foldedText = text.toCaseFolded();
+    const QChar lineFeed = QChar::fromLatin1('\n');
+    for(int i = 0, size = foldedText.size(); (i + 2) < size; ++i)
+    {
+        const QChar first = foldedText.at(i);
+        const QChar second = foldedText.at(i + 1);
+        const QChar third = foldedText.at(i + 2);
+
+        // The filter's literals can't contain line feeds
+        if ((first == lineFeed) || (second == lineFeed) || (third == lineFeed)) {
+            continue;
+        }
+
+        trigrams.push_back(trigramKey(first, second, third));
+    }
+}
+
+} // namespace quentier
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUENTIER_MODELS_LOG_VIEWER_FILTER_INDEX_H
+#define QUENTIER_MODELS_LOG_VIEWER_FILTER_INDEX_H
+
+#include <quentier/utility/Macros.h>
+#include <quentier/logging/QuentierLogger.h>
+#include <QBitArray>
+#include <QHash>
+#include <QRegExp>
+#include <QString>
+#include <QVector>
+
+// The number of log levels the row bitmaps are kept for
+#define LOG_VIEWER_FILTER_INDEX_NUM_LOG_LEVELS (6)
+
+// The max number of the most recently indexed rows the postings are kept for
+#define LOG_VIEWER_FILTER_INDEX_MAX_TEXT_INDEXED_ROWS (50000)
+
+namespace quentier {
+
+/**
+ * @brief The LogViewerFilterIndex class is the index of the log entries of the current log file
+ * built incrementally by LogViewerFilterModel, row by row in the ascending order, once some filter is set;
+ * the log entries only need to be parsed for their text while the text indexing is enabled
+ *
+ * For each log level the index keeps the bitmap of rows having this log level. If the text indexing
+ * is enabled, the index also keeps the postings of case folded character trigrams: for each trigram
+ * met within the entry's source file name or message, the ascending list of rows containing it.
+ * The rows containing all the trigrams of the literal parts of the content filter are the only
+ * candidates for matching the filter so the filter itself only needs to confirm these rows.
+ *
+ * The postings are only kept for the window of the most recently indexed rows; the postings of older rows
+ * are evicted as the window moves and these rows are all considered candidates, i.e. the filter checks them
+ * one by one.
+ */
+class LogViewerFilterIndex
+{
+public:
+    LogViewerFilterIndex();
+
+    int numIndexedRows() const { return m_numIndexedRows; }
+
+    /**
+     * Text indexing is disabled by default as postings take memory comparable to the size of the log window
+     * they are kept for; disabling it drops the postings while enabling it removes the rows within that window
+     * from the index as these rows need to be indexed anew
+     */
+    bool textIndexingEnabled() const { return m_textIndexingEnabled; }
+    void setTextIndexingEnabled(const bool enabled);
+
+    /**
+     * @brief addEntry - adds the next row to the index
+     */
+    void addEntry(const LogLevel::type logLevel, const QString & sourceFileName, const QString & logEntry);
+
+    /**
+     * @brief addEntry - adds the next row to the index without its text; with text indexing enabled
+     * such a row contains no trigrams
+     */
+    void addEntry(const LogLevel::type logLevel);
+
+    /**
+     * @brief addUnparsedEntry - adds the next row which could not be parsed to the index;
+     * such a row has no log level and no text
+     */
+    void addUnparsedEntry();
+
+    bool rowHasLogLevel(const int row, const int logLevel) const;
+
+    /**
+     * @brief truncate - removes the rows starting from the specified one from the index
+     */
+    void truncate(const int numRows);
+
+    void clear();
+
+    /**
+     * @brief findCandidateRows - sets the bits of rows in range [fromRow, numIndexedRows) containing all the specified
+     * trigrams and clears the bits of the rest of rows in this range; the bit array is resized to numIndexedRows
+     */
+    void findCandidateRows(const QVector<quint64> & trigrams, const int fromRow, QBitArray & candidateRows) const;
+
+    /**
+     * @brief literalTrigrams - collects the trigrams of the literal parts of the filter
+     *
+     * @return the sorted trigrams which must be present within any text matched by the filter;
+     * empty vector means the filter can't be narrowed down by trigrams
+     */
+    static QVector<quint64> literalTrigrams(const QRegExp & filter);
+
+private:
+    void ensureRowCapacity(const int row);
+    void evictPostings(const int textIndexedFromRow);
+    void addTrigrams(const QString & text, QVector<quint64> & trigrams) const;
+
+private:
+    int                             m_numIndexedRows;
+    bool                            m_textIndexingEnabled;
+
+    // The rows before this one have no postings
+    int                             m_textIndexedFromRow;
+
+    QBitArray                       m_rowsByLogLevel[LOG_VIEWER_FILTER_INDEX_NUM_LOG_LEVELS];
+    QHash<quint64, QVector<int> >   m_postingsByTrigram;
+};
+
+} // namespace quentier
+
+#endif // QUENTIER_MODELS_LOG_VIEWER_FILTER_INDEX_H
@@ -25,7 +25,12 @@ namespace quentier {
 LogViewerFilterModel::LogViewerFilterModel(QObject * parent) :
     QSortFilterProxyModel(parent),
     m_filterOutBeforeRow(-1),
-    m_enabledLogLevels()
+    m_enabledLogLevels(),
+    m_contentFilter(),
+    m_contentFilterTrigrams(),
+    m_index(),
+    m_contentFilterCandidateRows(),
+    m_numContentFilterCheckedRows(0)
 {
     for(size_t i = 0; i < sizeof(m_enabledLogLevels); ++i) {
         m_enabledLogLevels[i] = true;
@@ -60,49 +65,215 @@ void LogViewerFilterModel::setLogLevelEnabled(const LogLevel::type logLevel, con
     invalidateFilter();
 }
 
+void LogViewerFilterModel::setContentFilter(const QRegExp & contentFilter)
+{
+    QNDEBUG(QStringLiteral("LogViewerFilterModel::setContentFilter: ") << contentFilter.pattern());
+
+    if ((m_contentFilter == contentFilter) ||
+        (m_contentFilter.isEmpty() && contentFilter.isEmpty()))
+    {
+        QNDEBUG(QStringLiteral("The same content filter is already set"));
+        return;
+    }
+
+    m_contentFilter = contentFilter;
+    m_contentFilterTrigrams = LogViewerFilterIndex::literalTrigrams(m_contentFilter);
+
+    // NOTE: once the content filter narrowed down by the index is set, the log entries' text keeps being indexed
+    // while the content filter is changed since the log entries would need to be parsed again otherwise;
+    // the postings are dropped once the content filter is cleared
+    if (!m_contentFilterTrigrams.isEmpty() && !m_index.textIndexingEnabled()) {
+        m_index.setTextIndexingEnabled(true);
+    }
+    else if (m_contentFilter.isEmpty() && m_index.textIndexingEnabled()) {
+        m_index.setTextIndexingEnabled(false);
+    }
+
+    resetContentFilterCandidateRows();
+    invalidateFilter();
+}
+
+void LogViewerFilterModel::setSourceModel(QAbstractItemModel * pSourceModel)
+{
+    QAbstractItemModel * pPreviousSourceModel = sourceModel();
+    if (pPreviousSourceModel) {
+        QObject::disconnect(pPreviousSourceModel, Q_NULLPTR, this, Q_NULLPTR);
+    }
+
+    m_index.clear();
+    resetContentFilterCandidateRows();
+
+    // NOTE: connecting before the base class does so that the index is updated before the proxy model re-filters
+    // the changed rows
+    if (pSourceModel)
+    {
+        QObject::connect(pSourceModel, QNSIGNAL(QAbstractItemModel,modelAboutToBeReset),
+                         this, QNSLOT(LogViewerFilterModel,onSourceModelAboutToBeReset));
+#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
+        QObject::connect(pSourceModel, QNSIGNAL(QAbstractItemModel,dataChanged,const QModelIndex&,const QModelIndex&),
+                         this, QNSLOT(LogViewerFilterModel,onSourceModelDataChanged,const QModelIndex&,const QModelIndex&));
+#else
+        QObject::connect(pSourceModel, QNSIGNAL(QAbstractItemModel,dataChanged,const QModelIndex&,const QModelIndex&,const QVector<int>&),
+                         this, QNSLOT(LogViewerFilterModel,onSourceModelDataChanged,const QModelIndex&,const QModelIndex&,const QVector<int>&));
+#endif
+    }
+
+    QSortFilterProxyModel::setSourceModel(pSourceModel);
+}
+
 bool LogViewerFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex & sourceParent) const
 {
     if (sourceRow < m_filterOutBeforeRow) {
         return false;
     }
 
+    if (sourceParent.isValid()) {
+        return false;
+    }
+
     const LogViewerModel * pLogViewerModel = qobject_cast<const LogViewerModel*>(sourceModel());
     if (Q_UNLIKELY(!pLogViewerModel)) {
         return false;
     }
 
-    QModelIndex sourceIndex = pLogViewerModel->index(sourceRow, LogViewerModel::Columns::LogLevel, sourceParent);
-    if (!sourceIndex.isValid()) {
+    if ((sourceRow < 0) || (sourceRow >= pLogViewerModel->rowCount())) {
         return false;
     }
 
-    const LogViewerModel::Data * pDataEntry = pLogViewerModel->dataEntry(sourceIndex.row());
-    if (Q_UNLIKELY(!pDataEntry)) {
-        return false;
+    // Nothing is filtered out, the rows are indexed once some filter is set
+    if (m_contentFilter.isEmpty() && allLogLevelsEnabled()) {
+        return true;
     }
 
-    int logLevelInt = pDataEntry->m_logLevel;
-    if (Q_UNLIKELY((logLevelInt < 0) || (logLevelInt >= static_cast<int>(sizeof(m_enabledLogLevels))))) {
+    if (!indexRows(*pLogViewerModel, sourceRow)) {
         return false;
     }
 
-    if (!m_enabledLogLevels[static_cast<size_t>(logLevelInt)]) {
+    bool logLevelEnabled = false;
+    for(int i = 0; i < LOG_VIEWER_FILTER_INDEX_NUM_LOG_LEVELS; ++i)
+    {
+        if (m_enabledLogLevels[i] && m_index.rowHasLogLevel(sourceRow, i)) {
+            logLevelEnabled = true;
+            break;
+        }
+    }
+
+    if (!logLevelEnabled) {
         return false;
     }
 
-    QRegExp regExp = filterRegExp();
+    if (m_contentFilter.isEmpty()) {
+        return true;
+    }
+
+    if (!m_contentFilterTrigrams.isEmpty())
+    {
+        if (sourceRow >= m_numContentFilterCheckedRows) {
+            m_index.findCandidateRows(m_contentFilterTrigrams, m_numContentFilterCheckedRows,
+                                      m_contentFilterCandidateRows);
+            m_numContentFilterCheckedRows = m_index.numIndexedRows();
+        }
+
+        if (!m_contentFilterCandidateRows.testBit(sourceRow)) {
+            return false;
+        }
+    }
+
+    // The candidate row needs to be confirmed by the filter itself
+    const LogViewerModel::Data * pDataEntry = pLogViewerModel->dataEntry(sourceRow);
+    if (Q_UNLIKELY(!pDataEntry)) {
+        return false;
+    }
 
-    const QString & sourceFileName = pDataEntry->m_sourceFileName;
-    if (regExp.indexIn(sourceFileName) >= 0) {
+    if (m_contentFilter.indexIn(pDataEntry->m_sourceFileName) >= 0) {
         return true;
     }
 
-    const QString & logEntry = pDataEntry->m_logEntry;
-    if (regExp.indexIn(logEntry) >= 0) {
+    if (m_contentFilter.indexIn(pDataEntry->m_logEntry) >= 0) {
         return true;
     }
 
     return false;
 }
 
+void LogViewerFilterModel::onSourceModelAboutToBeReset()
+{
+    m_index.clear();
+    resetContentFilterCandidateRows();
+}
+
+void LogViewerFilterModel::onSourceModelDataChanged(const QModelIndex & topLeft, const QModelIndex & bottomRight
+#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
+                                                    )
+#else
+                                                    , const QVector<int> & roles)
+#endif
+{
+    Q_UNUSED(bottomRight)
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+    Q_UNUSED(roles)
+#endif
+
+    if (!topLeft.isValid()) {
+        return;
+    }
+
+    // The changed rows need to be indexed anew; the changes only happen to the last log entries
+    // as more lines of them get written to the log file, so the index is simply truncated
+    int row = topLeft.row();
+    if (row >= m_index.numIndexedRows()) {
+        return;
+    }
+
+    m_index.truncate(row);
+
+    if (m_numContentFilterCheckedRows > row) {
+        m_numContentFilterCheckedRows = row;
+    }
+}
+
+bool LogViewerFilterModel::allLogLevelsEnabled() const
+{
+    for(int i = 0; i < LOG_VIEWER_FILTER_INDEX_NUM_LOG_LEVELS; ++i)
+    {
+        if (!m_enabledLogLevels[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool LogViewerFilterModel::indexRows(const LogViewerModel & logViewerModel, const int lastRow) const
+{
+    while(m_index.numIndexedRows() <= lastRow)
+    {
+        const int row = m_index.numIndexedRows();
+
+        // The log levels come from the log file's index, the log entries only need to be parsed
+        // for the postings which are kept once the content filter narrowed down by them is set
+        LogLevel::type logLevel = logViewerModel.logEntryLevel(row);
+        if (!m_index.textIndexingEnabled()) {
+            m_index.addEntry(logLevel);
+            continue;
+        }
+
+        const LogViewerModel::Data * pDataEntry = logViewerModel.dataEntry(row);
+        if (Q_UNLIKELY(!pDataEntry)) {
+            m_index.addEntry(logLevel);
+            continue;
+        }
+
+        m_index.addEntry(logLevel, pDataEntry->m_sourceFileName, pDataEntry->m_logEntry);
+    }
+
+    return (m_index.numIndexedRows() > lastRow);
+}
+
+void LogViewerFilterModel::resetContentFilterCandidateRows()
+{
+    m_contentFilterCandidateRows.clear();
+    m_numContentFilterCheckedRows = 0;
+}
+
 } // namespace quentier
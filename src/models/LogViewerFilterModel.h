@@ -21,10 +21,16 @@
 
 #include <quentier/utility/Macros.h>
 #include <quentier/logging/QuentierLogger.h>
+#include "LogViewerFilterIndex.h"
 #include <QSortFilterProxyModel>
+#include <QBitArray>
+#include <QRegExp>
+#include <QVector>
 
 namespace quentier {
 
+class LogViewerModel;
+
 class LogViewerFilterModel: public QSortFilterProxyModel
 {
     Q_OBJECT
@@ -37,12 +43,47 @@ public:
     bool logLevelEnabled(const LogLevel::type logLevel) const;
     void setLogLevelEnabled(const LogLevel::type logLevel, const bool enabled);
 
+    const QRegExp & contentFilter() const { return m_contentFilter; }
+
+    /**
+     * @brief setContentFilter - sets the filter the source file name or the message of the accepted log entries
+     * must match; the literal parts of wildcard and fixed string filters are looked up within the index of
+     * log entries so that the filter itself only needs to be run against the candidate rows. NOTE: the filter set
+     * via QSortFilterProxyModel's methods is not used by this model.
+     */
+    void setContentFilter(const QRegExp & contentFilter);
+
 public:
+    virtual void setSourceModel(QAbstractItemModel * pSourceModel) Q_DECL_OVERRIDE;
     virtual bool filterAcceptsRow(int sourceRow, const QModelIndex & sourceParent) const Q_DECL_OVERRIDE;
 
+private Q_SLOTS:
+    void onSourceModelAboutToBeReset();
+    void onSourceModelDataChanged(const QModelIndex & topLeft, const QModelIndex & bottomRight
+#if QT_VERSION < 0x050000
+                                  );
+#else
+                                  , const QVector<int> & roles = QVector<int>());
+#endif
+
 private:
-    int         m_filterOutBeforeRow;
-    bool        m_enabledLogLevels[6];
+    bool allLogLevelsEnabled() const;
+    bool indexRows(const LogViewerModel & logViewerModel, const int lastRow) const;
+    void resetContentFilterCandidateRows();
+
+private:
+    int                             m_filterOutBeforeRow;
+    bool                            m_enabledLogLevels[LOG_VIEWER_FILTER_INDEX_NUM_LOG_LEVELS];
+
+    QRegExp                         m_contentFilter;
+    QVector<quint64>                m_contentFilterTrigrams;
+
+    mutable LogViewerFilterIndex    m_index;
+
+    // Rows [0, m_numContentFilterCheckedRows) were looked up within the index and their bits within
+    // m_contentFilterCandidateRows tell whether they might match the content filter
+    mutable QBitArray               m_contentFilterCandidateRows;
+    mutable int                     m_numContentFilterCheckedRows;
 };
 
 } // namespace quentier
@@ -18,6 +18,7 @@
 
 #include "LogViewerModel.h"
 #include "LogViewerModelFileReaderAsync.h"
+#include "LogLineParser.h"
 #include <quentier/utility/Utility.h>
 #include <quentier/utility/EventLoopWithExitStatus.h>
 #include <QFileInfo>
@@ -33,40 +34,59 @@
 #endif
 
 #include <algorithm>
+#include <cstring>
 
 #define LOG_VIEWER_MODEL_COLUMN_COUNT (5)
-#define LOG_VIEWER_MODEL_PARSED_LINES_BUCKET_SIZE (100)
-#define LOG_VIEWER_MODEL_FETCH_ITEMS_BUCKET_SIZE (100)
 #define LOG_VIEWER_MODEL_LOG_FILE_POLLING_TIMER_MSEC (500)
 #define LOG_VIEWER_MODEL_MAX_LOG_ENTRY_LINE_SIZE (700)
 
+// Max number of parsed log entries kept in memory at once
+#define LOG_VIEWER_MODEL_DATA_CACHE_SIZE (2000)
+
 namespace quentier {
 
 LogViewerModel::LogViewerModel(QObject * parent) :
     QAbstractTableModel(parent),
     m_currentLogFileInfo(),
     m_currentLogFileWatcher(),
-    m_logParsingRegex(QStringLiteral("^(\\d{4}-\\d{2}-\\d{2}\\s+\\d{2}:\\d{2}:\\d{2}.\\d{3})\\s+(\\w+)\\s+(.+)\\s+@\\s+(\\d+)\\s+\\[(\\w+)\\]:\\s(.+$)"),
-                      Qt::CaseInsensitive, QRegExp::RegExp),
     m_currentLogFilePos(-1),
-    m_currentParsedLogFileLines(0),
-    m_currentLogFileLines(),
+    m_logFileEntryOffsets(),
+    m_logFileEntryLevels(),
+    m_currentLogFile(),
     m_currentLogFileSize(0),
     m_currentLogFileSizePollingTimer(),
+    m_logFileReadRequestId(0),
     m_pendingLogFileReadData(false),
+    m_logFileChangedWhileReading(false),
     m_pReadLogFileIOThread(new QThread),
     m_pFileReaderAsync(Q_NULLPTR),
-    m_data(),
+    m_dataCache(LOG_VIEWER_MODEL_DATA_CACHE_SIZE),
     m_pendingCurrentLogFileWipe(false),
     m_wipeCurrentLogFileResultStatus(false),
     m_wipeCurrentLogFileErrorDescription()
 {
+    Q_UNUSED(qRegisterMetaType<QVector<qint64> >("QVector<qint64>"))
+
     QObject::connect(m_pReadLogFileIOThread, QNSIGNAL(QThread,finished),
                      this, QNSLOT(QThread,deleteLater));
     QObject::connect(this, QNSIGNAL(LogViewerModel,destroyed),
                      m_pReadLogFileIOThread, QNSLOT(QThread,quit));
     m_pReadLogFileIOThread->start(QThread::LowestPriority);
 
+    m_pFileReaderAsync = new FileReaderAsync;
+    m_pFileReaderAsync->moveToThread(m_pReadLogFileIOThread);
+    QObject::connect(m_pReadLogFileIOThread, QNSIGNAL(QThread,finished),
+                     m_pFileReaderAsync, QNSLOT(FileReaderAsync,deleteLater));
+    QObject::connect(this, QNSIGNAL(LogViewerModel,startAsyncLogFileReading,qint64,QString,qint64),
+                     m_pFileReaderAsync, QNSLOT(FileReaderAsync,onStartReading,qint64,QString,qint64),
+                     Qt::QueuedConnection);
+    QObject::connect(m_pFileReaderAsync, QNSIGNAL(FileReaderAsync,logEntriesIndexed,qint64,qint64,QVector<qint64>,QByteArray),
+                     this, QNSLOT(LogViewerModel,onLogEntriesIndexed,qint64,qint64,QVector<qint64>,QByteArray),
+                     Qt::QueuedConnection);
+    QObject::connect(m_pFileReaderAsync, QNSIGNAL(FileReaderAsync,finished,qint64,qint64,bool,ErrorString),
+                     this, QNSLOT(LogViewerModel,onFileReadAsyncReady,qint64,qint64,bool,ErrorString),
+                     Qt::QueuedConnection);
+
     QObject::connect(&m_currentLogFileWatcher, QNSIGNAL(FileSystemWatcher,fileChanged,QString),
                      this, QNSLOT(LogViewerModel,onFileChanged,QString));
     QObject::connect(&m_currentLogFileWatcher, QNSIGNAL(FileSystemWatcher,fileRemoved,QString),
@@ -90,7 +110,8 @@ void LogViewerModel::setLogFileName(const QString & logFileName)
 
     beginResetModel();
 
-    m_currentLogFilePos = 0;
+    cancelLogFileReading();
+    resetLogFileIndex();
     m_currentLogFileSize = 0;
     m_currentLogFileSizePollingTimer.stop();
 
@@ -100,14 +121,6 @@ void LogViewerModel::setLogFileName(const QString & logFileName)
     }
 
     m_currentLogFileInfo = newLogFileInfo;
-    m_data.clear();
-    m_currentParsedLogFileLines = 0;
-    m_currentLogFileLines.clear();
-
-    for(size_t i = 0; i < sizeof(m_currentLogFileStartBytes); ++i) {
-        m_currentLogFileStartBytes[i] = 0;
-    }
-    m_currentLogFileStartBytesRead = 0;
 
     QFile currentLogFile(newLogFileInfo.absoluteFilePath());
     if (Q_UNLIKELY(!currentLogFile.exists()))
@@ -131,28 +144,34 @@ void LogViewerModel::setLogFileName(const QString & logFileName)
         return;
     }
 
-    m_currentLogFileStartBytesRead = currentLogFile.read(m_currentLogFileStartBytes, sizeof(m_currentLogFileStartBytes));
     currentLogFile.close();
 
     m_currentLogFileSize = m_currentLogFileInfo.size();
-    m_currentLogFileSizePollingTimer.start(LOG_VIEWER_MODEL_LOG_FILE_POLLING_TIMER_MSEC, this);
+
+    QString filePath = m_currentLogFileInfo.absoluteFilePath();
 
     // NOTE: for unknown reason QFileSystemWatcher from Qt4 fails to add any log file path + also hangs the process;
     // hence, using only the current log file size polling timer as the means to watch the log file's changes with Qt4
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
-    QString filePath = m_currentLogFileInfo.absoluteFilePath();
     if (!m_currentLogFileWatcher.files().contains(filePath)) {
         m_currentLogFileWatcher.addPath(filePath);
     }
 #endif
 
+    // The changes of the watched log file are followed as soon as they are notified of,
+    // polling the file's size is the fallback for the case the file can't be watched
+    if (!m_currentLogFileWatcher.files().contains(filePath)) {
+        QNDEBUG(QStringLiteral("Can't watch the log file for changes, will poll its size instead: ") << filePath);
+        m_currentLogFileSizePollingTimer.start(LOG_VIEWER_MODEL_LOG_FILE_POLLING_TIMER_MSEC, this);
+    }
+
     parseFullDataFromLogFile();
     endResetModel();
 }
 
 bool LogViewerModel::wipeCurrentLogFile(ErrorString & errorDescription)
 {
-    if (!m_pFileReaderAsync) {
+    if (!m_pendingLogFileReadData) {
         return wipeCurrentLogFileImpl(errorDescription);
     }
 
@@ -194,20 +213,13 @@ void LogViewerModel::clear()
 {
     beginResetModel();
 
-    m_currentLogFilePos = 0;
+    cancelLogFileReading();
+    resetLogFileIndex();
     m_currentLogFileSize = 0;
     m_currentLogFileSizePollingTimer.stop();
 
     m_currentLogFileWatcher.removePath(m_currentLogFileInfo.absoluteFilePath());
     m_currentLogFileInfo = QFileInfo();
-    m_data.clear();
-    m_currentParsedLogFileLines = 0;
-    m_currentLogFileLines.clear();
-
-    for(size_t i = 0; i < sizeof(m_currentLogFileStartBytes); ++i) {
-        m_currentLogFileStartBytes[i] = 0;
-    }
-    m_currentLogFileStartBytesRead = 0;
 
     m_pendingCurrentLogFileWipe = false;
     m_wipeCurrentLogFileResultStatus = false;
@@ -218,11 +230,33 @@ void LogViewerModel::clear()
 
 const LogViewerModel::Data * LogViewerModel::dataEntry(const int row) const
 {
-    if (Q_UNLIKELY((row < 0) || (row >= m_data.size()))) {
+    if (Q_UNLIKELY((row < 0) || (row >= m_logFileEntryOffsets.size()))) {
+        return Q_NULLPTR;
+    }
+
+    Data * pEntry = m_dataCache.object(row);
+    if (pEntry) {
+        return pEntry;
+    }
+
+    pEntry = new Data;
+    if (!parseDataEntry(row, *pEntry)) {
+        delete pEntry;
         return Q_NULLPTR;
     }
 
-    return &(m_data.at(row));
+    // NOTE: the cache takes the ownership of the entry
+    Q_UNUSED(m_dataCache.insert(row, pEntry))
+    return pEntry;
+}
+
+LogLevel::type LogViewerModel::logEntryLevel(const int row) const
+{
+    if (Q_UNLIKELY((row < 0) || (row >= m_logFileEntryLevels.size()))) {
+        return LogLevel::InfoLevel;
+    }
+
+    return static_cast<LogLevel::type>(m_logFileEntryLevels.at(row));
 }
 
 QString LogViewerModel::dataEntryToString(const LogViewerModel::Data & dataEntry) const
@@ -274,7 +308,7 @@ QColor LogViewerModel::backgroundColorForLogLevel(const LogLevel::type logLevel)
 int LogViewerModel::rowCount(const QModelIndex & parent) const
 {
     if (!parent.isValid()) {
-        return m_data.size();
+        return m_logFileEntryOffsets.size();
     }
 
     return 0;
@@ -304,12 +338,12 @@ QVariant LogViewerModel::data(const QModelIndex & index, int role) const
         return QVariant();
     }
 
-    int rowIndex = index.row();
-    if ((rowIndex < 0) || (rowIndex >= m_data.size())) {
+    const Data * pDataEntry = dataEntry(index.row());
+    if (!pDataEntry) {
         return QVariant();
     }
 
-    const Data & dataEntry = m_data.at(rowIndex);
+    const Data & dataEntry = *pDataEntry;
 
     switch(columnIndex)
     {
@@ -360,149 +394,134 @@ QVariant LogViewerModel::headerData(int section, Qt::Orientation orientation, in
     }
 }
 
-bool LogViewerModel::canFetchMore(const QModelIndex & parent) const
+void LogViewerModel::onFileChanged(const QString & path)
 {
-    if (parent.isValid()) {
-        return false;
+    if (m_currentLogFileInfo.absoluteFilePath() != path) {
+        // The changed file is not the current log file
+        return;
     }
 
-    return m_currentParsedLogFileLines < m_currentLogFileLines.size();
+    if (m_pendingLogFileReadData) {
+        // Will read the rest of the log file once the current request is done
+        m_logFileChangedWhileReading = true;
+        return;
+    }
+
+    // The file reader checks whether the log file was truncated or replaced (i.e. rotated) before
+    // indexing the data appended to it since the last read
+    parseDataFromLogFileFromCurrentPos();
 }
 
-void LogViewerModel::fetchMore(const QModelIndex & parent)
+void LogViewerModel::onFileRemoved(const QString & path)
 {
-    if (parent.isValid()) {
+    if (m_currentLogFileInfo.absoluteFilePath() != path) {
+        // The changed file is not the current log file
         return;
     }
 
-    parseNextChunkOfLogFileLines();
+    beginResetModel();
+    m_currentLogFileInfo = QFileInfo();
+    m_currentLogFileWatcher.removePath(path);
+    cancelLogFileReading();
+    resetLogFileIndex();
+    m_currentLogFileSize = 0;
+    m_currentLogFileSizePollingTimer.stop();
+    endResetModel();
 }
 
-void LogViewerModel::onFileChanged(const QString & path)
+void LogViewerModel::onLogEntriesIndexed(qint64 requestId, qint64 pos, QVector<qint64> logEntryOffsets,
+                                         QByteArray logEntryLevels)
 {
-    if (m_currentLogFileInfo.absoluteFilePath() != path) {
-        // The changed file is not the current log file
+    if (requestId != m_logFileReadRequestId) {
+        // The index chunk from the outdated request
         return;
     }
 
-    QFile currentLogFile(path);
-    if (!currentLogFile.isOpen() && !currentLogFile.open(QIODevice::ReadOnly))
-    {
-        ErrorString errorDescription(QT_TR_NOOP("Can't open log file for reading"));
-        errorDescription.details() = path;
-        Q_EMIT notifyError(errorDescription);
+    if (m_pendingCurrentLogFileWipe) {
+        // The indexed entries would be wiped out anyway
         return;
     }
 
-    char startBytes[sizeof(m_currentLogFileStartBytes)];
-    qint64 startBytesRead = currentLogFile.read(startBytes, sizeof(startBytes));
+    if (pos <= m_currentLogFilePos) {
+        // No new complete lines were written to the log file
+        return;
+    }
 
-    currentLogFile.close();
+    int numPreviousEntries = m_logFileEntryOffsets.size();
+    bool lastEntryChanged = (numPreviousEntries > 0) &&
+                            (logEntryOffsets.isEmpty() || (logEntryOffsets.front() > m_currentLogFilePos));
+    m_currentLogFilePos = pos;
 
-    bool fileStartBytesChanged = false;
-    if (startBytesRead != m_currentLogFileStartBytesRead)
-    {
-        fileStartBytesChanged = true;
-    }
-    else
+    if (lastEntryChanged)
     {
-        for(qint64 i = 0, size = std::min(startBytesRead, qint64(sizeof(startBytes))); i < size; ++i)
-        {
-            size_t index = static_cast<size_t>(i);
-            if (startBytes[index] != m_currentLogFileStartBytes[index]) {
-                fileStartBytesChanged = true;
-                break;
-            }
-        }
+        // The lines preceding the first new log entry continue the last already indexed entry
+        int lastRow = numPreviousEntries - 1;
+        Q_UNUSED(m_dataCache.remove(lastRow))
+        Q_EMIT dataChanged(index(lastRow, 0), index(lastRow, LOG_VIEWER_MODEL_COLUMN_COUNT - 1));
     }
 
-    if (fileStartBytesChanged)
-    {
-        // The change within the file is not just the addition of new log entry, the file's start bytes changed,
-        // hence should reset the model
-
-        m_currentLogFileStartBytesRead = startBytesRead;
-
-        for(qint64 i = 0, size = sizeof(startBytes); i < size; ++i) {
-            size_t index = static_cast<size_t>(i);
-            m_currentLogFileStartBytes[index] = startBytes[index];
-        }
-
-        beginResetModel();
-        m_currentLogFilePos = 0;
-        m_currentLogFileSize = 0;
-        m_data.clear();
-        m_currentParsedLogFileLines = 0;
-        m_currentLogFileLines.clear();
-        parseFullDataFromLogFile();
-        endResetModel();
-
+    if (logEntryOffsets.isEmpty()) {
         return;
     }
 
-    // New log entries were appended to the log file, need to process them
-    parseDataFromLogFileFromCurrentPos();
+    beginInsertRows(QModelIndex(), numPreviousEntries, numPreviousEntries + logEntryOffsets.size() - 1);
+    m_logFileEntryOffsets += logEntryOffsets;
+    m_logFileEntryLevels += logEntryLevels;
+    endInsertRows();
 }
 
-void LogViewerModel::onFileRemoved(const QString & path)
+void LogViewerModel::onFileReadAsyncReady(qint64 requestId, qint64 pos, bool logFileReplaced,
+                                          ErrorString errorDescription)
 {
-    if (m_currentLogFileInfo.absoluteFilePath() != path) {
-        // The changed file is not the current log file
+    if (requestId != m_logFileReadRequestId) {
+        // The outdated request has finished
         return;
     }
 
-    beginResetModel();
-    m_currentLogFileInfo = QFileInfo();
-    m_currentLogFileWatcher.removePath(path);
-    m_currentLogFileStartBytesRead = 0;
-    for(size_t i = 0; i < sizeof(m_currentLogFileStartBytes); ++i) {
-        m_currentLogFileStartBytes[i] = 0;
-    }
-    m_currentLogFilePos = 0;
-    m_currentLogFileSize = 0;
-    m_currentLogFileSizePollingTimer.stop();
-    m_data.clear();
-    m_currentParsedLogFileLines = 0;
-    m_currentLogFileLines.clear();
-    endResetModel();
-}
+    m_pendingLogFileReadData = false;
 
-void LogViewerModel::onFileReadAsyncReady(qint64 pos, QString readData, ErrorString errorDescription)
-{
-    if (m_pFileReaderAsync)
+    if (m_pendingCurrentLogFileWipe)
     {
-        QObject::disconnect(m_pFileReaderAsync);
-        Q_EMIT deleteFileReaderAsync();
-        m_pFileReaderAsync = Q_NULLPTR;
-
-        if (m_pendingCurrentLogFileWipe)
-        {
-            m_pendingCurrentLogFileWipe = false;
+        m_pendingCurrentLogFileWipe = false;
 
-            m_wipeCurrentLogFileErrorDescription.clear();
-            m_wipeCurrentLogFileResultStatus = wipeCurrentLogFileImpl(m_wipeCurrentLogFileErrorDescription);
-            Q_EMIT wipeCurrentLogFileFinished();
+        m_wipeCurrentLogFileErrorDescription.clear();
+        m_wipeCurrentLogFileResultStatus = wipeCurrentLogFileImpl(m_wipeCurrentLogFileErrorDescription);
+        Q_EMIT wipeCurrentLogFileFinished();
 
-            return;
-        }
+        return;
     }
 
-    m_pendingLogFileReadData = false;
-
     // NOTE: it is necessary to create a new object of QFileInfo type
     // because the existing m_currentLogFileInfo has cached value of
     // current log file size, it doesn't update in live regime
     QFileInfo currentLogFileInfo(m_currentLogFileInfo.absoluteFilePath());
     m_currentLogFileSize = currentLogFileInfo.size();
 
+    if (logFileReplaced)
+    {
+        // The change within the file is not just the addition of new log entries, the file was truncated
+        // or its start bytes changed, hence should reset the model
+        QNDEBUG(QStringLiteral("The current log file was truncated or replaced, indexing it anew"));
+
+        beginResetModel();
+        resetLogFileIndex();
+        parseFullDataFromLogFile();
+        endResetModel();
+
+        return;
+    }
+
     if (!errorDescription.isEmpty()) {
         Q_EMIT notifyError(errorDescription);
         return;
     }
 
-    m_currentLogFilePos = pos;
-    m_currentLogFileLines.append(readData.split(QChar::fromLatin1('\n'), QString::SkipEmptyParts));
-    parseNextChunkOfLogFileLines();
+    QNTRACE(QStringLiteral("Indexed the current log file up to position ") << pos
+            << QStringLiteral(", number of log entries: ") << m_logFileEntryOffsets.size());
+
+    if (m_logFileChangedWhileReading) {
+        parseDataFromLogFileFromCurrentPos();
+    }
 }
 
 void LogViewerModel::parseFullDataFromLogFile()
@@ -513,154 +532,113 @@ void LogViewerModel::parseFullDataFromLogFile()
 
 void LogViewerModel::parseDataFromLogFileFromCurrentPos()
 {
-    if (Q_UNLIKELY(m_pFileReaderAsync)) {
-        QObject::disconnect(m_pFileReaderAsync);
-        m_pFileReaderAsync->deleteLater();
-        m_pFileReaderAsync = Q_NULLPTR;
-    }
-
-    m_pFileReaderAsync = new FileReaderAsync(m_currentLogFileInfo.absoluteFilePath(),
-                                             m_currentLogFilePos);
-    m_pFileReaderAsync->moveToThread(m_pReadLogFileIOThread);
-    QObject::connect(m_pReadLogFileIOThread, QNSIGNAL(QThread,finished),
-                     m_pFileReaderAsync, QNSLOT(FileReaderAsync,deleteLater));
-    QObject::connect(this, QNSIGNAL(LogViewerModel,startAsyncLogFileReading),
-                     m_pFileReaderAsync, QNSLOT(FileReaderAsync,onStartReading),
-                     Qt::QueuedConnection);
-    QObject::connect(m_pFileReaderAsync, QNSIGNAL(FileReaderAsync,finished,qint64,QString,ErrorString),
-                     this, QNSLOT(LogViewerModel,onFileReadAsyncReady,qint64,QString,ErrorString),
-                     Qt::QueuedConnection);
-    QObject::connect(this, QNSIGNAL(LogViewerModel,deleteFileReaderAsync),
-                     m_pFileReaderAsync, QNSLOT(FileReaderAsync,deleteLater));
-
+    ++m_logFileReadRequestId;
     m_pendingLogFileReadData = true;
+    m_logFileChangedWhileReading = false;
 
-    Q_EMIT startAsyncLogFileReading();
+    QNTRACE(QStringLiteral("Requesting to index the current log file from position ") << m_currentLogFilePos
+            << QStringLiteral(", request id = ") << m_logFileReadRequestId);
+
+    Q_EMIT startAsyncLogFileReading(m_logFileReadRequestId, m_currentLogFileInfo.absoluteFilePath(), m_currentLogFilePos);
 }
 
-void LogViewerModel::parseNextChunkOfLogFileLines()
+void LogViewerModel::cancelLogFileReading()
 {
-    QList<LogViewerModel::Data> readLogFileEntries;
-    int lastParsedLogFileLine = 0;
-    bool res = parseNextChunkOfLogFileLines(m_currentParsedLogFileLines, readLogFileEntries, lastParsedLogFileLine);
-    m_currentParsedLogFileLines = lastParsedLogFileLine + 1;
-    if (!res) {
-        return;
-    }
-
-    int numNewRows = readLogFileEntries.size();
-    if (Q_UNLIKELY(numNewRows < 0)) {
-        return;
-    }
-
-    beginInsertRows(QModelIndex(), m_data.size(), m_data.size() + numNewRows);
+    // NOTE: the request being processed by the file reader can't be interrupted but its results would be ignored
+    ++m_logFileReadRequestId;
+    m_pendingLogFileReadData = false;
+    m_logFileChangedWhileReading = false;
+}
 
-    for(int i = 0, numEntries = readLogFileEntries.size(); i < numEntries; ++i) {
-        m_data.append(readLogFileEntries[i]);
+void LogViewerModel::resetLogFileIndex()
+{
+    if (m_currentLogFile.isOpen()) {
+        m_currentLogFile.close();
     }
 
-    endInsertRows();
+    m_currentLogFilePos = 0;
+    m_logFileEntryOffsets.clear();
+    m_logFileEntryLevels.clear();
+    m_dataCache.clear();
 }
 
-bool LogViewerModel::parseNextChunkOfLogFileLines(const int lineNumFrom, QList<Data> & readLogFileEntries,
-                                                  int & lastParsedLogFileLine)
+bool LogViewerModel::parseDataEntry(const int row, Data & entry) const
 {
-    int estimatedLastLine = lineNumFrom + LOG_VIEWER_MODEL_PARSED_LINES_BUCKET_SIZE;
-    readLogFileEntries.reserve(std::max(readLogFileEntries.size(), 0) + LOG_VIEWER_MODEL_PARSED_LINES_BUCKET_SIZE / 10);  // Just a rough guess
+    qint64 entryStartPos = m_logFileEntryOffsets.at(row);
+    qint64 entryEndPos = ((row + 1) < m_logFileEntryOffsets.size()
+                          ? m_logFileEntryOffsets.at(row + 1)
+                          : m_currentLogFilePos);
+    if (Q_UNLIKELY(entryEndPos <= entryStartPos)) {
+        return false;
+    }
 
-    int numFoundMatches = 0;
-    lastParsedLogFileLine = 0;
-    for(int i = lineNumFrom, numLines = m_currentLogFileLines.size(); i < numLines; ++i)
+    if (!m_currentLogFile.isOpen())
     {
-        const QString & line = m_currentLogFileLines.at(i);
-        int currentIndex = m_logParsingRegex.indexIn(line);
-        if (currentIndex < 0)
-        {
-            lastParsedLogFileLine = i;
-
-            if ((numFoundMatches == 0) || readLogFileEntries.empty()) {
-                continue;
-            }
-
-            LogViewerModel::Data & lastEntry = readLogFileEntries.back();
-            appendLogEntryLine(lastEntry, line);
-            continue;
+        m_currentLogFile.setFileName(m_currentLogFileInfo.absoluteFilePath());
+        if (!m_currentLogFile.open(QIODevice::ReadOnly)) {
+            QNWARNING(QStringLiteral("Can't open log file for reading: ") << m_currentLogFileInfo.absoluteFilePath());
+            return false;
         }
+    }
 
-        if (i >= estimatedLastLine) {
-            break;
-        }
+    if (!m_currentLogFile.seek(entryStartPos)) {
+        QNWARNING(QStringLiteral("Failed to seek the log file at position ") << entryStartPos);
+        return false;
+    }
 
-        lastParsedLogFileLine = i;
+    QByteArray entryBytes = m_currentLogFile.read(entryEndPos - entryStartPos);
+    if (Q_UNLIKELY(entryBytes.size() != static_cast<int>(entryEndPos - entryStartPos))) {
+        // The log file was truncated since it was indexed, the model would be reset once the file reader notices that
+        QNDEBUG(QStringLiteral("Failed to read the log entry at position ") << entryStartPos
+                << QStringLiteral(", read ") << entryBytes.size() << QStringLiteral(" bytes"));
+        return false;
+    }
 
-        QStringList capturedTexts = m_logParsingRegex.capturedTexts();
+    const char * pEntryData = entryBytes.constData();
+    const int entrySize = entryBytes.size();
 
-        if (capturedTexts.size() != 7) {
-            ErrorString errorDescription(QT_TR_NOOP("Error parsing the log file's contents: unexpected number of captures by regex"));
-            errorDescription.details() += QString::number(capturedTexts.size());
-            QNWARNING(errorDescription);
-            Q_EMIT notifyError(errorDescription);
-            return false;
-        }
+    const void * pLineFeed = std::memchr(pEntryData, '\n', static_cast<size_t>(entrySize));
+    int firstLineSize = (pLineFeed ? static_cast<int>(static_cast<const char*>(pLineFeed) - pEntryData) : entrySize);
 
-        bool convertedSourceLineNumberToInt = false;
-        int sourceFileLineNumber = capturedTexts[4].toInt(&convertedSourceLineNumberToInt);
-        if (!convertedSourceLineNumberToInt) {
-            ErrorString errorDescription(QT_TR_NOOP("Error parsing the log file's contents: failed to convert the source line number to int"));
-            errorDescription.details() += capturedTexts[3];
-            QNWARNING(errorDescription);
-            Q_EMIT notifyError(errorDescription);
-            return false;
-        }
+    LogLineParser::Fields fields;
+    if (Q_UNLIKELY(!LogLineParser::parse(pEntryData, firstLineSize, fields))) {
+        QNWARNING(QStringLiteral("Failed to parse the log entry's first line: ")
+                  << QString::fromUtf8(pEntryData, firstLineSize));
+        return false;
+    }
 
-        Data entry;
-        entry.m_timestamp = QDateTime::fromString(capturedTexts[1],
+    entry.m_timestamp = QDateTime::fromString(QString::fromLatin1(pEntryData + fields.m_timestampOffset, fields.m_timestampSize),
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
-                                                  QStringLiteral("yyyy-MM-dd HH:mm:ss.zzz")
+                                              QStringLiteral("yyyy-MM-dd HH:mm:ss.zzz")
 #else
-                                                  QStringLiteral("yyyy-MM-dd hh:mm:ss.zzz")
+                                              QStringLiteral("yyyy-MM-dd hh:mm:ss.zzz")
 #endif
-                                                 );
+                                             );
 
 #if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
-        // Trying to add timezone info
-        QTimeZone timezone(capturedTexts[2].toLocal8Bit());
-        if (timezone.isValid()) {
-            entry.m_timestamp.setTimeZone(timezone);
-        }
+    // Trying to add timezone info
+    QTimeZone timezone(QByteArray(pEntryData + fields.m_timeZoneOffset, fields.m_timeZoneSize));
+    if (timezone.isValid()) {
+        entry.m_timestamp.setTimeZone(timezone);
+    }
 #endif
 
-        entry.m_sourceFileName = capturedTexts[3];
-        entry.m_sourceFileLineNumber = sourceFileLineNumber;
+    entry.m_sourceFileName = QString::fromUtf8(pEntryData + fields.m_sourceFileNameOffset, fields.m_sourceFileNameSize);
+    entry.m_sourceFileLineNumber = fields.m_sourceFileLineNumber;
+    entry.m_logLevel = fields.m_logLevel;
+    appendLogEntryLine(entry, QString::fromUtf8(pEntryData + fields.m_messageOffset, fields.m_messageSize));
 
-        const QString & logLevel = capturedTexts[5];
-        if (logLevel == QStringLiteral("Trace")) {
-            entry.m_logLevel = LogLevel::TraceLevel;
-        }
-        else if (logLevel == QStringLiteral("Debug")) {
-            entry.m_logLevel = LogLevel::DebugLevel;
-        }
-        else if (logLevel == QStringLiteral("Info")) {
-            entry.m_logLevel = LogLevel::InfoLevel;
-        }
-        else if (logLevel == QStringLiteral("Warn")) {
-            entry.m_logLevel = LogLevel::WarnLevel;
-        }
-        else if (logLevel == QStringLiteral("Error")) {
-            entry.m_logLevel = LogLevel::ErrorLevel;
-        }
-        else
-        {
-            ErrorString errorDescription(QT_TR_NOOP("Error parsing the log file's contents: failed to parse the log level"));
-            errorDescription.details() += logLevel;
-            QNWARNING(errorDescription);
-            Q_EMIT notifyError(errorDescription);
-            return false;
+    // The rest of the entry's lines continue the message
+    int lineStart = firstLineSize + 1;
+    while(lineStart < entrySize)
+    {
+        pLineFeed = std::memchr(pEntryData + lineStart, '\n', static_cast<size_t>(entrySize - lineStart));
+        int lineEnd = (pLineFeed ? static_cast<int>(static_cast<const char*>(pLineFeed) - pEntryData) : entrySize);
+        if (lineEnd > lineStart) {
+            appendLogEntryLine(entry, QString::fromUtf8(pEntryData + lineStart, lineEnd - lineStart));
         }
 
-        appendLogEntryLine(entry, capturedTexts[6]);
-        readLogFileEntries.push_back(entry);
-        ++numFoundMatches;
+        lineStart = lineEnd + 1;
     }
 
     return true;
@@ -754,6 +732,9 @@ bool LogViewerModel::wipeCurrentLogFileImpl(ErrorString & errorDescription)
 
     beginResetModel();
 
+    // NOTE: resetting the index closes the log file opened for reading the log entries
+    resetLogFileIndex();
+
     QFile currentLogFile(m_currentLogFileInfo.absoluteFilePath());
     bool res = currentLogFile.resize(qint64(0));
     if (Q_UNLIKELY(!res))
@@ -763,21 +744,14 @@ bool LogViewerModel::wipeCurrentLogFileImpl(ErrorString & errorDescription)
         if (!errorString.isEmpty()) {
             errorDescription.details() = errorString;
         }
+
+        // The log file's contents stay in place, need to index them again
+        parseFullDataFromLogFile();
     }
     else
     {
-        m_currentLogFilePos = 0;
         m_currentLogFileSize = 0;
 
-        m_data.clear();
-        m_currentParsedLogFileLines = 0;
-        m_currentLogFileLines.clear();
-
-        for(size_t i = 0; i < sizeof(m_currentLogFileStartBytes); ++i) {
-            m_currentLogFileStartBytes[i] = 0;
-        }
-        m_currentLogFileStartBytesRead = 0;
-
         m_pendingCurrentLogFileWipe = false;
         m_wipeCurrentLogFileResultStatus = false;
         m_wipeCurrentLogFileErrorDescription.clear();
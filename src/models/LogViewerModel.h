@@ -26,9 +26,12 @@
 #include <quentier/types/ErrorString.h>
 #include <QAbstractTableModel>
 #include <QFileInfo>
+#include <QFile>
 #include <QList>
+#include <QVector>
+#include <QByteArray>
+#include <QCache>
 #include <QThread>
-#include <QRegExp>
 #include <QBasicTimer>
 
 namespace quentier {
@@ -88,8 +91,29 @@ public:
         int             m_logEntryMaxNumCharsPerLine;
     };
 
+    /**
+     * @brief dataEntry - returns the parsed log entry corresponding to the given row
+     *
+     * Log entries are parsed on demand from the current log file and only a limited number
+     * of recently accessed entries is kept in memory. The returned pointer is only valid
+     * until the next call to dataEntry.
+     *
+     * @param row - the row of the log entry within the model
+     * @return pointer to the parsed log entry or null pointer if the row is invalid
+     * or the entry could not be parsed
+     */
     const Data * dataEntry(const int row) const;
 
+    /**
+     * @brief logEntryLevel - returns the log level of the log entry corresponding to the given row;
+     * unlike the rest of the entry's data, the log level is found while indexing the log file
+     * so it is returned without parsing the entry
+     *
+     * @param row - the row of the log entry within the model
+     * @return the log level of the log entry or LogLevel::InfoLevel if the row is invalid
+     */
+    LogLevel::type logEntryLevel(const int row) const;
+
     QString dataEntryToString(const Data & dataEntry) const;
 
     QColor backgroundColorForLogLevel(const LogLevel::type logLevel) const;
@@ -98,8 +122,7 @@ Q_SIGNALS:
     void notifyError(ErrorString errorDescription);
 
     // private signals
-    void startAsyncLogFileReading();
-    void deleteFileReaderAsync();
+    void startAsyncLogFileReading(qint64 requestId, QString logFilePath, qint64 startPos);
     void wipeCurrentLogFileFinished();
 
 public:
@@ -108,21 +131,22 @@ public:
     virtual int columnCount(const QModelIndex & parent = QModelIndex()) const Q_DECL_OVERRIDE;
     virtual QVariant data(const QModelIndex & index, int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
     virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
-    virtual bool canFetchMore(const QModelIndex & parent) const Q_DECL_OVERRIDE;
-    virtual void fetchMore(const QModelIndex & parent) Q_DECL_OVERRIDE;
 
 private Q_SLOTS:
     void onFileChanged(const QString & path);
     void onFileRemoved(const QString & path);
 
-    void onFileReadAsyncReady(qint64 logFilePos, QString readData, ErrorString errorDescription);
+    void onLogEntriesIndexed(qint64 requestId, qint64 logFilePos, QVector<qint64> logEntryOffsets,
+                             QByteArray logEntryLevels);
+    void onFileReadAsyncReady(qint64 requestId, qint64 logFilePos, bool logFileReplaced, ErrorString errorDescription);
 
 private:
     void parseFullDataFromLogFile();
     void parseDataFromLogFileFromCurrentPos();
-    void parseNextChunkOfLogFileLines();
-    bool parseNextChunkOfLogFileLines(const int lineNumFrom, QList<Data> & readLogFileEntries,
-                                      int & lastParsedLogFileLine);
+
+    void resetLogFileIndex();
+    void cancelLogFileReading();
+    bool parseDataEntry(const int row, Data & entry) const;
 
 private:
     virtual void timerEvent(QTimerEvent * pEvent) Q_DECL_OVERRIDE;
@@ -141,25 +165,33 @@ private:
     QFileInfo           m_currentLogFileInfo;
     FileSystemWatcher   m_currentLogFileWatcher;
 
-    QRegExp             m_logParsingRegex;
+    qint64              m_currentLogFilePos;
 
-    char                m_currentLogFileStartBytes[256];
-    qint64              m_currentLogFileStartBytesRead;
+    // Offsets of the log entries' first lines within the current log file;
+    // each entry spans up to the next entry's offset or up to m_currentLogFilePos
+    QVector<qint64>     m_logFileEntryOffsets;
 
-    qint64              m_currentLogFilePos;
+    // Log levels of the log entries, one byte holding LogLevel::type per entry
+    QByteArray          m_logFileEntryLevels;
 
-    int                 m_currentParsedLogFileLines;
-    QStringList         m_currentLogFileLines;
+    // NOTE: the log entries are read from the file on demand rather than mapped into memory:
+    // the log file is written and might be truncated while being viewed
+    mutable QFile       m_currentLogFile;
 
+    // The log file's size is only polled if the file can't be watched for changes
     qint64              m_currentLogFileSize;
     QBasicTimer         m_currentLogFileSizePollingTimer;
 
+    // The single file reader living in the IO thread handles the requests one by one;
+    // the results of requests other than the last one are outdated and ignored
+    qint64              m_logFileReadRequestId;
     bool                m_pendingLogFileReadData;
+    bool                m_logFileChangedWhileReading;
 
     QThread *           m_pReadLogFileIOThread;
     FileReaderAsync *   m_pFileReaderAsync;
 
-    QList<Data>         m_data;
+    mutable QCache<int, Data>   m_dataCache;
 
     bool                m_pendingCurrentLogFileWipe;
     bool                m_wipeCurrentLogFileResultStatus;
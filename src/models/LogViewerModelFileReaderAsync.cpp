@@ -17,73 +17,257 @@
  */
 
 #include "LogViewerModelFileReaderAsync.h"
+#include "LogLineParser.h"
+#include <QFile>
 #include <QFileInfo>
+#include <QThread>
+#include <QThreadPool>
+#include <QList>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+// Size of the log file's chunk indexed by a single thread pool's task
+#define LOG_VIEWER_MODEL_INDEXING_CHUNK_SIZE (4 * 1024 * 1024)
+
+// Size of the log file's piece read past the chunk's end to get the line crossing it
+#define LOG_VIEWER_MODEL_INDEXING_CHUNK_OVERHANG_SIZE (64 * 1024)
+
+// Number of the log file's start bytes compared with the previously read ones to detect the file's replacement
+#define LOG_VIEWER_MODEL_LOG_FILE_START_BYTES_SIZE (256)
 
 namespace quentier {
 
-LogViewerModel::FileReaderAsync::FileReaderAsync(QString targetFilePath,
-                                                 qint64 startPos, QObject * parent) :
+LogViewerModel::FileReaderAsync::FileReaderAsync(QObject * parent) :
     QObject(parent),
-    m_targetFile(targetFilePath),
-    m_startPos(startPos)
+    m_targetFilePath(),
+    m_targetFileStartBytes()
 {}
 
 LogViewerModel::FileReaderAsync::~FileReaderAsync()
-{
-    if (m_targetFile.isOpen()) {
-        m_targetFile.close();
-    }
-}
+{}
 
-void LogViewerModel::FileReaderAsync::onStartReading()
+void LogViewerModel::FileReaderAsync::onStartReading(qint64 requestId, QString targetFilePath, qint64 startPos)
 {
-    if (!m_targetFile.isOpen() && !m_targetFile.open(QIODevice::ReadOnly)) {
-        QFileInfo targetFileInfo(m_targetFile);
+    QFileInfo targetFileInfo(targetFilePath);
+    if (!targetFileInfo.isFile() || !targetFileInfo.isReadable()) {
         ErrorString errorDescription(QT_TR_NOOP("Can't open log file for reading"));
         errorDescription.details() = targetFileInfo.absoluteFilePath();
         QNWARNING(errorDescription);
-        Q_EMIT finished(-1, QString(), errorDescription);
+        Q_EMIT finished(requestId, -1, false, errorDescription);
         return;
     }
 
-    if (!m_targetFile.seek(m_startPos)) {
-        ErrorString errorDescription(QT_TR_NOOP("Failed to read the data from log file: failed to seek at position"));
-        errorDescription.details() = QString::number(m_startPos);
-        QNWARNING(errorDescription);
-        Q_EMIT finished(-1, QString(), errorDescription);
+    const qint64 fileSize = targetFileInfo.size();
+
+    if (checkLogFileReplaced(targetFilePath, startPos, fileSize)) {
+        QNDEBUG(QStringLiteral("The log file was truncated or replaced since the previous read: ") << targetFilePath);
+        Q_EMIT finished(requestId, -1, true, ErrorString());
         return;
     }
 
-    const qint64 bufSize = 1024;
-    char buf[bufSize];
-    QByteArray readData;
+    QThreadPool * pThreadPool = QThreadPool::globalInstance();
+
+    // Limit the number of chunks indexed ahead of the merged ones so that the memory taken by
+    // the not yet merged results stays bounded regardless of the log file's size
+    const int maxPendingChunks = std::max(QThread::idealThreadCount(), 1) * 2;
+
+    QList<LogFileChunkIndexer*> pendingChunkIndexers;
+    qint64 nextChunkStartPos = startPos;
+    qint64 currentPos = startPos;
+    ErrorString errorDescription;
 
-    qint64 currentPos = m_startPos;
     while(true)
     {
-        qint64 bytesRead = m_targetFile.read(buf, bufSize);
-        if (bytesRead == -1)
+        while(errorDescription.isEmpty() && (pendingChunkIndexers.size() < maxPendingChunks) &&
+              (nextChunkStartPos < fileSize))
         {
-            ErrorString errorDescription(QT_TR_NOOP("Failed to read the data from log file"));
-            QString logFileError = m_targetFile.errorString();
-            if (!logFileError.isEmpty()) {
-                errorDescription.details() = logFileError;
+            qint64 chunkEndPos = std::min(nextChunkStartPos + LOG_VIEWER_MODEL_INDEXING_CHUNK_SIZE, fileSize);
+            LogFileChunkIndexer * pIndexer = new LogFileChunkIndexer(targetFilePath, startPos, nextChunkStartPos,
+                                                                     chunkEndPos, fileSize);
+            pendingChunkIndexers << pIndexer;
+            nextChunkStartPos = chunkEndPos;
+
+            // NOTE: if the thread pool is busy, the chunk is indexed within the current thread
+            // which would otherwise wait for it anyway; the same goes for the only chunk to index
+            // which is the common case for the data just appended to the followed log file
+            bool onlyChunk = (pendingChunkIndexers.size() == 1) && (chunkEndPos == fileSize);
+            if (onlyChunk || !pThreadPool->tryStart(pIndexer)) {
+                pIndexer->run();
             }
+        }
 
-            QNWARNING(errorDescription);
-            Q_EMIT finished(-1, QString(), errorDescription);
-            return;
+        if (pendingChunkIndexers.isEmpty()) {
+            break;
         }
-        else if (bytesRead == 0)
+
+        LogFileChunkIndexer * pIndexer = pendingChunkIndexers.takeFirst();
+        pIndexer->waitForDone();
+
+        if (errorDescription.isEmpty())
         {
+            if (!pIndexer->errorDescription().isEmpty()) {
+                errorDescription = pIndexer->errorDescription();
+                QNWARNING(errorDescription);
+            }
+            else if (pIndexer->endPos() > currentPos) {
+                currentPos = pIndexer->endPos();
+                Q_EMIT logEntriesIndexed(requestId, currentPos, pIndexer->logEntryOffsets(),
+                                         pIndexer->logEntryLevels());
+            }
+        }
+
+        delete pIndexer;
+    }
+
+    if (!errorDescription.isEmpty()) {
+        Q_EMIT finished(requestId, -1, false, errorDescription);
+        return;
+    }
+
+    Q_EMIT finished(requestId, currentPos, false, ErrorString());
+}
+
+bool LogViewerModel::FileReaderAsync::checkLogFileReplaced(const QString & targetFilePath, const qint64 startPos,
+                                                           const qint64 fileSize)
+{
+    const bool sameFile = (startPos > 0) && (m_targetFilePath == targetFilePath);
+    if (sameFile && (fileSize < startPos)) {
+        // Truncated, no need to read anything to tell that
+        return true;
+    }
+
+    QByteArray startBytes;
+    QFile file(targetFilePath);
+    if (file.open(QIODevice::ReadOnly)) {
+        startBytes = file.read(LOG_VIEWER_MODEL_LOG_FILE_START_BYTES_SIZE);
+        file.close();
+    }
+
+    // NOTE: while the log file is shorter than the number of compared start bytes, the start bytes
+    // read before are just the prefix of the ones read now
+    bool replaced = sameFile && !startBytes.startsWith(m_targetFileStartBytes);
+
+    m_targetFilePath = targetFilePath;
+    m_targetFileStartBytes = startBytes;
+
+    return replaced;
+}
+
+LogFileChunkIndexer::LogFileChunkIndexer(const QString & filePath, const qint64 indexingStartPos,
+                                         const qint64 chunkStartPos, const qint64 chunkEndPos, const qint64 fileSize) :
+    QRunnable(),
+    m_filePath(filePath),
+    m_indexingStartPos(indexingStartPos),
+    m_chunkStartPos(chunkStartPos),
+    m_chunkEndPos(chunkEndPos),
+    m_fileSize(fileSize),
+    m_logEntryOffsets(),
+    m_logEntryLevels(),
+    m_endPos(-1),
+    m_errorDescription(),
+    m_doneSemaphore()
+{
+    // NOTE: the results are read after the indexer has finished, hence it is not deleted by the thread pool
+    setAutoDelete(false);
+}
+
+void LogFileChunkIndexer::run()
+{
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        m_errorDescription.setBase(QT_TR_NOOP("Can't open log file for reading"));
+        m_errorDescription.details() = m_filePath;
+        m_doneSemaphore.release();
+        return;
+    }
+
+    // The line starting right at the chunk's start belongs to the chunk only if the preceding byte is the line feed
+    const qint64 dataStartPos = ((m_chunkStartPos > m_indexingStartPos) ? (m_chunkStartPos - 1) : m_chunkStartPos);
+    qint64 dataSize = std::min(m_chunkEndPos - dataStartPos + LOG_VIEWER_MODEL_INDEXING_CHUNK_OVERHANG_SIZE,
+                               m_fileSize - dataStartPos);
+
+    // NOTE: the data is read rather than mapped into memory: the log file being written to might get truncated
+    // while the chunk is indexed and accessing the mapped memory past the truncated file's end crashes the process
+    while(true)
+    {
+        QByteArray data;
+        if (file.seek(dataStartPos)) {
+            data = file.read(dataSize);
+        }
+
+        if (Q_UNLIKELY(data.size() != static_cast<int>(dataSize)))
+        {
+            m_errorDescription.setBase(QT_TR_NOOP("Failed to read the data from log file"));
+            QString logFileError = file.errorString();
+            if (!logFileError.isEmpty()) {
+                m_errorDescription.details() = logFileError;
+            }
+
+            break;
+        }
+
+        if (indexData(data.constData(), dataStartPos, dataSize)) {
             break;
         }
 
-        readData.append(buf, static_cast<int>(bytesRead));
-        currentPos = m_targetFile.pos();
+        // The line crossing the chunk's end is longer than the piece read past the chunk's end
+        dataSize = std::min(dataSize * 2, m_fileSize - dataStartPos);
+    }
+
+    m_doneSemaphore.release();
+}
+
+void LogFileChunkIndexer::waitForDone()
+{
+    m_doneSemaphore.acquire();
+}
+
+bool LogFileChunkIndexer::indexData(const char * pData, const qint64 dataStartPos, const qint64 dataSize)
+{
+    m_logEntryOffsets.clear();
+    m_logEntryLevels.clear();
+    m_endPos = -1;
+
+    const bool readUntilFileEnd = ((dataStartPos + dataSize) >= m_fileSize);
+
+    qint64 lineStart = 0;
+    if (dataStartPos < m_chunkStartPos)
+    {
+        const void * pLineFeed = std::memchr(pData, '\n', static_cast<size_t>(dataSize));
+        if (!pLineFeed) {
+            // Either the line started before the chunk continues until the file's end or it is not read in full yet
+            return readUntilFileEnd;
+        }
+
+        lineStart = static_cast<const char*>(pLineFeed) - pData + 1;
+    }
+
+    while((dataStartPos + lineStart) < m_chunkEndPos)
+    {
+        const void * pLineFeed = std::memchr(pData + lineStart, '\n', static_cast<size_t>(dataSize - lineStart));
+        if (!pLineFeed) {
+            // The last line is either not complete yet, will index it once it is, or not read in full
+            return readUntilFileEnd;
+        }
+
+        qint64 lineEnd = static_cast<const char*>(pLineFeed) - pData;
+        qint64 lineSize = lineEnd - lineStart;
+
+        LogLineParser::Fields fields;
+        if ((lineSize > 0) && (lineSize <= std::numeric_limits<int>::max()) &&
+            LogLineParser::parse(pData + lineStart, static_cast<int>(lineSize), fields))
+        {
+            m_logEntryOffsets.push_back(dataStartPos + lineStart);
+            m_logEntryLevels.append(static_cast<char>(fields.m_logLevel));
+        }
+
+        lineStart = lineEnd + 1;
+        m_endPos = dataStartPos + lineStart;
     }
 
-    Q_EMIT finished(currentPos, QString::fromUtf8(readData), ErrorString());
+    return true;
 }
 
 } // namespace quentier
@@ -20,27 +20,101 @@
 #define QUENTIER_MODELS_LOG_VIEWER_MODEL_FILE_READER_ASYNC_H
 
 #include "LogViewerModel.h"
-#include <QFile>
+#include <QByteArray>
+#include <QVector>
+#include <QRunnable>
+#include <QSemaphore>
 
 namespace quentier {
 
+/**
+ * @brief The LogViewerModel::FileReaderAsync class indexes the log file's contents
+ * from the specified start position: the file is split into chunks indexed concurrently
+ * by LogFileChunkIndexer runnables within the thread pool while the reader merges
+ * their results in the file order, passing each chunk's index to LogViewerModel
+ * as soon as all the preceding chunks have been passed. Only the compact index
+ * of the log entries' offsets and log levels is passed to LogViewerModel,
+ * the rest of the entries' contents are parsed by the model on demand.
+ * Only complete lines are indexed: the position reported with the index is the one
+ * right past the last line feed found in the file.
+ *
+ * The single reader serves all the requests of LogViewerModel one after another.
+ * Before indexing the data appended to the log file since the previous request,
+ * the reader checks whether the file was truncated or replaced (i.e. rotated)
+ * by comparing its size and start bytes with the ones seen before; if so,
+ * the request finishes without indexing anything and LogViewerModel needs
+ * to index the file anew from the start.
+ */
 class LogViewerModel::FileReaderAsync : public QObject
 {
     Q_OBJECT
 public:
-    explicit FileReaderAsync(QString targetFilePath, qint64 startPos,
-                             QObject * parent = Q_NULLPTR);
+    explicit FileReaderAsync(QObject * parent = Q_NULLPTR);
     ~FileReaderAsync();
 
 Q_SIGNALS:
-    void finished(qint64 currentPos, QString readData, ErrorString errorDescription);
+    void logEntriesIndexed(qint64 requestId, qint64 currentPos, QVector<qint64> logEntryOffsets,
+                           QByteArray logEntryLevels);
+    void finished(qint64 requestId, qint64 currentPos, bool logFileReplaced, ErrorString errorDescription);
 
 public Q_SLOTS:
-    void onStartReading();
+    void onStartReading(qint64 requestId, QString targetFilePath, qint64 startPos);
+
+private:
+    bool checkLogFileReplaced(const QString & targetFilePath, const qint64 startPos, const qint64 fileSize);
 
 private:
-    QFile       m_targetFile;
-    qint64      m_startPos;
+    // The path and the start bytes of the log file read by the previous request
+    QString     m_targetFilePath;
+    QByteArray  m_targetFileStartBytes;
+};
+
+/**
+ * @brief The LogFileChunkIndexer class collects the offsets of the log entries' first lines
+ * along with the entries' log levels among the lines starting within the chunk of the log file; the line crossing the chunk's end
+ * belongs to the chunk and is read in full. The results can only be accessed after waitForDone returns.
+ */
+class LogFileChunkIndexer: public QRunnable
+{
+public:
+    LogFileChunkIndexer(const QString & filePath, const qint64 indexingStartPos,
+                        const qint64 chunkStartPos, const qint64 chunkEndPos, const qint64 fileSize);
+
+    virtual void run() Q_DECL_OVERRIDE;
+
+    void waitForDone();
+
+    const QVector<qint64> & logEntryOffsets() const { return m_logEntryOffsets; }
+
+    /**
+     * @return the log levels of the log entries, one byte holding LogLevel::type per entry
+     */
+    const QByteArray & logEntryLevels() const { return m_logEntryLevels; }
+
+    /**
+     * @return the position right past the last complete line starting within the chunk
+     * or -1 if there is no such line
+     */
+    qint64 endPos() const { return m_endPos; }
+
+    const ErrorString & errorDescription() const { return m_errorDescription; }
+
+private:
+    bool indexData(const char * pData, const qint64 dataStartPos, const qint64 dataSize);
+
+private:
+    QString             m_filePath;
+    qint64              m_indexingStartPos;
+    qint64              m_chunkStartPos;
+    qint64              m_chunkEndPos;
+    qint64              m_fileSize;
+
+    QVector<qint64>     m_logEntryOffsets;
+    QByteArray          m_logEntryLevels;
+    qint64              m_endPos;
+    ErrorString         m_errorDescription;
+
+    QSemaphore          m_doneSemaphore;
 };
 
 } // namespace quentier
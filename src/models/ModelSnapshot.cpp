@@ -0,0 +1,246 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ModelSnapshot.h"
+#include <quentier/utility/StandardPaths.h>
+#include <quentier/logging/QuentierLogger.h>
+#include <QFileInfo>
+#include <QDir>
+#include <limits>
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+#include <QSaveFile>
+#endif
+
+// The first bytes of every model snapshot file: "QMSS"
+#define MODEL_SNAPSHOT_MAGIC (0x514D5353)
+
+// The version of the snapshot file header; the versions of the items' formats are maintained by the models
+#define MODEL_SNAPSHOT_FORMAT_VERSION (1)
+
+// The version of QDataStream format used for the snapshots: fixed so that Qt4 and Qt5 builds can read each other's snapshots
+#define MODEL_SNAPSHOT_STREAM_VERSION (QDataStream::Qt_4_6)
+
+#define MODEL_SNAPSHOTS_FOLDER_NAME QStringLiteral("modelSnapshots")
+#define MODEL_SNAPSHOT_FILE_EXTENSION QStringLiteral(".snapshot")
+#define MODEL_SNAPSHOT_TEMPORARY_FILE_SUFFIX QStringLiteral(".tmp")
+
+namespace quentier {
+
+QString modelSnapshotFilePath(const Account & account, const QString & modelName)
+{
+    return accountPersistentStoragePath(account) + QStringLiteral("/") + MODEL_SNAPSHOTS_FOLDER_NAME +
+           QStringLiteral("/") + modelName + MODEL_SNAPSHOT_FILE_EXTENSION;
+}
+
+ModelSnapshotWriter::ModelSnapshotWriter(const quint32 itemsVersion) :
+    m_data(),
+    m_stream(&m_data, QIODevice::WriteOnly)
+{
+    m_stream.setVersion(MODEL_SNAPSHOT_STREAM_VERSION);
+    m_stream << static_cast<quint32>(MODEL_SNAPSHOT_MAGIC);
+    m_stream << static_cast<quint32>(MODEL_SNAPSHOT_FORMAT_VERSION);
+    m_stream << itemsVersion;
+}
+
+bool ModelSnapshotWriter::writeToFile(const QString & filePath, ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("ModelSnapshotWriter::writeToFile: ") << filePath << QStringLiteral(", snapshot size = ")
+            << m_data.size());
+
+    if (Q_UNLIKELY(m_stream.status() != QDataStream::Ok)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't write the model snapshot: failed to serialize the model items"));
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    QFileInfo fileInfo(filePath);
+    QDir dir = fileInfo.absoluteDir();
+    if (!dir.exists() && !dir.mkpath(dir.absolutePath())) {
+        errorDescription.setBase(QT_TR_NOOP("Can't write the model snapshot: failed to create the folder for it"));
+        errorDescription.details() = QDir::toNativeSeparators(dir.absolutePath());
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    // NOTE: the snapshot is written into the temporary file first so that the crash or the lack of disk space
+    // in the middle of writing doesn't leave the truncated snapshot in place of the previous complete one
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+    // QSaveFile replaces the previous snapshot with the temporary file atomically on commit
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't write the model snapshot: failed to open the file for writing"));
+        errorDescription.details() = file.errorString();
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    qint64 bytesWritten = file.write(m_data);
+    if (bytesWritten != static_cast<qint64>(m_data.size())) {
+        errorDescription.setBase(QT_TR_NOOP("Can't write the model snapshot: failed to write the data into the file"));
+        errorDescription.details() = file.errorString();
+        QNWARNING(errorDescription);
+        file.cancelWriting();
+        return false;
+    }
+
+    if (!file.commit()) {
+        errorDescription.setBase(QT_TR_NOOP("Can't write the model snapshot: failed to replace the previous snapshot file"));
+        errorDescription.details() = file.errorString();
+        QNWARNING(errorDescription);
+        return false;
+    }
+#else
+    // NOTE: Qt4 has no QSaveFile and QFile::rename doesn't overwrite the existing file, hence the previous snapshot
+    // is removed before the temporary file is renamed; the crash in between leaves no snapshot at all which only
+    // means the model is listed from the local storage from scratch on the next start, never a truncated snapshot
+    QString temporaryFilePath = filePath + MODEL_SNAPSHOT_TEMPORARY_FILE_SUFFIX;
+    QFile temporaryFile(temporaryFilePath);
+    if (!temporaryFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't write the model snapshot: failed to open the file for writing"));
+        errorDescription.details() = temporaryFile.errorString();
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    qint64 bytesWritten = temporaryFile.write(m_data);
+    temporaryFile.close();
+
+    if (bytesWritten != static_cast<qint64>(m_data.size())) {
+        errorDescription.setBase(QT_TR_NOOP("Can't write the model snapshot: failed to write the data into the file"));
+        errorDescription.details() = temporaryFile.errorString();
+        QNWARNING(errorDescription);
+        Q_UNUSED(QFile::remove(temporaryFilePath))
+        return false;
+    }
+
+    if (QFile::exists(filePath) && !QFile::remove(filePath)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't write the model snapshot: failed to remove the previous snapshot file"));
+        errorDescription.details() = QDir::toNativeSeparators(filePath);
+        QNWARNING(errorDescription);
+        Q_UNUSED(QFile::remove(temporaryFilePath))
+        return false;
+    }
+
+    if (!QFile::rename(temporaryFilePath, filePath)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't write the model snapshot: failed to rename the temporary snapshot file"));
+        errorDescription.details() = QDir::toNativeSeparators(temporaryFilePath);
+        QNWARNING(errorDescription);
+        Q_UNUSED(QFile::remove(temporaryFilePath))
+        return false;
+    }
+#endif
+
+    return true;
+}
+
+ModelSnapshotReader::ModelSnapshotReader() :
+    m_file(),
+    m_pMappedData(Q_NULLPTR),
+    m_data(),
+    m_pStream(new QDataStream(QByteArray()))
+{}
+
+ModelSnapshotReader::~ModelSnapshotReader()
+{
+    // The stream reads the mapped memory in place so it needs to go away before the memory is unmapped
+    m_pStream.reset();
+    m_data.clear();
+
+    if (m_pMappedData) {
+        Q_UNUSED(m_file.unmap(m_pMappedData))
+    }
+}
+
+bool ModelSnapshotReader::open(const QString & filePath, const quint32 itemsVersion, ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("ModelSnapshotReader::open: ") << filePath << QStringLiteral(", items version = ")
+            << itemsVersion);
+
+    if (!QFile::exists(filePath)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't read the model snapshot: the snapshot file doesn't exist"));
+        errorDescription.details() = QDir::toNativeSeparators(filePath);
+        QNDEBUG(errorDescription);
+        return false;
+    }
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't read the model snapshot: failed to open the file for reading"));
+        errorDescription.details() = m_file.errorString();
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    qint64 fileSize = m_file.size();
+    if (Q_UNLIKELY(fileSize > static_cast<qint64>(std::numeric_limits<int>::max()))) {
+        errorDescription.setBase(QT_TR_NOOP("Can't read the model snapshot: the snapshot file is too large"));
+        QNWARNING(errorDescription << QStringLiteral(", file size = ") << fileSize);
+        return false;
+    }
+
+    if (fileSize > 0) {
+        m_pMappedData = m_file.map(0, fileSize);
+    }
+
+    if (m_pMappedData) {
+        m_data = QByteArray::fromRawData(reinterpret_cast<const char*>(m_pMappedData), static_cast<int>(fileSize));
+    }
+    else {
+        QNDEBUG(QStringLiteral("Failed to map the model snapshot file into memory, reading it instead"));
+        m_data = m_file.readAll();
+    }
+
+    m_pStream.reset(new QDataStream(m_data));
+    m_pStream->setVersion(MODEL_SNAPSHOT_STREAM_VERSION);
+
+    quint32 magic = 0;
+    quint32 formatVersion = 0;
+    quint32 snapshotItemsVersion = 0;
+    *m_pStream >> magic >> formatVersion >> snapshotItemsVersion;
+
+    if ((m_pStream->status() != QDataStream::Ok) || (magic != MODEL_SNAPSHOT_MAGIC)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't read the model snapshot: the file is not a model snapshot"));
+        errorDescription.details() = QDir::toNativeSeparators(filePath);
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    if ((formatVersion != MODEL_SNAPSHOT_FORMAT_VERSION) || (snapshotItemsVersion != itemsVersion)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't read the model snapshot: the snapshot was written in another format version"));
+        QNDEBUG(errorDescription << QStringLiteral(", format version = ") << formatVersion
+                << QStringLiteral(", items version = ") << snapshotItemsVersion);
+        return false;
+    }
+
+    return true;
+}
+
+bool ModelSnapshotReader::checkStatus(ErrorString & errorDescription) const
+{
+    if (m_pStream->status() == QDataStream::Ok) {
+        return true;
+    }
+
+    errorDescription.setBase(QT_TR_NOOP("Can't read the model snapshot: the snapshot file is corrupted"));
+    errorDescription.details() = QDir::toNativeSeparators(m_file.fileName());
+    QNWARNING(errorDescription);
+    return false;
+}
+
+} // namespace quentier
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUENTIER_MODELS_MODEL_SNAPSHOT_H
+#define QUENTIER_MODELS_MODEL_SNAPSHOT_H
+
+#include <quentier/types/Account.h>
+#include <quentier/types/ErrorString.h>
+#include <quentier/utility/Macros.h>
+#include <QByteArray>
+#include <QDataStream>
+#include <QFile>
+#include <QScopedPointer>
+
+namespace quentier {
+
+/**
+ * @brief modelSnapshotFilePath - returns the path to the file with the snapshot of the named model's items
+ * for the given account; the snapshots are kept next to the account's local storage
+ */
+QString modelSnapshotFilePath(const Account & account, const QString & modelName);
+
+/**
+ * @brief The ModelSnapshotWriter class serializes the items of a model into the versioned binary snapshot file:
+ * the model writes its items into the stream and then the whole snapshot is written into the file at once,
+ * replacing the previous snapshot only after the new one has been written completely
+ */
+class ModelSnapshotWriter
+{
+public:
+    /**
+     * @param itemsVersion - the version of the model's own serialization format of the items; the snapshot
+     * of another items version is rejected by @link ModelSnapshotReader @endlink
+     */
+    explicit ModelSnapshotWriter(const quint32 itemsVersion);
+
+    QDataStream & stream() { return m_stream; }
+
+    bool writeToFile(const QString & filePath, ErrorString & errorDescription);
+
+private:
+    Q_DISABLE_COPY(ModelSnapshotWriter)
+
+private:
+    QByteArray      m_data;
+    QDataStream     m_stream;
+};
+
+/**
+ * @brief The ModelSnapshotReader class provides the stream of the model's items from the snapshot file written by
+ * @link ModelSnapshotWriter @endlink; the file is mapped into memory rather than read, so that
+ * the deserialization of the items is the only work done for restoring them
+ */
+class ModelSnapshotReader
+{
+public:
+    ModelSnapshotReader();
+    ~ModelSnapshotReader();
+
+    /**
+     * @brief open - opens the snapshot file and validates its header
+     * @return false if the file doesn't exist, can't be read or holds the snapshot of another format
+     * or items version
+     */
+    bool open(const QString & filePath, const quint32 itemsVersion, ErrorString & errorDescription);
+
+    QDataStream & stream() { return *m_pStream; }
+
+    /**
+     * @brief checkStatus - checks whether all the data read from the stream so far was read successfully,
+     * i.e. that the snapshot file was not truncated or otherwise corrupted
+     */
+    bool checkStatus(ErrorString & errorDescription) const;
+
+private:
+    Q_DISABLE_COPY(ModelSnapshotReader)
+
+private:
+    QFile                           m_file;
+    uchar *                         m_pMappedData;
+    QByteArray                      m_data;
+    QScopedPointer<QDataStream>     m_pStream;
+};
+
+} // namespace quentier
+
+#endif // QUENTIER_MODELS_MODEL_SNAPSHOT_H
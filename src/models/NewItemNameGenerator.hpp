@@ -48,6 +48,63 @@ QString newItemName(const NameIndexType & nameIndex, int & newItemCounter, QStri
     }
 }
 
+/**
+ * @brief newItemName - the overload of the function above which considers the name taken only if some item
+ * with the same upper case name within the passed in index satisfies the predicate. It allows looking up
+ * the candidate names directly within the ordered name index instead of collecting the names of the subset
+ * of items of interest into a separate set first.
+ */
+template <class NameIndexType, class Predicate>
+QString newItemName(const NameIndexType & nameIndex, int & newItemCounter, QString baseName, const Predicate & predicate)
+{
+    if (newItemCounter != 0) {
+        baseName += QStringLiteral(" (") + QString::number(newItemCounter) + QStringLiteral(")");
+    }
+
+    while(true)
+    {
+        bool nameTaken = false;
+        auto range = nameIndex.equal_range(baseName.toUpper());
+        for(auto it = range.first; it != range.second; ++it)
+        {
+            if (predicate(*it)) {
+                nameTaken = true;
+                break;
+            }
+        }
+
+        if (!nameTaken) {
+            return baseName;
+        }
+
+        if (newItemCounter != 0) {
+            QString numPart = QStringLiteral(" (") + QString::number(newItemCounter) + QStringLiteral(")");
+            baseName.chop(numPart.length());
+        }
+
+        ++newItemCounter;
+        baseName += QStringLiteral(" (") + QString::number(newItemCounter) + QStringLiteral(")");
+    }
+}
+
+/**
+ * @brief The LinkedNotebookGuidMatcher class is the predicate for the overload of newItemName above
+ * selecting the items belonging to the particular linked notebook (or to user's own account if the guid is empty)
+ */
+template <class ItemType>
+class LinkedNotebookGuidMatcher
+{
+public:
+    explicit LinkedNotebookGuidMatcher(const QString & linkedNotebookGuid) :
+        m_linkedNotebookGuid(linkedNotebookGuid)
+    {}
+
+    bool operator()(const ItemType & item) const { return item.linkedNotebookGuid() == m_linkedNotebookGuid; }
+
+private:
+    QString     m_linkedNotebookGuid;
+};
+
 } // namespace quentier
 
 #endif // QUENTIER_MODELS_NEW_ITEM_NAME_GENERATOR_HPP
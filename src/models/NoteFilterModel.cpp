@@ -27,10 +27,17 @@ NoteFilterModel::NoteFilterModel(QObject * parent) :
     m_notebookLocalUids(),
     m_tagNames(),
     m_noteLocalUids(),
+    m_notebookLocalUidsSet(),
+    m_tagNamesSet(),
+    m_noteLocalUidsSet(),
     m_usingNoteLocalUidsFilter(false),
     m_pendingFilterUpdate(false),
     m_modifiedWhilePendingFilterUpdate(false)
-{}
+{
+    // Re-evaluate the filter only for the rows inserted, changed or removed within the source model
+    // instead of requiring the full re-filtering on each note change (that's not the default in Qt4)
+    QSortFilterProxyModel::setDynamicSortFilter(true);
+}
 
 bool NoteFilterModel::hasFilters() const
 {
@@ -41,25 +48,16 @@ void NoteFilterModel::setNotebookLocalUids(const QStringList & notebookLocalUids
 {
     QNDEBUG(QStringLiteral("NoteFilterModel::setNotebookLocalUids: ") << notebookLocalUids.join(QStringLiteral(", ")));
 
-    if (!m_usingNoteLocalUidsFilter && (m_notebookLocalUids.size() == notebookLocalUids.size()))
-    {
-        bool foundDifference = false;
-        for(auto it = m_notebookLocalUids.constBegin(), end = m_notebookLocalUids.constEnd(); it != end; ++it)
-        {
-            if (!notebookLocalUids.contains(*it)) {
-                foundDifference = true;
-                break;
-            }
-        }
-
-        if (!foundDifference) {
-            QNTRACE(QStringLiteral("The same set of notebook local uids is set currently, nothing has changed"));
-            return;
-        }
+    QSet<QString> notebookLocalUidsSet = notebookLocalUids.toSet();
+    if (!m_usingNoteLocalUidsFilter && (m_notebookLocalUidsSet == notebookLocalUidsSet)) {
+        QNTRACE(QStringLiteral("The same set of notebook local uids is set currently, nothing has changed"));
+        return;
     }
 
     m_notebookLocalUids = notebookLocalUids;
+    m_notebookLocalUidsSet = notebookLocalUidsSet;
     m_noteLocalUids.clear();
+    m_noteLocalUidsSet.clear();
     m_usingNoteLocalUidsFilter = false;
 
     if (!m_pendingFilterUpdate) {
@@ -74,25 +72,16 @@ void NoteFilterModel::setTagNames(const QStringList & tagNames)
 {
     QNDEBUG(QStringLiteral("NoteFilterModel::setTagNames: ") << tagNames.join(QStringLiteral(", ")));
 
-    if (!m_usingNoteLocalUidsFilter && (m_tagNames.size() == tagNames.size()))
-    {
-        bool foundDifference = false;
-        for(auto it = m_tagNames.constBegin(), end = m_tagNames.constEnd(); it != end; ++it)
-        {
-            if (!tagNames.contains(*it)) {
-                foundDifference = true;
-                break;
-            }
-        }
-
-        if (!foundDifference) {
-            QNTRACE(QStringLiteral("The same set of tag names is set currently, nothing has changed"));
-            return;
-        }
+    QSet<QString> tagNamesSet = tagNames.toSet();
+    if (!m_usingNoteLocalUidsFilter && (m_tagNamesSet == tagNamesSet)) {
+        QNTRACE(QStringLiteral("The same set of tag names is set currently, nothing has changed"));
+        return;
     }
 
     m_tagNames = tagNames;
+    m_tagNamesSet = tagNamesSet;
     m_noteLocalUids.clear();
+    m_noteLocalUidsSet.clear();
     m_usingNoteLocalUidsFilter = false;
 
     if (!m_pendingFilterUpdate) {
@@ -110,24 +99,14 @@ void NoteFilterModel::setNoteLocalUids(const QStringList & noteLocalUids)
     bool wasUsingNoteLocalUidsFilter = m_usingNoteLocalUidsFilter;
     m_usingNoteLocalUidsFilter = true;
 
-    if (wasUsingNoteLocalUidsFilter && (m_noteLocalUids.size() == noteLocalUids.size()))
-    {
-        bool foundDifference = false;
-        for(auto it = m_noteLocalUids.constBegin(), end = m_noteLocalUids.constEnd(); it != end; ++it)
-        {
-            if (!noteLocalUids.contains(*it)) {
-                foundDifference = true;
-                break;
-            }
-        }
-
-        if (!foundDifference) {
-            QNTRACE(QStringLiteral("The same set of note local uids is set currently, nothing has changed"));
-            return;
-        }
+    QSet<QString> noteLocalUidsSet = noteLocalUids.toSet();
+    if (wasUsingNoteLocalUidsFilter && (m_noteLocalUidsSet == noteLocalUidsSet)) {
+        QNTRACE(QStringLiteral("The same set of note local uids is set currently, nothing has changed"));
+        return;
     }
 
     m_noteLocalUids = noteLocalUids;
+    m_noteLocalUidsSet = noteLocalUidsSet;
 
     if (!m_pendingFilterUpdate) {
         QSortFilterProxyModel::invalidateFilter();
@@ -142,6 +121,7 @@ void NoteFilterModel::clearNoteLocalUids()
     QNDEBUG(QStringLiteral("NoteFilterModel::clearNoteLocalUids"));
 
     m_noteLocalUids.clear();
+    m_noteLocalUidsSet.clear();
     m_usingNoteLocalUidsFilter = false;
 
     if (!m_pendingFilterUpdate) {
@@ -215,31 +195,36 @@ bool NoteFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex & source
         return false;
     }
 
+    return acceptsNoteItem(*pItem, pNoteModel->tagNameTable());
+}
+
+bool NoteFilterModel::acceptsNoteItem(const NoteModelItem & item, const TagNameTable & tagNameTable) const
+{
     // NOTE: filtering by note local uids overrides filtering by notebooks and tags
     if (m_usingNoteLocalUidsFilter) {
-        return m_noteLocalUids.contains(pItem->localUid());
+        return m_noteLocalUidsSet.contains(item.localUid());
     }
 
     // NOTE: filtering by notebooks and tags is cumulative: the row is only accepted if it's accepted by both
     // notebook and tag filters (if both are set)
 
-    if (!m_notebookLocalUids.isEmpty())
+    if (!m_notebookLocalUidsSet.isEmpty())
     {
-        bool filteredIn = m_notebookLocalUids.contains(pItem->notebookLocalUid());
+        bool filteredIn = m_notebookLocalUidsSet.contains(item.notebookLocalUid());
         if (!filteredIn) {
             QNTRACE(QStringLiteral("Note's notebook uid is not one of those to be filtered in: ")
-                    << pItem->notebookLocalUid() << QStringLiteral("; ") << m_notebookLocalUids.join(QStringLiteral(", "))
-                    << QStringLiteral("; item: ") << *pItem);
+                    << item.notebookLocalUid() << QStringLiteral("; ") << m_notebookLocalUids.join(QStringLiteral(", "))
+                    << QStringLiteral("; item: ") << item);
             return false;
         }
     }
 
-    if (!m_tagNames.isEmpty())
+    if (!m_tagNamesSet.isEmpty())
     {
-        const QStringList & itemTagNames = pItem->tagNameList();
-        for(auto it = itemTagNames.constBegin(), end = itemTagNames.constEnd(); it != end; ++it)
+        const QVector<qint32> & itemTagNameIds = item.tagNameIds();
+        for(auto it = itemTagNameIds.constBegin(), end = itemTagNameIds.constEnd(); it != end; ++it)
         {
-            if (m_tagNames.contains(*it)) {
+            if (m_tagNamesSet.contains(tagNameTable.name(*it))) {
                 return true;
             }
         }
@@ -23,9 +23,13 @@
 #include <quentier/types/ErrorString.h>
 #include <quentier/utility/Printable.h>
 #include <QSortFilterProxyModel>
+#include <QSet>
 
 namespace quentier {
 
+QT_FORWARD_DECLARE_CLASS(NoteModelItem)
+QT_FORWARD_DECLARE_CLASS(TagNameTable)
+
 class NoteFilterModel: public QSortFilterProxyModel,
                        public Printable
 {
@@ -45,9 +49,22 @@ public:
     void setNoteLocalUids(const QStringList & noteLocalUids);
     void clearNoteLocalUids();
 
+    /**
+     * @return true if the notes are filtered by the explicitly set note local uids (i.e. the result of
+     * the note search query), false otherwise
+     */
+    bool usingNoteLocalUidsFilter() const { return m_usingNoteLocalUidsFilter; }
+
     void beginUpdateFilter();
     void endUpdateFilter();
 
+    /**
+     * @param item - the note model item to check
+     * @param tagNameTable - the table through which the tag names of the item are resolved
+     * @return true if the note model item is accepted by the current filters, false otherwise
+     */
+    bool acceptsNoteItem(const NoteModelItem & item, const TagNameTable & tagNameTable) const;
+
     virtual QTextStream & print(QTextStream & strm) const Q_DECL_OVERRIDE;
 
 Q_SIGNALS:
@@ -60,6 +77,12 @@ private:
     QStringList m_notebookLocalUids;
     QStringList m_tagNames;
     QStringList m_noteLocalUids;
+
+    // The same filters as above, for the quick lookup within filterAcceptsRow
+    QSet<QString>   m_notebookLocalUidsSet;
+    QSet<QString>   m_tagNamesSet;
+    QSet<QString>   m_noteLocalUidsSet;
+
     bool        m_usingNoteLocalUidsFilter;
     bool        m_pendingFilterUpdate;
     bool        m_modifiedWhilePendingFilterUpdate;
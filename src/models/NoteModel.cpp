@@ -17,12 +17,19 @@
  */
 
 #include "NoteModel.h"
+#include "ModelSnapshot.h"
+#include "SortedItemsHelpers.hpp"
 #include <quentier/logging/QuentierLogger.h>
 #include <quentier/utility/UidGenerator.h>
 #include <quentier/utility/Utility.h>
 #include <quentier/types/Resource.h>
 #include <QDateTime>
+#include <QThreadPool>
+#include <QTimerEvent>
 #include <iterator>
+#include <algorithm>
+#include <functional>
+#include <limits>
 
 // Separate logging macros for the note model - to distinguish the one
 // for deleted notes from the one for non-deleted notes
@@ -58,13 +65,44 @@ inline QString includedNotesStr(const quentier::NoteModel::IncludedNotes::type i
 #define NMFATAL(message) \
     QNFATAL(includedNotesStr(m_includedNotes) << message)
 
-// Limit for the queries to the local storage
+// Initial limit for the queries to the local storage, adjusted then within the min/max bounds
+// depending on the measured timings of the queries
 #define NOTE_LIST_LIMIT (100)
+#define MIN_NOTE_LIST_LIMIT (20)
+#define MAX_NOTE_LIST_LIMIT (1000)
+#define NOTE_LIST_TARGET_ROUND_TRIP_MSEC (100)
+#define MAX_NOTE_LIST_REQUESTS_IN_FLIGHT (4)
 
 #define NOTE_PREVIEW_TEXT_SIZE (500)
 
+// The max number of decoded note thumbnails kept in memory
+#define NOTE_THUMBNAIL_CACHE_SIZE (200)
+
+// The max size of decoded note thumbnails, matches the size of thumbnails painted by NoteItemDelegate
+#define NOTE_THUMBNAIL_WIDTH (100)
+#define NOTE_THUMBNAIL_HEIGHT (120)
+
+// The number of notes listed on startup in windowed listing mode
+#define NOTE_MODEL_WINDOW_SIZE (200)
+
+// The max number of rows for which the thumbnails are kept in windowed listing mode
+#define NOTE_MODEL_MAX_MATERIALIZED_ROWS (300)
+
+// The minimal number of items for which the re-sorting is done in the background on the thread pool
+#define NOTE_MODEL_ASYNC_SORT_MIN_NUM_ITEMS (10000)
+
+// The max number of items for which the collation keys of the strings they are sorted by are cached
+#define NOTE_MODEL_COLLATION_KEY_CACHE_SIZE (2000)
+
+// The max time in milliseconds for which the note changes coming from the local storage are accumulated
+// before being applied to the model when the batching of note changes is enabled
+#define NOTE_MODEL_CHANGES_BATCH_DELAY (100)
+
 #define NUM_NOTE_MODEL_COLUMNS (12)
 
+// The version of the format of note items within the model snapshot
+#define NOTE_MODEL_SNAPSHOT_VERSION (2)
+
 #define REPORT_ERROR(error, ...) \
     ErrorString errorDescription(error); \
     NMWARNING(errorDescription << QStringLiteral("" __VA_ARGS__ "")); \
@@ -74,14 +112,15 @@ namespace quentier {
 
 NoteModel::NoteModel(const Account & account, LocalStorageManagerAsync & localStorageManagerAsync,
                      NoteCache & noteCache, NotebookCache & notebookCache, QObject * parent,
-                     const IncludedNotes::type includedNotes) :
+                     const IncludedNotes::type includedNotes, const ListingMode::type listingMode) :
     QAbstractItemModel(parent),
     m_account(account),
     m_includedNotes(includedNotes),
     m_data(),
-    m_listNotesOffset(0),
-    m_listNotesRequestId(),
+    m_listNotesPipeline(NOTE_LIST_LIMIT, MIN_NOTE_LIST_LIMIT, MAX_NOTE_LIST_LIMIT,
+                        NOTE_LIST_TARGET_ROUND_TRIP_MSEC, MAX_NOTE_LIST_REQUESTS_IN_FLIGHT),
     m_noteItemsNotYetInLocalStorageUids(),
+    m_restoredLocalUidsPendingReconciliation(),
     m_cache(noteCache),
     m_notebookCache(notebookCache),
     m_numberOfNotesPerAccount(0),
@@ -92,21 +131,60 @@ NoteModel::NoteModel(const Account & account, LocalStorageManagerAsync & localSt
     m_findNoteToPerformUpdateRequestIds(),
     m_sortedColumn(Columns::ModificationTimestamp),
     m_sortOrder(Qt::AscendingOrder),
+    m_collator(),
+    m_collationKeyCache(m_collator, NOTE_MODEL_COLLATION_KEY_CACHE_SIZE),
+    m_sortThreadPool(),
+    m_pSortTask(Q_NULLPTR),
     m_notebookDataByNotebookLocalUid(),
     m_findNotebookRequestForNotebookLocalUid(),
     m_noteItemsPendingNotebookDataUpdate(),
     m_noteLocalUidToFindNotebookRequestIdForMoveNoteToNotebookBimap(),
     m_tagDataByTagLocalUid(),
+    m_tagNameTable(),
     m_findTagRequestForTagLocalUid(),
     m_tagLocalUidToNoteLocalUid(),
-    m_allNotesListed(false)
-{
+    m_stringPool(),
+    m_allNotesListed(false),
+    m_listingMode(listingMode),
+    m_windowedListingTargetSize(NOTE_MODEL_WINDOW_SIZE),
+    m_viewportNoteLocalUids(),
+    m_noteLocalUidsWithBodies(),
+    m_findNoteBodyRequestIdByNoteLocalUid(),
+    m_sortKeyIndexState(SortKeyIndexState::Inactive),
+    m_sortKeyIndex(),
+    m_sortKeyIndexLocalUids(),
+    m_sortKeyIndexWindowEnd(0),
+    m_findNoteForWindowRequestIdByNoteLocalUid(),
+    m_pThumbnailCache(new NoteThumbnailCache(QSize(NOTE_THUMBNAIL_WIDTH, NOTE_THUMBNAIL_HEIGHT),
+                                             NOTE_THUMBNAIL_CACHE_SIZE, this)),
+    m_noteChangesBatchingEnabled(false),
+    m_noteChangesBatchDepth(0),
+    m_noteChangesBatchTimer(),
+    m_pendingAddedOrUpdatedNotes(),
+    m_pendingRemovedNoteLocalUids(),
+    m_numBatchedNoteChanges(0),
+    m_numCoalescedNoteChanges(0),
+    m_numAppliedNoteChangesBatches(0)
+{
+    QObject::connect(m_pThumbnailCache, QNSIGNAL(NoteThumbnailCache,thumbnailReady,QString),
+                     this, QNSLOT(NoteModel,onThumbnailReady,QString));
+
     createConnections(localStorageManagerAsync);
+
+    m_listNotesPipeline.start();
     requestNotesList();
 }
 
 NoteModel::~NoteModel()
-{}
+{
+    // NOTE: the sort tasks refer to nothing within the model but they should not outlive it
+    if (m_pSortTask) {
+        m_pSortTask->cancel();
+        m_pSortTask = Q_NULLPTR;
+    }
+
+    m_sortThreadPool.waitForDone();
+}
 
 void NoteModel::updateAccount(const Account & account)
 {
@@ -114,6 +192,42 @@ void NoteModel::updateAccount(const Account & account)
     m_account = account;
 }
 
+QHash<QString, QString> NoteModel::notebookLocalUidsByNoteLocalUids() const
+{
+    QHash<QString, QString> notebookLocalUidsByNoteLocalUids;
+    notebookLocalUidsByNoteLocalUids.reserve(static_cast<int>(m_data.size()));
+
+    const NoteDataByIndex & index = m_data.get<ByIndex>();
+    for(auto it = index.begin(), end = index.end(); it != end; ++it)
+    {
+        const NoteModelItem & item = *it;
+        if (Q_UNLIKELY(item.notebookLocalUid().isEmpty())) {
+            NMWARNING(QStringLiteral("Found note model item without notebook local uid: ") << item);
+            continue;
+        }
+
+        notebookLocalUidsByNoteLocalUids[item.localUid()] = item.notebookLocalUid();
+    }
+
+    return notebookLocalUidsByNoteLocalUids;
+}
+
+QHash<QString, QStringList> NoteModel::tagLocalUidsByNoteLocalUids() const
+{
+    QHash<QString, QStringList> tagLocalUidsByNoteLocalUids;
+
+    const NoteDataByIndex & index = m_data.get<ByIndex>();
+    for(auto it = index.begin(), end = index.end(); it != end; ++it)
+    {
+        const NoteModelItem & item = *it;
+        if (!item.tagLocalUids().isEmpty()) {
+            tagLocalUidsByNoteLocalUids[item.localUid()] = item.tagLocalUids();
+        }
+    }
+
+    return tagLocalUidsByNoteLocalUids;
+}
+
 QModelIndex NoteModel::indexForLocalUid(const QString & localUid) const
 {
     const NoteDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
@@ -170,6 +284,11 @@ const NoteModelItem * NoteModel::itemForIndex(const QModelIndex & index) const
     return itemAtRow(index.row());
 }
 
+QImage NoteModel::thumbnail(const NoteModelItem & item) const
+{
+    return m_pThumbnailCache->thumbnail(item.localUid(), item.thumbnailData(), item.thumbnailDataHash());
+}
+
 QModelIndex NoteModel::createNoteItem(const QString & notebookLocalUid)
 {
     if (Q_UNLIKELY((m_includedNotes != IncludedNotes::Deleted) &&
@@ -221,6 +340,167 @@ QModelIndex NoteModel::createNoteItem(const QString & notebookLocalUid)
     return createIndex(row, Columns::Title);
 }
 
+bool NoteModel::saveSnapshot(const QString & filePath, ErrorString & errorDescription) const
+{
+    NMDEBUG(QStringLiteral("NoteModel::saveSnapshot: ") << filePath);
+
+    if (m_listingMode != ListingMode::Full) {
+        errorDescription.setBase(QT_TR_NOOP("Can't save the snapshot of notes: the model doesn't list all notes"));
+        NMDEBUG(errorDescription);
+        return false;
+    }
+
+    if (!m_allNotesListed) {
+        errorDescription.setBase(QT_TR_NOOP("Can't save the snapshot of notes: not all notes have been listed yet"));
+        NMDEBUG(errorDescription);
+        return false;
+    }
+
+    ModelSnapshotWriter writer(NOTE_MODEL_SNAPSHOT_VERSION);
+    QDataStream & out = writer.stream();
+
+    out << static_cast<qint32>(m_includedNotes);
+
+    // The items are written in the order of the model's rows so that on restoring them with the same sorting
+    // they don't need to be moved around
+    const NoteDataByIndex & index = m_data.get<ByIndex>();
+
+    // The tag names are not within the items but in the tag name table, writing the names of the tags
+    // referred to by the items separately
+    QHash<QString, QString> tagNamesByTagLocalUid;
+    for(auto it = index.begin(), end = index.end(); it != end; ++it)
+    {
+        const QStringList & tagLocalUids = it->tagLocalUids();
+        for(auto tagIt = tagLocalUids.constBegin(), tagEnd = tagLocalUids.constEnd(); tagIt != tagEnd; ++tagIt)
+        {
+            const QString & tagName = m_tagNameTable.name(m_tagNameTable.findId(*tagIt));
+            if (!tagName.isEmpty()) {
+                tagNamesByTagLocalUid[*tagIt] = tagName;
+            }
+        }
+    }
+
+    out << static_cast<qint32>(tagNamesByTagLocalUid.size());
+    for(auto it = tagNamesByTagLocalUid.constBegin(), end = tagNamesByTagLocalUid.constEnd(); it != end; ++it) {
+        out << it.key() << it.value();
+    }
+
+    out << static_cast<qint32>(index.size());
+    for(auto it = index.begin(), end = index.end(); it != end; ++it) {
+        out << *it;
+    }
+
+    return writer.writeToFile(filePath, errorDescription);
+}
+
+bool NoteModel::restoreFromSnapshot(const QString & filePath, ErrorString & errorDescription)
+{
+    NMDEBUG(QStringLiteral("NoteModel::restoreFromSnapshot: ") << filePath);
+
+    if (m_listingMode != ListingMode::Full) {
+        errorDescription.setBase(QT_TR_NOOP("Can't restore the snapshot of notes: the model doesn't list all notes"));
+        NMDEBUG(errorDescription);
+        return false;
+    }
+
+    if (m_allNotesListed || !m_data.empty()) {
+        errorDescription.setBase(QT_TR_NOOP("Can't restore the snapshot of notes: the model already has notes"));
+        NMDEBUG(errorDescription);
+        return false;
+    }
+
+    ModelSnapshotReader reader;
+    if (!reader.open(filePath, NOTE_MODEL_SNAPSHOT_VERSION, errorDescription)) {
+        return false;
+    }
+
+    QDataStream & in = reader.stream();
+
+    qint32 includedNotes = 0;
+    in >> includedNotes;
+
+    QHash<QString, QString> tagNamesByTagLocalUid;
+    qint32 numTagNames = 0;
+    in >> numTagNames;
+    for(qint32 i = 0; (i < numTagNames) && (in.status() == QDataStream::Ok); ++i)
+    {
+        QString tagLocalUid;
+        QString tagName;
+        in >> tagLocalUid >> tagName;
+        tagNamesByTagLocalUid[tagLocalUid] = tagName;
+    }
+
+    std::vector<NoteModelItem> items;
+    qint32 numItems = 0;
+    in >> numItems;
+    if (numItems > 0) {
+        items.reserve(static_cast<size_t>(numItems));
+    }
+
+    for(qint32 i = 0; (i < numItems) && (in.status() == QDataStream::Ok); ++i) {
+        NoteModelItem item;
+        in >> item;
+        items.push_back(item);
+    }
+
+    if (!reader.checkStatus(errorDescription)) {
+        return false;
+    }
+
+    if (includedNotes != static_cast<qint32>(m_includedNotes)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't restore the snapshot of notes: the snapshot was saved "
+                                            "for another kind of notes"));
+        NMDEBUG(errorDescription << QStringLiteral(", snapshot's included notes = ") << includedNotes);
+        return false;
+    }
+
+    std::vector<NoteModelItem> restoredItems;
+    restoredItems.reserve(items.size());
+
+    for(auto it = items.begin(), end = items.end(); it != end; ++it)
+    {
+        NoteModelItem & item = *it;
+        if (item.localUid().isEmpty() || !itemMatchesIncludedNotes(item) ||
+            m_restoredLocalUidsPendingReconciliation.contains(item.localUid()))
+        {
+            continue;
+        }
+
+        item.setNotebookLocalUid(m_stringPool.intern(item.notebookLocalUid()));
+        item.setNotebookGuid(m_stringPool.intern(item.notebookGuid()));
+        item.setTagLocalUids(m_stringPool.intern(item.tagLocalUids()));
+        item.setTagGuids(m_stringPool.intern(item.tagGuids()));
+
+        const QStringList & tagLocalUids = item.tagLocalUids();
+        QVector<qint32> tagNameIds;
+        tagNameIds.reserve(tagLocalUids.size());
+
+        for(auto tagIt = tagLocalUids.constBegin(), tagEnd = tagLocalUids.constEnd(); tagIt != tagEnd; ++tagIt)
+        {
+            Q_UNUSED(m_tagLocalUidToNoteLocalUid.insert(*tagIt, item.localUid()))
+
+            // NOTE: the names of the tags already found by the moment take precedence over the restored ones
+            qint32 tagNameId = m_tagNameTable.idForTagLocalUid(*tagIt);
+            if (m_tagNameTable.name(tagNameId).isEmpty()) {
+                Q_UNUSED(m_tagNameTable.setName(tagNameId, tagNamesByTagLocalUid.value(*tagIt)))
+            }
+
+            tagNameIds << tagNameId;
+        }
+
+        item.setTagNameIds(tagNameIds);
+
+        Q_UNUSED(m_restoredLocalUidsPendingReconciliation.insert(item.localUid()))
+        restoredItems.push_back(item);
+    }
+
+    // NOTE: the restored notes don't get into the note cache, only the listed ones do
+    insertNewItems(restoredItems);
+
+    NMDEBUG(QStringLiteral("Restored ") << restoredItems.size() << QStringLiteral(" notes from the snapshot"));
+    return true;
+}
+
 bool NoteModel::deleteNote(const QString & noteLocalUid)
 {
     NMDEBUG(QStringLiteral("NoteModel::deleteNote: ") << noteLocalUid);
@@ -290,6 +570,98 @@ void NoteModel::unfavoriteNote(const QString & noteLocalUid)
     setNoteFavorited(noteLocalUid, false);
 }
 
+void NoteModel::setNoteChangesBatchingEnabled(const bool enabled)
+{
+    NMDEBUG(QStringLiteral("NoteModel::setNoteChangesBatchingEnabled: ")
+            << (enabled ? QStringLiteral("true") : QStringLiteral("false")));
+
+    if (m_noteChangesBatchingEnabled == enabled) {
+        return;
+    }
+
+    m_noteChangesBatchingEnabled = enabled;
+
+    if (!m_noteChangesBatchingEnabled && (m_noteChangesBatchDepth == 0)) {
+        applyPendingNoteChanges();
+    }
+}
+
+void NoteModel::beginNoteChangesBatch()
+{
+    ++m_noteChangesBatchDepth;
+    NMDEBUG(QStringLiteral("NoteModel::beginNoteChangesBatch: depth = ") << m_noteChangesBatchDepth);
+
+    // The changes accumulated so far would be applied along with the rest of the batch
+    m_noteChangesBatchTimer.stop();
+}
+
+void NoteModel::endNoteChangesBatch()
+{
+    NMDEBUG(QStringLiteral("NoteModel::endNoteChangesBatch: depth = ") << m_noteChangesBatchDepth);
+
+    if (Q_UNLIKELY(m_noteChangesBatchDepth <= 0)) {
+        NMWARNING(QStringLiteral("Detected attempt to end the batch of note changes which was not started"));
+        return;
+    }
+
+    --m_noteChangesBatchDepth;
+    if (m_noteChangesBatchDepth == 0) {
+        applyPendingNoteChanges();
+    }
+}
+
+void NoteModel::timerEvent(QTimerEvent * pEvent)
+{
+    if (Q_UNLIKELY(!pEvent)) {
+        return;
+    }
+
+    if (pEvent->timerId() == m_noteChangesBatchTimer.timerId()) {
+        applyPendingNoteChanges();
+        return;
+    }
+
+    QAbstractItemModel::timerEvent(pEvent);
+}
+
+void NoteModel::setViewportRows(const QVector<int> & rows)
+{
+    if (m_listingMode != ListingMode::Windowed) {
+        return;
+    }
+
+    NMTRACE(QStringLiteral("NoteModel::setViewportRows: num rows = ") << rows.size());
+
+    const NoteDataByIndex & index = m_data.get<ByIndex>();
+    int numRows = static_cast<int>(index.size());
+
+    QSet<QString> viewportNoteLocalUids;
+    viewportNoteLocalUids.reserve(std::min(rows.size(), NOTE_MODEL_MAX_MATERIALIZED_ROWS));
+
+    for(auto it = rows.constBegin(), end = rows.constEnd(); it != end; ++it)
+    {
+        int row = *it;
+        if (Q_UNLIKELY((row < 0) || (row >= numRows))) {
+            NMDEBUG(QStringLiteral("Ignoring invalid viewport row: ") << row);
+            continue;
+        }
+
+        if (viewportNoteLocalUids.size() >= NOTE_MODEL_MAX_MATERIALIZED_ROWS) {
+            NMDEBUG(QStringLiteral("Too many viewport rows, ignoring the rest of them"));
+            break;
+        }
+
+        Q_UNUSED(viewportNoteLocalUids.insert(index[static_cast<size_t>(row)].localUid()))
+    }
+
+    if (viewportNoteLocalUids == m_viewportNoteLocalUids) {
+        return;
+    }
+
+    m_viewportNoteLocalUids = viewportNoteLocalUids;
+    updateNoteBodiesForViewport();
+}
+
 Qt::ItemFlags NoteModel::flags(const QModelIndex & modelIndex) const
 {
     Qt::ItemFlags indexFlags = QAbstractItemModel::flags(modelIndex);
@@ -705,13 +1077,53 @@ void NoteModel::sort(int column, Qt::SortOrder order)
 
     NoteDataByIndex & index = m_data.get<ByIndex>();
 
-    if (column == m_sortedColumn)
+    if (m_pSortTask)
+    {
+        if ((column == m_pSortTask->sortedColumn()) && (order == m_pSortTask->sortOrder())) {
+            NMDEBUG(QStringLiteral("The sorting by this column and order is already in progress"));
+            return;
+        }
+
+        // NOTE: the superseded task would give up the sorting soon and its result would be ignored anyway
+        NMDEBUG(QStringLiteral("Dropping the sorting in progress"));
+        m_pSortTask->cancel();
+        m_pSortTask = Q_NULLPTR;
+    }
+
+    if ((column == m_sortedColumn) && (order == m_sortOrder)) {
+        NMDEBUG(QStringLiteral("Neither sorted column nor sort order have changed, nothing to do"));
+        return;
+    }
+
+    if ((m_listingMode == ListingMode::Windowed) && !windowedListingFinished())
     {
-        if (order == m_sortOrder) {
-            NMDEBUG(QStringLiteral("Neither sorted column nor sort order have changed, nothing to do"));
+        if ((column == m_sortedColumn) && (m_sortKeyIndexState == SortKeyIndexState::Building)) {
+            NMDEBUG(QStringLiteral("Only the sort order has changed, the sort key index being built would be sorted "
+                                   "in the new order"));
+            m_sortOrder = order;
             return;
         }
 
+        if ((column == m_sortedColumn) && (m_sortKeyIndexState == SortKeyIndexState::Ready)) {
+            NMDEBUG(QStringLiteral("Only the sort order has changed, reversing the sort key index and finding "
+                                   "the notes of its new window"));
+            m_sortOrder = order;
+            std::reverse(m_sortKeyIndex.begin(), m_sortKeyIndex.end());
+            resetWindowedListing();
+            return;
+        }
+
+        // Only a part of notes is listed, the rows for the new sorting need to be listed from the local storage
+        NMDEBUG(QStringLiteral("Not all notes are listed in windowed mode, re-listing notes for the new sorting"));
+        m_sortedColumn = static_cast<Columns::type>(column);
+        m_sortOrder = order;
+        m_sortKeyIndexState = SortKeyIndexState::Inactive;
+        resetWindowedListing();
+        return;
+    }
+
+    if (column == m_sortedColumn)
+    {
         m_sortOrder = order;
 
         NMDEBUG(QStringLiteral("Only the sort order has changed, reversing the index"));
@@ -720,6 +1132,19 @@ void NoteModel::sort(int column, Qt::SortOrder order)
         index.reverse();
         Q_EMIT layoutChanged();
 
+        std::reverse(m_sortKeyIndex.begin(), m_sortKeyIndex.end());
+        return;
+    }
+
+    // In Windowed mode all the notes are within the model by now, the sort key index for the previous sorting
+    // is of no use anymore
+    m_sortKeyIndexState = SortKeyIndexState::Inactive;
+    m_sortKeyIndex.clear();
+    m_sortKeyIndexLocalUids.clear();
+    m_sortKeyIndexWindowEnd = 0;
+
+    if (m_data.size() >= NOTE_MODEL_ASYNC_SORT_MIN_NUM_ITEMS) {
+        startAsyncSort(static_cast<Columns::type>(column), order);
         return;
     }
 
@@ -729,62 +1154,93 @@ void NoteModel::sort(int column, Qt::SortOrder order)
     Q_EMIT layoutAboutToBeChanged();
 
     QModelIndexList persistentIndices = persistentIndexList();
-    QVector<std::pair<QString, int> > localUidsToUpdateWithColumns;
-    localUidsToUpdateWithColumns.reserve(persistentIndices.size());
+    QVector<std::pair<QString, int> > localUidsToUpdateWithColumns = persistentIndexLocalUids(persistentIndices);
 
-    QStringList localUidsToUpdate;
-    for(auto it = persistentIndices.begin(), end = persistentIndices.end(); it != end; ++it)
-    {
-        const QModelIndex & modelIndex = *it;
-        int column = modelIndex.column();
+    std::vector<boost::reference_wrapper<const NoteModelItem> > items;
+    items.reserve(m_data.size());
 
-        if (!modelIndex.isValid()) {
-            localUidsToUpdateWithColumns << std::pair<QString, int>(QString(), column);
-            continue;
+    if (columnHasCollatedStrings(m_sortedColumn))
+    {
+        // NOTE: just like for the sorting in the background, the collation keys are computed once per item
+        // for the duration of the sorting instead of comparing the strings with the collator on each comparison
+        std::vector<CollationKey> sortKeys;
+        sortKeys.reserve(m_data.size());
+        std::vector<size_t> positions;
+        positions.reserve(m_data.size());
+
+        for(auto it = index.begin(), end = index.end(); it != end; ++it) {
+            positions.push_back(sortKeys.size());
+            sortKeys.push_back(m_collator.sortKey(collatedStringForItem(*it, m_sortedColumn)));
         }
 
-        int row = modelIndex.row();
+        std::sort(positions.begin(), positions.end(), SortKeyPositionComparator(sortKeys, m_sortOrder));
 
-        if ((row < 0) || (row >= static_cast<int>(m_data.size())) ||
-            (column < 0) || (column >= NUM_NOTE_MODEL_COLUMNS))
-        {
-            localUidsToUpdateWithColumns << std::pair<QString, int>(QString(), column);
+        for(auto it = positions.begin(), end = positions.end(); it != end; ++it) {
+            items.push_back(boost::reference_wrapper<const NoteModelItem>(index[*it]));
         }
-
-        auto itemIt = index.begin() + row;
-        const NoteModelItem & item = *itemIt;
-        localUidsToUpdateWithColumns << std::pair<QString, int>(item.localUid(), column);
+    }
+    else
+    {
+        items.assign(index.begin(), index.end());
+        std::sort(items.begin(), items.end(), NoteComparator(m_sortedColumn, m_sortOrder, &m_collator));
     }
 
-    std::vector<boost::reference_wrapper<const NoteModelItem> > items(index.begin(), index.end());
-    std::sort(items.begin(), items.end(), NoteComparator(m_sortedColumn, m_sortOrder));
     index.rearrange(items.begin());
 
-    QModelIndexList replacementIndices;
-    replacementIndices.reserve(std::max(localUidsToUpdateWithColumns.size(), 0));
-    for(auto it = localUidsToUpdateWithColumns.begin(), end = localUidsToUpdateWithColumns.end(); it != end; ++it)
+    updatePersistentIndices(persistentIndices, localUidsToUpdateWithColumns);
+
+    Q_EMIT layoutChanged();
+}
+
+bool NoteModel::canFetchMore(const QModelIndex & parent) const
+{
+    if (parent.isValid()) {
+        return false;
+    }
+
+    if (m_listingMode != ListingMode::Windowed) {
+        return false;
+    }
+
+    switch(m_sortKeyIndexState)
     {
-        const QString & localUid = it->first;
-        const int column = it->second;
+    case SortKeyIndexState::Building:
+        // The first window is found once the sort key index is built
+        return false;
+    case SortKeyIndexState::Ready:
+        return (m_sortKeyIndexWindowEnd < m_sortKeyIndex.size());
+    default:
+        return !m_listNotesPipeline.isFinished();
+    }
+}
 
-        if (localUid.isEmpty()) {
-            replacementIndices << QModelIndex();
-            continue;
-        }
+void NoteModel::fetchMore(const QModelIndex & parent)
+{
+    if (parent.isValid() || !canFetchMore(parent)) {
+        return;
+    }
 
-        QModelIndex newIndex = indexForLocalUid(localUid);
-        if (!newIndex.isValid()) {
-            replacementIndices << QModelIndex();
-            continue;
-        }
+    if (m_sortKeyIndexState == SortKeyIndexState::Ready) {
+        NMDEBUG(QStringLiteral("NoteModel::fetchMore: sort key index window end = ") << m_sortKeyIndexWindowEnd);
+        requestSortKeyIndexWindow(m_sortKeyIndexWindowEnd + NOTE_LIST_LIMIT);
+        return;
+    }
 
-        QModelIndex newIndexWithColumn = createIndex(newIndex.row(), column);
-        replacementIndices << newIndexWithColumn;
+    if (m_listNotesPipeline.numRequestsInFlight() != 0) {
+        NMTRACE(QStringLiteral("NoteModel::fetchMore: the requests to list notes are already in progress"));
+        return;
     }
 
-    changePersistentIndexList(persistentIndices, replacementIndices);
+    size_t offset = m_listNotesPipeline.appliedOffset();
+    NMDEBUG(QStringLiteral("NoteModel::fetchMore: offset = ") << offset);
 
-    Q_EMIT layoutChanged();
+    // The listing might have been stopped by the failure of the previous request, resume it then
+    if (!m_listNotesPipeline.isActive()) {
+        m_listNotesPipeline.start(offset);
+    }
+
+    m_windowedListingTargetSize = offset + NOTE_LIST_LIMIT;
+    requestNotesList();
 }
 
 void NoteModel::onAddNoteComplete(Note note, QUuid requestId)
@@ -796,6 +1252,12 @@ void NoteModel::onAddNoteComplete(Note note, QUuid requestId)
     auto it = m_addNoteRequestIds.find(requestId);
     if (it != m_addNoteRequestIds.end()) {
         Q_UNUSED(m_addNoteRequestIds.erase(it))
+        Q_UNUSED(updateSortKeyIndex(note))
+        return;
+    }
+
+    if (shouldBatchNoteChanges()) {
+        enqueueNoteAddedOrUpdated(note);
         return;
     }
 
@@ -828,11 +1290,20 @@ void NoteModel::onUpdateNoteComplete(Note note, bool updateResources, bool updat
     bool shouldRemoveNoteFromModel = (note.hasDeletionTimestamp() && (m_includedNotes == IncludedNotes::NonDeleted));
     shouldRemoveNoteFromModel |= (!note.hasDeletionTimestamp() && (m_includedNotes == IncludedNotes::Deleted));
 
-    if (shouldRemoveNoteFromModel) {
+    auto it = m_updateNoteRequestIds.find(requestId);
+
+    if (shouldRemoveNoteFromModel)
+    {
+        Q_UNUSED(removeFromSortKeyIndex(note.localUid()))
+
+        if ((it == m_updateNoteRequestIds.end()) && shouldBatchNoteChanges()) {
+            enqueueNoteRemoval(note.localUid());
+            return;
+        }
+
         removeItemByLocalUid(note.localUid());
     }
 
-    auto it = m_updateNoteRequestIds.find(requestId);
     if (it != m_updateNoteRequestIds.end())
     {
         NMDEBUG(QStringLiteral("This update was initiated by the note model"));
@@ -848,6 +1319,7 @@ void NoteModel::onUpdateNoteComplete(Note note, bool updateResources, bool updat
         }
 
         m_cache.put(note.localUid(), note);
+        Q_UNUSED(updateSortKeyIndex(note))
 
         return;
     }
@@ -870,6 +1342,17 @@ void NoteModel::onUpdateNoteComplete(Note note, bool updateResources, bool updat
                 note.setTagLocalUids(item.tagLocalUids());
                 NMDEBUG(QStringLiteral("Complemented the note with tag local uids and guids: ") << note);
             }
+            else if (m_listingMode == ListingMode::Windowed) {
+                NMDEBUG(QStringLiteral("The note is not within the window and its tags are not known, "
+                                       "finding the whole note"));
+                requestNotesForWindow(QStringList() << note.localUid());
+                return;
+            }
+        }
+
+        if (shouldBatchNoteChanges()) {
+            enqueueNoteAddedOrUpdated(note);
+            return;
         }
 
         onNoteAddedOrUpdated(note);
@@ -903,6 +1386,28 @@ void NoteModel::onFindNoteComplete(Note note, bool withResourceBinaryData, QUuid
 {
     Q_UNUSED(withResourceBinaryData)
 
+    auto bodyIt = m_findNoteBodyRequestIdByNoteLocalUid.right.find(requestId);
+    if (bodyIt != m_findNoteBodyRequestIdByNoteLocalUid.right.end())
+    {
+        NMTRACE(QStringLiteral("NoteModel::onFindNoteComplete: found note body for note with local uid ")
+                << note.localUid() << QStringLiteral(", request id = ") << requestId);
+        Q_UNUSED(m_findNoteBodyRequestIdByNoteLocalUid.right.erase(bodyIt))
+        m_cache.put(note.localUid(), note);
+        setNoteBody(note);
+        return;
+    }
+
+    auto windowIt = m_findNoteForWindowRequestIdByNoteLocalUid.right.find(requestId);
+    if (windowIt != m_findNoteForWindowRequestIdByNoteLocalUid.right.end())
+    {
+        NMTRACE(QStringLiteral("NoteModel::onFindNoteComplete: found note for the window: local uid = ")
+                << note.localUid() << QStringLiteral(", request id = ") << requestId);
+        Q_UNUSED(m_findNoteForWindowRequestIdByNoteLocalUid.right.erase(windowIt))
+        onNoteAddedOrUpdated(note);
+        checkAndNotifyAllNotesListed();
+        return;
+    }
+
     auto restoreUpdateIt = m_findNoteToRestoreFailedUpdateRequestIds.find(requestId);
     auto performUpdateIt = m_findNoteToPerformUpdateRequestIds.find(requestId);
 
@@ -936,17 +1441,38 @@ void NoteModel::onFindNoteFailed(Note note, bool withResourceBinaryData, ErrorSt
 {
     Q_UNUSED(withResourceBinaryData)
 
-    auto restoreUpdateIt = m_findNoteToRestoreFailedUpdateRequestIds.find(requestId);
-    auto performUpdateIt = m_findNoteToPerformUpdateRequestIds.find(requestId);
-    if ((restoreUpdateIt == m_findNoteToRestoreFailedUpdateRequestIds.end()) &&
-        (performUpdateIt == m_findNoteToPerformUpdateRequestIds.end()))
+    auto bodyIt = m_findNoteBodyRequestIdByNoteLocalUid.right.find(requestId);
+    if (bodyIt != m_findNoteBodyRequestIdByNoteLocalUid.right.end())
     {
+        NMWARNING(QStringLiteral("NoteModel::onFindNoteFailed: failed to find note body for note with local uid ")
+                  << note.localUid() << QStringLiteral(", error description = ") << errorDescription
+                  << QStringLiteral(", request id = ") << requestId);
+        Q_UNUSED(m_findNoteBodyRequestIdByNoteLocalUid.right.erase(bodyIt))
         return;
     }
 
-    NMDEBUG(QStringLiteral("NoteModel::onFindNoteFailed: note = ") << note << QStringLiteral("\nError description = ")
-            << errorDescription << QStringLiteral(", request id = ") << requestId);
-
+    auto windowIt = m_findNoteForWindowRequestIdByNoteLocalUid.right.find(requestId);
+    if (windowIt != m_findNoteForWindowRequestIdByNoteLocalUid.right.end())
+    {
+        NMWARNING(QStringLiteral("NoteModel::onFindNoteFailed: failed to find note for the window: local uid = ")
+                  << note.localUid() << QStringLiteral(", error description = ") << errorDescription
+                  << QStringLiteral(", request id = ") << requestId);
+        Q_UNUSED(m_findNoteForWindowRequestIdByNoteLocalUid.right.erase(windowIt))
+        checkAndNotifyAllNotesListed();
+        return;
+    }
+
+    auto restoreUpdateIt = m_findNoteToRestoreFailedUpdateRequestIds.find(requestId);
+    auto performUpdateIt = m_findNoteToPerformUpdateRequestIds.find(requestId);
+    if ((restoreUpdateIt == m_findNoteToRestoreFailedUpdateRequestIds.end()) &&
+        (performUpdateIt == m_findNoteToPerformUpdateRequestIds.end()))
+    {
+        return;
+    }
+
+    NMDEBUG(QStringLiteral("NoteModel::onFindNoteFailed: note = ") << note << QStringLiteral("\nError description = ")
+            << errorDescription << QStringLiteral(", request id = ") << requestId);
+
     if (restoreUpdateIt != m_findNoteToRestoreFailedUpdateRequestIds.end()) {
         Q_UNUSED(m_findNoteToRestoreFailedUpdateRequestIds.erase(restoreUpdateIt))
     }
@@ -962,7 +1488,8 @@ void NoteModel::onListNotesComplete(LocalStorageManager::ListObjectsOptions flag
                                     LocalStorageManager::OrderDirection::type orderDirection,
                                     QString linkedNotebookGuid, QList<Note> foundNotes, QUuid requestId)
 {
-    if (requestId != m_listNotesRequestId) {
+    QList<Note> readyNotes;
+    if (!m_listNotesPipeline.onRequestComplete(requestId, foundNotes, readyNotes)) {
         return;
     }
 
@@ -972,16 +1499,61 @@ void NoteModel::onListNotesComplete(LocalStorageManager::ListObjectsOptions flag
             << orderDirection << QStringLiteral(", linked notebook guid = ") << linkedNotebookGuid << QStringLiteral(", num found notes = ")
             << foundNotes.size() << QStringLiteral(", request id = ") << requestId);
 
-    for(auto it = foundNotes.begin(), end = foundNotes.end(); it != end; ++it) {
+    if (m_sortKeyIndexState == SortKeyIndexState::Building)
+    {
+        for(auto it = readyNotes.constBegin(), end = readyNotes.constEnd(); it != end; ++it)
+        {
+            ++m_numberOfNotesPerAccount;
+
+            // NOTE: the notes added or updated since the listing started are within the index with their latest keys
+            SortKeyIndexEntry entry;
+            if (!m_sortKeyIndexLocalUids.contains(it->localUid()) && sortKeyIndexEntryForNote(*it, entry)) {
+                Q_UNUSED(m_sortKeyIndexLocalUids.insert(entry.m_localUid))
+                m_sortKeyIndex.push_back(entry);
+            }
+        }
+
+        if (!m_listNotesPipeline.isFinished())
+        {
+            if (m_listNotesPipeline.isActive()) {
+                NMTRACE(QStringLiteral("Not all notes are listed for the sort key index yet, requesting more notes "
+                                       "from the local storage"));
+                requestNotesList();
+            }
+
+            return;
+        }
+
+        finishSortKeyIndex();
+        checkAndNotifyAllNotesListed();
+        return;
+    }
+
+    for(auto it = readyNotes.constBegin(), end = readyNotes.constEnd(); it != end; ++it) {
         ++m_numberOfNotesPerAccount;
         onNoteAddedOrUpdated(*it);
     }
 
-    m_listNotesRequestId = QUuid();
+    if (m_listingMode == ListingMode::Windowed)
+    {
+        if (m_listNotesPipeline.isFinished()) {
+            NMTRACE(QStringLiteral("The local storage has no more notes to list"));
+        }
+        else if (m_listNotesPipeline.appliedOffset() < m_windowedListingTargetSize) {
+            NMTRACE(QStringLiteral("Not enough notes were listed to fill the window yet, requesting more notes "
+                                   "from the local storage"));
+            requestNotesList();
+            return;
+        }
+        else {
+            NMTRACE(QStringLiteral("Listed enough notes to fill the window, waiting for fetchMore to list more"));
+        }
 
-    if (!foundNotes.isEmpty()) {
-        NMTRACE(QStringLiteral("The number of found notes is greater than zero, requesting more notes from the local storage"));
-        m_listNotesOffset += static_cast<size_t>(foundNotes.size());
+        updateNoteBodiesForViewport();
+    }
+    else if (m_listNotesPipeline.isActive())
+    {
+        NMTRACE(QStringLiteral("Not all notes are listed yet, requesting more notes from the local storage"));
         requestNotesList();
         return;
     }
@@ -994,7 +1566,7 @@ void NoteModel::onListNotesFailed(LocalStorageManager::ListObjectsOptions flag,
                                   LocalStorageManager::OrderDirection::type orderDirection,
                                   QString linkedNotebookGuid, ErrorString errorDescription, QUuid requestId)
 {
-    if (requestId != m_listNotesRequestId) {
+    if (!m_listNotesPipeline.onRequestFailed(requestId)) {
         return;
     }
 
@@ -1004,8 +1576,14 @@ void NoteModel::onListNotesFailed(LocalStorageManager::ListObjectsOptions flag,
             << orderDirection << QStringLiteral(", linked notebook guid = ") << linkedNotebookGuid
             << QStringLiteral(", error description = ") << errorDescription << QStringLiteral(", request id = ") << requestId);
 
-    m_listNotesRequestId = QUuid();
     Q_EMIT notifyError(errorDescription);
+
+    if (m_sortKeyIndexState == SortKeyIndexState::Building) {
+        // The listing is stopped, making do with the sort keys of the notes listed so far rather than
+        // leaving the model empty
+        finishSortKeyIndex();
+        checkAndNotifyAllNotesListed();
+    }
 }
 
 void NoteModel::onExpungeNoteComplete(Note note, QUuid requestId)
@@ -1013,6 +1591,7 @@ void NoteModel::onExpungeNoteComplete(Note note, QUuid requestId)
     NMDEBUG(QStringLiteral("NoteModel::onExpungeNoteComplete: note = ") << note << QStringLiteral("\nRequest id = ") << requestId);
 
     --m_numberOfNotesPerAccount;
+    Q_UNUSED(removeFromSortKeyIndex(note.localUid()))
 
     auto it = m_expungeNoteRequestIds.find(requestId);
     if (it != m_expungeNoteRequestIds.end()) {
@@ -1020,6 +1599,11 @@ void NoteModel::onExpungeNoteComplete(Note note, QUuid requestId)
         return;
     }
 
+    if (shouldBatchNoteChanges()) {
+        enqueueNoteRemoval(note.localUid());
+        return;
+    }
+
     removeItemByLocalUid(note.localUid());
 }
 
@@ -1140,6 +1724,8 @@ void NoteModel::onExpungeNotebookComplete(Notebook notebook, QUuid requestId)
     if (it != m_notebookDataByNotebookLocalUid.end()) {
         Q_UNUSED(m_notebookDataByNotebookLocalUid.erase(it))
     }
+
+    m_stringPool.purgeUnused();
 }
 
 void NoteModel::onFindTagComplete(Tag tag, QUuid requestId)
@@ -1196,6 +1782,21 @@ void NoteModel::onExpungeTagComplete(Tag tag, QStringList expungedChildTagLocalU
     for(auto it = expungedTagLocalUids.constBegin(), end = expungedTagLocalUids.constEnd(); it != end; ++it) {
         processTagExpunging(*it);
     }
+
+    m_stringPool.purgeUnused();
+}
+
+void NoteModel::onThumbnailReady(QString noteLocalUid)
+{
+    NMTRACE(QStringLiteral("NoteModel::onThumbnailReady: note local uid = ") << noteLocalUid);
+
+    QModelIndex modelIndex = indexForLocalUid(noteLocalUid);
+    if (!modelIndex.isValid()) {
+        return;
+    }
+
+    modelIndex = createIndex(modelIndex.row(), Columns::ThumbnailImage);
+    Q_EMIT dataChanged(modelIndex, modelIndex);
 }
 
 void NoteModel::createConnections(LocalStorageManagerAsync & localStorageManagerAsync)
@@ -1272,16 +1873,483 @@ void NoteModel::createConnections(LocalStorageManagerAsync & localStorageManager
 
 void NoteModel::requestNotesList()
 {
-    NMDEBUG(QStringLiteral("NoteModel::requestNotesList: offset = ") << m_listNotesOffset);
+    NMDEBUG(QStringLiteral("NoteModel::requestNotesList: offset = ") << m_listNotesPipeline.appliedOffset());
 
     LocalStorageManager::ListObjectsOptions flags = LocalStorageManager::ListAll;
     LocalStorageManager::ListNotesOrder::type order = LocalStorageManager::ListNotesOrder::NoOrder;
     LocalStorageManager::OrderDirection::type direction = LocalStorageManager::OrderDirection::Ascending;
 
-    m_listNotesRequestId = QUuid::createUuid();
-    NMTRACE(QStringLiteral("Emitting the request to list notes: offset = ") << m_listNotesOffset
-            << QStringLiteral(", request id = ") << m_listNotesRequestId);
-    Q_EMIT listNotes(flags, /* with resource binary data = */ false, NOTE_LIST_LIMIT, m_listNotesOffset, order, direction, QString(), m_listNotesRequestId);
+    if ((m_listingMode == ListingMode::Windowed) && listNotesOrderForSortedColumn(order)) {
+        direction = ((m_sortOrder == Qt::AscendingOrder)
+                     ? LocalStorageManager::OrderDirection::Ascending
+                     : LocalStorageManager::OrderDirection::Descending);
+    }
+
+    // In windowed mode only the notes up to the window's target size are listed until more are fetched
+    size_t endOffset = ((m_listingMode == ListingMode::Windowed)
+                        ? m_windowedListingTargetSize
+                        : std::numeric_limits<size_t>::max());
+
+    QList<ListNotesPipeline::Request> requests = m_listNotesPipeline.takeRequestsToSend(endOffset);
+    for(auto it = requests.constBegin(), end = requests.constEnd(); it != end; ++it)
+    {
+        const ListNotesPipeline::Request & request = *it;
+        NMTRACE(QStringLiteral("Emitting the request to list notes: offset = ") << request.m_offset
+                << QStringLiteral(", limit = ") << request.m_limit << QStringLiteral(", request id = ") << request.m_requestId);
+        Q_EMIT listNotes(flags, /* with resource binary data = */ false, request.m_limit, request.m_offset,
+                         order, direction, QString(), request.m_requestId);
+    }
+}
+
+bool NoteModel::listNotesOrderForSortedColumn(LocalStorageManager::ListNotesOrder::type & order) const
+{
+    switch(m_sortedColumn)
+    {
+    case Columns::CreationTimestamp:
+        order = LocalStorageManager::ListNotesOrder::ByCreationTimestamp;
+        return true;
+    case Columns::ModificationTimestamp:
+        order = LocalStorageManager::ListNotesOrder::ByModificationTimestamp;
+        return true;
+    case Columns::DeletionTimestamp:
+        order = LocalStorageManager::ListNotesOrder::ByDeletionTimestamp;
+        return true;
+    default:
+        // NOTE: the local storage can list notes by title but the model sorts them by title or,
+        // for the notes without title, by preview text, using the locale aware collation;
+        // paging through the notes listed by title would place them inconsistently, hence the sort key index
+        order = LocalStorageManager::ListNotesOrder::NoOrder;
+        return false;
+    }
+}
+
+void NoteModel::resetWindowedListing()
+{
+    NMDEBUG(QStringLiteral("NoteModel::resetWindowedListing"));
+
+    beginResetModel();
+
+    m_data.clear();
+    m_collationKeyCache.clear();
+    m_noteLocalUidsWithBodies.clear();
+    m_findNoteBodyRequestIdByNoteLocalUid.clear();
+    m_findNoteForWindowRequestIdByNoteLocalUid.clear();
+    m_viewportNoteLocalUids.clear();
+
+    endResetModel();
+
+    if (m_sortKeyIndexState == SortKeyIndexState::Ready) {
+        // The caller has kept the sort key index sorted for the new sorting, only the window needs to be found again
+        m_sortKeyIndexWindowEnd = 0;
+        requestSortKeyIndexWindow(NOTE_MODEL_WINDOW_SIZE);
+        return;
+    }
+
+    m_sortKeyIndex.clear();
+    m_sortKeyIndexLocalUids.clear();
+    m_sortKeyIndexWindowEnd = 0;
+
+    // The notes listed so far would be listed again
+    m_numberOfNotesPerAccount -= static_cast<qint32>(m_listNotesPipeline.appliedOffset());
+
+    m_listNotesPipeline.start();
+
+    LocalStorageManager::ListNotesOrder::type order = LocalStorageManager::ListNotesOrder::NoOrder;
+    if (listNotesOrderForSortedColumn(order)) {
+        m_sortKeyIndexState = SortKeyIndexState::Inactive;
+        m_windowedListingTargetSize = NOTE_MODEL_WINDOW_SIZE;
+    }
+    else if (sortKeyIndexUsed()) {
+        NMDEBUG(QStringLiteral("The local storage can't list notes sorted by column ") << m_sortedColumn
+                << QStringLiteral(", will list all notes to build the sort key index"));
+        m_sortKeyIndexState = SortKeyIndexState::Building;
+        m_windowedListingTargetSize = std::numeric_limits<size_t>::max();
+    }
+    else {
+        NMDEBUG(QStringLiteral("The local storage can't list notes sorted by column ") << m_sortedColumn
+                << QStringLiteral(", will list all notes"));
+        m_sortKeyIndexState = SortKeyIndexState::Inactive;
+        m_windowedListingTargetSize = std::numeric_limits<size_t>::max();
+    }
+
+    requestNotesList();
+}
+
+bool NoteModel::sortKeyIndexUsed() const
+{
+    if (m_listingMode != ListingMode::Windowed) {
+        return false;
+    }
+
+    LocalStorageManager::ListNotesOrder::type order = LocalStorageManager::ListNotesOrder::NoOrder;
+    if (listNotesOrderForSortedColumn(order)) {
+        return false;
+    }
+
+    // NOTE: the names of notebooks are not known for the notes listed just for their sort keys
+    return (m_sortedColumn != Columns::NotebookName);
+}
+
+bool NoteModel::sortKeyIndexEntryForNote(const Note & note, SortKeyIndexEntry & entry)
+{
+    switch(m_includedNotes)
+    {
+    case IncludedNotes::Deleted:
+        if (!note.hasDeletionTimestamp()) {
+            return false;
+        }
+        break;
+    case IncludedNotes::NonDeleted:
+        if (note.hasDeletionTimestamp()) {
+            return false;
+        }
+        break;
+    default:
+        break;
+    }
+
+    entry.m_localUid = note.localUid();
+
+    switch(m_sortedColumn)
+    {
+    case Columns::Title:
+    case Columns::PreviewText:
+        {
+            // NOTE: the plain text is only computed for the notes without title, same as collatedStringForItem
+            // falls back to the preview text
+            QString titleOrPreviewText = (note.hasTitle() ? note.title() : QString());
+            if (titleOrPreviewText.isEmpty() && note.hasContent()) {
+                titleOrPreviewText = note.plainText().left(NOTE_PREVIEW_TEXT_SIZE);
+            }
+
+            entry.m_collationKey = m_collator.sortKey(titleOrPreviewText);
+            break;
+        }
+    case Columns::Size:
+        entry.m_value = noteSizeInBytes(note);
+        break;
+    case Columns::Synchronizable:
+        entry.m_value = (note.isLocal() ? 0 : 1);
+        break;
+    case Columns::Dirty:
+        entry.m_value = (note.isDirty() ? 1 : 0);
+        break;
+    case Columns::HasResources:
+        entry.m_value = ((note.hasResources() && (note.numResources() > 0)) ? 1 : 0);
+        break;
+    default:
+        // The rest of columns don't order the notes at all
+        entry.m_value = 0;
+        break;
+    }
+
+    return true;
+}
+
+bool NoteModel::updateSortKeyIndex(const Note & note)
+{
+    if (m_sortKeyIndexState == SortKeyIndexState::Inactive) {
+        return true;
+    }
+
+    SortKeyIndexEntry entry;
+    bool included = sortKeyIndexEntryForNote(note, entry);
+    size_t previousPosition = sortKeyIndexPosition(note.localUid());
+
+    if (m_sortKeyIndexState == SortKeyIndexState::Building)
+    {
+        // The index is sorted once all notes are listed; until then the model has no rows
+        if (!included) {
+            Q_UNUSED(removeFromSortKeyIndex(note.localUid()))
+        }
+        else if (previousPosition < m_sortKeyIndex.size()) {
+            m_sortKeyIndex[previousPosition] = entry;
+        }
+        else {
+            Q_UNUSED(m_sortKeyIndexLocalUids.insert(entry.m_localUid))
+            m_sortKeyIndex.push_back(entry);
+        }
+
+        return false;
+    }
+
+    SortKeyIndexEntryComparator comparator(m_sortedColumn, m_sortOrder);
+
+    if (included && (previousPosition < m_sortKeyIndex.size()))
+    {
+        const SortKeyIndexEntry & previousEntry = m_sortKeyIndex[previousPosition];
+        if (!comparator(entry, previousEntry) && !comparator(previousEntry, entry)) {
+            // The key is the same, so is the position; moving the note past the notes with the same key
+            // might have moved it out of the window
+            m_sortKeyIndex[previousPosition] = entry;
+            return (previousPosition < m_sortKeyIndexWindowEnd);
+        }
+    }
+
+    bool wasWithinWindow = (previousPosition < m_sortKeyIndexWindowEnd);
+    Q_UNUSED(removeFromSortKeyIndex(note.localUid()))
+
+    if (!included) {
+        return false;
+    }
+
+    Q_UNUSED(m_sortKeyIndexLocalUids.insert(entry.m_localUid))
+
+    bool wholeIndexWithinWindow = (m_sortKeyIndexWindowEnd >= m_sortKeyIndex.size());
+
+    // The note from the window goes first among the notes with the same key to stay within the window if possible
+    std::vector<SortKeyIndexEntry>::iterator it;
+    if (wasWithinWindow) {
+        it = std::lower_bound(m_sortKeyIndex.begin(), m_sortKeyIndex.end(), entry, comparator);
+    }
+    else {
+        it = std::upper_bound(m_sortKeyIndex.begin(), m_sortKeyIndex.end(), entry, comparator);
+    }
+
+    size_t position = static_cast<size_t>(std::distance(m_sortKeyIndex.begin(), it));
+    Q_UNUSED(m_sortKeyIndex.insert(it, entry))
+
+    // The note within the window stays there unless its key has moved past the window's end; the note
+    // from beyond the window gets into it if its key has moved inside the window or if the window has all notes
+    bool withinWindow = ((position < m_sortKeyIndexWindowEnd) ||
+                         ((position == m_sortKeyIndexWindowEnd) && (wasWithinWindow || wholeIndexWithinWindow)));
+    if (withinWindow) {
+        ++m_sortKeyIndexWindowEnd;
+    }
+
+    return withinWindow;
+}
+
+size_t NoteModel::sortKeyIndexPosition(const QString & noteLocalUid) const
+{
+    if (!m_sortKeyIndexLocalUids.contains(noteLocalUid)) {
+        return m_sortKeyIndex.size();
+    }
+
+    // NOTE: the linear lookup costs about as much as the insertion into or the erasure from the vector
+    // which follow it anyway
+    for(size_t i = 0, size = m_sortKeyIndex.size(); i < size; ++i)
+    {
+        if (m_sortKeyIndex[i].m_localUid == noteLocalUid) {
+            return i;
+        }
+    }
+
+    return m_sortKeyIndex.size();
+}
+
+size_t NoteModel::removeFromSortKeyIndex(const QString & noteLocalUid)
+{
+    size_t position = sortKeyIndexPosition(noteLocalUid);
+    if (position >= m_sortKeyIndex.size()) {
+        return position;
+    }
+
+    Q_UNUSED(m_sortKeyIndexLocalUids.remove(noteLocalUid))
+    Q_UNUSED(m_sortKeyIndex.erase(m_sortKeyIndex.begin() + static_cast<std::ptrdiff_t>(position)))
+
+    if ((m_sortKeyIndexState == SortKeyIndexState::Ready) && (position < m_sortKeyIndexWindowEnd)) {
+        --m_sortKeyIndexWindowEnd;
+    }
+
+    return position;
+}
+
+void NoteModel::finishSortKeyIndex()
+{
+    NMDEBUG(QStringLiteral("NoteModel::finishSortKeyIndex: num notes = ") << m_sortKeyIndex.size());
+
+    std::sort(m_sortKeyIndex.begin(), m_sortKeyIndex.end(), SortKeyIndexEntryComparator(m_sortedColumn, m_sortOrder));
+
+    m_sortKeyIndexState = SortKeyIndexState::Ready;
+    m_sortKeyIndexWindowEnd = 0;
+    requestSortKeyIndexWindow(NOTE_MODEL_WINDOW_SIZE);
+}
+
+void NoteModel::requestSortKeyIndexWindow(const size_t windowEnd)
+{
+    size_t end = std::min(windowEnd, m_sortKeyIndex.size());
+
+    NMDEBUG(QStringLiteral("NoteModel::requestSortKeyIndexWindow: from ") << m_sortKeyIndexWindowEnd
+            << QStringLiteral(" to ") << end);
+
+    const NoteDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
+
+    QStringList noteLocalUids;
+    for(size_t i = m_sortKeyIndexWindowEnd; i < end; ++i)
+    {
+        const QString & noteLocalUid = m_sortKeyIndex[i].m_localUid;
+        if (localUidIndex.find(noteLocalUid) == localUidIndex.end()) {
+            noteLocalUids << noteLocalUid;
+        }
+    }
+
+    // NOTE: the window end is moved before the notes are requested since the found notes are checked against it
+    m_sortKeyIndexWindowEnd = std::max(m_sortKeyIndexWindowEnd, end);
+    requestNotesForWindow(noteLocalUids);
+}
+
+void NoteModel::requestNotesForWindow(const QStringList & noteLocalUids)
+{
+    QList<QUuid> requestIds;
+    requestIds.reserve(noteLocalUids.size());
+
+    // All the requests are registered before any of them is sent so that none of the found notes
+    // makes the model consider the window completely listed prematurely
+    for(auto it = noteLocalUids.constBegin(), end = noteLocalUids.constEnd(); it != end; ++it)
+    {
+        if (m_findNoteForWindowRequestIdByNoteLocalUid.left.find(*it) != m_findNoteForWindowRequestIdByNoteLocalUid.left.end()) {
+            NMTRACE(QStringLiteral("The request to find the note for the window has already been sent: local uid = ") << *it);
+            requestIds << QUuid();
+            continue;
+        }
+
+        QUuid requestId = QUuid::createUuid();
+        Q_UNUSED(m_findNoteForWindowRequestIdByNoteLocalUid.insert(LocalUidToRequestIdBimap::value_type(*it, requestId)))
+        requestIds << requestId;
+    }
+
+    for(int i = 0, size = noteLocalUids.size(); i < size; ++i)
+    {
+        const QUuid & requestId = requestIds[i];
+        if (requestId.isNull()) {
+            continue;
+        }
+
+        Note dummy;
+        dummy.setLocalUid(noteLocalUids[i]);
+        NMTRACE(QStringLiteral("Emitting the request to find note for the window: local uid = ") << noteLocalUids[i]
+                << QStringLiteral(", request id = ") << requestId);
+        Q_EMIT findNote(dummy, /* with resource binary data = */ false, requestId);
+    }
+}
+
+bool NoteModel::windowedListingFinished() const
+{
+    switch(m_sortKeyIndexState)
+    {
+    case SortKeyIndexState::Building:
+        return false;
+    case SortKeyIndexState::Ready:
+        return (m_sortKeyIndexWindowEnd >= m_sortKeyIndex.size()) && m_findNoteForWindowRequestIdByNoteLocalUid.empty();
+    default:
+        return m_listNotesPipeline.isFinished();
+    }
+}
+
+void NoteModel::updateNoteBodiesForViewport()
+{
+    if (m_listingMode != ListingMode::Windowed) {
+        return;
+    }
+
+    if (m_viewportNoteLocalUids.isEmpty()) {
+        NMTRACE(QStringLiteral("The viewport is not known yet, keeping the thumbnails listed so far"));
+        return;
+    }
+
+    NMTRACE(QStringLiteral("NoteModel::updateNoteBodiesForViewport: num viewport rows = ")
+            << m_viewportNoteLocalUids.size() << QStringLiteral(", num rows with note bodies = ")
+            << m_noteLocalUidsWithBodies.size());
+
+    const NoteDataByIndex & index = m_data.get<ByIndex>();
+    NoteDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
+
+    for(auto it = m_viewportNoteLocalUids.constBegin(), end = m_viewportNoteLocalUids.constEnd(); it != end; ++it)
+    {
+        if (!m_noteLocalUidsWithBodies.contains(*it) && (localUidIndex.find(*it) != localUidIndex.end())) {
+            requestNoteBody(*it);
+        }
+    }
+
+    for(auto it = m_noteLocalUidsWithBodies.begin(); it != m_noteLocalUidsWithBodies.end(); )
+    {
+        if (m_viewportNoteLocalUids.contains(*it)) {
+            ++it;
+            continue;
+        }
+
+        // NOTE: the preview text is kept since it is a part of the key by which the model sorts the notes
+        // by title or preview text; it is limited in size anyway unlike the thumbnail
+        auto itemIt = localUidIndex.find(*it);
+        if (itemIt != localUidIndex.end())
+        {
+            NoteModelItem item = *itemIt;
+            item.setThumbnailData(QByteArray());
+            Q_UNUSED(localUidIndex.replace(itemIt, item))
+
+            auto indexIt = m_data.project<ByIndex>(itemIt);
+            int row = static_cast<int>(std::distance(index.begin(), indexIt));
+            QModelIndex modelIndex = createIndex(row, Columns::ThumbnailImage);
+            Q_EMIT dataChanged(modelIndex, modelIndex);
+        }
+
+        it = m_noteLocalUidsWithBodies.erase(it);
+    }
+}
+
+void NoteModel::requestNoteBody(const QString & noteLocalUid)
+{
+    const Note * pCachedNote = m_cache.get(noteLocalUid);
+    if (pCachedNote && pCachedNote->hasContent()) {
+        NMTRACE(QStringLiteral("Found the note body within the note cache: local uid = ") << noteLocalUid);
+        setNoteBody(*pCachedNote);
+        return;
+    }
+
+    auto it = m_findNoteBodyRequestIdByNoteLocalUid.left.find(noteLocalUid);
+    if (it != m_findNoteBodyRequestIdByNoteLocalUid.left.end()) {
+        NMTRACE(QStringLiteral("The request to find the note body has already been sent: local uid = ") << noteLocalUid);
+        return;
+    }
+
+    QUuid requestId = QUuid::createUuid();
+    Q_UNUSED(m_findNoteBodyRequestIdByNoteLocalUid.insert(LocalUidToRequestIdBimap::value_type(noteLocalUid, requestId)))
+
+    Note dummy;
+    dummy.setLocalUid(noteLocalUid);
+    NMTRACE(QStringLiteral("Emitting the request to find note for its body: local uid = ") << noteLocalUid
+            << QStringLiteral(", request id = ") << requestId);
+    Q_EMIT findNote(dummy, /* with resource binary data = */ false, requestId);
+}
+
+void NoteModel::setNoteBody(const Note & note)
+{
+    NoteDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
+    auto it = localUidIndex.find(note.localUid());
+    if (it == localUidIndex.end()) {
+        NMTRACE(QStringLiteral("The note which body was found is no longer within the model: local uid = ")
+                << note.localUid());
+        return;
+    }
+
+    NoteModelItem item = *it;
+
+    bool previewTextChanged = false;
+    if (note.hasContent())
+    {
+        // NOTE: unlike truncate, left doesn't keep the capacity of the whole plain text
+        QString previewText = note.plainText().left(NOTE_PREVIEW_TEXT_SIZE);
+        if (previewText != item.previewText()) {
+            item.setPreviewText(previewText);
+            previewTextChanged = true;
+        }
+    }
+
+    item.setThumbnailData(note.thumbnailData());
+    Q_UNUSED(localUidIndex.replace(it, item))
+    Q_UNUSED(m_noteLocalUidsWithBodies.insert(note.localUid()))
+
+    const NoteDataByIndex & index = m_data.get<ByIndex>();
+    auto indexIt = m_data.project<ByIndex>(it);
+    int row = static_cast<int>(std::distance(index.begin(), indexIt));
+    QModelIndex modelIndexFrom = createIndex(row, Columns::PreviewText);
+    QModelIndex modelIndexTo = createIndex(row, Columns::ThumbnailImage);
+    Q_EMIT dataChanged(modelIndexFrom, modelIndexTo);
+
+    if (previewTextChanged) {
+        updateItemRowWithRespectToSorting(item);
+    }
 }
 
 QVariant NoteModel::dataImpl(const int row, const Columns::type column) const
@@ -1306,15 +2374,11 @@ QVariant NoteModel::dataImpl(const int row, const Columns::type column) const
     case Columns::PreviewText:
         return item.previewText();
     case Columns::ThumbnailImage:
-        {
-            QImage thumbnail;
-            Q_UNUSED(thumbnail.loadFromData(item.thumbnailData(), "PNG"))
-            return thumbnail;
-        }
+        return thumbnail(item);
     case Columns::NotebookName:
         return item.notebookName();
     case Columns::TagNameList:
-        return item.tagNameList();
+        return m_tagNameTable.names(item.tagNameIds());
     case Columns::Size:
         return item.sizeInBytes();
     case Columns::Synchronizable:
@@ -1411,7 +2475,7 @@ QVariant NoteModel::dataAccessibleText(const int row, const Columns::type column
         }
     case Columns::TagNameList:
         {
-            const QStringList & tagNameList = item.tagNameList();
+            QStringList tagNameList = m_tagNameTable.names(item.tagNameIds());
             if (tagNameList.isEmpty()) {
                 accessibleText += tr("tag list is empty");
             }
@@ -1459,9 +2523,10 @@ void NoteModel::processTagExpunging(const QString & tagLocalUid)
     }
 
     QString tagGuid = tagDataIt->m_guid;
-    QString tagName = tagDataIt->m_name;
+    qint32 tagNameId = m_tagNameTable.findId(tagLocalUid);
 
     Q_UNUSED(m_tagDataByTagLocalUid.erase(tagDataIt))
+    m_tagNameTable.remove(tagLocalUid);
 
     auto noteIt = m_tagLocalUidToNoteLocalUid.find(tagLocalUid);
     if (noteIt == m_tagLocalUidToNoteLocalUid.end()) {
@@ -1469,6 +2534,7 @@ void NoteModel::processTagExpunging(const QString & tagLocalUid)
     }
 
     NoteDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
+    NoteDataByIndex & index = m_data.get<ByIndex>();
 
     QStringList affectedNotesLocalUids;
     while(noteIt != m_tagLocalUidToNoteLocalUid.end())
@@ -1484,35 +2550,52 @@ void NoteModel::processTagExpunging(const QString & tagLocalUid)
     Q_UNUSED(m_tagLocalUidToNoteLocalUid.remove(tagLocalUid))
 
     NMDEBUG("Affected notes local uids: " << affectedNotesLocalUids.join(QStringLiteral(", ")));
+
+    int firstAffectedRow = -1;
+    int lastAffectedRow = -1;
+
     for(auto it = affectedNotesLocalUids.constBegin(), end = affectedNotesLocalUids.constEnd(); it != end; ++it)
     {
         auto noteItemIt = localUidIndex.find(*it);
         if (Q_UNLIKELY(noteItemIt == localUidIndex.end())) {
-            NMDEBUG(QStringLiteral("Can't find the note pointed to by the expunged tag by local uid: note local uid = ") << noteIt.value());
+            NMDEBUG(QStringLiteral("Can't find the note pointed to by the expunged tag by local uid: note local uid = ") << *it);
             continue;
         }
 
         NoteModelItem item = *noteItemIt;
         item.removeTagGuid(tagGuid);
-        item.removeTagName(tagName);
+        item.removeTagNameId(tagNameId);
         item.removeTagLocalUid(tagLocalUid);
 
         Q_UNUSED(localUidIndex.replace(noteItemIt, item))
 
-        QModelIndex modelIndex = indexForLocalUid(item.localUid());
-        modelIndex = createIndex(modelIndex.row(), Columns::TagNameList);
-        Q_EMIT dataChanged(modelIndex, modelIndex);
+        int row = static_cast<int>(std::distance(index.begin(), m_data.project<ByIndex>(noteItemIt)));
+        if ((firstAffectedRow < 0) || (row < firstAffectedRow)) {
+            firstAffectedRow = row;
+        }
+
+        if (row > lastAffectedRow) {
+            lastAffectedRow = row;
+        }
 
         // This note's cache entry is clearly stale now, need to ensure
         // it won't be present in the cache
         Q_UNUSED(m_cache.remove(item.localUid()))
     }
+
+    if (firstAffectedRow >= 0) {
+        QModelIndex modelIndexFrom = createIndex(firstAffectedRow, Columns::TagNameList);
+        QModelIndex modelIndexTo = createIndex(lastAffectedRow, Columns::TagNameList);
+        Q_EMIT dataChanged(modelIndexFrom, modelIndexTo);
+    }
 }
 
 void NoteModel::removeItemByLocalUid(const QString & localUid)
 {
     NMDEBUG(QStringLiteral("NoteModel::removeItemByLocalUid: ") << localUid);
 
+    Q_UNUSED(m_restoredLocalUidsPendingReconciliation.remove(localUid))
+
     NoteDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
     auto itemIt = localUidIndex.find(localUid);
     if (Q_UNLIKELY(itemIt == localUidIndex.end())) {
@@ -1536,6 +2619,9 @@ void NoteModel::removeItemByLocalUid(const QString & localUid)
         return;
     }
 
+    m_pThumbnailCache->remove(localUid);
+    m_collationKeyCache.remove(localUid);
+
     beginRemoveRows(QModelIndex(), row, row);
     Q_UNUSED(localUidIndex.erase(itemIt))
     endRemoveRows();
@@ -1568,33 +2654,108 @@ void NoteModel::updateItemRowWithRespectToSorting(const NoteModelItem & item)
         return;
     }
 
-    NoteModelItem itemCopy(item);
+    // NOTE: all the items but the updated one are still sorted so its new position can be found
+    // with the binary search either before or after its original position
+    NoteComparator comparator = itemComparator();
+    NoteDataByIndex::iterator positionIt = it;
+    NoteDataByIndex::iterator nextIt = it + 1;
 
-    NMTRACE(QStringLiteral("Removing the moved item from the original row ") << originalRow);
-    beginRemoveRows(QModelIndex(), originalRow, originalRow);
-    Q_UNUSED(index.erase(it))
-    endRemoveRows();
+    if ((it != index.begin()) && comparator(*it, *(it - 1))) {
+        positionIt = std::lower_bound(index.begin(), it, *it, comparator);
+    }
+    else if ((nextIt != index.end()) && comparator(*nextIt, *it)) {
+        positionIt = std::lower_bound(nextIt, index.end(), *it, comparator);
+    }
+    else {
+        NMTRACE(QStringLiteral("The item's row is still correct with respect to sorting"));
+        return;
+    }
 
-    auto positionIter = std::lower_bound(index.begin(), index.end(), itemCopy,
-                                         NoteComparator(m_sortedColumn, m_sortOrder));
-    if (positionIter == index.end())
-    {
-        int newRow = static_cast<int>(index.size());
+    // NOTE: the destination row is the row before which the item is moved in terms of rows before the move
+    int destinationRow = static_cast<int>(std::distance(index.begin(), positionIt));
 
-        NMTRACE(QStringLiteral("Inserting the moved item at row ") << newRow);
-        beginInsertRows(QModelIndex(), newRow, newRow);
-        index.push_back(itemCopy);
-        endInsertRows();
+    NMTRACE(QStringLiteral("Moving the item from row ") << originalRow << QStringLiteral(" to before row ")
+            << destinationRow);
 
+    if (Q_UNLIKELY(!beginMoveRows(QModelIndex(), originalRow, originalRow, QModelIndex(), destinationRow))) {
+        NMWARNING(QStringLiteral("Can't move the item from row ") << originalRow << QStringLiteral(" to before row ")
+                  << destinationRow << QStringLiteral(", item: ") << item);
         return;
     }
 
-    int newRow = static_cast<int>(std::distance(index.begin(), positionIter));
+    // NOTE: relocation within the random access index only shifts the pointers to elements, the elements themselves
+    // stay in place and the other indices are not affected
+    index.relocate(positionIt, it);
 
-    NMTRACE(QStringLiteral("Inserting the moved item at row ") << newRow);
-    beginInsertRows(QModelIndex(), newRow, newRow);
-    Q_UNUSED(index.insert(positionIter, itemCopy))
-    endInsertRows();
+    endMoveRows();
+}
+
+void NoteModel::startAsyncSort(const Columns::type column, const Qt::SortOrder order)
+{
+    NMDEBUG(QStringLiteral("NoteModel::startAsyncSort: column = ") << column << QStringLiteral(", order = ") << order
+            << QStringLiteral(", number of items = ") << m_data.size());
+
+    const NoteDataByIndex & index = m_data.get<ByIndex>();
+    std::vector<NoteModelItem> snapshot(index.begin(), index.end());
+
+    m_pSortTask = new NoteSortTask(snapshot, column, order);
+
+    QObject::connect(m_pSortTask, QNSIGNAL(AsyncSortTask,finished),
+                     this, QNSLOT(NoteModel,onSortTaskFinished));
+    QObject::connect(m_pSortTask, QNSIGNAL(AsyncSortTask,finished),
+                     m_pSortTask, QNSLOT(AsyncSortTask,deleteLater));
+
+    m_sortThreadPool.start(m_pSortTask);
+}
+
+void NoteModel::onSortTaskFinished()
+{
+    NMDEBUG(QStringLiteral("NoteModel::onSortTaskFinished"));
+
+    if (!m_pSortTask || (sender() != m_pSortTask)) {
+        NMDEBUG(QStringLiteral("The sorting has been superseded, ignoring its result"));
+        return;
+    }
+
+    const NoteSortTask * pSortTask = m_pSortTask;
+    m_pSortTask = Q_NULLPTR;
+
+    applySortedItems(pSortTask->sortedItems(), pSortTask->sortedColumn(), pSortTask->sortOrder());
+}
+
+void NoteModel::applySortedItems(const std::vector<const NoteModelItem*> & sortedItems, const Columns::type column,
+                                 const Qt::SortOrder order)
+{
+    NMDEBUG(QStringLiteral("NoteModel::applySortedItems: column = ") << column << QStringLiteral(", order = ") << order);
+
+    Q_EMIT layoutAboutToBeChanged();
+
+    QModelIndexList persistentIndices = persistentIndexList();
+    QVector<std::pair<QString, int> > localUidsToUpdateWithColumns = persistentIndexLocalUids(persistentIndices);
+
+    m_sortedColumn = column;
+    m_sortOrder = order;
+
+    size_t numPositionedItems =
+        rearrangeBySortedSnapshot<ByIndex, ByLocalUid>(m_data, sortedItems, SortedColumnDataEqual(m_sortedColumn),
+                                                       itemComparator());
+    NMDEBUG(QStringLiteral("Positioned ") << numPositionedItems
+            << QStringLiteral(" items added or changed during the sorting"));
+
+    updatePersistentIndices(persistentIndices, localUidsToUpdateWithColumns);
+
+    Q_EMIT layoutChanged();
+}
+
+QVector<std::pair<QString, int> > NoteModel::persistentIndexLocalUids(const QModelIndexList & persistentIndices) const
+{
+    return localUidsForPersistentIndices(*this, persistentIndices);
+}
+
+void NoteModel::updatePersistentIndices(const QModelIndexList & persistentIndices,
+                                        const QVector<std::pair<QString, int> > & localUidsWithColumns)
+{
+    changePersistentIndexList(persistentIndices, persistentIndexReplacements(*this, localUidsWithColumns));
 }
 
 void NoteModel::updateNoteInLocalStorage(const NoteModelItem & item, const bool updateTags)
@@ -1603,6 +2764,9 @@ void NoteModel::updateNoteInLocalStorage(const NoteModelItem & item, const bool
             << item.localUid() << QStringLiteral(", update tags = ")
             << (updateTags ? QStringLiteral("true") : QStringLiteral("false")));
 
+    // The pending change of the note coming from the local storage is superseded by this update
+    Q_UNUSED(m_pendingAddedOrUpdatedNotes.remove(item.localUid()))
+
     Note note;
 
     auto notYetSavedItemIt = m_noteItemsNotYetInLocalStorageUids.find(item.localUid());
@@ -1669,7 +2833,7 @@ int NoteModel::rowForNewItem(const NoteModelItem & item) const
 {
     const NoteDataByIndex & index = m_data.get<ByIndex>();
 
-    auto it = std::lower_bound(index.begin(), index.end(), item, NoteComparator(m_sortedColumn, m_sortOrder));
+    auto it = std::lower_bound(index.begin(), index.end(), item, itemComparator());
     if (it == index.end()) {
         return static_cast<int>(index.size());
     }
@@ -1727,129 +2891,466 @@ void NoteModel::updateNotebookData(const Notebook & notebook)
                                          : true);
     }
 
-    if (notebook.hasName()) {
-        notebookData.m_name = notebook.name();
+    if (notebook.hasName()) {
+        notebookData.m_name = notebook.name();
+    }
+
+    if (notebook.hasGuid()) {
+        notebookData.m_guid = notebook.guid();
+    }
+
+    NMDEBUG(QStringLiteral("Collected notebook data from notebook with local uid ") << notebook.localUid()
+            << QStringLiteral(": guid = ") << notebookData.m_guid << QStringLiteral("; name = ") << notebookData.m_name
+            << QStringLiteral(": can create notes = ") << (notebookData.m_canCreateNotes ? QStringLiteral("true") : QStringLiteral("false"))
+            << QStringLiteral(": can update notes = ") << (notebookData.m_canUpdateNotes ? QStringLiteral("true") : QStringLiteral("false")));
+
+    checkAddedNoteItemsPendingNotebookData(notebook.localUid(), notebookData);
+}
+
+void NoteModel::updateTagData(const Tag & tag)
+{
+    NMDEBUG(QStringLiteral("NoteModel::updateTagData: tag local uid = ") << tag.localUid());
+
+    // NOTE: the note items get their tag guids from the notes themselves so the guids only need to be
+    // refreshed within the items when the guid of the already known tag changes
+    bool newTagData = !m_tagDataByTagLocalUid.contains(tag.localUid());
+    TagData & tagData = m_tagDataByTagLocalUid[tag.localUid()];
+
+    bool guidChanged = false;
+    if (tag.hasGuid()) {
+        guidChanged = !newTagData && (tagData.m_guid != tag.guid());
+        tagData.m_guid = tag.guid();
+    }
+    else {
+        guidChanged = !tagData.m_guid.isEmpty();
+        tagData.m_guid.resize(0);
+    }
+
+    // NOTE: the note items refer to the tag's name by id so the rename only touches the tag name table
+    qint32 tagNameId = m_tagNameTable.idForTagLocalUid(tag.localUid());
+    bool nameChanged = m_tagNameTable.setName(tagNameId, (tag.hasName() ? tag.name() : QString()));
+
+    if (!m_tagLocalUidToNoteLocalUid.contains(tag.localUid())) {
+        return;
+    }
+
+    if (guidChanged) {
+        updateTagGuidsForNotes(tag.localUid());
+    }
+
+    if (nameChanged && !m_data.empty()) {
+        QModelIndex modelIndexFrom = createIndex(0, Columns::TagNameList);
+        QModelIndex modelIndexTo = createIndex(static_cast<int>(m_data.size()) - 1, Columns::TagNameList);
+        Q_EMIT dataChanged(modelIndexFrom, modelIndexTo);
+    }
+}
+
+void NoteModel::updateTagGuidsForNotes(const QString & tagLocalUid)
+{
+    NMDEBUG(QStringLiteral("NoteModel::updateTagGuidsForNotes: tag local uid = ") << tagLocalUid);
+
+    NoteDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
+
+    QStringList affectedNotesLocalUids = m_tagLocalUidToNoteLocalUid.values(tagLocalUid);
+    for(auto it = affectedNotesLocalUids.constBegin(), end = affectedNotesLocalUids.constEnd(); it != end; ++it)
+    {
+        auto noteItemIt = localUidIndex.find(*it);
+        if (Q_UNLIKELY(noteItemIt == localUidIndex.end())) {
+            NMDEBUG(QStringLiteral("Can't find the note pointed to by a tag by local uid: "
+                                   "note local uid = ") << *it);
+            continue;
+        }
+
+        NoteModelItem item = *noteItemIt;
+        const QStringList & tagLocalUids = item.tagLocalUids();
+
+        QStringList tagGuids;
+        tagGuids.reserve(tagLocalUids.size());
+
+        for(auto tagLocalUidIt = tagLocalUids.constBegin(), tagLocalUidEnd = tagLocalUids.constEnd();
+            tagLocalUidIt != tagLocalUidEnd; ++tagLocalUidIt)
+        {
+            auto tagDataIt = m_tagDataByTagLocalUid.find(*tagLocalUidIt);
+            if ((tagDataIt != m_tagDataByTagLocalUid.end()) && !tagDataIt->m_guid.isEmpty()) {
+                tagGuids << tagDataIt->m_guid;
+            }
+        }
+
+        item.setTagGuids(m_stringPool.intern(tagGuids));
+        Q_UNUSED(localUidIndex.replace(noteItemIt, item))
+    }
+}
+
+void NoteModel::setNoteFavorited(const QString & noteLocalUid, const bool favorited)
+{
+    NoteDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
+    auto it = localUidIndex.find(noteLocalUid);
+    if (Q_UNLIKELY(it == localUidIndex.end())) {
+        REPORT_ERROR(QT_TR_NOOP("Can't favorite/unfavorite the note: internal error, the note "
+                                "to be favorited/unfavorited was not found within the model"));
+        return;
+    }
+
+    const NoteModelItem & item = *it;
+
+    if (favorited == item.isFavorited()) {
+        NMDEBUG(QStringLiteral("Favorited flag's value hasn't changed"));
+        return;
+    }
+
+    NoteModelItem itemCopy(item);
+    itemCopy.setFavorited(favorited);
+
+    localUidIndex.replace(it, itemCopy);
+    updateNoteInLocalStorage(itemCopy);
+}
+
+bool NoteModel::shouldBatchNoteChanges() const
+{
+    return m_noteChangesBatchingEnabled || (m_noteChangesBatchDepth > 0);
+}
+
+void NoteModel::enqueueNoteAddedOrUpdated(const Note & note)
+{
+    NMTRACE(QStringLiteral("NoteModel::enqueueNoteAddedOrUpdated: note local uid = ") << note.localUid());
+
+    ++m_numBatchedNoteChanges;
+
+    if (m_pendingAddedOrUpdatedNotes.contains(note.localUid()) ||
+        m_pendingRemovedNoteLocalUids.remove(note.localUid()))
+    {
+        ++m_numCoalescedNoteChanges;
+    }
+
+    m_pendingAddedOrUpdatedNotes[note.localUid()] = note;
+
+    if ((m_noteChangesBatchDepth == 0) && !m_noteChangesBatchTimer.isActive()) {
+        m_noteChangesBatchTimer.start(NOTE_MODEL_CHANGES_BATCH_DELAY, this);
+    }
+}
+
+void NoteModel::enqueueNoteRemoval(const QString & noteLocalUid)
+{
+    NMTRACE(QStringLiteral("NoteModel::enqueueNoteRemoval: note local uid = ") << noteLocalUid);
+
+    ++m_numBatchedNoteChanges;
+
+    if ((m_pendingAddedOrUpdatedNotes.remove(noteLocalUid) != 0) ||
+        m_pendingRemovedNoteLocalUids.contains(noteLocalUid))
+    {
+        ++m_numCoalescedNoteChanges;
+    }
+
+    Q_UNUSED(m_pendingRemovedNoteLocalUids.insert(noteLocalUid))
+
+    if ((m_noteChangesBatchDepth == 0) && !m_noteChangesBatchTimer.isActive()) {
+        m_noteChangesBatchTimer.start(NOTE_MODEL_CHANGES_BATCH_DELAY, this);
+    }
+}
+
+void NoteModel::applyPendingNoteChanges()
+{
+    m_noteChangesBatchTimer.stop();
+
+    if (m_pendingAddedOrUpdatedNotes.isEmpty() && m_pendingRemovedNoteLocalUids.isEmpty()) {
+        return;
+    }
+
+    NMDEBUG(QStringLiteral("NoteModel::applyPendingNoteChanges: ") << m_pendingAddedOrUpdatedNotes.size()
+            << QStringLiteral(" added or updated notes, ") << m_pendingRemovedNoteLocalUids.size()
+            << QStringLiteral(" removed notes; batched ") << m_numBatchedNoteChanges
+            << QStringLiteral(" note changes so far, coalesced ") << m_numCoalescedNoteChanges);
+
+    ++m_numAppliedNoteChangesBatches;
+
+    QHash<QString, Note> addedOrUpdatedNotes;
+    addedOrUpdatedNotes.swap(m_pendingAddedOrUpdatedNotes);
+
+    QSet<QString> removedNoteLocalUids;
+    removedNoteLocalUids.swap(m_pendingRemovedNoteLocalUids);
+
+    const NoteDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
+
+    std::vector<NoteModelItem> newItems;
+    std::vector<NoteModelItem> updatedItems;
+
+    for(auto it = addedOrUpdatedNotes.constBegin(), end = addedOrUpdatedNotes.constEnd(); it != end; ++it)
+    {
+        if (!updateSortKeyIndex(it.value())) {
+            // The note doesn't belong to the window of the sort key index
+            Q_UNUSED(removedNoteLocalUids.insert(it.key()))
+            continue;
+        }
+
+        NoteModelItem item;
+        if (!prepareNoteItem(it.value(), item)) {
+            continue;
+        }
+
+        bool itemExists = (localUidIndex.find(item.localUid()) != localUidIndex.end());
+        bool itemIncluded = itemMatchesIncludedNotes(item);
+
+        if (!itemExists)
+        {
+            if (itemIncluded) {
+                newItems.push_back(item);
+            }
+        }
+        else if (!itemIncluded)
+        {
+            Q_UNUSED(removedNoteLocalUids.insert(item.localUid()))
+        }
+        else
+        {
+            updatedItems.push_back(item);
+        }
+    }
+
+    removeItemsByLocalUids(removedNoteLocalUids);
+    updateExistingItems(updatedItems);
+    insertNewItems(newItems);
+}
+
+void NoteModel::removeItemsByLocalUids(const QSet<QString> & localUids)
+{
+    NoteDataByIndex & index = m_data.get<ByIndex>();
+    const NoteDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
+
+    std::vector<int> rows;
+    rows.reserve(static_cast<size_t>(localUids.size()));
+
+    for(auto it = localUids.constBegin(), end = localUids.constEnd(); it != end; ++it)
+    {
+        auto itemIt = localUidIndex.find(*it);
+        if (itemIt == localUidIndex.end()) {
+            continue;
+        }
+
+        auto indexIt = m_data.project<ByIndex>(itemIt);
+        rows.push_back(static_cast<int>(std::distance(index.begin(), indexIt)));
+        m_pThumbnailCache->remove(*it);
+        m_collationKeyCache.remove(*it);
     }
 
-    if (notebook.hasGuid()) {
-        notebookData.m_guid = notebook.guid();
+    if (rows.empty()) {
+        return;
     }
 
-    NMDEBUG(QStringLiteral("Collected notebook data from notebook with local uid ") << notebook.localUid()
-            << QStringLiteral(": guid = ") << notebookData.m_guid << QStringLiteral("; name = ") << notebookData.m_name
-            << QStringLiteral(": can create notes = ") << (notebookData.m_canCreateNotes ? QStringLiteral("true") : QStringLiteral("false"))
-            << QStringLiteral(": can update notes = ") << (notebookData.m_canUpdateNotes ? QStringLiteral("true") : QStringLiteral("false")));
+    NMDEBUG(QStringLiteral("Removing ") << rows.size() << QStringLiteral(" note items"));
 
-    checkAddedNoteItemsPendingNotebookData(notebook.localUid(), notebookData);
+    // Removing the contiguous ranges of rows starting from the last one so that the rows yet to be removed stay intact
+    std::sort(rows.begin(), rows.end(), std::greater<int>());
+
+    size_t i = 0;
+    const size_t numRows = rows.size();
+    while(i < numRows)
+    {
+        int lastRow = rows[i];
+        int firstRow = lastRow;
+
+        ++i;
+        while((i < numRows) && (rows[i] == firstRow - 1)) {
+            firstRow = rows[i];
+            ++i;
+        }
+
+        beginRemoveRows(QModelIndex(), firstRow, lastRow);
+        Q_UNUSED(index.erase(index.begin() + firstRow, index.begin() + lastRow + 1))
+        endRemoveRows();
+    }
 }
 
-void NoteModel::updateTagData(const Tag & tag)
+void NoteModel::insertNewItems(std::vector<NoteModelItem> & items)
 {
-    NMDEBUG(QStringLiteral("NoteModel::updateTagData: tag local uid = ") << tag.localUid());
+    if (items.empty()) {
+        return;
+    }
 
-    bool hasName = tag.hasName();
-    bool hasGuid = tag.hasGuid();
+    NMDEBUG(QStringLiteral("Inserting ") << items.size() << QStringLiteral(" new note items"));
 
-    TagData & tagData = m_tagDataByTagLocalUid[tag.localUid()];
+    NoteComparator comparator = itemComparator();
+    std::stable_sort(items.begin(), items.end(), comparator);
 
-    if (hasName) {
-        tagData.m_name = tag.name();
-    }
-    else {
-        tagData.m_name.resize(0);
+    NoteDataByIndex & index = m_data.get<ByIndex>();
+
+    std::vector<int> rows;
+    rows.reserve(items.size());
+    for(auto it = items.begin(), end = items.end(); it != end; ++it) {
+        auto positionIt = std::lower_bound(index.begin(), index.end(), *it, comparator);
+        rows.push_back(static_cast<int>(std::distance(index.begin(), positionIt)));
     }
 
-    if (hasGuid) {
-        tagData.m_guid = tag.guid();
+    // The new items falling into the same position within the existing rows form a contiguous range;
+    // inserting such ranges starting from the last one so that the positions of the others stay intact
+    size_t end = items.size();
+    while(end > 0)
+    {
+        size_t begin = end - 1;
+        while((begin > 0) && (rows[begin - 1] == rows[end - 1])) {
+            --begin;
+        }
+
+        int row = rows[begin];
+        int numInsertedRows = static_cast<int>(end - begin);
+
+        beginInsertRows(QModelIndex(), row, row + numInsertedRows - 1);
+        index.insert(index.begin() + row, items.begin() + static_cast<std::ptrdiff_t>(begin),
+                     items.begin() + static_cast<std::ptrdiff_t>(end));
+        endInsertRows();
+
+        end = begin;
     }
-    else {
-        tagData.m_guid.resize(0);
+
+    if (m_listingMode == ListingMode::Windowed)
+    {
+        for(auto it = items.begin(), itemsEnd = items.end(); it != itemsEnd; ++it) {
+            Q_UNUSED(m_noteLocalUidsWithBodies.insert(it->localUid()))
+        }
     }
+}
 
-    auto noteIt = m_tagLocalUidToNoteLocalUid.find(tag.localUid());
-    if (noteIt == m_tagLocalUidToNoteLocalUid.end()) {
+void NoteModel::updateExistingItems(const std::vector<NoteModelItem> & items)
+{
+    if (items.empty()) {
         return;
     }
 
+    NMDEBUG(QStringLiteral("Updating ") << items.size() << QStringLiteral(" note items"));
+
+    NoteDataByIndex & index = m_data.get<ByIndex>();
     NoteDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
 
-    QStringList affectedNotesLocalUids;
-    while(noteIt != m_tagLocalUidToNoteLocalUid.end())
+    std::vector<int> rows;
+    rows.reserve(items.size());
+
+    for(auto it = items.begin(), end = items.end(); it != end; ++it)
     {
-        if (noteIt.key() != tag.localUid()) {
-            break;
+        auto itemIt = localUidIndex.find(it->localUid());
+        if (Q_UNLIKELY(itemIt == localUidIndex.end())) {
+            continue;
         }
 
-        affectedNotesLocalUids << noteIt.value();
-        ++noteIt;
+        Q_UNUSED(localUidIndex.replace(itemIt, *it))
+
+        auto indexIt = m_data.project<ByIndex>(itemIt);
+        rows.push_back(static_cast<int>(std::distance(index.begin(), indexIt)));
+
+        if (m_listingMode == ListingMode::Windowed) {
+            Q_UNUSED(m_noteLocalUidsWithBodies.insert(it->localUid()))
+        }
     }
 
-    NMDEBUG("Affected notes local uids: " << affectedNotesLocalUids.join(QStringLiteral(", ")));
-    for(auto it = affectedNotesLocalUids.constBegin(), end = affectedNotesLocalUids.constEnd(); it != end; ++it)
+    std::sort(rows.begin(), rows.end());
+
+    // NOTE: all the rows but the updated ones are still sorted so only the updated rows need to be checked
+    NoteComparator comparator = itemComparator();
+    const int numItems = static_cast<int>(m_data.size());
+    bool sortingBroken = false;
+    for(auto it = rows.begin(), end = rows.end(); it != end; ++it)
     {
-        auto noteItemIt = localUidIndex.find(*it);
-        if (Q_UNLIKELY(noteItemIt == localUidIndex.end())) {
-            NMDEBUG(QStringLiteral("Can't find the note pointed to by a tag by local uid: "
-                                   "note local uid = ") << *it);
-            continue;
+        int row = *it;
+        auto indexIt = index.begin() + row;
+        if (((row > 0) && comparator(*indexIt, *(indexIt - 1))) ||
+            (((row + 1) < numItems) && comparator(*(indexIt + 1), *indexIt)))
+        {
+            sortingBroken = true;
+            break;
         }
+    }
 
-        NoteModelItem item = *noteItemIt;
-        QStringList tagLocalUids = item.tagLocalUids();
+    if (!sortingBroken) {
+        emitDataChangedForRows(rows);
+        return;
+    }
 
-        // Need to refresh all the tag names and guids because it is generally unknown which particular tag was updated
-        item.setTagNameList(QStringList());
-        item.setTagGuids(QStringList());
+    if (rows.size() == 1) {
+        emitDataChangedForRows(rows);
+        updateItemRowWithRespectToSorting(*(index.begin() + rows.front()));
+        return;
+    }
 
-        for(auto tagLocalUidIt = tagLocalUids.begin(), tagLocalUidEnd = tagLocalUids.end(); tagLocalUidIt != tagLocalUidEnd; ++tagLocalUidIt)
-        {
-            auto tagDataIt = m_tagDataByTagLocalUid.find(*tagLocalUidIt);
-            if (tagDataIt == m_tagDataByTagLocalUid.end()) {
-                NMTRACE(QStringLiteral("Still no tag data for tag with local uid ") << *tagLocalUidIt);
-                continue;
-            }
+    NMDEBUG(QStringLiteral("Re-positioning the updated note items with respect to sorting"));
 
-            const TagData & tagData = tagDataIt.value();
+    Q_EMIT layoutAboutToBeChanged();
 
-            if (!tagData.m_name.isEmpty()) {
-                item.addTagName(tagData.m_name);
-            }
+    QModelIndexList persistentIndices = persistentIndexList();
+    QVector<std::pair<QString, int> > localUidsToUpdateWithColumns = persistentIndexLocalUids(persistentIndices);
 
-            if (!tagData.m_guid.isEmpty()) {
-                item.addTagGuid(tagData.m_guid);
-            }
+    // The items which were not updated are still sorted so it's enough to sort the updated ones and merge the two
+    std::vector<boost::reference_wrapper<const NoteModelItem> > unchangedItems;
+    unchangedItems.reserve(m_data.size() - rows.size());
+    std::vector<boost::reference_wrapper<const NoteModelItem> > updatedItems;
+    updatedItems.reserve(rows.size());
+
+    auto rowIt = rows.begin();
+    for(int row = 0; row < numItems; ++row)
+    {
+        const NoteModelItem & item = *(index.begin() + row);
+        if ((rowIt != rows.end()) && (*rowIt == row)) {
+            updatedItems.push_back(boost::reference_wrapper<const NoteModelItem>(item));
+            ++rowIt;
         }
+        else {
+            unchangedItems.push_back(boost::reference_wrapper<const NoteModelItem>(item));
+        }
+    }
 
-        Q_UNUSED(localUidIndex.replace(noteItemIt, item))
+    std::sort(updatedItems.begin(), updatedItems.end(), comparator);
+
+    std::vector<boost::reference_wrapper<const NoteModelItem> > mergedItems;
+    mergedItems.reserve(m_data.size());
+    std::merge(unchangedItems.begin(), unchangedItems.end(), updatedItems.begin(), updatedItems.end(),
+               std::back_inserter(mergedItems), comparator);
+
+    index.rearrange(mergedItems.begin());
+
+    updatePersistentIndices(persistentIndices, localUidsToUpdateWithColumns);
+
+    Q_EMIT layoutChanged();
 
-        QModelIndex modelIndex = indexForLocalUid(item.localUid());
-        modelIndex = createIndex(modelIndex.row(), Columns::TagNameList);
-        Q_EMIT dataChanged(modelIndex, modelIndex);
+    rows.clear();
+    for(auto it = updatedItems.begin(), end = updatedItems.end(); it != end; ++it) {
+        QModelIndex modelIndex = indexForLocalUid(it->get().localUid());
+        rows.push_back(modelIndex.row());
     }
+
+    emitDataChangedForRows(rows);
 }
 
-void NoteModel::setNoteFavorited(const QString & noteLocalUid, const bool favorited)
+void NoteModel::emitDataChangedForRows(std::vector<int> & rows)
 {
-    NoteDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
-    auto it = localUidIndex.find(noteLocalUid);
-    if (Q_UNLIKELY(it == localUidIndex.end())) {
-        REPORT_ERROR(QT_TR_NOOP("Can't favorite/unfavorite the note: internal error, the note "
-                                "to be favorited/unfavorited was not found within the model"));
-        return;
-    }
+    std::sort(rows.begin(), rows.end());
 
-    const NoteModelItem & item = *it;
+    size_t i = 0;
+    const size_t numRows = rows.size();
+    while(i < numRows)
+    {
+        int firstRow = rows[i];
+        int lastRow = firstRow;
 
-    if (favorited == item.isFavorited()) {
-        NMDEBUG(QStringLiteral("Favorited flag's value hasn't changed"));
-        return;
-    }
+        ++i;
+        while((i < numRows) && (rows[i] <= lastRow + 1)) {
+            lastRow = rows[i];
+            ++i;
+        }
 
-    NoteModelItem itemCopy(item);
-    itemCopy.setFavorited(favorited);
+        QModelIndex modelIndexFrom = createIndex(firstRow, Columns::CreationTimestamp);
+        QModelIndex modelIndexTo = createIndex(lastRow, Columns::HasResources);
+        Q_EMIT dataChanged(modelIndexFrom, modelIndexTo);
+    }
+}
 
-    localUidIndex.replace(it, itemCopy);
-    updateNoteInLocalStorage(itemCopy);
+bool NoteModel::itemMatchesIncludedNotes(const NoteModelItem & item) const
+{
+    switch(m_includedNotes)
+    {
+    case IncludedNotes::Deleted:
+        return (item.deletionTimestamp() >= 0);
+    case IncludedNotes::NonDeleted:
+        return (item.deletionTimestamp() < 0);
+    default:
+        return true;
+    }
 }
 
 void NoteModel::checkAddedNoteItemsPendingNotebookData(const QString & notebookLocalUid, const NotebookData & notebookData)
@@ -1871,14 +3372,35 @@ void NoteModel::onNoteAddedOrUpdated(const Note & note)
     NMDEBUG(QStringLiteral("NoteModel::onNoteAddedOrUpdated: note local uid = ") << note.localUid());
     NMTRACE(note);
 
+    Q_UNUSED(m_restoredLocalUidsPendingReconciliation.remove(note.localUid()))
+
+    if (!updateSortKeyIndex(note))
+    {
+        NMDEBUG(QStringLiteral("The note doesn't belong to the window of the sort key index"));
+
+        const NoteDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
+        if (localUidIndex.find(note.localUid()) != localUidIndex.end()) {
+            removeItemByLocalUid(note.localUid());
+        }
+
+        return;
+    }
+
+    NoteModelItem item;
+    if (prepareNoteItem(note, item)) {
+        addOrUpdatePreparedNoteItem(item);
+    }
+}
+
+bool NoteModel::prepareNoteItem(const Note & note, NoteModelItem & item)
+{
     m_cache.put(note.localUid(), note);
 
     if (!note.hasNotebookLocalUid()) {
         NMWARNING(QStringLiteral("Skipping the note not having the notebook local uid: ") << note);
-        return;
+        return false;
     }
 
-    NoteModelItem item;
     noteToItem(note, item);
 
     auto notebookIt = m_notebookDataByNotebookLocalUid.find(item.notebookLocalUid());
@@ -1915,11 +3437,18 @@ void NoteModel::onNoteAddedOrUpdated(const Note & note)
             NMTRACE(QStringLiteral("The request to find notebook for this note has already been sent"));
         }
 
-        return;
+        return false;
     }
 
     const NotebookData & notebookData = notebookIt.value();
-    addOrUpdateNoteItem(item, notebookData);
+    setNotebookDataForItem(item, notebookData);
+    return true;
+}
+
+void NoteModel::setNotebookDataForItem(NoteModelItem & item, const NotebookData & notebookData)
+{
+    item.setNotebookName(notebookData.m_name);
+    findTagNamesForItem(item);
 }
 
 void NoteModel::addOrUpdateNoteItem(NoteModelItem & item, const NotebookData & notebookData)
@@ -1928,9 +3457,12 @@ void NoteModel::addOrUpdateNoteItem(NoteModelItem & item, const NotebookData & n
             << QStringLiteral(", notebook local uid = ") << item.notebookLocalUid()
             << QStringLiteral(", notebook name = ") << notebookData.m_name);
 
-    item.setNotebookName(notebookData.m_name);
-    findTagNamesForItem(item);
+    setNotebookDataForItem(item, notebookData);
+    addOrUpdatePreparedNoteItem(item);
+}
 
+void NoteModel::addOrUpdatePreparedNoteItem(const NoteModelItem & item)
+{
     NoteDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
     auto it = localUidIndex.find(item.localUid());
     if (it == localUidIndex.end())
@@ -1962,6 +3494,10 @@ void NoteModel::addOrUpdateNoteItem(NoteModelItem & item, const NotebookData & n
         Q_UNUSED(localUidIndex.insert(item))
         endInsertRows();
 
+        if (m_listingMode == ListingMode::Windowed) {
+            Q_UNUSED(m_noteLocalUidsWithBodies.insert(item.localUid()))
+        }
+
         updateItemRowWithRespectToSorting(item);
     }
     else
@@ -2017,6 +3553,10 @@ void NoteModel::addOrUpdateNoteItem(NoteModelItem & item, const NotebookData & n
             Q_UNUSED(localUidIndex.replace(it, item))
             Q_EMIT dataChanged(modelIndexFrom, modelIndexTo);
 
+            if (m_listingMode == ListingMode::Windowed) {
+                Q_UNUSED(m_noteLocalUidsWithBodies.insert(item.localUid()))
+            }
+
             updateItemRowWithRespectToSorting(item);
         }
     }
@@ -2027,10 +3567,18 @@ void NoteModel::findTagNamesForItem(NoteModelItem & item)
     NMDEBUG(QStringLiteral("NoteModel::findTagNamesForItem: ") << item);
 
     const QStringList & tagLocalUids = item.tagLocalUids();
+
+    QVector<qint32> tagNameIds;
+    tagNameIds.reserve(tagLocalUids.size());
+
     for(auto it = tagLocalUids.constBegin(), end = tagLocalUids.constEnd(); it != end; ++it)
     {
         const QString & tagLocalUid = *it;
 
+        // NOTE: the tag gets the id even if its name is not known yet; the name is set into the table
+        // once the tag is found
+        tagNameIds << m_tagNameTable.idForTagLocalUid(tagLocalUid);
+
         bool alreadyGotNoteLocalUidMapped = false;
 
         auto tagToNoteIt = m_tagLocalUidToNoteLocalUid.find(tagLocalUid);
@@ -2057,8 +3605,7 @@ void NoteModel::findTagNamesForItem(NoteModelItem & item)
         auto tagDataIt = m_tagDataByTagLocalUid.find(tagLocalUid);
         if (tagDataIt != m_tagDataByTagLocalUid.end()) {
             NMTRACE(QStringLiteral("Found tag data for tag local uid ") << tagLocalUid
-                    << QStringLiteral(": tag name = ") << tagDataIt->m_name);
-            item.addTagName(tagDataIt->m_name);
+                    << QStringLiteral(": tag name = ") << m_tagNameTable.name(tagNameIds.back()));
             continue;
         }
 
@@ -2080,6 +3627,8 @@ void NoteModel::findTagNamesForItem(NoteModelItem & item)
                 << QStringLiteral(", request id = ") << requestId);
         Q_EMIT findTag(tag, requestId);
     }
+
+    item.setTagNameIds(tagNameIds);
 }
 
 // WARNING: this method assumes the iterator passed to it is not end()
@@ -2103,9 +3652,9 @@ void NoteModel::moveNoteToNotebookImpl(NoteDataByLocalUid::iterator it, const No
         return;
     }
 
-    item.setNotebookLocalUid(notebook.localUid());
+    item.setNotebookLocalUid(m_stringPool.intern(notebook.localUid()));
     item.setNotebookName(notebook.hasName() ? notebook.name() : QString());
-    item.setNotebookGuid(notebook.hasGuid() ? notebook.guid() : QString());
+    item.setNotebookGuid(notebook.hasGuid() ? m_stringPool.intern(notebook.guid()) : QString());
 
     item.setDirty(true);
     item.setModificationTimestamp(QDateTime::currentMSecsSinceEpoch());
@@ -2130,11 +3679,24 @@ void NoteModel::checkAndNotifyAllNotesListed()
         return;
     }
 
-    if (!m_listNotesRequestId.isNull()) {
+    if (m_listNotesPipeline.numRequestsInFlight() != 0) {
         NMDEBUG(QStringLiteral("Not all notes have been listed yet"));
         return;
     }
 
+    // In Windowed mode the notes beyond the first window are listed on demand, all notes are considered listed
+    // once the first window is
+    if (m_sortKeyIndexState == SortKeyIndexState::Building) {
+        NMDEBUG(QStringLiteral("The sort key index is not built yet"));
+        return;
+    }
+
+    if (!m_findNoteForWindowRequestIdByNoteLocalUid.empty()) {
+        NMDEBUG(QStringLiteral("Not all notes of the window have been found yet, currently waiting for ")
+                << m_findNoteForWindowRequestIdByNoteLocalUid.size() << QStringLiteral(" notes to be found"));
+        return;
+    }
+
     if (!m_findNotebookRequestForNotebookLocalUid.empty()) {
         NMDEBUG(QStringLiteral("Not all notebooks for notes have been found yet, currently waiting for ")
                 << m_findNotebookRequestForNotebookLocalUid.size() << QStringLiteral(" notebooks to be found"));
@@ -2148,6 +3710,17 @@ void NoteModel::checkAndNotifyAllNotesListed()
     }
 
     NMDEBUG(QStringLiteral("All the necessary data items were listed"));
+
+    if (!m_restoredLocalUidsPendingReconciliation.isEmpty())
+    {
+        NMDEBUG(QStringLiteral("Removing ") << m_restoredLocalUidsPendingReconciliation.size()
+                << QStringLiteral(" restored note items which no longer exist in the local storage"));
+
+        QSet<QString> localUids = m_restoredLocalUidsPendingReconciliation;
+        m_restoredLocalUidsPendingReconciliation.clear();
+        removeItemsByLocalUids(localUids);
+    }
+
     m_allNotesListed = true;
     Q_EMIT notifyAllNotesListed();
 }
@@ -2161,11 +3734,11 @@ void NoteModel::noteToItem(const Note & note, NoteModelItem & item)
     }
 
     if (note.hasNotebookGuid()) {
-        item.setNotebookGuid(note.notebookGuid());
+        item.setNotebookGuid(m_stringPool.intern(note.notebookGuid()));
     }
 
     if (note.hasNotebookLocalUid()) {
-        item.setNotebookLocalUid(note.notebookLocalUid());
+        item.setNotebookLocalUid(m_stringPool.intern(note.notebookLocalUid()));
     }
 
     if (note.hasTitle()) {
@@ -2173,36 +3746,19 @@ void NoteModel::noteToItem(const Note & note, NoteModelItem & item)
     }
 
     if (note.hasContent()) {
-        QString previewText = note.plainText();
-        previewText.truncate(NOTE_PREVIEW_TEXT_SIZE);
-        item.setPreviewText(previewText);
+        // NOTE: unlike truncate, left doesn't keep the capacity of the whole plain text
+        item.setPreviewText(note.plainText().left(NOTE_PREVIEW_TEXT_SIZE));
     }
 
     item.setThumbnailData(note.thumbnailData());
 
     if (note.hasTagLocalUids())
     {
-        const QStringList & tagLocalUids = note.tagLocalUids();
-        item.setTagLocalUids(tagLocalUids);
-
-        QStringList tagNames;
-        tagNames.reserve(tagLocalUids.size());
-
-        for(auto it = tagLocalUids.constBegin(), end = tagLocalUids.constEnd(); it != end; ++it)
-        {
-            auto tagIt = m_tagDataByTagLocalUid.find(*it);
-            if (tagIt != m_tagDataByTagLocalUid.end()) {
-                const TagData & tagData = tagIt.value();
-                tagNames << tagData.m_name;
-            }
-        }
-
-        item.setTagNameList(tagNames);
+        item.setTagLocalUids(m_stringPool.intern(note.tagLocalUids()));
     }
 
     if (note.hasTagGuids()) {
-        const QStringList tagGuids = note.tagGuids();
-        item.setTagGuids(tagGuids);
+        item.setTagGuids(m_stringPool.intern(note.tagGuids()));
     }
 
     if (note.hasCreationTimestamp()) {
@@ -2238,6 +3794,11 @@ void NoteModel::noteToItem(const Note & note, NoteModelItem & item)
         item.setCanSharePublicly(true);
     }
 
+    item.setSizeInBytes(noteSizeInBytes(note));
+}
+
+quint64 NoteModel::noteSizeInBytes(const Note & note)
+{
     qint64 sizeInBytes = 0;
     if (note.hasContent()) {
         sizeInBytes += note.content().size();
@@ -2265,7 +3826,131 @@ void NoteModel::noteToItem(const Note & note, NoteModelItem & item)
     }
 
     sizeInBytes = std::max(qint64(0), sizeInBytes);
-    item.setSizeInBytes(static_cast<quint64>(sizeInBytes));
+    return static_cast<quint64>(sizeInBytes);
+}
+
+bool NoteModel::columnHasCollatedStrings(const Columns::type column)
+{
+    return ((column == Columns::Title) || (column == Columns::PreviewText) || (column == Columns::NotebookName));
+}
+
+const QString & NoteModel::collatedStringForItem(const NoteModelItem & item, const Columns::type column)
+{
+    if (column == Columns::NotebookName) {
+        return item.notebookName();
+    }
+
+    return (item.title().isEmpty() ? item.previewText() : item.title());
+}
+
+bool NoteModel::sortedColumnDataEqual(const NoteModelItem & lhs, const NoteModelItem & rhs,
+                                      const Columns::type column)
+{
+    switch(column)
+    {
+    case Columns::Title:
+    case Columns::PreviewText:
+        {
+            const QString & leftTitleOrPreview = (lhs.title().isEmpty() ? lhs.previewText() : lhs.title());
+            const QString & rightTitleOrPreview = (rhs.title().isEmpty() ? rhs.previewText() : rhs.title());
+            return (leftTitleOrPreview == rightTitleOrPreview);
+        }
+    case Columns::NotebookName:
+        return (lhs.notebookName() == rhs.notebookName());
+    default:
+        {
+            NoteComparator comparator(column, Qt::AscendingOrder);
+            return !comparator(lhs, rhs) && !comparator(rhs, lhs);
+        }
+    }
+}
+
+NoteModel::NoteComparator NoteModel::itemComparator() const
+{
+    NoteComparator comparator(m_sortedColumn, m_sortOrder, &m_collator);
+    if (columnHasCollatedStrings(m_sortedColumn)) {
+        comparator.setCollationKeyCache(&m_collationKeyCache);
+    }
+
+    return comparator;
+}
+
+void NoteModel::NoteSortTask::prepareItems(std::vector<NoteModelItem> & items)
+{
+    if (!NoteModel::columnHasCollatedStrings(m_sortedColumn) || items.empty()) {
+        return;
+    }
+
+    // NOTE: the collation keys are only computed for the duration of the sorting: comparing the keys
+    // is much cheaper than comparing the strings with the collator while keeping the keys for all items
+    // within the model would cost a lot of memory
+    m_sortKeys.reserve(items.size());
+    for(auto it = items.begin(), end = items.end(); it != end; ++it) {
+        m_sortKeys.push_back(m_collator.sortKey(NoteModel::collatedStringForItem(*it, m_sortedColumn)));
+    }
+
+    comparator().setSortKeys(&m_sortKeys, &items[0]);
+}
+
+NoteModel::CollationKeyCache::CollationKeyCache(const Collator & collator, const size_t maxSize) :
+    m_collator(collator),
+    m_entries(maxSize)
+{}
+
+CollationKey NoteModel::CollationKeyCache::sortKey(const NoteModelItem & item, const Columns::type column)
+{
+    const QString & str = NoteModel::collatedStringForItem(item, column);
+
+    const Entry * pEntry = m_entries.get(item.localUid());
+    if (pEntry && (pEntry->m_string == str)) {
+        return pEntry->m_key;
+    }
+
+    Entry entry;
+    entry.m_string = str;
+    entry.m_key = m_collator.sortKey(str);
+    m_entries.put(item.localUid(), entry);
+    return entry.m_key;
+}
+
+void NoteModel::CollationKeyCache::remove(const QString & localUid)
+{
+    Q_UNUSED(m_entries.remove(localUid))
+}
+
+void NoteModel::CollationKeyCache::clear()
+{
+    m_entries.clear();
+}
+
+bool NoteModel::SortKeyPositionComparator::operator()(const size_t lhs, const size_t rhs) const
+{
+    int compareResult = m_sortKeys[lhs].compare(m_sortKeys[rhs]);
+    if (m_sortOrder == Qt::AscendingOrder) {
+        return (compareResult < 0);
+    }
+    else {
+        return (compareResult > 0);
+    }
+}
+
+bool NoteModel::SortKeyIndexEntryComparator::operator()(const SortKeyIndexEntry & lhs,
+                                                        const SortKeyIndexEntry & rhs) const
+{
+    int compareResult = 0;
+    if (m_collatedStrings) {
+        compareResult = lhs.m_collationKey.compare(rhs.m_collationKey);
+    }
+    else if (lhs.m_value != rhs.m_value) {
+        compareResult = ((lhs.m_value < rhs.m_value) ? -1 : 1);
+    }
+
+    if (m_sortOrder == Qt::AscendingOrder) {
+        return (compareResult < 0);
+    }
+    else {
+        return (compareResult > 0);
+    }
 }
 
 bool NoteModel::NoteComparator::operator()(const NoteModelItem & lhs, const NoteModelItem & rhs) const
@@ -2288,42 +3973,24 @@ bool NoteModel::NoteComparator::operator()(const NoteModelItem & lhs, const Note
         greater = (lhs.deletionTimestamp() > rhs.deletionTimestamp());
         break;
     case Columns::Title:
-        {
-            QString leftTitleOrPreview = lhs.title();
-            if (leftTitleOrPreview.isEmpty()) {
-                leftTitleOrPreview = lhs.previewText();
-            }
-
-            QString rightTitleOrPreview = rhs.title();
-            if (rightTitleOrPreview.isEmpty()) {
-                rightTitleOrPreview = rhs.previewText();
-            }
-
-            int compareResult = leftTitleOrPreview.localeAwareCompare(rightTitleOrPreview);
-            less = (compareResult < 0);
-            greater = (compareResult > 0);
-            break;
-        }
     case Columns::PreviewText:
+    case Columns::NotebookName:
         {
-            QString leftTitleOrPreview = lhs.title();
-            if (leftTitleOrPreview.isEmpty()) {
-                leftTitleOrPreview = lhs.previewText();
+            int compareResult = 0;
+            if (m_pSortKeys) {
+                const CollationKey & lhsKey = (*m_pSortKeys)[static_cast<size_t>(&lhs - m_pFirstItem)];
+                const CollationKey & rhsKey = (*m_pSortKeys)[static_cast<size_t>(&rhs - m_pFirstItem)];
+                compareResult = lhsKey.compare(rhsKey);
             }
-
-            QString rightTitleOrPreview = rhs.title();
-            if (rightTitleOrPreview.isEmpty()) {
-                rightTitleOrPreview = rhs.previewText();
+            else if (m_pCollationKeyCache) {
+                compareResult = m_pCollationKeyCache->sortKey(lhs, m_sortedColumn).compare(
+                                    m_pCollationKeyCache->sortKey(rhs, m_sortedColumn));
+            }
+            else if (Q_LIKELY(m_pCollator)) {
+                compareResult = m_pCollator->compare(NoteModel::collatedStringForItem(lhs, m_sortedColumn),
+                                                     NoteModel::collatedStringForItem(rhs, m_sortedColumn));
             }
 
-            int compareResult = leftTitleOrPreview.localeAwareCompare(rightTitleOrPreview);
-            less = (compareResult < 0);
-            greater = (compareResult > 0);
-            break;
-        }
-    case Columns::NotebookName:
-        {
-            int compareResult = lhs.notebookName().localeAwareCompare(rhs.notebookName());
             less = (compareResult < 0);
             greater = (compareResult > 0);
             break;
@@ -20,8 +20,14 @@
 #define QUENTIER_MODELS_NOTE_MODEL_H
 
 #include "NoteModelItem.h"
+#include "StringPool.h"
+#include "TagNameTable.h"
+#include "Collator.h"
+#include "ParallelSort.h"
+#include "NoteThumbnailCache.h"
 #include "NoteCache.h"
 #include "NotebookCache.h"
+#include "ListRequestPipeline.hpp"
 #include <quentier/types/Note.h>
 #include <quentier/types/Tag.h>
 #include <quentier/types/Account.h>
@@ -30,7 +36,9 @@
 #include <QAbstractItemModel>
 #include <QUuid>
 #include <QSet>
+#include <QVector>
 #include <QMultiHash>
+#include <QBasicTimer>
 
 // NOTE: Workaround a bug in Qt4 which may prevent building with some boost versions
 #ifndef Q_MOC_RUN
@@ -58,14 +66,37 @@ public:
         };
     };
 
+    /**
+     * @brief The ListingMode struct defines how the model populates itself with notes from the local storage
+     *
+     * In Full mode the model lists all the notes from the local storage on startup; in Windowed mode
+     * it lists only enough notes to fill the visible window, in the order matching the current sorting,
+     * and lists more of them on demand via fetchMore; in Windowed mode the thumbnails are only kept
+     * for the notes near the viewport set via setViewportRows. If the local storage can't list notes
+     * in the order matching the current sorting, the model pages through all notes once to build the sorted
+     * index of their sort keys and then finds the notes of the window, and of each fetchMore, by that index;
+     * the sorting by notebook name is the exception: all notes are listed for it even in Windowed mode
+     */
+    struct ListingMode
+    {
+        enum type
+        {
+            Full = 0,
+            Windowed
+        };
+    };
+
     explicit NoteModel(const Account & account,  LocalStorageManagerAsync & localStorageManagerAsync,
                        NoteCache & noteCache, NotebookCache & notebookCache, QObject * parent = Q_NULLPTR,
-                       const IncludedNotes::type includedNotes = IncludedNotes::NonDeleted);
+                       const IncludedNotes::type includedNotes = IncludedNotes::NonDeleted,
+                       const ListingMode::type listingMode = ListingMode::Full);
     virtual ~NoteModel();
 
     const Account & account() const { return m_account; }
     void updateAccount(const Account & account);
 
+    ListingMode::type listingMode() const { return m_listingMode; }
+
     struct Columns
     {
         enum type {
@@ -92,6 +123,15 @@ public:
     const NoteModelItem * itemAtRow(const int row) const;
     const NoteModelItem * itemForIndex(const QModelIndex & index) const;
 
+    /**
+     * @brief thumbnail - returns the decoded thumbnail image for the note model item
+     *
+     * The decoded thumbnails are cached; if the thumbnail for the item is not within the cache yet,
+     * it is decoded in the background, null image is returned and dataChanged signal is emitted
+     * for the item's ThumbnailImage column once the thumbnail is ready
+     */
+    QImage thumbnail(const NoteModelItem & item) const;
+
     /**
      * @brief createNoteItem - attempts to create a new note within the notebook specified by local uid
      * @param notebookLocalUid - the local uid of notebook in which the new note is to be created
@@ -100,8 +140,72 @@ public:
      */
     QModelIndex createNoteItem(const QString & notebookLocalUid);
 
+    /**
+     * @brief allNotesListed - tells whether the model has listed all the notes it needs from the local storage
+     *
+     * In Full listing mode it means all the notes are within the model; in Windowed listing mode it means
+     * the notes of the first window have been listed, the rest of notes are not within the model until fetched
+     */
     bool allNotesListed() const { return m_allNotesListed; }
 
+    /**
+     * @return the notebook local uids of all the notes within the model by their local uids,
+     * complete only once all notes have been listed in Full listing mode
+     */
+    QHash<QString, QString> notebookLocalUidsByNoteLocalUids() const;
+
+    /**
+     * @return the tag local uids of all the notes within the model having tags by the notes' local uids,
+     * complete only once all notes have been listed in Full listing mode
+     */
+    QHash<QString, QStringList> tagLocalUidsByNoteLocalUids() const;
+
+    /**
+     * @return the table through which the tag names of the note model items are resolved
+     */
+    const TagNameTable & tagNameTable() const { return m_tagNameTable; }
+
+    /**
+     * @brief saveSnapshot - writes all the model's note items into the snapshot file so that the next instance
+     * of the model for the same account could show them before they are listed from the local storage
+     *
+     * Only the model in Full listing mode can save the snapshot: in Windowed listing mode the model doesn't have
+     * all the notes and their bodies
+     *
+     * @param filePath - the path to the snapshot file
+     * @param errorDescription - the textual description of the error if the snapshot was not saved
+     * @return false if not all notes have been listed yet or if the snapshot could not be written
+     */
+    bool saveSnapshot(const QString & filePath, ErrorString & errorDescription) const;
+
+    /**
+     * @brief restoreFromSnapshot - fills the model with the note items from the snapshot file written by saveSnapshot
+     *
+     * The restored items are reconciled with the notes being listed from the local storage: they are updated
+     * as the corresponding notes are listed and the ones not listed by the end of the listing are removed
+     * from the model before notifyAllNotesListed is emitted
+     *
+     * @param filePath - the path to the snapshot file
+     * @param errorDescription - the textual description of the error if the snapshot was not restored
+     * @return false if the model is not in Full listing mode, already has some notes or if the snapshot
+     * could not be read
+     */
+    bool restoreFromSnapshot(const QString & filePath, ErrorString & errorDescription);
+
+    /**
+     * @brief setViewportRows - informs the model which rows are currently visible within the view
+     *
+     * In Windowed listing mode the model keeps the thumbnails only for the rows within the viewport;
+     * for the other rows the thumbnails are released and then fetched from the local storage again
+     * when the rows get into the viewport. The preview texts are kept for all rows since the model sorts
+     * by them. In Full listing mode this method does nothing.
+     *
+     * @param rows - the model's rows visible within the view, including the margin around the visible ones
+     * if the view wants the thumbnails to be ready before the rows get visible; as the view might show
+     * the model's rows through a proxy model, the rows don't need to be contiguous or ordered
+     */
+    void setViewportRows(const QVector<int> & rows);
+
     /**
      * @brief deleteNote - attempts to mark the note with the specified local uid as deleted.
      *
@@ -148,6 +252,48 @@ public:
      */
     void unfavoriteNote(const QString & noteLocalUid);
 
+    /**
+     * @brief setNoteChangesBatchingEnabled - enables or disables the batching of note changes coming from
+     * the local storage
+     *
+     * When batching is enabled, the notes added, updated and expunged by anyone but the model itself are not
+     * applied to the model right away but accumulated for a short period of time; the changes of the same note
+     * within this period are merged and then all the changes are applied at once with coalesced model signals:
+     * single signal per contiguous range of removed, inserted or changed rows and at most one layout change
+     * for all the rows moved due to sorting
+     */
+    void setNoteChangesBatchingEnabled(const bool enabled);
+    bool noteChangesBatchingEnabled() const { return m_noteChangesBatchingEnabled; }
+
+    /**
+     * @brief beginNoteChangesBatch - starts accumulating the note changes coming from the local storage
+     * until the matching @link endNoteChangesBatch @endlink call regardless of whether the batching is enabled,
+     * i.e. for the duration of some bulk operation; the calls can be nested
+     */
+    void beginNoteChangesBatch();
+
+    /**
+     * @brief endNoteChangesBatch - finishes the batch of note changes started by @link beginNoteChangesBatch @endlink
+     * and applies the accumulated changes unless it was a nested batch
+     */
+    void endNoteChangesBatch();
+
+    /**
+     * @return the number of note changes coming from the local storage which were accumulated for batching
+     */
+    quint64 numBatchedNoteChanges() const { return m_numBatchedNoteChanges; }
+
+    /**
+     * @return the number of accumulated note changes which were merged with earlier changes of the same notes
+     * and thus didn't need to be applied separately
+     */
+    quint64 numCoalescedNoteChanges() const { return m_numCoalescedNoteChanges; }
+
+    /**
+     * @return the number of batches of note changes applied to the model
+     */
+    quint64 numAppliedNoteChangesBatches() const { return m_numAppliedNoteChangesBatches; }
+
 public:
     // QAbstractItemModel interface
     virtual Qt::ItemFlags flags(const QModelIndex & index) const Q_DECL_OVERRIDE;
@@ -166,6 +312,12 @@ public:
 
     virtual void sort(int column, Qt::SortOrder order) Q_DECL_OVERRIDE;
 
+    virtual bool canFetchMore(const QModelIndex & parent) const Q_DECL_OVERRIDE;
+    virtual void fetchMore(const QModelIndex & parent) Q_DECL_OVERRIDE;
+
+protected:
+    virtual void timerEvent(QTimerEvent * pEvent) Q_DECL_OVERRIDE;
+
 Q_SIGNALS:
     void notifyError(ErrorString errorDescription);
 
@@ -217,16 +369,53 @@ private Q_SLOTS:
     void onUpdateTagComplete(Tag tag, QUuid requestId);
     void onExpungeTagComplete(Tag tag, QStringList expungedChildTagLocalUids, QUuid requestId);
 
+    void onThumbnailReady(QString noteLocalUid);
+
+    void onSortTaskFinished();
+
 private:
     void createConnections(LocalStorageManagerAsync & localStorageManagerAsync);
     void requestNotesList();
 
+    // Returns false if the local storage can't list the notes in the order corresponding to the current sorting
+    bool listNotesOrderForSortedColumn(LocalStorageManager::ListNotesOrder::type & order) const;
+    void resetWindowedListing();
+
+    void updateNoteBodiesForViewport();
+    void requestNoteBody(const QString & noteLocalUid);
+    void setNoteBody(const Note & note);
+
     QVariant dataImpl(const int row, const Columns::type column) const;
     QVariant dataAccessibleText(const int row, const Columns::type column) const;
 
     void processTagExpunging(const QString & tagLocalUid);
     void removeItemByLocalUid(const QString & localUid);
     void updateItemRowWithRespectToSorting(const NoteModelItem & item);
+
+    bool shouldBatchNoteChanges() const;
+    void enqueueNoteAddedOrUpdated(const Note & note);
+    void enqueueNoteRemoval(const QString & noteLocalUid);
+    void applyPendingNoteChanges();
+
+    // Batch counterparts of removeItemByLocalUid, addOrUpdateNoteItem and updateItemRowWithRespectToSorting
+    // emitting the signals for contiguous ranges of rows
+    void removeItemsByLocalUids(const QSet<QString> & localUids);
+    void insertNewItems(std::vector<NoteModelItem> & items);
+    void updateExistingItems(const std::vector<NoteModelItem> & items);
+    void emitDataChangedForRows(std::vector<int> & rows);
+
+    void startAsyncSort(const Columns::type column, const Qt::SortOrder order);
+
+    /**
+     * @brief applySortedItems - reorders the model's items according to the sorted snapshot of them; the items
+     * added or changed since the snapshot was taken are put into their positions according to the new sorting
+     */
+    void applySortedItems(const std::vector<const NoteModelItem*> & sortedItems, const Columns::type column,
+                          const Qt::SortOrder order);
+
+    QVector<std::pair<QString, int> > persistentIndexLocalUids(const QModelIndexList & persistentIndices) const;
+    void updatePersistentIndices(const QModelIndexList & persistentIndices,
+                                 const QVector<std::pair<QString, int> > & localUidsWithColumns);
     void updateNoteInLocalStorage(const NoteModelItem & item, const bool updateTags = false);
 
     // Returns the appropriate row before which the new item should be inserted according to the current sorting criteria and column
@@ -237,6 +426,7 @@ private:
     void updateNotebookData(const Notebook & notebook);
 
     void updateTagData(const Tag & tag);
+    void updateTagGuidsForNotes(const QString & tagLocalUid);
 
     void setNoteFavorited(const QString & noteLocalUid, const bool favorited);
 
@@ -260,20 +450,95 @@ private:
     typedef NoteData::index<ByLocalUid>::type NoteDataByLocalUid;
     typedef NoteData::index<ByIndex>::type NoteDataByIndex;
 
+    /**
+     * @brief The CollationKeyCache class keeps the collation keys of the strings the recently compared items
+     * are sorted by, so that the binary searches for the rows of new and updated items compute the key
+     * of the searched item once and reuse the keys of the items it meets on the way; the key cached
+     * for the item is rebuilt once the item's string changes i.e. after the change of its title or preview text
+     */
+    class CollationKeyCache
+    {
+    public:
+        CollationKeyCache(const Collator & collator, const size_t maxSize);
+
+        CollationKey sortKey(const NoteModelItem & item, const Columns::type column);
+        void remove(const QString & localUid);
+        void clear();
+
+    private:
+        struct Entry
+        {
+            Entry() :
+                m_string(),
+                m_key()
+            {}
+
+            QString         m_string;
+            CollationKey    m_key;
+        };
+
+        const Collator &                m_collator;
+        LRUCache<QString, Entry>        m_entries;
+    };
+
+    /**
+     * @brief The NoteComparator class compares note model items by the sorted column; the strings are compared
+     * by the collation keys set for the items being compared or found within the set collation key cache,
+     * otherwise with the passed in collator
+     */
     class NoteComparator
     {
     public:
         NoteComparator(const Columns::type column,
-                       const Qt::SortOrder sortOrder) :
+                       const Qt::SortOrder sortOrder,
+                       const Collator * pCollator = Q_NULLPTR) :
             m_sortedColumn(column),
-            m_sortOrder(sortOrder)
+            m_sortOrder(sortOrder),
+            m_pCollator(pCollator),
+            m_pSortKeys(Q_NULLPTR),
+            m_pFirstItem(Q_NULLPTR),
+            m_pCollationKeyCache(Q_NULLPTR)
         {}
 
+        /**
+         * @brief setSortKeys - makes the comparator compare the strings by the collation keys precomputed
+         * for the contiguous range of items starting at pFirstItem, one key per item; only the items
+         * from that range can be compared then
+         */
+        void setSortKeys(const std::vector<CollationKey> * pSortKeys, const NoteModelItem * pFirstItem)
+        { m_pSortKeys = pSortKeys; m_pFirstItem = pFirstItem; }
+
+        void setCollationKeyCache(CollationKeyCache * pCollationKeyCache)
+        { m_pCollationKeyCache = pCollationKeyCache; }
+
         bool operator()(const NoteModelItem & lhs, const NoteModelItem & rhs) const;
 
     private:
-        Columns::type   m_sortedColumn;
-        Qt::SortOrder   m_sortOrder;
+        Columns::type                       m_sortedColumn;
+        Qt::SortOrder                       m_sortOrder;
+        const Collator *                    m_pCollator;
+        const std::vector<CollationKey> *   m_pSortKeys;
+        const NoteModelItem *               m_pFirstItem;
+        CollationKeyCache *                 m_pCollationKeyCache;
+    };
+
+    /**
+     * @brief The SortKeyPositionComparator class compares the positions within the vector of collation keys
+     * by the keys at these positions
+     */
+    class SortKeyPositionComparator
+    {
+    public:
+        SortKeyPositionComparator(const std::vector<CollationKey> & sortKeys, const Qt::SortOrder sortOrder) :
+            m_sortKeys(sortKeys),
+            m_sortOrder(sortOrder)
+        {}
+
+        bool operator()(const size_t lhs, const size_t rhs) const;
+
+    private:
+        const std::vector<CollationKey> &   m_sortKeys;
+        Qt::SortOrder                       m_sortOrder;
     };
 
     struct NotebookData
@@ -293,12 +558,86 @@ private:
 
     struct TagData
     {
-        QString m_name;
         QString m_guid;
     };
 
     typedef boost::bimap<QString, QUuid> LocalUidToRequestIdBimap;
 
+    typedef ListRequestPipeline<Note> ListNotesPipeline;
+
+    struct SortKeyIndexState
+    {
+        enum type
+        {
+            Inactive = 0,
+            Building,
+            Ready
+        };
+    };
+
+    /**
+     * @brief The SortKeyIndexEntry struct is the note's key by the sorted column within the sort key index:
+     * the collation key for the columns holding strings, the value of the column otherwise
+     */
+    struct SortKeyIndexEntry
+    {
+        SortKeyIndexEntry() :
+            m_localUid(),
+            m_collationKey(),
+            m_value(0)
+        {}
+
+        QString         m_localUid;
+        CollationKey    m_collationKey;
+        quint64         m_value;
+    };
+
+    class SortKeyIndexEntryComparator
+    {
+    public:
+        SortKeyIndexEntryComparator(const Columns::type column, const Qt::SortOrder sortOrder) :
+            m_collatedStrings(columnHasCollatedStrings(column)),
+            m_sortOrder(sortOrder)
+        {}
+
+        bool operator()(const SortKeyIndexEntry & lhs, const SortKeyIndexEntry & rhs) const;
+
+    private:
+        bool            m_collatedStrings;
+        Qt::SortOrder   m_sortOrder;
+    };
+
+    /**
+     * @brief The NoteSortTask class sorts the snapshot of note model items; if the sorted column holds strings,
+     * the collation keys are computed for the snapshot items before sorting and live as long as the task
+     */
+    class NoteSortTask: public SnapshotSortTask<NoteModelItem, NoteComparator>
+    {
+    public:
+        NoteSortTask(std::vector<NoteModelItem> & snapshot, const Columns::type column,
+                     const Qt::SortOrder sortOrder) :
+            SnapshotSortTask<NoteModelItem, NoteComparator>(snapshot, NoteComparator(column, sortOrder)),
+            m_sortedColumn(column),
+            m_sortOrder(sortOrder),
+            m_collator(),
+            m_sortKeys()
+        {}
+
+        Columns::type sortedColumn() const { return m_sortedColumn; }
+        Qt::SortOrder sortOrder() const { return m_sortOrder; }
+
+    protected:
+        virtual void prepareItems(std::vector<NoteModelItem> & items) Q_DECL_OVERRIDE;
+
+    private:
+        Columns::type   m_sortedColumn;
+        Qt::SortOrder   m_sortOrder;
+
+        // NOTE: the collator is not shared with the model as it is not thread-safe
+        Collator                    m_collator;
+        std::vector<CollationKey>   m_sortKeys;
+    };
+
     class ThumbnailPathModifier
     {
     public:
@@ -314,12 +653,81 @@ private:
 
 private:
     void onNoteAddedOrUpdated(const Note & note);
+
     void noteToItem(const Note & note, NoteModelItem & item);
+    static quint64 noteSizeInBytes(const Note & note);
+
+    // Returns true if the notes are listed through the sort key index for the current sorting in Windowed mode
+    bool sortKeyIndexUsed() const;
+    bool sortKeyIndexEntryForNote(const Note & note, SortKeyIndexEntry & entry);
+
+    /**
+     * @brief updateSortKeyIndex - puts the note's current sort key into the sort key index or removes the note
+     * from the index if the model doesn't include it anymore
+     * @return true if the note belongs to the window of the sort key index entries materialized as rows
+     */
+    bool updateSortKeyIndex(const Note & note);
+
+    // Returns the position of the note's entry or the size of the index if the note has no entry
+    size_t sortKeyIndexPosition(const QString & noteLocalUid) const;
+    size_t removeFromSortKeyIndex(const QString & noteLocalUid);
+
+    void finishSortKeyIndex();
+    void requestSortKeyIndexWindow(const size_t windowEnd);
+    void requestNotesForWindow(const QStringList & noteLocalUids);
+    bool windowedListingFinished() const;
+
+    /**
+     * @brief prepareNoteItem - converts the note into the item complemented with its notebook's and tags' data
+     * @return false if the item can't be prepared right now; in particular, if the data of note's notebook
+     * is yet to be found, the item would be added or updated once that data is found
+     */
+    bool prepareNoteItem(const Note & note, NoteModelItem & item);
+
     void checkAddedNoteItemsPendingNotebookData(const QString & notebookLocalUid, const NotebookData & notebookData);
+    void setNotebookDataForItem(NoteModelItem & item, const NotebookData & notebookData);
     void addOrUpdateNoteItem(NoteModelItem & item, const NotebookData & notebookData);
+    void addOrUpdatePreparedNoteItem(const NoteModelItem & item);
+    bool itemMatchesIncludedNotes(const NoteModelItem & item) const;
 
     void findTagNamesForItem(NoteModelItem & item);
 
+    /**
+     * @return true if the column holds the strings compared with the collator
+     */
+    static bool columnHasCollatedStrings(const Columns::type column);
+
+    /**
+     * @return the item's string by which the items are sorted by the column holding strings
+     */
+    static const QString & collatedStringForItem(const NoteModelItem & item, const Columns::type column);
+
+    /**
+     * @return true if both items have the same data in the specified column as far as the sorting is concerned
+     */
+    static bool sortedColumnDataEqual(const NoteModelItem & lhs, const NoteModelItem & rhs,
+                                      const Columns::type column);
+
+    /**
+     * @return the comparator of the model's items by the current sorting which takes the collation keys
+     * of the strings from the model's collation key cache
+     */
+    NoteComparator itemComparator() const;
+
+    class SortedColumnDataEqual
+    {
+    public:
+        SortedColumnDataEqual(const Columns::type column) :
+            m_column(column)
+        {}
+
+        bool operator()(const NoteModelItem & lhs, const NoteModelItem & rhs) const
+        { return sortedColumnDataEqual(lhs, rhs, m_column); }
+
+    private:
+        Columns::type   m_column;
+    };
+
     void moveNoteToNotebookImpl(NoteDataByLocalUid::iterator it, const Notebook & notebook);
 
     void checkAndNotifyAllNotesListed();
@@ -328,10 +736,12 @@ private:
     Account                 m_account;
     IncludedNotes::type     m_includedNotes;
     NoteData                m_data;
-    size_t                  m_listNotesOffset;
-    QUuid                   m_listNotesRequestId;
+    ListNotesPipeline       m_listNotesPipeline;
     QSet<QUuid>             m_noteItemsNotYetInLocalStorageUids;
 
+    // Local uids of the note items restored from the snapshot which have not been listed from the local storage yet
+    QSet<QString>           m_restoredLocalUidsPendingReconciliation;
+
     NoteCache &             m_cache;
     NotebookCache &         m_notebookCache;
 
@@ -347,6 +757,17 @@ private:
 
     Columns::type           m_sortedColumn;
     Qt::SortOrder           m_sortOrder;
+    Collator                m_collator;
+
+    // The collation keys of the items recently compared while positioning the new and updated items
+    mutable CollationKeyCache   m_collationKeyCache;
+
+    // The thread pool running the tasks sorting the snapshot of items in the background; the superseded
+    // tasks are cancelled and the ones still running are waited for on the model's destruction
+    QThreadPool             m_sortThreadPool;
+
+    // The task sorting the snapshot of items in the background, if any
+    NoteSortTask *          m_pSortTask;
 
     QHash<QString, NotebookData>        m_notebookDataByNotebookLocalUid;
     LocalUidToRequestIdBimap            m_findNotebookRequestForNotebookLocalUid;
@@ -356,10 +777,46 @@ private:
 
     QHash<QString, TagData>             m_tagDataByTagLocalUid;
 
+    // Names of the tags referred to by the note model items by ids
+    TagNameTable                        m_tagNameTable;
+
     LocalUidToRequestIdBimap            m_findTagRequestForTagLocalUid;
     QMultiHash<QString, QString>        m_tagLocalUidToNoteLocalUid;
 
+    // Notebook and tag local uids and guids shared by note model items
+    StringPool              m_stringPool;
+
     bool                    m_allNotesListed;
+
+    ListingMode::type       m_listingMode;
+    size_t                  m_windowedListingTargetSize;
+
+    QSet<QString>           m_viewportNoteLocalUids;
+    QSet<QString>           m_noteLocalUidsWithBodies;
+    LocalUidToRequestIdBimap            m_findNoteBodyRequestIdByNoteLocalUid;
+
+    // The sort keys of all the notes included into the model, sorted once all notes have been listed for them,
+    // for the sorting the local storage can't list notes by in Windowed mode; the leading entries up to
+    // m_sortKeyIndexWindowEnd are materialized as rows, the notes for them are found one by one
+    SortKeyIndexState::type             m_sortKeyIndexState;
+    std::vector<SortKeyIndexEntry>      m_sortKeyIndex;
+    QSet<QString>                       m_sortKeyIndexLocalUids;
+    size_t                              m_sortKeyIndexWindowEnd;
+    LocalUidToRequestIdBimap            m_findNoteForWindowRequestIdByNoteLocalUid;
+
+    NoteThumbnailCache *    m_pThumbnailCache;
+
+    bool                    m_noteChangesBatchingEnabled;
+    int                     m_noteChangesBatchDepth;
+    QBasicTimer             m_noteChangesBatchTimer;
+
+    // Note changes accumulated for batching: the latest added or updated notes and the removed notes by local uids
+    QHash<QString, Note>    m_pendingAddedOrUpdatedNotes;
+    QSet<QString>           m_pendingRemovedNoteLocalUids;
+
+    quint64                 m_numBatchedNoteChanges;
+    quint64                 m_numCoalescedNoteChanges;
+    quint64                 m_numAppliedNoteChangesBatches;
 };
 
 } // namespace quentier
@@ -32,20 +32,14 @@ NoteModelItem::NoteModelItem() :
     m_notebookName(),
     m_tagLocalUids(),
     m_tagGuids(),
-    m_tagNameList(),
+    m_tagNameIds(),
     m_creationTimestamp(-1),
     m_modificationTimestamp(-1),
     m_deletionTimestamp(-1),
     m_sizeInBytes(0),
-    m_isSynchronizable(false),
-    m_isDirty(true),
-    m_isFavorited(false),
-    m_hasResources(false),
-    m_canUpdateTitle(true),
-    m_canUpdateContent(true),
-    m_canEmail(true),
-    m_canShare(true),
-    m_canSharePublicly(true)
+    m_thumbnailDataHash(qHash(QByteArray())),
+    m_flags(Flag::Dirty | Flag::CanUpdateTitle | Flag::CanUpdateContent |
+            Flag::CanEmail | Flag::CanShare | Flag::CanSharePublicly)
 {}
 
 NoteModelItem::~NoteModelItem()
@@ -111,34 +105,14 @@ int NoteModelItem::numTagGuids() const
     return m_tagGuids.size();
 }
 
-void NoteModelItem::addTagName(const QString & tagName)
+void NoteModelItem::removeTagNameId(const qint32 tagNameId)
 {
-    int index = m_tagNameList.indexOf(tagName);
-    if (index >= 0) {
-        return;
-    }
-
-    m_tagNameList << tagName;
-}
-
-void NoteModelItem::removeTagName(const QString & tagName)
-{
-    int index = m_tagNameList.indexOf(tagName);
+    int index = m_tagNameIds.indexOf(tagNameId);
     if (index < 0) {
         return;
     }
 
-    m_tagNameList.removeAt(index);
-}
-
-bool NoteModelItem::hasTagName(const QString & tagName) const
-{
-    return m_tagNameList.contains(tagName);
-}
-
-int NoteModelItem::numTagNames() const
-{
-    return m_tagNameList.size();
+    m_tagNameIds.remove(index);
 }
 
 QTextStream & NoteModelItem::print(QTextStream & strm) const
@@ -149,22 +123,42 @@ QTextStream & NoteModelItem::print(QTextStream & strm) const
          << m_previewText << QStringLiteral(", thumbnail ") << (m_thumbnailData.isEmpty() ? QStringLiteral("null") : QStringLiteral("not null"))
          << QStringLiteral(", notebook name = ") << m_notebookName << QStringLiteral(", tag local uids = ")
          << m_tagLocalUids.join(QStringLiteral(", ")) << QStringLiteral(", tag guids = ") << m_tagGuids.join(QStringLiteral(", "))
-         << QStringLiteral(", tag name list = ") << m_tagNameList.join(QStringLiteral(", ")) << QStringLiteral(", creation timestamp = ")
+         << QStringLiteral(", num tag name ids = ") << m_tagNameIds.size() << QStringLiteral(", creation timestamp = ")
          << m_creationTimestamp << QStringLiteral(" (") << printableDateTimeFromTimestamp(m_creationTimestamp) << QStringLiteral(")")
          << QStringLiteral(", modification timestamp = ") << m_modificationTimestamp << QStringLiteral(" (")
          << printableDateTimeFromTimestamp(m_modificationTimestamp) << QStringLiteral(")") << QStringLiteral(", deletion timestamp = ")
          << m_deletionTimestamp << QStringLiteral(" (") << printableDateTimeFromTimestamp(m_deletionTimestamp) << QStringLiteral(")")
          << QStringLiteral(", size in bytes = ") << m_sizeInBytes << QStringLiteral(", is synchronizable = ")
-         << (m_isSynchronizable ? QStringLiteral("true") : QStringLiteral("false")) << QStringLiteral(", is dirty = ")
-         << (m_isDirty ? QStringLiteral("true") : QStringLiteral("false")) << QStringLiteral(", is favorited = ")
-         << (m_isFavorited ? QStringLiteral("true") : QStringLiteral("false")) << QStringLiteral(", can update title = ")
-         << (m_canUpdateTitle ? QStringLiteral("true") : QStringLiteral("false")) << QStringLiteral(", can update content = ")
-         << (m_canUpdateContent ? QStringLiteral("true") : QStringLiteral("false")) << QStringLiteral(", can email = ")
-         << (m_canEmail ? QStringLiteral("true") : QStringLiteral("false")) << QStringLiteral(", can share = ")
-         << (m_canShare ? QStringLiteral("true") : QStringLiteral("false")) << QStringLiteral(", can share publicly = ")
-         << (m_canSharePublicly ? QStringLiteral("true") : QStringLiteral("false"));
+         << (isSynchronizable() ? QStringLiteral("true") : QStringLiteral("false")) << QStringLiteral(", is dirty = ")
+         << (isDirty() ? QStringLiteral("true") : QStringLiteral("false")) << QStringLiteral(", is favorited = ")
+         << (isFavorited() ? QStringLiteral("true") : QStringLiteral("false")) << QStringLiteral(", can update title = ")
+         << (canUpdateTitle() ? QStringLiteral("true") : QStringLiteral("false")) << QStringLiteral(", can update content = ")
+         << (canUpdateContent() ? QStringLiteral("true") : QStringLiteral("false")) << QStringLiteral(", can email = ")
+         << (canEmail() ? QStringLiteral("true") : QStringLiteral("false")) << QStringLiteral(", can share = ")
+         << (canShare() ? QStringLiteral("true") : QStringLiteral("false")) << QStringLiteral(", can share publicly = ")
+         << (canSharePublicly() ? QStringLiteral("true") : QStringLiteral("false"));
 
     return strm;
 }
 
+QDataStream & operator<<(QDataStream & out, const NoteModelItem & item)
+{
+    out << item.m_localUid << item.m_guid << item.m_notebookLocalUid << item.m_notebookGuid << item.m_title
+        << item.m_previewText << item.m_thumbnailData << item.m_notebookName << item.m_tagLocalUids
+        << item.m_tagGuids << item.m_creationTimestamp << item.m_modificationTimestamp
+        << item.m_deletionTimestamp << item.m_sizeInBytes << item.m_flags;
+    return out;
+}
+
+QDataStream & operator>>(QDataStream & in, NoteModelItem & item)
+{
+    in >> item.m_localUid >> item.m_guid >> item.m_notebookLocalUid >> item.m_notebookGuid >> item.m_title
+       >> item.m_previewText >> item.m_thumbnailData >> item.m_notebookName >> item.m_tagLocalUids
+       >> item.m_tagGuids >> item.m_creationTimestamp >> item.m_modificationTimestamp
+       >> item.m_deletionTimestamp >> item.m_sizeInBytes >> item.m_flags;
+    item.m_tagNameIds.clear();
+    item.m_thumbnailDataHash = qHash(item.m_thumbnailData);
+    return in;
+}
+
 } // namespace quentier
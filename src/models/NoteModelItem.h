@@ -21,7 +21,10 @@
 
 #include <quentier/utility/Printable.h>
 #include <QStringList>
+#include <QVector>
 #include <QByteArray>
+#include <QDataStream>
+#include <QHash>
 
 namespace quentier {
 
@@ -50,7 +53,14 @@ public:
     void setPreviewText(const QString & previewText) { m_previewText = previewText; }
 
     const QByteArray & thumbnailData() const { return m_thumbnailData; }
-    void setThumbnailData(const QByteArray & thumbnailData) { m_thumbnailData = thumbnailData; }
+    void setThumbnailData(const QByteArray & thumbnailData)
+    { m_thumbnailData = thumbnailData; m_thumbnailDataHash = qHash(thumbnailData); }
+
+    /**
+     * @return the hash of thumbnail data computed once the data is set so that it doesn't need to be computed
+     * each time the thumbnail is painted
+     */
+    uint thumbnailDataHash() const { return m_thumbnailDataHash; }
 
     const QString & notebookName() const { return m_notebookName; }
     void setNotebookName(const QString & notebookName) { m_notebookName = notebookName; }
@@ -69,12 +79,13 @@ public:
     bool hasTagGuid(const QString & tagGuid) const;
     int numTagGuids() const;
 
-    const QStringList & tagNameList() const { return m_tagNameList; }
-    void setTagNameList(const QStringList & tagNameList) { m_tagNameList = tagNameList; }
-    void addTagName(const QString & tagName);
-    void removeTagName(const QString & tagName);
-    bool hasTagName(const QString & tagName) const;
-    int numTagNames() const;
+    /**
+     * @return the ids of the note's tags within the tag name table of the note model
+     * through which the names of the tags are resolved
+     */
+    const QVector<qint32> & tagNameIds() const { return m_tagNameIds; }
+    void setTagNameIds(const QVector<qint32> & tagNameIds) { m_tagNameIds = tagNameIds; }
+    void removeTagNameId(const qint32 tagNameId);
 
     qint64 creationTimestamp() const { return m_creationTimestamp; }
     void setCreationTimestamp(const qint64 creationTimestamp) { m_creationTimestamp = creationTimestamp; }
@@ -88,35 +99,62 @@ public:
     quint64 sizeInBytes() const { return m_sizeInBytes; }
     void setSizeInBytes(const quint64 sizeInBytes) { m_sizeInBytes = sizeInBytes; }
 
-    bool isSynchronizable() const { return m_isSynchronizable; }
-    void setSynchronizable(const bool synchronizable) { m_isSynchronizable = synchronizable; }
+    bool isSynchronizable() const { return ((m_flags & Flag::Synchronizable) != 0); }
+    void setSynchronizable(const bool synchronizable) { setFlag(Flag::Synchronizable, synchronizable); }
 
-    bool isDirty() const { return m_isDirty; }
-    void setDirty(const bool dirty) { m_isDirty = dirty; }
+    bool isDirty() const { return ((m_flags & Flag::Dirty) != 0); }
+    void setDirty(const bool dirty) { setFlag(Flag::Dirty, dirty); }
 
-    bool isFavorited() const { return m_isFavorited; }
-    void setFavorited(const bool favorited) { m_isFavorited = favorited; }
+    bool isFavorited() const { return ((m_flags & Flag::Favorited) != 0); }
+    void setFavorited(const bool favorited) { setFlag(Flag::Favorited, favorited); }
 
-    bool hasResources() const { return m_hasResources; }
-    void setHasResources(const bool hasResources) { m_hasResources = hasResources; }
+    bool hasResources() const { return ((m_flags & Flag::HasResources) != 0); }
+    void setHasResources(const bool hasResources) { setFlag(Flag::HasResources, hasResources); }
 
-    bool canUpdateTitle() const { return m_canUpdateTitle; }
-    void setCanUpdateTitle(const bool canUpdateTitle) { m_canUpdateTitle = canUpdateTitle; }
+    bool canUpdateTitle() const { return ((m_flags & Flag::CanUpdateTitle) != 0); }
+    void setCanUpdateTitle(const bool canUpdateTitle) { setFlag(Flag::CanUpdateTitle, canUpdateTitle); }
 
-    bool canUpdateContent() const { return m_canUpdateContent; }
-    void setCanUpdateContent(const bool canUpdateContent) { m_canUpdateContent = canUpdateContent; }
+    bool canUpdateContent() const { return ((m_flags & Flag::CanUpdateContent) != 0); }
+    void setCanUpdateContent(const bool canUpdateContent) { setFlag(Flag::CanUpdateContent, canUpdateContent); }
 
-    bool canEmail() const { return m_canEmail; }
-    void setCanEmail(const bool canEmail) { m_canEmail = canEmail; }
+    bool canEmail() const { return ((m_flags & Flag::CanEmail) != 0); }
+    void setCanEmail(const bool canEmail) { setFlag(Flag::CanEmail, canEmail); }
 
-    bool canShare() const { return m_canShare; }
-    void setCanShare(const bool canShare) { m_canShare = canShare; }
+    bool canShare() const { return ((m_flags & Flag::CanShare) != 0); }
+    void setCanShare(const bool canShare) { setFlag(Flag::CanShare, canShare); }
 
-    bool canSharePublicly() const { return m_canSharePublicly; }
-    void setCanSharePublicly(const bool canSharePublicly) { m_canSharePublicly = canSharePublicly; }
+    bool canSharePublicly() const { return ((m_flags & Flag::CanSharePublicly) != 0); }
+    void setCanSharePublicly(const bool canSharePublicly) { setFlag(Flag::CanSharePublicly, canSharePublicly); }
 
     virtual QTextStream & print(QTextStream & strm) const Q_DECL_OVERRIDE;
 
+private:
+    struct Flag
+    {
+        enum type
+        {
+            Synchronizable = 1 << 0,
+            Dirty = 1 << 1,
+            Favorited = 1 << 2,
+            HasResources = 1 << 3,
+            CanUpdateTitle = 1 << 4,
+            CanUpdateContent = 1 << 5,
+            CanEmail = 1 << 6,
+            CanShare = 1 << 7,
+            CanSharePublicly = 1 << 8
+        };
+    };
+
+    void setFlag(const Flag::type flag, const bool value)
+    {
+        if (value) {
+            m_flags |= static_cast<quint16>(flag);
+        }
+        else {
+            m_flags &= ~static_cast<quint16>(flag);
+        }
+    }
+
 private:
     QString     m_localUid;
     QString     m_guid;
@@ -128,22 +166,27 @@ private:
     QString     m_notebookName;
     QStringList m_tagLocalUids;
     QStringList m_tagGuids;
-    QStringList m_tagNameList;
+    QVector<qint32> m_tagNameIds;
     qint64      m_creationTimestamp;
     qint64      m_modificationTimestamp;
     qint64      m_deletionTimestamp;
     quint64     m_sizeInBytes;
-    bool        m_isSynchronizable;
-    bool        m_isDirty;
-    bool        m_isFavorited;
-    bool        m_hasResources;
-    bool        m_canUpdateTitle;
-    bool        m_canUpdateContent;
-    bool        m_canEmail;
-    bool        m_canShare;
-    bool        m_canSharePublicly;
+
+    // NOTE: placed next to the flags to occupy the padding which would follow them anyway
+    uint        m_thumbnailDataHash;
+
+    // Bit-packed combination of Flag values
+    quint16     m_flags;
+
+    // NOTE: neither the tag name ids nor the thumbnail data hash are serialized: the former depend on the note model
+    // and the latter is computed anew from the deserialized thumbnail data
+    friend QDataStream & operator<<(QDataStream & out, const NoteModelItem & item);
+    friend QDataStream & operator>>(QDataStream & in, NoteModelItem & item);
 };
 
+QDataStream & operator<<(QDataStream & out, const NoteModelItem & item);
+QDataStream & operator>>(QDataStream & in, NoteModelItem & item);
+
 } // namespace quentier
 
 #endif // QUENTIER_MODELS_NOTE_MODEL_ITEM_H
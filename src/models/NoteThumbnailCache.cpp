@@ -0,0 +1,133 @@
+/*
+ * Copyright 2016 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NoteThumbnailCache.h"
+#include <quentier/logging/QuentierLogger.h>
+#include <QMetaObject>
+
+namespace quentier {
+
+NoteThumbnailCache::NoteThumbnailCache(const QSize & thumbnailSize, const size_t maxSize, QObject * parent) :
+    QObject(parent),
+    m_thumbnailSize(thumbnailSize),
+    m_cache(maxSize),
+    m_pendingThumbnailDataHashes(),
+    m_threadPool()
+{}
+
+NoteThumbnailCache::~NoteThumbnailCache()
+{
+    // NOTE: the decoders refer to the cache so need to wait for the ones in progress; the thumbnails they pass
+    // to the cache are discarded along with the rest of the cache's pending events
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+    m_threadPool.clear();
+#endif
+    m_threadPool.waitForDone();
+}
+
+QImage NoteThumbnailCache::thumbnail(const QString & noteLocalUid, const QByteArray & thumbnailData,
+                                     const uint thumbnailDataHash)
+{
+    if (thumbnailData.isEmpty()) {
+        return QImage();
+    }
+
+    const Entry * pEntry = m_cache.get(noteLocalUid);
+    if (pEntry && (pEntry->m_thumbnailDataHash == thumbnailDataHash)) {
+        return pEntry->m_thumbnail;
+    }
+
+    auto pendingIt = m_pendingThumbnailDataHashes.find(noteLocalUid);
+    if ((pendingIt != m_pendingThumbnailDataHashes.end()) && (pendingIt.value() == thumbnailDataHash)) {
+        return QImage();
+    }
+
+    QNTRACE(QStringLiteral("NoteThumbnailCache::thumbnail: scheduling the decoding of thumbnail for note with local uid ")
+            << noteLocalUid);
+
+    m_pendingThumbnailDataHashes[noteLocalUid] = thumbnailDataHash;
+
+    NoteThumbnailDecoder * pDecoder = new NoteThumbnailDecoder(this, noteLocalUid, thumbnailData,
+                                                               thumbnailDataHash, m_thumbnailSize);
+    m_threadPool.start(pDecoder);
+
+    return QImage();
+}
+
+void NoteThumbnailCache::remove(const QString & noteLocalUid)
+{
+    Q_UNUSED(m_cache.remove(noteLocalUid))
+    Q_UNUSED(m_pendingThumbnailDataHashes.remove(noteLocalUid))
+}
+
+void NoteThumbnailCache::clear()
+{
+    m_cache.clear();
+    m_pendingThumbnailDataHashes.clear();
+}
+
+void NoteThumbnailCache::onThumbnailDecoded(QString noteLocalUid, uint thumbnailDataHash, QImage thumbnail)
+{
+    auto pendingIt = m_pendingThumbnailDataHashes.find(noteLocalUid);
+    if ((pendingIt == m_pendingThumbnailDataHashes.end()) || (pendingIt.value() != thumbnailDataHash)) {
+        QNTRACE(QStringLiteral("Ignoring the outdated decoded thumbnail for note with local uid ") << noteLocalUid);
+        return;
+    }
+
+    Q_UNUSED(m_pendingThumbnailDataHashes.erase(pendingIt))
+
+    if (Q_UNLIKELY(thumbnail.isNull())) {
+        QNDEBUG(QStringLiteral("Failed to decode the thumbnail for note with local uid ") << noteLocalUid);
+    }
+
+    Entry entry;
+    entry.m_thumbnailDataHash = thumbnailDataHash;
+    entry.m_thumbnail = thumbnail;
+    m_cache.put(noteLocalUid, entry);
+
+    Q_EMIT thumbnailReady(noteLocalUid);
+}
+
+NoteThumbnailDecoder::NoteThumbnailDecoder(NoteThumbnailCache * pCache, const QString & noteLocalUid,
+                                           const QByteArray & thumbnailData, const uint thumbnailDataHash,
+                                           const QSize & thumbnailSize) :
+    QRunnable(),
+    m_pCache(pCache),
+    m_noteLocalUid(noteLocalUid),
+    m_thumbnailData(thumbnailData),
+    m_thumbnailDataHash(thumbnailDataHash),
+    m_thumbnailSize(thumbnailSize)
+{}
+
+void NoteThumbnailDecoder::run()
+{
+    QImage thumbnail;
+    Q_UNUSED(thumbnail.loadFromData(m_thumbnailData, "PNG"))
+
+    if (!thumbnail.isNull() && m_thumbnailSize.isValid() &&
+        ((thumbnail.width() > m_thumbnailSize.width()) || (thumbnail.height() > m_thumbnailSize.height())))
+    {
+        thumbnail = thumbnail.scaled(m_thumbnailSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+
+    Q_UNUSED(QMetaObject::invokeMethod(m_pCache, "onThumbnailDecoded", Qt::QueuedConnection,
+                                       Q_ARG(QString, m_noteLocalUid), Q_ARG(uint, m_thumbnailDataHash),
+                                       Q_ARG(QImage, thumbnail)))
+}
+
+} // namespace quentier
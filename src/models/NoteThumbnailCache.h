@@ -0,0 +1,116 @@
+/*
+ * Copyright 2016 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUENTIER_MODELS_NOTE_THUMBNAIL_CACHE_H
+#define QUENTIER_MODELS_NOTE_THUMBNAIL_CACHE_H
+
+#include <quentier/utility/Macros.h>
+#include <quentier/utility/LRUCache.hpp>
+#include <QObject>
+#include <QRunnable>
+#include <QImage>
+#include <QByteArray>
+#include <QSize>
+#include <QHash>
+#include <QThreadPool>
+
+namespace quentier {
+
+/**
+ * @brief The NoteThumbnailCache class holds the limited number of decoded and scaled note thumbnails,
+ * evicting the least recently used ones when the limit is reached
+ *
+ * The thumbnails missing from the cache are decoded in the background on the cache's own thread pool so that
+ * the request for a thumbnail never blocks on decoding the image data; once the thumbnail is decoded,
+ * thumbnailReady signal is emitted and the subsequent requests for the thumbnail return it. The cache waits
+ * for the decoding in progress on destruction so that no decoder outlives it
+ */
+class NoteThumbnailCache: public QObject
+{
+    Q_OBJECT
+public:
+    explicit NoteThumbnailCache(const QSize & thumbnailSize, const size_t maxSize, QObject * parent = Q_NULLPTR);
+    virtual ~NoteThumbnailCache();
+
+    /**
+     * @return the decoded thumbnail for the note with the specified local uid and thumbnail data
+     * if it is present within the cache; otherwise schedules the decoding of thumbnail data and returns
+     * null image
+     *
+     * @param thumbnailDataHash - the hash of thumbnail data by which the cache tells whether the cached
+     * thumbnail is outdated
+     */
+    QImage thumbnail(const QString & noteLocalUid, const QByteArray & thumbnailData, const uint thumbnailDataHash);
+
+    /**
+     * @brief remove - removes the thumbnail of the note with the specified local uid from the cache
+     */
+    void remove(const QString & noteLocalUid);
+
+    void clear();
+
+Q_SIGNALS:
+    void thumbnailReady(QString noteLocalUid);
+
+private Q_SLOTS:
+    void onThumbnailDecoded(QString noteLocalUid, uint thumbnailDataHash, QImage thumbnail);
+
+private:
+    struct Entry
+    {
+        Entry() : m_thumbnailDataHash(0), m_thumbnail() {}
+
+        uint        m_thumbnailDataHash;
+        QImage      m_thumbnail;
+    };
+
+    QSize                       m_thumbnailSize;
+    LRUCache<QString, Entry>    m_cache;
+
+    // Thumbnail data hashes of the thumbnails being decoded at the moment by note local uids
+    QHash<QString, uint>        m_pendingThumbnailDataHashes;
+
+    QThreadPool                 m_threadPool;
+};
+
+/**
+ * @brief The NoteThumbnailDecoder class decodes a single note thumbnail and scales it
+ * to the specified size within the thread pool's thread, then passes it to the cache
+ * via the queued call so that it is processed within the cache's thread
+ */
+class NoteThumbnailDecoder: public QRunnable
+{
+public:
+    explicit NoteThumbnailDecoder(NoteThumbnailCache * pCache, const QString & noteLocalUid,
+                                  const QByteArray & thumbnailData, const uint thumbnailDataHash,
+                                  const QSize & thumbnailSize);
+
+private:
+    virtual void run() Q_DECL_OVERRIDE;
+
+private:
+    NoteThumbnailCache *    m_pCache;
+    QString     m_noteLocalUid;
+    QByteArray  m_thumbnailData;
+    uint        m_thumbnailDataHash;
+    QSize       m_thumbnailSize;
+};
+
+} // namespace quentier
+
+#endif // QUENTIER_MODELS_NOTE_THUMBNAIL_CACHE_H
@@ -41,6 +41,7 @@ NotebookItem::NotebookItem(const QString & localUid,
     m_guid(guid),
     m_linkedNotebookGuid(linkedNotebookGuid),
     m_name(name),
+    m_nameUpper(name.toUpper()),
     m_stack(stack),
     m_flags(),
     m_numNotesPerNotebook(numNotesPerNotebook)
@@ -189,4 +190,43 @@ QTextStream & NotebookItem::print(QTextStream & strm) const
     return strm;
 }
 
+QDataStream & operator<<(QDataStream & out, const NotebookItem & item)
+{
+    out << item.localUid() << item.guid() << item.linkedNotebookGuid() << item.name() << item.stack()
+        << item.isSynchronizable() << item.isUpdatable() << item.nameIsUpdatable() << item.isDirty()
+        << item.isDefault() << item.isLastUsed() << item.isPublished() << item.isFavorited()
+        << item.canCreateNotes() << item.canUpdateNotes() << static_cast<qint32>(item.numNotesPerNotebook());
+    return out;
+}
+
+QDataStream & operator>>(QDataStream & in, NotebookItem & item)
+{
+    QString localUid;
+    QString guid;
+    QString linkedNotebookGuid;
+    QString name;
+    QString stack;
+    bool isSynchronizable = false;
+    bool isUpdatable = false;
+    bool nameIsUpdatable = false;
+    bool isDirty = false;
+    bool isDefault = false;
+    bool isLastUsed = false;
+    bool isPublished = false;
+    bool isFavorited = false;
+    bool canCreateNotes = true;
+    bool canUpdateNotes = true;
+    qint32 numNotesPerNotebook = -1;
+
+    in >> localUid >> guid >> linkedNotebookGuid >> name >> stack
+       >> isSynchronizable >> isUpdatable >> nameIsUpdatable >> isDirty
+       >> isDefault >> isLastUsed >> isPublished >> isFavorited
+       >> canCreateNotes >> canUpdateNotes >> numNotesPerNotebook;
+
+    item = NotebookItem(localUid, guid, linkedNotebookGuid, name, stack, isSynchronizable, isUpdatable,
+                        nameIsUpdatable, isDirty, isDefault, isLastUsed, isPublished, isFavorited,
+                        canCreateNotes, canUpdateNotes, numNotesPerNotebook);
+    return in;
+}
+
 } // namespace quentier
@@ -20,6 +20,7 @@
 #define QUENTIER_MODELS_NOTEBOOK_ITEM_H
 
 #include <quentier/utility/Printable.h>
+#include <QDataStream>
 #include <bitset>
 
 namespace quentier {
@@ -55,9 +56,14 @@ public:
     void setLinkedNotebookGuid(const QString & linkedNotebookGuid) { m_linkedNotebookGuid = linkedNotebookGuid; }
 
     const QString & name() const { return m_name; }
-    void setName(const QString & name) { m_name = name; }
+    void setName(const QString & name) { m_name = name; m_nameUpper = name.toUpper(); }
 
-    QString nameUpper() const { return m_name.toUpper(); }
+    /**
+     * @return the upper case version of the item's name, computed once per name change
+     * so that it can serve as the key of the ordered name index without being case-folded
+     * on every comparison
+     */
+    const QString & nameUpper() const { return m_nameUpper; }
 
     const QString & stack() const { return m_stack; }
     void setStack(const QString & stack) { m_stack = stack; }
@@ -102,6 +108,7 @@ private:
     QString     m_guid;
     QString     m_linkedNotebookGuid;
     QString     m_name;
+    QString     m_nameUpper;
     QString     m_stack;
 
     // Will use a bitset here to save some space from the more straigforward alternative of using booleans
@@ -128,6 +135,9 @@ private:
     int         m_numNotesPerNotebook;
 };
 
+QDataStream & operator<<(QDataStream & out, const NotebookItem & item);
+QDataStream & operator>>(QDataStream & in, NotebookItem & item);
+
 } // namespace quentier
 
 #endif // QUENTIER_MODELS_NOTEBOOK_ITEM_H
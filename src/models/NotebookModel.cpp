@@ -19,18 +19,27 @@
 #include "NotebookModel.h"
 #include "NoteModel.h"
 #include "NewItemNameGenerator.hpp"
+#include "ModelSnapshot.h"
 #include <quentier/logging/QuentierLogger.h>
 #include <QMimeData>
 
 namespace quentier {
 
-// Limit for the queries to the local storage
+// Initial limits for the queries to the local storage, adjusted then within the min/max bounds
+// depending on the measured timings of the queries
 #define NOTEBOOK_LIST_LIMIT (40)
 #define LINKED_NOTEBOOK_LIST_LIMIT (40)
+#define MIN_LIST_LIMIT (20)
+#define MAX_LIST_LIMIT (1000)
+#define LIST_TARGET_ROUND_TRIP_MSEC (100)
+#define MAX_LIST_REQUESTS_IN_FLIGHT (4)
 
 
 #define NUM_NOTEBOOK_MODEL_COLUMNS (8)
 
+// The version of the format of notebook items within the model snapshot
+#define NOTEBOOK_MODEL_SNAPSHOT_VERSION (1)
+
 #define REPORT_ERROR(error, ...) \
     ErrorString errorDescription(error); \
     QNWARNING(errorDescription << "" __VA_ARGS__ ); \
@@ -56,19 +65,25 @@ NotebookModel::NotebookModel(const Account & account, const NoteModel & noteMode
     m_indexIdToLinkedNotebookGuidBimap(),
     m_lastFreeIndexId(1),
     m_cache(cache),
-    m_listNotebooksOffset(0),
-    m_listNotebooksRequestId(),
+    m_listNotebooksPipeline(NOTEBOOK_LIST_LIMIT, MIN_LIST_LIMIT, MAX_LIST_LIMIT, LIST_TARGET_ROUND_TRIP_MSEC, MAX_LIST_REQUESTS_IN_FLIGHT),
+    m_ownNotebooksListed(false),
+    m_linkedNotebookGuidsPendingNotebooksListing(),
+    m_listNotebooksRequestIdsForLinkedNotebookGuids(),
+    m_restoredLocalUidsPendingReconciliation(),
     m_addNotebookRequestIds(),
     m_updateNotebookRequestIds(),
     m_expungeNotebookRequestIds(),
     m_findNotebookToRestoreFailedUpdateRequestIds(),
     m_findNotebookToPerformUpdateRequestIds(),
     m_noteCountPerNotebookRequestIds(),
+    m_noteCountForAllNotebooksRequestIds(),
+    m_noteCountForAllNotebooksDirty(false),
+    m_noteCountsByNotebookLocalUid(),
     m_notebookLocalUidByNoteLocalUid(),
     m_receivedNotebookLocalUidsForAllNotes(false),
     m_linkedNotebookOwnerUsernamesByLinkedNotebookGuids(),
-    m_listLinkedNotebooksOffset(0),
-    m_listLinkedNotebooksRequestId(),
+    m_listLinkedNotebooksPipeline(LINKED_NOTEBOOK_LIST_LIMIT, MIN_LIST_LIMIT, MAX_LIST_LIMIT,
+                                  LIST_TARGET_ROUND_TRIP_MSEC, MAX_LIST_REQUESTS_IN_FLIGHT),
     m_sortedColumn(Columns::Name),
     m_sortOrder(Qt::AscendingOrder),
     m_lastNewNotebookNameCounter(0),
@@ -77,11 +92,16 @@ NotebookModel::NotebookModel(const Account & account, const NoteModel & noteMode
 {
     createConnections(noteModel, localStorageManagerAsync);
 
-    if (noteModel.allNotesListed()) {
+    // NOTE: in Windowed listing mode the note model doesn't have all the notes to collect their notebook local uids
+    // from, the note counts then come from the local storage only
+    if ((noteModel.listingMode() == NoteModel::ListingMode::Full) && noteModel.allNotesListed()) {
         buildNotebookLocalUidByNoteLocalUidsHash(noteModel);
     }
 
+    m_listNotebooksPipeline.start();
     requestNotebooksList();
+
+    m_listLinkedNotebooksPipeline.start();
     requestLinkedNotebooksList();
 }
 
@@ -699,6 +719,8 @@ QModelIndex NotebookModel::createNotebook(const QString & notebookName,
     item.setLastUsed(numExistingNotebooks == 0);
     item.setUpdatable(true);
     item.setNameIsUpdatable(true);
+    item.setNumNotesPerNotebook(0);
+    m_noteCountsByNotebookLocalUid[item.localUid()] = 0;
 
     auto insertionResult = localUidIndex.insert(item);
 
@@ -763,6 +785,106 @@ bool NotebookModel::allNotebooksListed() const
     return m_allNotebooksListed && m_allLinkedNotebooksListed;
 }
 
+bool NotebookModel::saveSnapshot(const QString & filePath, ErrorString & errorDescription) const
+{
+    QNDEBUG(QStringLiteral("NotebookModel::saveSnapshot: ") << filePath);
+
+    if (!allNotebooksListed()) {
+        errorDescription.setBase(QT_TR_NOOP("Can't save the snapshot of notebooks: not all notebooks have been listed yet"));
+        QNDEBUG(errorDescription);
+        return false;
+    }
+
+    ModelSnapshotWriter writer(NOTEBOOK_MODEL_SNAPSHOT_VERSION);
+    QDataStream & out = writer.stream();
+
+    out << static_cast<qint32>(m_linkedNotebookOwnerUsernamesByLinkedNotebookGuids.size());
+    for(auto it = m_linkedNotebookOwnerUsernamesByLinkedNotebookGuids.constBegin(),
+        end = m_linkedNotebookOwnerUsernamesByLinkedNotebookGuids.constEnd(); it != end; ++it)
+    {
+        out << it.key() << it.value();
+    }
+
+    const NotebookDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
+
+    out << static_cast<qint32>(localUidIndex.size());
+    for(auto it = localUidIndex.begin(), end = localUidIndex.end(); it != end; ++it) {
+        out << *it;
+    }
+
+    return writer.writeToFile(filePath, errorDescription);
+}
+
+bool NotebookModel::restoreFromSnapshot(const QString & filePath, ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("NotebookModel::restoreFromSnapshot: ") << filePath);
+
+    if (m_allNotebooksListed || !m_data.empty()) {
+        errorDescription.setBase(QT_TR_NOOP("Can't restore the snapshot of notebooks: the model already has notebooks"));
+        QNDEBUG(errorDescription);
+        return false;
+    }
+
+    ModelSnapshotReader reader;
+    if (!reader.open(filePath, NOTEBOOK_MODEL_SNAPSHOT_VERSION, errorDescription)) {
+        return false;
+    }
+
+    QDataStream & in = reader.stream();
+
+    QHash<QString,QString> linkedNotebookOwnerUsernamesByLinkedNotebookGuids;
+    qint32 numLinkedNotebooks = 0;
+    in >> numLinkedNotebooks;
+    for(qint32 i = 0; (i < numLinkedNotebooks) && (in.status() == QDataStream::Ok); ++i)
+    {
+        QString linkedNotebookGuid;
+        QString username;
+        in >> linkedNotebookGuid >> username;
+        linkedNotebookOwnerUsernamesByLinkedNotebookGuids[linkedNotebookGuid] = username;
+    }
+
+    std::vector<NotebookItem> items;
+    qint32 numItems = 0;
+    in >> numItems;
+    for(qint32 i = 0; (i < numItems) && (in.status() == QDataStream::Ok); ++i) {
+        NotebookItem item;
+        in >> item;
+        items.push_back(item);
+    }
+
+    if (!reader.checkStatus(errorDescription)) {
+        return false;
+    }
+
+    for(auto it = linkedNotebookOwnerUsernamesByLinkedNotebookGuids.constBegin(),
+        end = linkedNotebookOwnerUsernamesByLinkedNotebookGuids.constEnd(); it != end; ++it)
+    {
+        if (!m_linkedNotebookOwnerUsernamesByLinkedNotebookGuids.contains(it.key())) {
+            Q_UNUSED(m_linkedNotebookOwnerUsernamesByLinkedNotebookGuids.insert(it.key(), it.value()))
+        }
+    }
+
+    const NotebookDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
+
+    for(auto it = items.begin(), end = items.end(); it != end; ++it)
+    {
+        const NotebookItem & item = *it;
+        if (item.localUid().isEmpty() || (localUidIndex.find(item.localUid()) != localUidIndex.end())) {
+            continue;
+        }
+
+        // NOTE: neither the notebook cache nor the default and last used notebook local uids are touched here:
+        // the latter are switched by the listed notebooks and switching them for the restored ones would
+        // modify the previously default or last used notebooks in the local storage
+        addNotebookItem(item);
+        Q_UNUSED(m_restoredLocalUidsPendingReconciliation.insert(item.localUid()))
+    }
+
+    QNDEBUG(QStringLiteral("Restored ") << m_restoredLocalUidsPendingReconciliation.size()
+            << QStringLiteral(" notebooks from the snapshot"));
+    return true;
+}
+
 void NotebookModel::favoriteNotebook(const QModelIndex & index)
 {
     QNDEBUG(QStringLiteral("NotebookModel::favoriteNotebook: index: is valid = ")
@@ -2195,7 +2317,7 @@ void NotebookModel::onAddNotebookComplete(Notebook notebook, QUuid requestId)
     }
 
     onNotebookAddedOrUpdated(notebook);
-    requestNoteCountForNotebook(notebook);
+    Q_UNUSED(requestNoteCountForNotebook(notebook))
 }
 
 void NotebookModel::onAddNotebookFailed(Notebook notebook, ErrorString errorDescription, QUuid requestId)
@@ -2306,7 +2428,13 @@ void NotebookModel::onListNotebooksComplete(LocalStorageManager::ListObjectsOpti
                                             LocalStorageManager::OrderDirection::type orderDirection,
                                             QString linkedNotebookGuid, QList<Notebook> foundNotebooks, QUuid requestId)
 {
-    if (requestId != m_listNotebooksRequestId) {
+    QList<Notebook> readyNotebooks;
+    auto linkedNotebookRequestIt = m_listNotebooksRequestIdsForLinkedNotebookGuids.find(requestId);
+    if (linkedNotebookRequestIt != m_listNotebooksRequestIdsForLinkedNotebookGuids.end()) {
+        Q_UNUSED(m_listNotebooksRequestIdsForLinkedNotebookGuids.erase(linkedNotebookRequestIt))
+        readyNotebooks = foundNotebooks;
+    }
+    else if (!m_listNotebooksPipeline.onRequestComplete(requestId, foundNotebooks, readyNotebooks)) {
         return;
     }
 
@@ -2316,27 +2444,26 @@ void NotebookModel::onListNotebooksComplete(LocalStorageManager::ListObjectsOpti
             << (linkedNotebookGuid.isNull() ? QStringLiteral("<null>") : linkedNotebookGuid) << QStringLiteral(", num found notebooks = ")
             << foundNotebooks.size() << QStringLiteral(", request id = ") << requestId);
 
-    for(auto it = foundNotebooks.constBegin(), end = foundNotebooks.constEnd(); it != end; ++it) {
-        onNotebookAddedOrUpdated(*it);
-        requestNoteCountForNotebook(*it);
+    for(auto it = readyNotebooks.constBegin(), end = readyNotebooks.constEnd(); it != end; ++it)
+    {
+        const Notebook & notebook = *it;
+        onNotebookAddedOrUpdated(notebook);
+        Q_UNUSED(requestNoteCountForNotebook(notebook))
     }
 
-    m_listNotebooksRequestId = QUuid();
-
-    if (!foundNotebooks.isEmpty()) {
-        QNTRACE(QStringLiteral("The number of found notebooks is not empty, requesting more "
-                               "notebooks from the local storage"));
-        m_listNotebooksOffset += static_cast<size_t>(foundNotebooks.size());
+    if (m_listNotebooksPipeline.isActive()) {
+        QNTRACE(QStringLiteral("Not all notebooks are listed yet, requesting more notebooks from the local storage"));
         requestNotebooksList();
         return;
     }
 
-    m_allNotebooksListed = true;
-
-    if (m_allLinkedNotebooksListed) {
-        Q_EMIT notifyAllNotebooksListed();
-        Q_EMIT notifyAllItemsListed();
+    if (!m_ownNotebooksListed) {
+        QNDEBUG(QStringLiteral("Listed all notebooks from user's own account, proceeding to the notebooks from linked notebooks"));
+        m_ownNotebooksListed = true;
+        requestNotebooksListsForLinkedNotebooks();
     }
+
+    checkAndNotifyAllNotebooksListed();
 }
 
 void NotebookModel::onListNotebooksFailed(LocalStorageManager::ListObjectsOptions flag,
@@ -2345,7 +2472,12 @@ void NotebookModel::onListNotebooksFailed(LocalStorageManager::ListObjectsOption
                                           LocalStorageManager::OrderDirection::type orderDirection,
                                           QString linkedNotebookGuid, ErrorString errorDescription, QUuid requestId)
 {
-    if (requestId != m_listNotebooksRequestId) {
+    auto linkedNotebookRequestIt = m_listNotebooksRequestIdsForLinkedNotebookGuids.find(requestId);
+    bool linkedNotebookRequest = (linkedNotebookRequestIt != m_listNotebooksRequestIdsForLinkedNotebookGuids.end());
+    if (linkedNotebookRequest) {
+        Q_UNUSED(m_listNotebooksRequestIdsForLinkedNotebookGuids.erase(linkedNotebookRequestIt))
+    }
+    else if (!m_listNotebooksPipeline.onRequestFailed(requestId)) {
         return;
     }
 
@@ -2355,9 +2487,16 @@ void NotebookModel::onListNotebooksFailed(LocalStorageManager::ListObjectsOption
             << (linkedNotebookGuid.isNull() ? QStringLiteral("<null>") : linkedNotebookGuid) << QStringLiteral(", error description = ")
             << errorDescription << QStringLiteral(", request id = ") << requestId);
 
-    m_listNotebooksRequestId = QUuid();
-
     Q_EMIT notifyError(errorDescription);
+
+    if (linkedNotebookRequest) {
+        // The notebook from this linked notebook would get to the model with the next update of it
+        checkAndNotifyAllNotebooksListed();
+        return;
+    }
+
+    // Failed to list own notebooks, the restored items which weren't listed so far won't get reconciled
+    removeUnreconciledRestoredItems();
 }
 
 void NotebookModel::onExpungeNotebookComplete(Notebook notebook, QUuid requestId)
@@ -2365,6 +2504,8 @@ void NotebookModel::onExpungeNotebookComplete(Notebook notebook, QUuid requestId
     QNDEBUG(QStringLiteral("NotebookModel::onExpungeNotebookComplete: notebook = ") << notebook
             << QStringLiteral("\nRequest id = ") << requestId);
 
+    Q_UNUSED(m_noteCountsByNotebookLocalUid.remove(notebook.localUid()))
+
     auto it = m_expungeNotebookRequestIds.find(requestId);
     if (it != m_expungeNotebookRequestIds.end()) {
         Q_UNUSED(m_expungeNotebookRequestIds.erase(it))
@@ -2389,7 +2530,7 @@ void NotebookModel::onExpungeNotebookFailed(Notebook notebook, ErrorString error
     Q_UNUSED(m_expungeNotebookRequestIds.erase(it))
 
     onNotebookAddedOrUpdated(notebook);
-    requestNoteCountForNotebook(notebook);
+    Q_UNUSED(requestNoteCountForNotebook(notebook))
 }
 
 void NotebookModel::onGetNoteCountPerNotebookComplete(int noteCount, Notebook notebook, QUuid requestId)
@@ -2403,20 +2544,29 @@ void NotebookModel::onGetNoteCountPerNotebookComplete(int noteCount, Notebook no
             << QStringLiteral(", notebook = ") << notebook << QStringLiteral("\nRequest id = ") << requestId);
 
     Q_UNUSED(m_noteCountPerNotebookRequestIds.erase(it))
+    checkNoteCountForAllNotebooksRequestFinished(requestId);
 
     QString notebookLocalUid = notebook.localUid();
+    if (notebookLocalUid.isEmpty() && notebook.hasGuid())
+    {
+        // The count was requested by notebook guid
+        const NotebookDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
+        for(auto itemIt = localUidIndex.begin(), end = localUidIndex.end(); itemIt != end; ++itemIt)
+        {
+            if (itemIt->guid() == notebook.guid()) {
+                notebookLocalUid = itemIt->localUid();
+                break;
+            }
+        }
+    }
 
-    NotebookDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
-    auto itemIt = localUidIndex.find(notebookLocalUid);
-    if (Q_UNLIKELY(itemIt == localUidIndex.end())) {
-        QNDEBUG(QStringLiteral("Can't find the notebook item by local uid: ") << notebookLocalUid);
+    if (Q_UNLIKELY(notebookLocalUid.isEmpty())) {
+        QNDEBUG(QStringLiteral("Can't find the notebook item corresponding to the received note count"));
         return;
     }
 
-    NotebookItem item = *itemIt;
-    item.setNumNotesPerNotebook(noteCount);
-
-    Q_UNUSED(updateNoteCountPerNotebookIndex(item, itemIt))
+    m_noteCountsByNotebookLocalUid[notebookLocalUid] = noteCount;
+    setNoteCountForNotebookItem(notebookLocalUid, noteCount);
 }
 
 void NotebookModel::onGetNoteCountPerNotebookFailed(ErrorString errorDescription, Notebook notebook, QUuid requestId)
@@ -2430,10 +2580,12 @@ void NotebookModel::onGetNoteCountPerNotebookFailed(ErrorString errorDescription
               << QStringLiteral(", notebook: ") << notebook << QStringLiteral("\nRequest id = ") << requestId);
 
     Q_UNUSED(m_noteCountPerNotebookRequestIds.erase(it))
+    checkNoteCountForAllNotebooksRequestFinished(requestId);
 
     // Not much can be done here - will just attempt ot "remove" the count from the item
 
     QString notebookLocalUid = notebook.localUid();
+    Q_UNUSED(m_noteCountsByNotebookLocalUid.remove(notebookLocalUid))
 
     NotebookDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
     auto itemIt = localUidIndex.find(notebookLocalUid);
@@ -2459,17 +2611,12 @@ void NotebookModel::onAddNoteComplete(Note note, QUuid requestId)
             m_notebookLocalUidByNoteLocalUid[note.localUid()] = note.notebookLocalUid();
         }
 
-        bool res = onAddNoteWithNotebookLocalUid(note.notebookLocalUid());
-        if (res) {
-            return;
-        }
+        applyNoteCountDelta(note.notebookLocalUid(), 1);
+        return;
     }
 
     Notebook notebook;
-    if (note.hasNotebookLocalUid()) {
-        notebook.setLocalUid(note.notebookLocalUid());
-    }
-    else if (note.hasNotebookGuid()) {
+    if (note.hasNotebookGuid()) {
         notebook.setGuid(note.notebookGuid());
     }
     else {
@@ -2478,7 +2625,7 @@ void NotebookModel::onAddNoteComplete(Note note, QUuid requestId)
         return;
     }
 
-    requestNoteCountForNotebook(notebook);
+    Q_UNUSED(requestNoteCountForNotebook(notebook))
 }
 
 void NotebookModel::onUpdateNoteComplete(Note note, bool updateResources, bool updateTags, QUuid requestId)
@@ -2526,13 +2673,8 @@ void NotebookModel::onUpdateNoteComplete(Note note, bool updateResources, bool u
     QNDEBUG(QStringLiteral("The note's notebook local uid has changed: was ") << oldNotebookLocalUid
             << QStringLiteral(", now ") << newNotebookLocalUid);
 
-    Notebook oldNotebook;
-    oldNotebook.setLocalUid(oldNotebookLocalUid);
-    requestNoteCountForNotebook(oldNotebook);
-
-    Notebook newNotebook;
-    newNotebook.setLocalUid(newNotebookLocalUid);
-    requestNoteCountForNotebook(newNotebook);
+    applyNoteCountDelta(oldNotebookLocalUid, -1);
+    applyNoteCountDelta(newNotebookLocalUid, 1);
 }
 
 void NotebookModel::onExpungeNoteComplete(Note note, QUuid requestId)
@@ -2541,32 +2683,30 @@ void NotebookModel::onExpungeNoteComplete(Note note, QUuid requestId)
             << QStringLiteral("\nRequest id = ") << requestId);
 
     QString notebookLocalUid;
-    if (note.hasNotebookLocalUid())
-    {
+    if (note.hasNotebookLocalUid()) {
         notebookLocalUid = note.notebookLocalUid();
     }
-    else if (m_receivedNotebookLocalUidsForAllNotes)
+
+    if (m_receivedNotebookLocalUidsForAllNotes)
     {
         auto it = m_notebookLocalUidByNoteLocalUid.find(note.localUid());
-        if (it != m_notebookLocalUidByNoteLocalUid.end()) {
-            notebookLocalUid = it.value();
+        if (it != m_notebookLocalUidByNoteLocalUid.end())
+        {
+            if (notebookLocalUid.isEmpty()) {
+                notebookLocalUid = it.value();
+            }
+
             Q_UNUSED(m_notebookLocalUidByNoteLocalUid.erase(it))
         }
     }
 
-    if (!notebookLocalUid.isEmpty())
-    {
-        bool res = onExpungeNoteWithNotebookLocalUid(note.notebookLocalUid());
-        if (res) {
-            return;
-        }
+    if (!notebookLocalUid.isEmpty()) {
+        applyNoteCountDelta(notebookLocalUid, -1);
+        return;
     }
 
     Notebook notebook;
-    if (!notebookLocalUid.isEmpty()) {
-        notebook.setLocalUid(notebookLocalUid);
-    }
-    else if (note.hasNotebookGuid()) {
+    if (note.hasNotebookGuid()) {
         notebook.setGuid(note.notebookGuid());
     }
     else {
@@ -2575,7 +2715,7 @@ void NotebookModel::onExpungeNoteComplete(Note note, QUuid requestId)
         return;
     }
 
-    requestNoteCountForNotebook(notebook);
+    Q_UNUSED(requestNoteCountForNotebook(notebook))
 }
 
 void NotebookModel::onAddLinkedNotebookComplete(LinkedNotebook linkedNotebook, QUuid requestId)
@@ -2605,6 +2745,19 @@ void NotebookModel::onExpungeLinkedNotebookComplete(LinkedNotebook linkedNoteboo
 
     const QString & linkedNotebookGuid = linkedNotebook.guid();
 
+    Q_UNUSED(m_linkedNotebookGuidsPendingNotebooksListing.removeAll(linkedNotebookGuid))
+
+    for(auto it = m_listNotebooksRequestIdsForLinkedNotebookGuids.begin();
+        it != m_listNotebooksRequestIdsForLinkedNotebookGuids.end(); )
+    {
+        if (it.value() == linkedNotebookGuid) {
+            it = m_listNotebooksRequestIdsForLinkedNotebookGuids.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
     QStringList expungedNotebookLocalUids;
     const NotebookDataByLinkedNotebookGuid & linkedNotebookGuidIndex = m_data.get<ByLinkedNotebookGuid>();
     auto range = linkedNotebookGuidIndex.equal_range(linkedNotebookGuid);
@@ -2659,7 +2812,8 @@ void NotebookModel::onListAllLinkedNotebooksComplete(size_t limit, size_t offset
                                                      QList<LinkedNotebook> foundLinkedNotebooks,
                                                      QUuid requestId)
 {
-    if (requestId != m_listLinkedNotebooksRequestId) {
+    QList<LinkedNotebook> readyLinkedNotebooks;
+    if (!m_listLinkedNotebooksPipeline.onRequestComplete(requestId, foundLinkedNotebooks, readyLinkedNotebooks)) {
         return;
     }
 
@@ -2668,26 +2822,28 @@ void NotebookModel::onListAllLinkedNotebooksComplete(size_t limit, size_t offset
             << order << QStringLiteral(", order direction = ") << orderDirection
             << QStringLiteral(", request id = ") << requestId);
 
-    for(auto it = foundLinkedNotebooks.constBegin(), end = foundLinkedNotebooks.constEnd(); it != end; ++it) {
-        onLinkedNotebookAddedOrUpdated(*it);
+    for(auto it = readyLinkedNotebooks.constBegin(), end = readyLinkedNotebooks.constEnd(); it != end; ++it)
+    {
+        const LinkedNotebook & linkedNotebook = *it;
+        onLinkedNotebookAddedOrUpdated(linkedNotebook);
+
+        if (linkedNotebook.hasGuid()) {
+            m_linkedNotebookGuidsPendingNotebooksListing << linkedNotebook.guid();
+        }
     }
 
-    m_listLinkedNotebooksRequestId = QUuid();
+    if (m_ownNotebooksListed) {
+        requestNotebooksListsForLinkedNotebooks();
+    }
 
-    if (!foundLinkedNotebooks.isEmpty()) {
-        QNTRACE(QStringLiteral("The number of found linked notebooks is not empty, requesting more "
-                               "linked notebooks from the local storage"));
-        m_listLinkedNotebooksOffset += static_cast<size_t>(foundLinkedNotebooks.size());
+    if (m_listLinkedNotebooksPipeline.isActive()) {
+        QNTRACE(QStringLiteral("Not all linked notebooks are listed yet, requesting more linked notebooks from the local storage"));
         requestLinkedNotebooksList();
         return;
     }
 
     m_allLinkedNotebooksListed = true;
-
-    if (m_allNotebooksListed) {
-        Q_EMIT notifyAllNotebooksListed();
-        Q_EMIT notifyAllItemsListed();
-    }
+    checkAndNotifyAllNotebooksListed();
 }
 
 void NotebookModel::onListAllLinkedNotebooksFailed(size_t limit, size_t offset,
@@ -2695,7 +2851,7 @@ void NotebookModel::onListAllLinkedNotebooksFailed(size_t limit, size_t offset,
                                                    LocalStorageManager::OrderDirection::type orderDirection,
                                                    ErrorString errorDescription, QUuid requestId)
 {
-    if (requestId != m_listLinkedNotebooksRequestId) {
+    if (!m_listLinkedNotebooksPipeline.onRequestFailed(requestId)) {
         return;
     }
 
@@ -2704,16 +2860,17 @@ void NotebookModel::onListAllLinkedNotebooksFailed(size_t limit, size_t offset,
             << QStringLiteral(", order direction = ") << orderDirection << QStringLiteral(", error description = ")
             << errorDescription << QStringLiteral(", request id = ") << requestId);
 
-    m_listLinkedNotebooksRequestId = QUuid();
-
     Q_EMIT notifyError(errorDescription);
+
+    // Without the linked notebooks listed the listing of notebooks won't complete
+    removeUnreconciledRestoredItems();
 }
 
 void NotebookModel::createConnections(const NoteModel & noteModel, LocalStorageManagerAsync & localStorageManagerAsync)
 {
     QNDEBUG(QStringLiteral("NotebookModel::createConnections"));
 
-    if (!noteModel.allNotesListed()) {
+    if ((noteModel.listingMode() == NoteModel::ListingMode::Full) && !noteModel.allNotesListed()) {
         QObject::connect(&noteModel, QNSIGNAL(NoteModel,notifyAllNotesListed),
                          this, QNSLOT(NotebookModel,onAllNotesListed));
     }
@@ -2809,19 +2966,78 @@ void NotebookModel::createConnections(const NoteModel & noteModel, LocalStorageM
 
 void NotebookModel::requestNotebooksList()
 {
-    QNDEBUG(QStringLiteral("NotebookModel::requestNotebooksList: offset = ") << m_listNotebooksOffset);
+    QNDEBUG(QStringLiteral("NotebookModel::requestNotebooksList: offset = ") << m_listNotebooksPipeline.appliedOffset());
 
     LocalStorageManager::ListObjectsOptions flags = LocalStorageManager::ListAll;
     LocalStorageManager::ListNotebooksOrder::type order = LocalStorageManager::ListNotebooksOrder::NoOrder;
     LocalStorageManager::OrderDirection::type direction = LocalStorageManager::OrderDirection::Ascending;
 
-    m_listNotebooksRequestId = QUuid::createUuid();
-    QNTRACE(QStringLiteral("Emitting the request to list notebooks: offset = ") << m_listNotebooksOffset
-            << QStringLiteral(", request id = ") << m_listNotebooksRequestId);
-    Q_EMIT listNotebooks(flags, NOTEBOOK_LIST_LIMIT, m_listNotebooksOffset, order, direction, QString(), m_listNotebooksRequestId);
+    // NOTE: empty but not null linked notebook guid means listing the notebooks from user's own account only,
+    // these are listed first so that the top level notebooks and stacks appear in the model before anything else;
+    // the notebooks from linked notebooks are listed afterwards, see requestNotebooksListsForLinkedNotebooks
+    QString linkedNotebookGuid = QStringLiteral("");
+
+    QList<ListNotebooksPipeline::Request> requests = m_listNotebooksPipeline.takeRequestsToSend();
+    for(auto it = requests.constBegin(), end = requests.constEnd(); it != end; ++it)
+    {
+        const ListNotebooksPipeline::Request & request = *it;
+        QNTRACE(QStringLiteral("Emitting the request to list notebooks: offset = ") << request.m_offset
+                << QStringLiteral(", limit = ") << request.m_limit << QStringLiteral(", request id = ") << request.m_requestId);
+        Q_EMIT listNotebooks(flags, request.m_limit, request.m_offset, order, direction, linkedNotebookGuid, request.m_requestId);
+    }
 }
 
-void NotebookModel::requestNoteCountForNotebook(const Notebook & notebook)
+void NotebookModel::requestNotebooksListsForLinkedNotebooks()
+{
+    QNDEBUG(QStringLiteral("NotebookModel::requestNotebooksListsForLinkedNotebooks: ")
+            << m_linkedNotebookGuidsPendingNotebooksListing.join(QStringLiteral(", ")));
+
+    LocalStorageManager::ListObjectsOptions flags = LocalStorageManager::ListAll;
+    LocalStorageManager::ListNotebooksOrder::type order = LocalStorageManager::ListNotebooksOrder::NoOrder;
+    LocalStorageManager::OrderDirection::type direction = LocalStorageManager::OrderDirection::Ascending;
+
+    // NOTE: each linked notebook holds exactly one notebook so there's no need to list them page by page;
+    // zero limit means no limit
+    size_t limit = 0, offset = 0;
+
+    for(auto it = m_linkedNotebookGuidsPendingNotebooksListing.constBegin(),
+        end = m_linkedNotebookGuidsPendingNotebooksListing.constEnd(); it != end; ++it)
+    {
+        const QString & linkedNotebookGuid = *it;
+
+        QUuid requestId = QUuid::createUuid();
+        m_listNotebooksRequestIdsForLinkedNotebookGuids[requestId] = linkedNotebookGuid;
+        QNTRACE(QStringLiteral("Emitting the request to list notebooks: linked notebook guid = ") << linkedNotebookGuid
+                << QStringLiteral(", request id = ") << requestId);
+        Q_EMIT listNotebooks(flags, limit, offset, order, direction, linkedNotebookGuid, requestId);
+    }
+
+    m_linkedNotebookGuidsPendingNotebooksListing.clear();
+}
+
+void NotebookModel::checkAndNotifyAllNotebooksListed()
+{
+    if (m_allNotebooksListed) {
+        return;
+    }
+
+    if (!m_ownNotebooksListed || !m_allLinkedNotebooksListed) {
+        return;
+    }
+
+    if (!m_linkedNotebookGuidsPendingNotebooksListing.isEmpty() || !m_listNotebooksRequestIdsForLinkedNotebookGuids.isEmpty()) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("NotebookModel::checkAndNotifyAllNotebooksListed: listed all notebooks"));
+
+    m_allNotebooksListed = true;
+    removeUnreconciledRestoredItems();
+    Q_EMIT notifyAllNotebooksListed();
+    Q_EMIT notifyAllItemsListed();
+}
+
+QUuid NotebookModel::requestNoteCountForNotebook(const Notebook & notebook)
 {
     QNDEBUG(QStringLiteral("NotebookModel::requestNoteCountForNotebook: ") << notebook);
 
@@ -2829,33 +3045,76 @@ void NotebookModel::requestNoteCountForNotebook(const Notebook & notebook)
     Q_UNUSED(m_noteCountPerNotebookRequestIds.insert(requestId))
     QNTRACE(QStringLiteral("Emitting request to get the note count per notebook: request id = ") << requestId);
     Q_EMIT requestNoteCountPerNotebook(notebook, requestId);
+    return requestId;
 }
 
 void NotebookModel::requestNoteCountForAllNotebooks()
 {
     QNDEBUG(QStringLiteral("NotebookModel::requestNoteCountForAllNotebooks"));
 
+    // NOTE: the note counts already received within the pending recount don't account for the change of notes
+    // which caused this request, hence the recount is repeated once all the pending note counts are received
+    if (!m_noteCountForAllNotebooksRequestIds.isEmpty()) {
+        QNDEBUG(QStringLiteral("The recount of notes for all notebooks is already pending, will repeat it once it's finished"));
+        m_noteCountForAllNotebooksDirty = true;
+        return;
+    }
+
+    m_noteCountForAllNotebooksDirty = false;
+
+    // NOTE: all the request ids are registered before emitting any of the requests since the local storage
+    // might process them synchronously, otherwise the recount could be considered finished after the first note count
+    QList<Notebook> notebooks;
+    QList<QUuid> requestIds;
+
     const NotebookDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
 
-    for(auto it = localUidIndex.begin(), end = localUidIndex.end(); it != end; ++it) {
+    for(auto it = localUidIndex.begin(), end = localUidIndex.end(); it != end; ++it)
+    {
         const NotebookItem & item = *it;
         Notebook notebook;
         notebook.setLocalUid(item.localUid());
-        requestNoteCountForNotebook(notebook);
+        notebooks << notebook;
+
+        QUuid requestId = QUuid::createUuid();
+        Q_UNUSED(m_noteCountPerNotebookRequestIds.insert(requestId))
+        Q_UNUSED(m_noteCountForAllNotebooksRequestIds.insert(requestId))
+        requestIds << requestId;
+    }
+
+    for(int i = 0, size = notebooks.size(); i < size; ++i) {
+        QNTRACE(QStringLiteral("Emitting request to get the note count per notebook: request id = ") << requestIds[i]);
+        Q_EMIT requestNoteCountPerNotebook(notebooks[i], requestIds[i]);
+    }
+}
+
+void NotebookModel::checkNoteCountForAllNotebooksRequestFinished(const QUuid & requestId)
+{
+    if (!m_noteCountForAllNotebooksRequestIds.remove(requestId) || !m_noteCountForAllNotebooksRequestIds.isEmpty()) {
+        return;
+    }
+
+    if (m_noteCountForAllNotebooksDirty) {
+        QNDEBUG(QStringLiteral("Notes have changed since the recount of notes for all notebooks was requested, repeating it"));
+        requestNoteCountForAllNotebooks();
     }
 }
 
 void NotebookModel::requestLinkedNotebooksList()
 {
-    QNDEBUG(QStringLiteral("NotebookModel::requestLinkedNotebooksList: offset = ") << m_listLinkedNotebooksOffset);
+    QNDEBUG(QStringLiteral("NotebookModel::requestLinkedNotebooksList: offset = ") << m_listLinkedNotebooksPipeline.appliedOffset());
 
     LocalStorageManager::ListLinkedNotebooksOrder::type order = LocalStorageManager::ListLinkedNotebooksOrder::NoOrder;
     LocalStorageManager::OrderDirection::type direction = LocalStorageManager::OrderDirection::Ascending;
 
-    m_listLinkedNotebooksRequestId = QUuid::createUuid();
-    QNTRACE(QStringLiteral("Emitting the request to list linked notebooks: offset = ") << m_listLinkedNotebooksOffset
-            << QStringLiteral(", request id = ") << m_listLinkedNotebooksRequestId);
-    Q_EMIT listAllLinkedNotebooks(LINKED_NOTEBOOK_LIST_LIMIT, m_listLinkedNotebooksOffset, order, direction, m_listLinkedNotebooksRequestId);
+    QList<ListLinkedNotebooksPipeline::Request> requests = m_listLinkedNotebooksPipeline.takeRequestsToSend();
+    for(auto it = requests.constBegin(), end = requests.constEnd(); it != end; ++it)
+    {
+        const ListLinkedNotebooksPipeline::Request & request = *it;
+        QNTRACE(QStringLiteral("Emitting the request to list linked notebooks: offset = ") << request.m_offset
+                << QStringLiteral(", limit = ") << request.m_limit << QStringLiteral(", request id = ") << request.m_requestId);
+        Q_EMIT listAllLinkedNotebooks(request.m_limit, request.m_offset, order, direction, request.m_requestId);
+    }
 }
 
 QVariant NotebookModel::dataImpl(const NotebookModelItem & item, const Columns::type column) const
@@ -3184,6 +3443,8 @@ void NotebookModel::onNotebookAddedOrUpdated(const Notebook & notebook)
 {
     NotebookDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
 
+    Q_UNUSED(m_restoredLocalUidsPendingReconciliation.remove(notebook.localUid()))
+
     m_cache.put(notebook.localUid(), notebook);
 
     auto itemIt = localUidIndex.find(notebook.localUid());
@@ -3213,6 +3474,14 @@ void NotebookModel::onNotebookAdded(const Notebook & notebook)
 {
     QNDEBUG(QStringLiteral("NotebookModel::onNotebookAdded: notebook local uid = ") << notebook.localUid());
 
+    NotebookItem item;
+    notebookToItem(notebook, item);
+
+    addNotebookItem(item);
+}
+
+void NotebookModel::addNotebookItem(const NotebookItem & item)
+{
     NotebookDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
 
     const NotebookModelItem * pParentItem = Q_NULLPTR;
@@ -3221,25 +3490,25 @@ void NotebookModel::onNotebookAdded(const Notebook & notebook)
         m_fakeRootItem = new NotebookModelItem;
     }
 
-    if (notebook.hasStack())
+    if (!item.stack().isEmpty())
     {
         ModelItems * pModelItemsByStack = Q_NULLPTR;
         StackItems * pStackItems = Q_NULLPTR;
         const NotebookModelItem * pGrandParentItem = Q_NULLPTR;
 
-        if (!notebook.hasLinkedNotebookGuid()) {
+        if (item.linkedNotebookGuid().isEmpty()) {
             pModelItemsByStack = &m_modelItemsByStack;
             pStackItems = &m_stackItems;
             pGrandParentItem = m_fakeRootItem;
         }
         else {
-            const QString & linkedNotebookGuid = notebook.linkedNotebookGuid();
+            const QString & linkedNotebookGuid = item.linkedNotebookGuid();
             pModelItemsByStack = &(m_modelItemsByStackByLinkedNotebookGuid[linkedNotebookGuid]);
             pStackItems = &(m_stackItemsByLinkedNotebookGuid[linkedNotebookGuid]);
             pGrandParentItem = &(findOrCreateLinkedNotebookModelItem(linkedNotebookGuid));
         }
 
-        const QString & stack = notebook.stack();
+        const QString & stack = item.stack();
         auto it = pModelItemsByStack->find(stack);
         if (it == pModelItemsByStack->end()) {
             auto stackItemIt = pStackItems->insert(stack, NotebookStackItem(stack));
@@ -3248,20 +3517,17 @@ void NotebookModel::onNotebookAdded(const Notebook & notebook)
 
         pParentItem = &(*it);
     }
-    else if (!notebook.hasLinkedNotebookGuid())
+    else if (item.linkedNotebookGuid().isEmpty())
     {
         pParentItem = m_fakeRootItem;
     }
     else
     {
-        pParentItem = &(findOrCreateLinkedNotebookModelItem(notebook.linkedNotebookGuid()));
+        pParentItem = &(findOrCreateLinkedNotebookModelItem(item.linkedNotebookGuid()));
     }
 
     QModelIndex parentIndex = indexForItem(pParentItem);
 
-    NotebookItem item;
-    notebookToItem(notebook, item);
-
     int row = pParentItem->numChildren();
 
     auto insertionResult = localUidIndex.insert(item);
@@ -3508,6 +3774,8 @@ void NotebookModel::removeItemByLocalUid(const QString & localUid)
 {
     QNDEBUG(QStringLiteral("NotebookModel::removeItemByLocalUid: local uid = ") << localUid);
 
+    Q_UNUSED(m_restoredLocalUidsPendingReconciliation.remove(localUid))
+
     NotebookDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
     auto itemIt = localUidIndex.find(localUid);
     if (Q_UNLIKELY(itemIt == localUidIndex.end())) {
@@ -3724,43 +3992,52 @@ void NotebookModel::updatePersistentModelIndices()
     }
 }
 
-bool NotebookModel::onAddNoteWithNotebookLocalUid(const QString & notebookLocalUid)
+void NotebookModel::applyNoteCountDelta(const QString & notebookLocalUid, const int delta)
 {
-    QNDEBUG(QStringLiteral("NotebookModel::onAddNoteWithNotebookLocalUid: ") << notebookLocalUid);
+    QNDEBUG(QStringLiteral("NotebookModel::applyNoteCountDelta: notebook local uid = ") << notebookLocalUid
+            << QStringLiteral(", delta = ") << delta);
 
-    NotebookDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
-    auto it = localUidIndex.find(notebookLocalUid);
-    if (Q_UNLIKELY(it == localUidIndex.end())) {
-        QNDEBUG(QStringLiteral("Wasn't able to find the notebook item by the specified local uid"));
-        return false;
+    auto countIt = m_noteCountsByNotebookLocalUid.find(notebookLocalUid);
+    if (countIt == m_noteCountsByNotebookLocalUid.end()) {
+        QNDEBUG(QStringLiteral("The note count for this notebook hasn't been received from the local storage yet"));
+        return;
     }
 
-    NotebookItem item = *it;
-    int noteCount = item.numNotesPerNotebook();
-    ++noteCount;
-    item.setNumNotesPerNotebook(noteCount);
+    int noteCount = countIt.value() + delta;
+    if (Q_UNLIKELY(noteCount < 0))
+    {
+        QNINFO(QStringLiteral("Detected the drift of delta-maintained note count for notebook ") << notebookLocalUid
+               << QStringLiteral(", requesting the recount"));
 
-    return updateNoteCountPerNotebookIndex(item, it);
+        Q_UNUSED(m_noteCountsByNotebookLocalUid.erase(countIt))
+
+        Notebook notebook;
+        notebook.setLocalUid(notebookLocalUid);
+        Q_UNUSED(requestNoteCountForNotebook(notebook))
+        return;
+    }
+
+    countIt.value() = noteCount;
+    setNoteCountForNotebookItem(notebookLocalUid, noteCount);
 }
 
-bool NotebookModel::onExpungeNoteWithNotebookLocalUid(const QString & notebookLocalUid)
+void NotebookModel::setNoteCountForNotebookItem(const QString & notebookLocalUid, const int noteCount)
 {
-    QNDEBUG(QStringLiteral("NotebookModel::onExpungeNoteWithNotebookLocalUid: ") << notebookLocalUid);
-
     NotebookDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
-    auto it = localUidIndex.find(notebookLocalUid);
-    if (Q_UNLIKELY(it == localUidIndex.end())) {
-        QNDEBUG(QStringLiteral("Wasn't able to find the notebook item by the specified local uid"));
-        return false;
+    auto itemIt = localUidIndex.find(notebookLocalUid);
+    if (Q_UNLIKELY(itemIt == localUidIndex.end())) {
+        QNDEBUG(QStringLiteral("Can't find the notebook item by local uid: ") << notebookLocalUid);
+        return;
     }
 
-    NotebookItem item = *it;
-    int noteCount = item.numNotesPerNotebook();
-    --noteCount;
-    noteCount = std::max(noteCount, 0);
+    if (itemIt->numNotesPerNotebook() == noteCount) {
+        return;
+    }
+
+    NotebookItem item = *itemIt;
     item.setNumNotesPerNotebook(noteCount);
 
-    return updateNoteCountPerNotebookIndex(item, it);
+    Q_UNUSED(updateNoteCountPerNotebookIndex(item, itemIt))
 }
 
 void NotebookModel::switchDefaultNotebookLocalUid(const QString & localUid)
@@ -3931,6 +4208,27 @@ void NotebookModel::checkAndRemoveEmptyStackItem(const NotebookModelItem & model
     }
 }
 
+void NotebookModel::removeUnreconciledRestoredItems()
+{
+    if (m_restoredLocalUidsPendingReconciliation.isEmpty()) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("Removing ") << m_restoredLocalUidsPendingReconciliation.size()
+            << QStringLiteral(" restored notebook items which no longer exist in the local storage"));
+
+    QSet<QString> localUids = m_restoredLocalUidsPendingReconciliation;
+    m_restoredLocalUidsPendingReconciliation.clear();
+
+    Q_EMIT aboutToRemoveNotebooks();
+
+    for(auto it = localUids.constBegin(), end = localUids.constEnd(); it != end; ++it) {
+        removeItemByLocalUid(*it);
+    }
+
+    Q_EMIT removedNotebooks();
+}
+
 void NotebookModel::setNotebookFavorited(const QModelIndex & index, const bool favorited)
 {
     if (Q_UNLIKELY(!index.isValid())) {
@@ -3994,29 +4292,8 @@ void NotebookModel::buildNotebookLocalUidByNoteLocalUidsHash(const NoteModel & n
 {
     QNDEBUG(QStringLiteral("NotebookModel::buildNotebookLocalUidByNoteLocalUidsHash"));
 
-    m_notebookLocalUidByNoteLocalUid.clear();
-
-    int numNotes = noteModel.rowCount(QModelIndex());
-    for(int i = 0; i < numNotes; ++i)
-    {
-        const NoteModelItem * pNoteModelItem = noteModel.itemAtRow(i);
-        if (Q_UNLIKELY(!pNoteModelItem)) {
-            QNWARNING(QStringLiteral("Can't find note model item at row ") << i << QStringLiteral(" even though there are ")
-                      << numNotes << QStringLiteral(" rows within the model"));
-            continue;
-        }
-
-        const QString & notebookLocalUid = pNoteModelItem->notebookLocalUid();
-        if (Q_UNLIKELY(notebookLocalUid.isEmpty())) {
-            QNWARNING(QStringLiteral("Found note model item without notebook local uid: ") << *pNoteModelItem);
-            continue;
-        }
-
-        QNTRACE(QStringLiteral("Notebook local uid for note local uid ") << pNoteModelItem->localUid()
-                << QStringLiteral(": ") << notebookLocalUid);
-
-        m_notebookLocalUidByNoteLocalUid[pNoteModelItem->localUid()] = notebookLocalUid;
-    }
+    m_notebookLocalUidByNoteLocalUid = noteModel.notebookLocalUidsByNoteLocalUids();
+    QNTRACE(QStringLiteral("Notebook local uids are known for ") << m_notebookLocalUidByNoteLocalUid.size() << QStringLiteral(" notes"));
 
     m_receivedNotebookLocalUidsForAllNotes = true;
 }
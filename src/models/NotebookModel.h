@@ -22,6 +22,7 @@
 #include "ItemModel.h"
 #include "NotebookModelItem.h"
 #include "NotebookCache.h"
+#include "ListRequestPipeline.hpp"
 #include <quentier/local_storage/LocalStorageManagerAsync.h>
 #include <quentier/types/Account.h>
 #include <QAbstractItemModel>
@@ -209,6 +210,28 @@ public:
      */
     bool allNotebooksListed() const;
 
+    /**
+     * @brief saveSnapshot - writes all the model's notebook items into the snapshot file so that the next instance
+     * of the model for the same account could show them before they are listed from the local storage
+     * @param filePath - the path to the snapshot file
+     * @param errorDescription - the textual description of the error if the snapshot was not saved
+     * @return false if not all notebooks have been listed yet or if the snapshot could not be written
+     */
+    bool saveSnapshot(const QString & filePath, ErrorString & errorDescription) const;
+
+    /**
+     * @brief restoreFromSnapshot - fills the model with the notebook items from the snapshot file written by saveSnapshot
+     *
+     * The restored items are reconciled with the notebooks being listed from the local storage: they are updated
+     * as the corresponding notebooks are listed and the ones not listed by the end of the listing are removed
+     * from the model before notifyAllNotebooksListed is emitted
+     *
+     * @param filePath - the path to the snapshot file
+     * @param errorDescription - the textual description of the error if the snapshot was not restored
+     * @return false if the model already has some notebooks or if the snapshot could not be read
+     */
+    bool restoreFromSnapshot(const QString & filePath, ErrorString & errorDescription);
+
     /**
      * @brief favoriteNotebook - marks the notebook pointed to by the index as favorited
      *
@@ -375,8 +398,11 @@ private Q_SLOTS:
 private:
     void createConnections(const NoteModel & noteModel, LocalStorageManagerAsync & localStorageManagerAsync);
     void requestNotebooksList();
-    void requestNoteCountForNotebook(const Notebook & notebook);
+    void requestNotebooksListsForLinkedNotebooks();
+    void checkAndNotifyAllNotebooksListed();
+    QUuid requestNoteCountForNotebook(const Notebook & notebook);
     void requestNoteCountForAllNotebooks();
+    void checkNoteCountForAllNotebooksRequestFinished(const QUuid & requestId);
     void requestLinkedNotebooksList();
 
     QVariant dataImpl(const NotebookModelItem & item, const Columns::type column) const;
@@ -401,17 +427,25 @@ private:
 
     void updatePersistentModelIndices();
 
-    // Returns true if successfully incremented the note count for the notebook item with the corresponding local uid
-    bool onAddNoteWithNotebookLocalUid(const QString & notebookLocalUid);
-
-    // Returns true if successfully decremented the note count for the notebook item with the corresponding local uid
-    bool onExpungeNoteWithNotebookLocalUid(const QString & notebookLocalUid);
+    /**
+     * @brief applyNoteCountDelta - adjusts the in-memory note count for the notebook with the specified local uid
+     * after some note has been added to (positive delta) or removed from (negative delta) it and reflects
+     * the new count within the notebook item
+     *
+     * The delta is ignored if the note count for the notebook has not been received from the local storage yet:
+     * the pending count already accounts for it. If the count would become negative, it is considered to have
+     * drifted from the local storage and the recount of notes for this notebook is requested.
+     */
+    void applyNoteCountDelta(const QString & notebookLocalUid, const int delta);
+    void setNoteCountForNotebookItem(const QString & notebookLocalUid, const int noteCount);
 
     void switchDefaultNotebookLocalUid(const QString & localUid);
     void switchLastUsedNotebookLocalUid(const QString & localUid);
 
     void checkAndRemoveEmptyStackItem(const NotebookModelItem & modelItem);
 
+    void removeUnreconciledRestoredItems();
+
     void setNotebookFavorited(const QModelIndex & index, const bool favorited);
 
     void beginRemoveNotebooks();
@@ -436,7 +470,7 @@ private:
             >,
             boost::multi_index::ordered_non_unique<
                 boost::multi_index::tag<ByNameUpper>,
-                boost::multi_index::const_mem_fun<NotebookItem,QString,&NotebookItem::nameUpper>
+                boost::multi_index::const_mem_fun<NotebookItem,const QString&,&NotebookItem::nameUpper>
             >,
             boost::multi_index::ordered_non_unique<
                 boost::multi_index::tag<ByStack>,
@@ -488,6 +522,9 @@ private:
     typedef QMap<QString, NotebookStackItem> StackItems;
     typedef QMap<QString, NotebookLinkedNotebookRootItem> LinkedNotebookItems;
 
+    typedef ListRequestPipeline<Notebook> ListNotebooksPipeline;
+    typedef ListRequestPipeline<LinkedNotebook> ListLinkedNotebooksPipeline;
+
 #if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
     typedef quint32 IndexId;
 #else
@@ -513,6 +550,7 @@ private:
 private:
     void onNotebookAddedOrUpdated(const Notebook & notebook);
     void onNotebookAdded(const Notebook & notebook);
+    void addNotebookItem(const NotebookItem & item);
     void onNotebookUpdated(const Notebook & notebook, NotebookDataByLocalUid::iterator it);
 
     void onLinkedNotebookAddedOrUpdated(const LinkedNotebook & linkedNotebook);
@@ -553,10 +591,18 @@ private:
 
     NotebookCache &         m_cache;
 
-    size_t                  m_listNotebooksOffset;
-    QUuid                   m_listNotebooksRequestId;
+    ListNotebooksPipeline   m_listNotebooksPipeline;
+    bool                    m_ownNotebooksListed;
+
+    // Guids of the linked notebooks which notebooks are to be listed after the notebooks from user's own account
+    QStringList             m_linkedNotebookGuidsPendingNotebooksListing;
+    QHash<QUuid, QString>   m_listNotebooksRequestIdsForLinkedNotebookGuids;
+
     QSet<QUuid>             m_notebookItemsNotYetInLocalStorageUids;
 
+    // Local uids of the notebook items restored from the snapshot which have not been listed from the local storage yet
+    QSet<QString>           m_restoredLocalUidsPendingReconciliation;
+
     QSet<QUuid>             m_addNotebookRequestIds;
     QSet<QUuid>             m_updateNotebookRequestIds;
     QSet<QUuid>             m_expungeNotebookRequestIds;
@@ -566,12 +612,21 @@ private:
 
     QSet<QUuid>             m_noteCountPerNotebookRequestIds;
 
+    // The subset of the above request ids which belong to the pending recount of notes for all notebooks
+    QSet<QUuid>             m_noteCountForAllNotebooksRequestIds;
+
+    // Notes have changed since the pending recount of notes for all notebooks was requested
+    bool                    m_noteCountForAllNotebooksDirty;
+
+    // Note counts per notebook local uid, received from the local storage once per notebook and then
+    // maintained from the note add, update and expunge events
+    QHash<QString, int>     m_noteCountsByNotebookLocalUid;
+
     QHash<QString, QString> m_notebookLocalUidByNoteLocalUid;
     bool                    m_receivedNotebookLocalUidsForAllNotes;
 
     QHash<QString,QString>  m_linkedNotebookOwnerUsernamesByLinkedNotebookGuids;
-    size_t                  m_listLinkedNotebooksOffset;
-    QUuid                   m_listLinkedNotebooksRequestId;
+    ListLinkedNotebooksPipeline     m_listLinkedNotebooksPipeline;
 
     Columns::type           m_sortedColumn;
     Qt::SortOrder           m_sortOrder;
@@ -17,6 +17,7 @@
  */
 
 #include "NotebookModelItem.h"
+#include <algorithm>
 
 namespace quentier {
 
@@ -30,6 +31,7 @@ NotebookModelItem::NotebookModelItem(const Type::type type,
     m_pNotebookStackItem(notebookStackItem),
     m_pNotebookLinkedNotebookItem(notebookLinkedNotebookItem),
     m_pParent(Q_NULLPTR),
+    m_row(-1),
     m_children()
 {
     if (parent) {
@@ -60,7 +62,16 @@ const NotebookModelItem * NotebookModelItem::childAtRow(const int row) const
 
 int NotebookModelItem::rowForChild(const NotebookModelItem * child) const
 {
-    return m_children.indexOf(child);
+    if (Q_UNLIKELY(!child) || (child->m_pParent != this)) {
+        return -1;
+    }
+
+    int row = child->m_row;
+    if ((row < 0) || (row >= m_children.size()) || (m_children[row] != child)) {
+        return -1;
+    }
+
+    return row;
 }
 
 void NotebookModelItem::insertChild(const int row, const NotebookModelItem * item) const
@@ -71,6 +82,7 @@ void NotebookModelItem::insertChild(const int row, const NotebookModelItem * ite
 
     item->m_pParent = this;
     m_children.insert(row, item);
+    updateChildRows(row);
 }
 
 void NotebookModelItem::addChild(const NotebookModelItem * item) const
@@ -80,6 +92,7 @@ void NotebookModelItem::addChild(const NotebookModelItem * item) const
     }
 
     item->m_pParent = this;
+    item->m_row = m_children.size();
     m_children.push_back(item);
 }
 
@@ -92,6 +105,7 @@ bool NotebookModelItem::swapChildren(const int sourceRow, const int destRow) con
     }
 
     m_children.swap(sourceRow, destRow);
+    updateChildRows(std::min(sourceRow, destRow));
     return true;
 }
 
@@ -102,13 +116,28 @@ const NotebookModelItem * NotebookModelItem::takeChild(const int row) const
     }
 
     const NotebookModelItem * item = m_children.takeAt(row);
-    if (item) {
+    if (item && (item->m_pParent == this)) {
         item->m_pParent = Q_NULLPTR;
+        item->m_row = -1;
     }
 
+    updateChildRows(row);
     return item;
 }
 
+void NotebookModelItem::updateChildRows(const int firstRow) const
+{
+    // NOTE: the copies of the item share the pointers to children with the original
+    // so only the rows of children actually belonging to this item are updated
+    for(int i = std::max(firstRow, 0), size = m_children.size(); i < size; ++i)
+    {
+        const NotebookModelItem * pChild = m_children[i];
+        if (pChild && (pChild->m_pParent == this)) {
+            pChild->m_row = i;
+        }
+    }
+}
+
 QTextStream & NotebookModelItem::print(QTextStream & strm) const
 {
     strm << QStringLiteral("Notebook model item (")
@@ -61,6 +61,12 @@ public:
     const NotebookModelItem * parent() const { return m_pParent; }
     void setParent(const NotebookModelItem * parent) const;
 
+    /**
+     * @return the row of this item within its parent item or -1 if the item has no parent; the row is cached
+     * within the item and kept up to date by all the methods changing the parent's children
+     */
+    int row() const { return m_row; }
+
     const NotebookModelItem * childAtRow(const int row) const;
     int rowForChild(const NotebookModelItem * child) const;
 
@@ -79,6 +85,9 @@ public:
     friend QDataStream & operator<<(QDataStream & out, const NotebookModelItem & item);
     friend QDataStream & operator>>(QDataStream & in, NotebookModelItem & item);
 
+private:
+    void updateChildRows(const int firstRow) const;
+
 private:
     Type::type                  m_type;
     const NotebookItem *        m_pNotebookItem;
@@ -91,6 +100,7 @@ private:
     // however, these pointers to parent and children don't really affect
     // that container's indices
     mutable const NotebookModelItem *       m_pParent;
+    mutable int                             m_row;
     mutable QList<const NotebookModelItem*> m_children;
 };
 
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2016 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ParallelSort.h"
+
+namespace quentier {
+
+void runParallelSortSteps(std::vector<QRunnable*> & steps, QSemaphore & doneSemaphore, QThreadPool * pThreadPool)
+{
+    const size_t numSteps = steps.size();
+    for(size_t i = 0; i < numSteps; ++i)
+    {
+        QRunnable * pStep = steps[i];
+
+        // NOTE: the last step is always run within the current thread which would wait for the others anyway
+        if (pThreadPool && ((i + 1) < numSteps) && pThreadPool->tryStart(pStep)) {
+            continue;
+        }
+
+        pStep->run();
+        delete pStep;
+    }
+
+    doneSemaphore.acquire(static_cast<int>(numSteps));
+}
+
+AsyncSortTask::AsyncSortTask(QObject * parent) :
+    QObject(parent),
+    QRunnable(),
+    m_cancelled(0)
+{
+    // NOTE: the sort results are read after the task has finished, hence the task is not deleted by the thread pool
+    setAutoDelete(false);
+}
+
+void AsyncSortTask::cancel()
+{
+    Q_UNUSED(m_cancelled.fetchAndStoreOrdered(1))
+}
+
+bool AsyncSortTask::isCancelled() const
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+    return (m_cancelled.loadAcquire() != 0);
+#else
+    return (static_cast<int>(m_cancelled) != 0);
+#endif
+}
+
+} // namespace quentier
@@ -0,0 +1,245 @@
+/*
+ * Copyright 2016 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUENTIER_MODELS_PARALLEL_SORT_H
+#define QUENTIER_MODELS_PARALLEL_SORT_H
+
+#include <quentier/utility/Macros.h>
+#include <QObject>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QAtomicInt>
+#include <algorithm>
+#include <vector>
+
+// The minimal number of elements worth sorting within a separate thread
+#define PARALLEL_SORT_MIN_CHUNK_SIZE (4096)
+
+namespace quentier {
+
+/**
+ * @brief The ParallelSortStep class either sorts a single chunk of the range or merges two adjacent sorted chunks
+ * within the thread pool's thread
+ */
+template <typename RandomAccessIterator, typename Comparator>
+class ParallelSortStep: public QRunnable
+{
+public:
+    ParallelSortStep(RandomAccessIterator begin, RandomAccessIterator middle, RandomAccessIterator end,
+                     const bool merge, const Comparator & comparator, QSemaphore & doneSemaphore) :
+        QRunnable(),
+        m_begin(begin),
+        m_middle(middle),
+        m_end(end),
+        m_merge(merge),
+        m_comparator(comparator),
+        m_doneSemaphore(doneSemaphore)
+    {}
+
+    virtual void run() Q_DECL_OVERRIDE
+    {
+        if (m_merge) {
+            std::inplace_merge(m_begin, m_middle, m_end, m_comparator);
+        }
+        else {
+            std::sort(m_begin, m_end, m_comparator);
+        }
+
+        m_doneSemaphore.release();
+    }
+
+private:
+    RandomAccessIterator    m_begin;
+    RandomAccessIterator    m_middle;
+    RandomAccessIterator    m_end;
+    bool                    m_merge;
+    Comparator              m_comparator;
+    QSemaphore &            m_doneSemaphore;
+};
+
+/**
+ * @brief runParallelSortSteps - runs the passed in steps on the thread pool and waits for all of them to finish;
+ * the steps for which the thread pool has no free thread are run within the calling thread so that waiting
+ * on a pool's thread for other pool's threads can never deadlock
+ */
+void runParallelSortSteps(std::vector<QRunnable*> & steps, QSemaphore & doneSemaphore, QThreadPool * pThreadPool);
+
+/**
+ * @brief parallelSort - sorts the range with the parallel merge sort: the range is split into chunks
+ * sorted within separate threads which are then merged pairwise, also in parallel
+ */
+template <typename RandomAccessIterator, typename Comparator>
+void parallelSort(RandomAccessIterator begin, RandomAccessIterator end, const Comparator & comparator,
+                  QThreadPool * pThreadPool = QThreadPool::globalInstance())
+{
+    const qint64 size = static_cast<qint64>(end - begin);
+    const qint64 numChunks = std::min(static_cast<qint64>(std::max(QThread::idealThreadCount(), 1)),
+                                      size / PARALLEL_SORT_MIN_CHUNK_SIZE);
+    if (numChunks < 2) {
+        std::sort(begin, end, comparator);
+        return;
+    }
+
+    typedef ParallelSortStep<RandomAccessIterator, Comparator> Step;
+
+    std::vector<RandomAccessIterator> bounds;
+    bounds.reserve(static_cast<size_t>(numChunks + 1));
+    for(qint64 i = 0; i < numChunks; ++i) {
+        bounds.push_back(begin + size * i / numChunks);
+    }
+    bounds.push_back(end);
+
+    QSemaphore doneSemaphore;
+    std::vector<QRunnable*> steps;
+    steps.reserve(static_cast<size_t>(numChunks));
+    for(size_t i = 0, numBounds = bounds.size(); (i + 1) < numBounds; ++i) {
+        steps.push_back(new Step(bounds[i], bounds[i], bounds[i + 1], /* merge = */ false, comparator, doneSemaphore));
+    }
+
+    runParallelSortSteps(steps, doneSemaphore, pThreadPool);
+
+    while(bounds.size() > 2)
+    {
+        steps.clear();
+
+        std::vector<RandomAccessIterator> mergedBounds;
+        mergedBounds.reserve(bounds.size() / 2 + 1);
+
+        size_t i = 0;
+        for(; (i + 2) < bounds.size(); i += 2) {
+            steps.push_back(new Step(bounds[i], bounds[i + 1], bounds[i + 2], /* merge = */ true, comparator, doneSemaphore));
+            mergedBounds.push_back(bounds[i]);
+        }
+
+        // The odd chunk without a pair is left for the next round
+        if ((i + 2) == bounds.size()) {
+            mergedBounds.push_back(bounds[i]);
+        }
+
+        mergedBounds.push_back(end);
+
+        runParallelSortSteps(steps, doneSemaphore, pThreadPool);
+        bounds.swap(mergedBounds);
+    }
+}
+
+/**
+ * @brief The DereferencingComparator class adapts the comparator of items to the comparison of pointers to items
+ */
+template <typename T, typename Comparator>
+class DereferencingComparator
+{
+public:
+    DereferencingComparator(const Comparator & comparator) :
+        m_comparator(comparator)
+    {}
+
+    bool operator()(const T * pLhs, const T * pRhs) const { return m_comparator(*pLhs, *pRhs); }
+
+private:
+    Comparator  m_comparator;
+};
+
+/**
+ * @brief The AsyncSortTask class is the base for the tasks sorting the snapshot of model items
+ * within the thread pool's thread so that re-sorting a large model doesn't block the GUI thread;
+ * finished signal is emitted once the snapshot is sorted or once the task gives up the sorting
+ * after being cancelled
+ */
+class AsyncSortTask: public QObject,
+                     public QRunnable
+{
+    Q_OBJECT
+public:
+    explicit AsyncSortTask(QObject * parent = Q_NULLPTR);
+
+    /**
+     * @brief cancel - tells the task its result is no longer needed; the task checks it between the steps
+     * of its work so that the superseded sorting doesn't keep the thread pool's thread busy for long
+     */
+    void cancel();
+    bool isCancelled() const;
+
+Q_SIGNALS:
+    void finished();
+
+private:
+    QAtomicInt  m_cancelled;
+};
+
+/**
+ * @brief The SnapshotSortTask class sorts the pointers to items of the snapshot taken from the model
+ * in parallel; subclasses might override prepareItems to compute whatever the comparator needs
+ * (i.e. sort keys) off the GUI thread as well
+ */
+template <typename Item, typename Comparator>
+class SnapshotSortTask: public AsyncSortTask
+{
+public:
+    SnapshotSortTask(std::vector<Item> & snapshot, const Comparator & comparator) :
+        AsyncSortTask(),
+        m_items(),
+        m_sortedItems(),
+        m_comparator(comparator)
+    {
+        m_items.swap(snapshot);
+    }
+
+    /**
+     * @return the pointers to the snapshot items in the sorted order; only valid after finished signal is emitted
+     */
+    const std::vector<const Item*> & sortedItems() const { return m_sortedItems; }
+
+    virtual void run() Q_DECL_OVERRIDE
+    {
+        if (!isCancelled()) {
+            prepareItems(m_items);
+        }
+
+        if (isCancelled()) {
+            Q_EMIT finished();
+            return;
+        }
+
+        m_sortedItems.reserve(m_items.size());
+        for(auto it = m_items.begin(), end = m_items.end(); it != end; ++it) {
+            m_sortedItems.push_back(&(*it));
+        }
+
+        parallelSort(m_sortedItems.begin(), m_sortedItems.end(),
+                     DereferencingComparator<Item, Comparator>(m_comparator));
+
+        Q_EMIT finished();
+    }
+
+protected:
+    virtual void prepareItems(std::vector<Item> & items) { Q_UNUSED(items) }
+
+    Comparator & comparator() { return m_comparator; }
+
+private:
+    std::vector<Item>           m_items;
+    std::vector<const Item*>    m_sortedItems;
+    Comparator                  m_comparator;
+};
+
+} // namespace quentier
+
+#endif // QUENTIER_MODELS_PARALLEL_SORT_H
@@ -18,16 +18,25 @@
 
 #include "SavedSearchModel.h"
 #include "NewItemNameGenerator.hpp"
+#include "ModelSnapshot.h"
 #include <quentier/logging/QuentierLogger.h>
 #include <quentier/utility/UidGenerator.h>
 #include <limits>
 #include <algorithm>
 
-// Limit for the queries to the local storage
+// Initial limit for the queries to the local storage, adjusted then within the min/max bounds
+// depending on the measured timings of the queries
 #define SAVED_SEARCH_LIST_LIMIT (100)
+#define MIN_LIST_LIMIT (20)
+#define MAX_LIST_LIMIT (1000)
+#define LIST_TARGET_ROUND_TRIP_MSEC (100)
+#define MAX_LIST_REQUESTS_IN_FLIGHT (4)
 
 #define NUM_SAVED_SEARCH_MODEL_COLUMNS (4)
 
+// The version of the format of saved search model items within the model snapshot
+#define SAVED_SEARCH_MODEL_SNAPSHOT_VERSION (1)
+
 #define REPORT_ERROR(error, ...) \
     ErrorString errorDescription(error); \
     QNWARNING(errorDescription << QStringLiteral("" __VA_ARGS__ "")); \
@@ -40,9 +49,10 @@ SavedSearchModel::SavedSearchModel(const Account & account, LocalStorageManagerA
     ItemModel(parent),
     m_account(account),
     m_data(),
-    m_listSavedSearchesOffset(0),
-    m_listSavedSearchesRequestId(),
+    m_listSavedSearchesPipeline(SAVED_SEARCH_LIST_LIMIT, MIN_LIST_LIMIT, MAX_LIST_LIMIT,
+                                LIST_TARGET_ROUND_TRIP_MSEC, MAX_LIST_REQUESTS_IN_FLIGHT),
     m_savedSearchItemsNotYetInLocalStorageUids(),
+    m_restoredLocalUidsPendingReconciliation(),
     m_cache(cache),
     m_addSavedSearchRequestIds(),
     m_updateSavedSearchRequestIds(),
@@ -55,6 +65,8 @@ SavedSearchModel::SavedSearchModel(const Account & account, LocalStorageManagerA
     m_allSavedSearchesListed(false)
 {
     createConnections(localStorageManagerAsync);
+
+    m_listSavedSearchesPipeline.start();
     requestSavedSearchesList();
 }
 
@@ -218,6 +230,87 @@ void SavedSearchModel::unfavoriteSavedSearch(const QModelIndex & index)
     setSavedSearchFavorited(index, false);
 }
 
+bool SavedSearchModel::saveSnapshot(const QString & filePath, ErrorString & errorDescription) const
+{
+    QNDEBUG(QStringLiteral("SavedSearchModel::saveSnapshot: ") << filePath);
+
+    if (!m_allSavedSearchesListed) {
+        errorDescription.setBase(QT_TR_NOOP("Can't save the snapshot of saved searches: not all saved searches have been listed yet"));
+        QNDEBUG(errorDescription);
+        return false;
+    }
+
+    ModelSnapshotWriter writer(SAVED_SEARCH_MODEL_SNAPSHOT_VERSION);
+    QDataStream & out = writer.stream();
+
+    const SavedSearchDataByIndex & index = m_data.get<ByIndex>();
+    out << static_cast<qint32>(index.size());
+    for(auto it = index.begin(), end = index.end(); it != end; ++it) {
+        out << *it;
+    }
+
+    return writer.writeToFile(filePath, errorDescription);
+}
+
+bool SavedSearchModel::restoreFromSnapshot(const QString & filePath, ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("SavedSearchModel::restoreFromSnapshot: ") << filePath);
+
+    if (m_allSavedSearchesListed || !m_data.empty()) {
+        errorDescription.setBase(QT_TR_NOOP("Can't restore the snapshot of saved searches: the model already has saved searches"));
+        QNDEBUG(errorDescription);
+        return false;
+    }
+
+    ModelSnapshotReader reader;
+    if (!reader.open(filePath, SAVED_SEARCH_MODEL_SNAPSHOT_VERSION, errorDescription)) {
+        return false;
+    }
+
+    QDataStream & in = reader.stream();
+
+    qint32 numItems = 0;
+    in >> numItems;
+
+    // The data container takes care of dropping the duplicate items the corrupted snapshot might have
+    SavedSearchData restoredData;
+    for(qint32 i = 0; (i < numItems) && (in.status() == QDataStream::Ok); ++i) {
+        SavedSearchModelItem item;
+        in >> item;
+        Q_UNUSED(restoredData.get<ByIndex>().push_back(item))
+    }
+
+    if (!reader.checkStatus(errorDescription)) {
+        return false;
+    }
+
+    SavedSearchDataByIndex & restoredIndex = restoredData.get<ByIndex>();
+    std::vector<boost::reference_wrapper<const SavedSearchModelItem> > items(restoredIndex.begin(), restoredIndex.end());
+    if (m_sortOrder == Qt::AscendingOrder) {
+        std::sort(items.begin(), items.end(), LessByName());
+    }
+    else {
+        std::sort(items.begin(), items.end(), GreaterByName());
+    }
+    restoredIndex.rearrange(items.begin());
+
+    for(auto it = restoredIndex.begin(), end = restoredIndex.end(); it != end; ++it) {
+        Q_UNUSED(m_restoredLocalUidsPendingReconciliation.insert(it->m_localUid))
+    }
+
+    QNDEBUG(QStringLiteral("Restored ") << restoredData.size() << QStringLiteral(" saved searches from the snapshot"));
+
+    if (restoredData.empty()) {
+        return true;
+    }
+
+    beginInsertRows(QModelIndex(), 0, static_cast<int>(restoredData.size()) - 1);
+    m_data.swap(restoredData);
+    endInsertRows();
+
+    return true;
+}
+
 QString SavedSearchModel::localUidForItemName(const QString & itemName,
                                               const QString & linkedNotebookGuid) const
 {
@@ -824,7 +917,8 @@ void SavedSearchModel::onListSavedSearchesComplete(LocalStorageManager::ListObje
                                                    LocalStorageManager::OrderDirection::type orderDirection,
                                                    QList<SavedSearch> foundSearches, QUuid requestId)
 {
-    if (requestId != m_listSavedSearchesRequestId) {
+    QList<SavedSearch> readySearches;
+    if (!m_listSavedSearchesPipeline.onRequestComplete(requestId, foundSearches, readySearches)) {
         return;
     }
 
@@ -833,18 +927,18 @@ void SavedSearchModel::onListSavedSearchesComplete(LocalStorageManager::ListObje
             << orderDirection << QStringLiteral(", num found searches = ") << foundSearches.size() << QStringLiteral(", request id = ")
             << requestId);
 
-    for(auto it = foundSearches.constBegin(), end = foundSearches.constEnd(); it != end; ++it) {
+    for(auto it = readySearches.constBegin(), end = readySearches.constEnd(); it != end; ++it) {
         onSavedSearchAddedOrUpdated(*it);
     }
 
-    m_listSavedSearchesRequestId = QUuid();
-    if (!foundSearches.isEmpty()) {
-        QNTRACE(QStringLiteral("The number of found saved searches is greater than zero, requesting more saved searches from the local storage"));
-        m_listSavedSearchesOffset += static_cast<size_t>(foundSearches.size());
+    if (m_listSavedSearchesPipeline.isActive()) {
+        QNTRACE(QStringLiteral("Not all saved searches are listed yet, requesting more saved searches from the local storage"));
         requestSavedSearchesList();
         return;
     }
 
+    removeUnreconciledRestoredItems();
+
     m_allSavedSearchesListed = true;
     Q_EMIT notifyAllSavedSearchesListed();
     Q_EMIT notifyAllItemsListed();
@@ -856,7 +950,7 @@ void SavedSearchModel::onListSavedSearchesFailed(LocalStorageManager::ListObject
                                                  LocalStorageManager::OrderDirection::type orderDirection,
                                                  ErrorString errorDescription, QUuid requestId)
 {
-    if (requestId != m_listSavedSearchesRequestId) {
+    if (!m_listSavedSearchesPipeline.onRequestFailed(requestId)) {
         return;
     }
 
@@ -864,9 +958,10 @@ void SavedSearchModel::onListSavedSearchesFailed(LocalStorageManager::ListObject
             << limit << QStringLiteral(", offset = ") << offset << QStringLiteral(", order = ") << order << QStringLiteral(", direction = ")
             << orderDirection << QStringLiteral(", error: ") << errorDescription << QStringLiteral(", request id = ") << requestId);
 
-    m_listSavedSearchesRequestId = QUuid();
-
     Q_EMIT notifyError(errorDescription);
+
+    // No complete listing is coming, the restored items not confirmed by the local storage so far are dropped
+    removeUnreconciledRestoredItems();
 }
 
 void SavedSearchModel::onExpungeSavedSearchComplete(SavedSearch search, QUuid requestId)
@@ -874,6 +969,8 @@ void SavedSearchModel::onExpungeSavedSearchComplete(SavedSearch search, QUuid re
     QNDEBUG(QStringLiteral("SavedSearchModel::onExpungeSavedSearchComplete: search = ") << search << QStringLiteral("\nRequest id = ")
             << requestId);
 
+    Q_UNUSED(m_restoredLocalUidsPendingReconciliation.remove(search.localUid()))
+
     auto it = m_expungeSavedSearchRequestIds.find(requestId);
     if (it != m_expungeSavedSearchRequestIds.end()) {
         Q_UNUSED(m_expungeSavedSearchRequestIds.erase(it))
@@ -977,17 +1074,21 @@ void SavedSearchModel::createConnections(LocalStorageManagerAsync & localStorage
 
 void SavedSearchModel::requestSavedSearchesList()
 {
-    QNDEBUG(QStringLiteral("SavedSearchModel::requestSavedSearchesList: offset = ") << m_listSavedSearchesOffset);
+    QNDEBUG(QStringLiteral("SavedSearchModel::requestSavedSearchesList: offset = ")
+            << m_listSavedSearchesPipeline.appliedOffset());
 
     LocalStorageManager::ListObjectsOptions flags = LocalStorageManager::ListAll;
     LocalStorageManager::ListSavedSearchesOrder::type order = LocalStorageManager::ListSavedSearchesOrder::NoOrder;
     LocalStorageManager::OrderDirection::type direction = LocalStorageManager::OrderDirection::Ascending;
 
-    m_listSavedSearchesRequestId = QUuid::createUuid();
-    QNTRACE(QStringLiteral("Emitting the request to list saved searches: offset = ") << m_listSavedSearchesOffset
-            << QStringLiteral(", request id = ") << m_listSavedSearchesRequestId);
-    Q_EMIT listSavedSearches(flags, SAVED_SEARCH_LIST_LIMIT, m_listSavedSearchesOffset,
-                             order, direction, m_listSavedSearchesRequestId);
+    QList<ListSavedSearchesPipeline::Request> requests = m_listSavedSearchesPipeline.takeRequestsToSend();
+    for(auto it = requests.constBegin(), end = requests.constEnd(); it != end; ++it)
+    {
+        const ListSavedSearchesPipeline::Request & request = *it;
+        QNTRACE(QStringLiteral("Emitting the request to list saved searches: offset = ") << request.m_offset
+                << QStringLiteral(", limit = ") << request.m_limit << QStringLiteral(", request id = ") << request.m_requestId);
+        Q_EMIT listSavedSearches(flags, request.m_limit, request.m_offset, order, direction, request.m_requestId);
+    }
 }
 
 void SavedSearchModel::onSavedSearchAddedOrUpdated(const SavedSearch & search)
@@ -1015,6 +1116,10 @@ void SavedSearchModel::onSavedSearchAddedOrUpdated(const SavedSearch & search)
     item.m_isDirty = search.isDirty();
     item.m_isFavorited = search.isFavorited();
 
+    if (!m_restoredLocalUidsPendingReconciliation.isEmpty()) {
+        reconcileRestoredItem(item);
+    }
+
     SavedSearchDataByLocalUid::iterator itemIt = localUidIndex.find(search.localUid());
     bool newSavedSearch = (itemIt == localUidIndex.end());
     if (newSavedSearch)
@@ -1069,6 +1174,65 @@ void SavedSearchModel::onSavedSearchAddedOrUpdated(const SavedSearch & search)
     Q_EMIT updatedSavedSearch(savedSearchIndexAfter);
 }
 
+void SavedSearchModel::reconcileRestoredItem(const SavedSearchModelItem & item)
+{
+    Q_UNUSED(m_restoredLocalUidsPendingReconciliation.remove(item.m_localUid))
+
+    // The names of saved searches are unique within the local storage so the restored item having the same name
+    // but different local uid corresponds to the saved search which has been either renamed or expunged since
+    // the snapshot was saved; if it has been renamed, it would be added back once listed
+    const SavedSearchDataByNameUpper & nameIndex = m_data.get<ByNameUpper>();
+    auto it = nameIndex.find(item.nameUpper());
+    if ((it == nameIndex.end()) || (it->m_localUid == item.m_localUid)) {
+        return;
+    }
+
+    QString conflictingLocalUid = it->m_localUid;
+    if (m_restoredLocalUidsPendingReconciliation.remove(conflictingLocalUid)) {
+        QNDEBUG(QStringLiteral("Removing the restored saved search item with the name taken by another saved search: ")
+                << conflictingLocalUid);
+        removeItemByLocalUid(conflictingLocalUid);
+    }
+}
+
+void SavedSearchModel::removeUnreconciledRestoredItems()
+{
+    if (m_restoredLocalUidsPendingReconciliation.isEmpty()) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("Removing ") << m_restoredLocalUidsPendingReconciliation.size()
+            << QStringLiteral(" restored saved search items which no longer exist in the local storage"));
+
+    QSet<QString> localUids = m_restoredLocalUidsPendingReconciliation;
+    m_restoredLocalUidsPendingReconciliation.clear();
+
+    for(auto it = localUids.constBegin(), end = localUids.constEnd(); it != end; ++it) {
+        removeItemByLocalUid(*it);
+    }
+}
+
+void SavedSearchModel::removeItemByLocalUid(const QString & localUid)
+{
+    SavedSearchDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
+    SavedSearchDataByLocalUid::iterator itemIt = localUidIndex.find(localUid);
+    if (itemIt == localUidIndex.end()) {
+        return;
+    }
+
+    SavedSearchDataByIndex & index = m_data.get<ByIndex>();
+    SavedSearchDataByIndex::iterator indexIt = m_data.project<ByIndex>(itemIt);
+
+    Q_EMIT aboutToRemoveSavedSearches();
+
+    int rowIndex = static_cast<int>(std::distance(index.begin(), indexIt));
+    beginRemoveRows(QModelIndex(), rowIndex, rowIndex);
+    Q_UNUSED(m_data.erase(indexIt))
+    endRemoveRows();
+
+    Q_EMIT removedSavedSearches();
+}
+
 QVariant SavedSearchModel::dataImpl(const int row, const Columns::type column) const
 {
     QNTRACE(QStringLiteral("SavedSearchModel::dataImpl: row = ") << row << QStringLiteral(", column = ") << column);
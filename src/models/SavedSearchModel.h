@@ -22,6 +22,7 @@
 #include "ItemModel.h"
 #include "SavedSearchModelItem.h"
 #include "SavedSearchCache.h"
+#include "ListRequestPipeline.hpp"
 #include <quentier/types/SavedSearch.h>
 #include <quentier/types/Account.h>
 #include <quentier/local_storage/LocalStorageManagerAsync.h>
@@ -114,6 +115,28 @@ public:
      */
     void unfavoriteSavedSearch(const QModelIndex & index);
 
+    /**
+     * @brief saveSnapshot - writes all the model's items into the snapshot file so that the next instance
+     * of the model for the same account could show them before they are listed from the local storage
+     * @param filePath - the path to the snapshot file
+     * @param errorDescription - the textual description of the error if the snapshot was not saved
+     * @return false if not all saved searches have been listed yet or if the snapshot could not be written
+     */
+    bool saveSnapshot(const QString & filePath, ErrorString & errorDescription) const;
+
+    /**
+     * @brief restoreFromSnapshot - fills the model with the items from the snapshot file written by saveSnapshot
+     *
+     * The restored items are reconciled with the saved searches being listed from the local storage: they are
+     * updated as the corresponding saved searches are listed and the ones not listed by the end of the listing
+     * are removed from the model before notifyAllSavedSearchesListed is emitted
+     *
+     * @param filePath - the path to the snapshot file
+     * @param errorDescription - the textual description of the error if the snapshot was not restored
+     * @return false if the model already has some items or if the snapshot could not be read
+     */
+    bool restoreFromSnapshot(const QString & filePath, ErrorString & errorDescription);
+
 public:
     // ItemModel interface
     virtual QString localUidForItemName(const QString & itemName,
@@ -196,6 +219,14 @@ private:
 
     void onSavedSearchAddedOrUpdated(const SavedSearch & search);
 
+    /**
+     * @brief reconcileRestoredItem - marks the restored item as matching the saved search from the local storage
+     * and removes the restored item which no longer matches any saved search as the saved search took its name
+     */
+    void reconcileRestoredItem(const SavedSearchModelItem & item);
+    void removeUnreconciledRestoredItems();
+    void removeItemByLocalUid(const QString & localUid);
+
     QVariant dataImpl(const int row, const Columns::type column) const;
     QVariant dataAccessibleText(const int row, const Columns::type column) const;
 
@@ -236,6 +267,8 @@ private:
     typedef SavedSearchData::index<ByIndex>::type SavedSearchDataByIndex;
     typedef SavedSearchData::index<ByNameUpper>::type SavedSearchDataByNameUpper;
 
+    typedef ListRequestPipeline<SavedSearch> ListSavedSearchesPipeline;
+
     struct LessByName
     {
         bool operator()(const SavedSearchModelItem & lhs, const SavedSearchModelItem & rhs) const;
@@ -251,10 +284,12 @@ private:
 private:
     Account                 m_account;
     SavedSearchData         m_data;
-    size_t                  m_listSavedSearchesOffset;
-    QUuid                   m_listSavedSearchesRequestId;
+    ListSavedSearchesPipeline   m_listSavedSearchesPipeline;
     QSet<QUuid>             m_savedSearchItemsNotYetInLocalStorageUids;
 
+    // Local uids of the items restored from the snapshot which have not been listed from the local storage yet
+    QSet<QString>           m_restoredLocalUidsPendingReconciliation;
+
     SavedSearchCache &      m_cache;
 
     QSet<QUuid>             m_addSavedSearchRequestIds;
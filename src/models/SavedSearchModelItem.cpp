@@ -49,4 +49,18 @@ QTextStream & SavedSearchModelItem::print(QTextStream & strm) const
     return strm;
 }
 
+QDataStream & operator<<(QDataStream & out, const SavedSearchModelItem & item)
+{
+    out << item.m_localUid << item.m_guid << item.m_name << item.m_query
+        << item.m_isSynchronizable << item.m_isDirty << item.m_isFavorited;
+    return out;
+}
+
+QDataStream & operator>>(QDataStream & in, SavedSearchModelItem & item)
+{
+    in >> item.m_localUid >> item.m_guid >> item.m_name >> item.m_query
+       >> item.m_isSynchronizable >> item.m_isDirty >> item.m_isFavorited;
+    return in;
+}
+
 } // namespace quentier
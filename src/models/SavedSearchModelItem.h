@@ -20,6 +20,7 @@
 #define QUENTIER_MODELS_SAVED_SEARCH_MODEL_ITEM_H
 
 #include <quentier/utility/Printable.h>
+#include <QDataStream>
 
 namespace quentier {
 
@@ -47,6 +48,9 @@ public:
     bool        m_isFavorited;
 };
 
+QDataStream & operator<<(QDataStream & out, const SavedSearchModelItem & item);
+QDataStream & operator>>(QDataStream & in, SavedSearchModelItem & item);
+
 } // namespace quentier
 
 #endif // QUENTIER_MODELS_SAVED_SEARCH_MODEL_ITEM_H
@@ -0,0 +1,198 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUENTIER_MODELS_SORTED_ITEMS_HELPERS_HPP
+#define QUENTIER_MODELS_SORTED_ITEMS_HELPERS_HPP
+
+#include <quentier/utility/Macros.h>
+#include <QModelIndex>
+#include <QString>
+#include <QVector>
+#include <boost/ref.hpp>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace quentier {
+
+/**
+ * @brief The ComparatorEquivalence class tells whether two items are equivalent as far as the comparator is concerned
+ */
+template <typename Item, typename Comparator>
+class ComparatorEquivalence
+{
+public:
+    ComparatorEquivalence(const Comparator & comparator) :
+        m_comparator(comparator)
+    {}
+
+    bool operator()(const Item & lhs, const Item & rhs) const
+    {
+        return !m_comparator(lhs, rhs) && !m_comparator(rhs, lhs);
+    }
+
+private:
+    Comparator  m_comparator;
+};
+
+/**
+ * @brief rearrangeBySortedSnapshot - reorders the items of the model's multi-index container according to the sorted
+ * snapshot of them: the items removed since the snapshot was taken are skipped while the ones added or changed
+ * since then (as told by sortedDataEqual predicate) are put into their positions with the binary search afterwards
+ *
+ * @return the number of items positioned separately from the sorted snapshot
+ */
+template <typename ByIndexTag, typename ByLocalUidTag, typename Container, typename Item,
+          typename SortedDataEqual, typename Comparator>
+size_t rearrangeBySortedSnapshot(Container & data, const std::vector<const Item*> & sortedItems,
+                                 const SortedDataEqual & sortedDataEqual, const Comparator & comparator)
+{
+    auto & index = data.template get<ByIndexTag>();
+    const auto & localUidIndex = data.template get<ByLocalUidTag>();
+
+    std::vector<boost::reference_wrapper<const Item> > items;
+    items.reserve(data.size());
+
+    std::vector<bool> placedRows(data.size(), false);
+
+    for(auto it = sortedItems.begin(), end = sortedItems.end(); it != end; ++it)
+    {
+        const Item & sortedItem = **it;
+
+        auto itemIt = localUidIndex.find(sortedItem.localUid());
+        if (itemIt == localUidIndex.end()) {
+            // The item has been removed since the snapshot was taken
+            continue;
+        }
+
+        if (!sortedDataEqual(*itemIt, sortedItem)) {
+            // The item has been changed since the snapshot was taken, will be positioned separately
+            continue;
+        }
+
+        auto indexIt = data.template project<ByIndexTag>(itemIt);
+        placedRows[static_cast<size_t>(std::distance(index.begin(), indexIt))] = true;
+        items.push_back(boost::reference_wrapper<const Item>(*itemIt));
+    }
+
+    const size_t numSortedItems = items.size();
+    const size_t numItems = data.size();
+
+    for(size_t row = 0; row < numItems; ++row)
+    {
+        if (placedRows[row]) {
+            continue;
+        }
+
+        auto indexIt = index.begin() + static_cast<std::ptrdiff_t>(row);
+        items.push_back(boost::reference_wrapper<const Item>(*indexIt));
+    }
+
+    index.rearrange(items.begin());
+
+    for(size_t row = numSortedItems; row < numItems; ++row)
+    {
+        auto indexIt = index.begin() + static_cast<std::ptrdiff_t>(row);
+        auto positionIt = std::lower_bound(index.begin(), indexIt, *indexIt, comparator);
+        index.relocate(positionIt, indexIt);
+    }
+
+    return numItems - numSortedItems;
+}
+
+/**
+ * @brief localUidsForPersistentIndices - collects the local uids of the items pointed to by the model's persistent
+ * indices along with the indices' columns so that the indices can be updated after the model's items are reordered;
+ * the model should provide itemAtRow method returning the pointer to the item or null pointer
+ */
+template <typename Model>
+QVector<std::pair<QString, int> > localUidsForPersistentIndices(const Model & model,
+                                                                const QModelIndexList & persistentIndices)
+{
+    const int numRows = model.rowCount(QModelIndex());
+    const int numColumns = model.columnCount(QModelIndex());
+
+    QVector<std::pair<QString, int> > localUidsWithColumns;
+    localUidsWithColumns.reserve(persistentIndices.size());
+
+    for(auto it = persistentIndices.constBegin(), end = persistentIndices.constEnd(); it != end; ++it)
+    {
+        const QModelIndex & modelIndex = *it;
+        int column = modelIndex.column();
+
+        if (!modelIndex.isValid()) {
+            localUidsWithColumns << std::pair<QString, int>(QString(), column);
+            continue;
+        }
+
+        int row = modelIndex.row();
+
+        if ((row < 0) || (row >= numRows) || (column < 0) || (column >= numColumns)) {
+            localUidsWithColumns << std::pair<QString, int>(QString(), column);
+            continue;
+        }
+
+        const auto * pItem = model.itemAtRow(row);
+        if (Q_UNLIKELY(!pItem)) {
+            localUidsWithColumns << std::pair<QString, int>(QString(), column);
+            continue;
+        }
+
+        localUidsWithColumns << std::pair<QString, int>(pItem->localUid(), column);
+    }
+
+    return localUidsWithColumns;
+}
+
+/**
+ * @brief persistentIndexReplacements - builds the replacements for the model's persistent indices from the local uids
+ * and columns collected by localUidsForPersistentIndices before the model's items were reordered; the model should
+ * provide indexForLocalUid method
+ */
+template <typename Model>
+QModelIndexList persistentIndexReplacements(const Model & model,
+                                            const QVector<std::pair<QString, int> > & localUidsWithColumns)
+{
+    QModelIndexList replacementIndices;
+    replacementIndices.reserve(std::max(localUidsWithColumns.size(), 0));
+    for(auto it = localUidsWithColumns.constBegin(), end = localUidsWithColumns.constEnd(); it != end; ++it)
+    {
+        const QString & localUid = it->first;
+        const int column = it->second;
+
+        if (localUid.isEmpty()) {
+            replacementIndices << QModelIndex();
+            continue;
+        }
+
+        QModelIndex newIndex = model.indexForLocalUid(localUid);
+        if (!newIndex.isValid()) {
+            replacementIndices << QModelIndex();
+            continue;
+        }
+
+        replacementIndices << model.index(newIndex.row(), column, QModelIndex());
+    }
+
+    return replacementIndices;
+}
+
+} // namespace quentier
+
+#endif // QUENTIER_MODELS_SORTED_ITEMS_HELPERS_HPP
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2016 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StringPool.h"
+
+namespace quentier {
+
+StringPool::StringPool() :
+    m_strings()
+{}
+
+QString StringPool::intern(const QString & str)
+{
+    if (str.isEmpty()) {
+        return str;
+    }
+
+    auto it = m_strings.constFind(str);
+    if (it != m_strings.constEnd()) {
+        return *it;
+    }
+
+    // Don't let the pool retain the unused capacity of the original string
+    QString pooledStr = (str.capacity() > str.size()) ? QString(str.constData(), str.size()) : str;
+    Q_UNUSED(m_strings.insert(pooledStr))
+    return pooledStr;
+}
+
+QStringList StringPool::intern(const QStringList & strings)
+{
+    QStringList result;
+    result.reserve(strings.size());
+
+    for(auto it = strings.constBegin(), end = strings.constEnd(); it != end; ++it) {
+        result << intern(*it);
+    }
+
+    return result;
+}
+
+void StringPool::purgeUnused()
+{
+    for(auto it = m_strings.begin(); it != m_strings.end(); )
+    {
+        // NOTE: the string's data is shared with nobody else when the string is detached
+        if (it->isDetached()) {
+            it = m_strings.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+void StringPool::clear()
+{
+    m_strings.clear();
+}
+
+} // namespace quentier
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2016 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUENTIER_MODELS_STRING_POOL_H
+#define QUENTIER_MODELS_STRING_POOL_H
+
+#include <quentier/utility/Macros.h>
+#include <QStringList>
+#include <QSet>
+
+namespace quentier {
+
+/**
+ * @brief The StringPool class interns strings which are repeated across many model items
+ * (i.e. notebook and tag local uids and guids) so that all the items refer to the single
+ * implicitly shared copy of each distinct string instead of holding separate allocations of it
+ */
+class StringPool
+{
+public:
+    StringPool();
+
+    /**
+     * @return the pooled copy of the passed in string, sharing the data with all other
+     * copies interned before
+     */
+    QString intern(const QString & str);
+
+    /**
+     * @return the list of pooled copies of the passed in strings
+     */
+    QStringList intern(const QStringList & strings);
+
+    /**
+     * @brief purgeUnused - removes the strings no longer referenced by anything but the pool itself
+     */
+    void purgeUnused();
+
+    void clear();
+
+    int size() const { return m_strings.size(); }
+
+private:
+    QSet<QString>   m_strings;
+};
+
+} // namespace quentier
+
+#endif // QUENTIER_MODELS_STRING_POOL_H
@@ -34,6 +34,7 @@ TagItem::TagItem(const QString & localUid,
     m_guid(guid),
     m_linkedNotebookGuid(linkedNotebookGuid),
     m_name(name),
+    m_nameUpper(name.toUpper()),
     m_parentLocalUid(parentLocalUid),
     m_parentGuid(parentGuid),
     m_isSynchronizable(isSynchronizable),
@@ -57,4 +58,33 @@ QTextStream & TagItem::print(QTextStream & strm) const
     return strm;
 }
 
+QDataStream & operator<<(QDataStream & out, const TagItem & item)
+{
+    out << item.localUid() << item.guid() << item.linkedNotebookGuid() << item.name()
+        << item.parentLocalUid() << item.parentGuid() << item.isSynchronizable() << item.isDirty()
+        << item.isFavorited() << static_cast<qint32>(item.numNotesPerTag());
+    return out;
+}
+
+QDataStream & operator>>(QDataStream & in, TagItem & item)
+{
+    QString localUid;
+    QString guid;
+    QString linkedNotebookGuid;
+    QString name;
+    QString parentLocalUid;
+    QString parentGuid;
+    bool isSynchronizable = false;
+    bool isDirty = false;
+    bool isFavorited = false;
+    qint32 numNotesPerTag = -1;
+
+    in >> localUid >> guid >> linkedNotebookGuid >> name >> parentLocalUid >> parentGuid
+       >> isSynchronizable >> isDirty >> isFavorited >> numNotesPerTag;
+
+    item = TagItem(localUid, guid, linkedNotebookGuid, name, parentLocalUid, parentGuid,
+                   isSynchronizable, isDirty, isFavorited, numNotesPerTag);
+    return in;
+}
+
 } // namespace quentier
@@ -20,6 +20,7 @@
 #define QUENTIER_MODELS_TAG_ITEM_H
 
 #include <quentier/utility/Printable.h>
+#include <QDataStream>
 
 namespace quentier {
 
@@ -47,10 +48,15 @@ public:
     const QString & linkedNotebookGuid() const { return m_linkedNotebookGuid; }
     void setLinkedNotebookGuid(const QString & linkedNotebookGuid) { m_linkedNotebookGuid = linkedNotebookGuid; }
 
-    QString nameUpper() const { return m_name.toUpper(); }
+    /**
+     * @return the upper case version of the item's name, computed once per name change
+     * so that it can serve as the key of the ordered name index without being case-folded
+     * on every comparison
+     */
+    const QString & nameUpper() const { return m_nameUpper; }
 
     const QString & name() const { return m_name; }
-    void setName(const QString & name) { m_name = name; }
+    void setName(const QString & name) { m_name = name; m_nameUpper = name.toUpper(); }
 
     const QString & parentGuid() const { return m_parentGuid; }
     void setParentGuid(const QString & parentGuid) { m_parentGuid = parentGuid; }
@@ -77,6 +83,7 @@ private:
     QString     m_guid;
     QString     m_linkedNotebookGuid;
     QString     m_name;
+    QString     m_nameUpper;
     QString     m_parentLocalUid;
     QString     m_parentGuid;
     bool        m_isSynchronizable;
@@ -85,6 +92,9 @@ private:
     int         m_numNotesPerTag;
 };
 
+QDataStream & operator<<(QDataStream & out, const TagItem & item);
+QDataStream & operator>>(QDataStream & in, TagItem & item);
+
 } // namespace quentier
 
 #endif // QUENTIER_MODELS_TAG_ITEM_H
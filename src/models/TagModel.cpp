@@ -20,18 +20,41 @@
 #include "NoteModel.h"
 #include "NoteModelItem.h"
 #include "NewItemNameGenerator.hpp"
+#include "ModelSnapshot.h"
 #include <quentier/logging/QuentierLogger.h>
 #include <QByteArray>
 #include <QMimeData>
+#include <QTimerEvent>
 #include <limits>
 #include <vector>
 
-// Limit for the queries to the local storage
+// Initial limits for the queries to the local storage, adjusted then within the min/max bounds
+// depending on the measured timings of the queries
 #define TAG_LIST_LIMIT (100)
 #define LINKED_NOTEBOOK_LIST_LIMIT (40)
+#define MIN_LIST_LIMIT (20)
+#define MAX_LIST_LIMIT (1000)
+#define LIST_TARGET_ROUND_TRIP_MSEC (100)
+#define MAX_LIST_REQUESTS_IN_FLIGHT (4)
 
 #define NUM_TAG_MODEL_COLUMNS (5)
 
+// The version of the format of tag items within the model snapshot
+#define TAG_MODEL_SNAPSHOT_VERSION (1)
+
+// The number of low bits of QModelIndex's internal id holding the index of the item's slot (plus one
+// so that zero remains the invalid id); the remaining high bits hold the generation of the slot
+#define TAG_MODEL_INDEX_ID_SLOT_BITS (20)
+#define TAG_MODEL_INDEX_ID_SLOT_MASK ((IndexId(1) << TAG_MODEL_INDEX_ID_SLOT_BITS) - 1)
+
+// The interval in milliseconds between the reconciliations of delta-maintained note counts per tag
+// with the local storage; the reconciliation only happens if some deltas were applied since the previous one
+#define TAG_MODEL_NOTE_COUNTS_RECONCILIATION_INTERVAL (600000)
+
+// The delay in milliseconds before the corrective recount of notes per tag once the reconciliation
+// has found the delta-maintained note counts to have drifted from the local storage
+#define TAG_MODEL_NOTE_COUNTS_DRIFT_RECOUNT_DELAY (5000)
+
 #define REPORT_ERROR(error, ...) \
     ErrorString errorDescription(error); \
     QNWARNING(errorDescription << "" __VA_ARGS__ ); \
@@ -55,28 +78,37 @@ TagModel::TagModel(const Account & account, const NoteModel & noteModel,
     m_modelItemsByLocalUid(),
     m_modelItemsByLinkedNotebookGuid(),
     m_linkedNotebookItems(),
-    m_indexIdToLocalUidBimap(),
-    m_indexIdToLinkedNotebookGuidBimap(),
-    m_lastFreeIndexId(1),
-    m_listTagsOffset(0),
-    m_listTagsRequestId(),
+    m_indexIdSlots(),
+    m_freeIndexIdSlots(),
+    m_listTagsPipeline(TAG_LIST_LIMIT, MIN_LIST_LIMIT, MAX_LIST_LIMIT, LIST_TARGET_ROUND_TRIP_MSEC, MAX_LIST_REQUESTS_IN_FLIGHT),
+    m_listTagsLinkedNotebookGuid(),
+    m_ownTagsListed(false),
+    m_linkedNotebookGuidsPendingTagsListing(),
+    m_listTagsOffsetsByLinkedNotebookGuid(),
     m_tagItemsNotYetInLocalStorageUids(),
+    m_restoredLocalUidsPendingReconciliation(),
     m_addTagRequestIds(),
     m_updateTagRequestIds(),
     m_expungeTagRequestIds(),
-    m_noteCountPerTagRequestIds(),
     m_noteCountsPerAllTagsRequestId(),
+    m_noteCountsByTagLocalUid(),
+    m_receivedNoteCountsForAllTags(false),
+    m_numNoteCountDeltasSinceReconciliation(0),
+    m_noteCountsRecountPending(false),
+    m_noteCountsDriftDetected(false),
+    m_noteCountsReconciliationTimer(),
     m_findTagToRestoreFailedUpdateRequestIds(),
     m_findTagToPerformUpdateRequestIds(),
     m_findTagAfterNotelessTagsErasureRequestIds(),
     m_listTagsPerNoteRequestIds(),
     m_linkedNotebookOwnerUsernamesByLinkedNotebookGuids(),
-    m_listLinkedNotebooksOffset(0),
-    m_listLinkedNotebooksRequestId(),
+    m_listLinkedNotebooksPipeline(LINKED_NOTEBOOK_LIST_LIMIT, MIN_LIST_LIMIT, MAX_LIST_LIMIT,
+                                  LIST_TARGET_ROUND_TRIP_MSEC, MAX_LIST_REQUESTS_IN_FLIGHT),
     m_sortedColumn(Columns::Name),
     m_sortOrder(Qt::AscendingOrder),
     m_tagLocalUidsByNoteLocalUid(),
     m_receivedTagLocalUidsForAllNotes(false),
+    m_expectTagLocalUidsForAllNotes(noteModel.listingMode() == NoteModel::ListingMode::Full),
     m_tagRestrictionsByLinkedNotebookGuid(),
     m_findNotebookRequestForLinkedNotebookGuid(),
     m_lastNewTagNameCounter(0),
@@ -86,11 +118,13 @@ TagModel::TagModel(const Account & account, const NoteModel & noteModel,
 {
     createConnections(noteModel, localStorageManagerAsync);
 
-    if (noteModel.allNotesListed()) {
+    if (m_expectTagLocalUidsForAllNotes && noteModel.allNotesListed()) {
         buildTagLocalUidsByNoteLocalUidsHash(noteModel);
     }
 
     requestTagsList();
+
+    m_listLinkedNotebooksPipeline.start();
     requestLinkedNotebooksList();
 }
 
@@ -99,6 +133,30 @@ TagModel::~TagModel()
     delete m_fakeRootItem;
 }
 
+void TagModel::timerEvent(QTimerEvent * pEvent)
+{
+    if (Q_UNLIKELY(!pEvent)) {
+        return;
+    }
+
+    if (pEvent->timerId() != m_noteCountsReconciliationTimer.timerId()) {
+        ItemModel::timerEvent(pEvent);
+        return;
+    }
+
+    if (((m_numNoteCountDeltasSinceReconciliation == 0) && !m_noteCountsDriftDetected) ||
+        !m_noteCountsPerAllTagsRequestId.isNull())
+    {
+        QNTRACE(QStringLiteral("No need to reconcile the note counts per tag with the local storage now"));
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("Reconciling the note counts per tag with the local storage after ")
+            << m_numNoteCountDeltasSinceReconciliation << QStringLiteral(" deltas")
+            << (m_noteCountsDriftDetected ? QStringLiteral(", the previous reconciliation has found the drift") : QString()));
+    requestNoteCountsPerAllTags();
+}
+
 void TagModel::updateAccount(const Account & account)
 {
     QNDEBUG(QStringLiteral("TagModel::updateAccount: ") << account);
@@ -110,6 +168,141 @@ bool TagModel::allTagsListed() const
     return m_allTagsListed && m_allLinkedNotebooksListed;
 }
 
+bool TagModel::saveSnapshot(const QString & filePath, ErrorString & errorDescription) const
+{
+    QNDEBUG(QStringLiteral("TagModel::saveSnapshot: ") << filePath);
+
+    if (!allTagsListed()) {
+        errorDescription.setBase(QT_TR_NOOP("Can't save the snapshot of tags: not all tags have been listed yet"));
+        QNDEBUG(errorDescription);
+        return false;
+    }
+
+    ModelSnapshotWriter writer(TAG_MODEL_SNAPSHOT_VERSION);
+    QDataStream & out = writer.stream();
+
+    out << static_cast<qint32>(m_linkedNotebookOwnerUsernamesByLinkedNotebookGuids.size());
+    for(auto it = m_linkedNotebookOwnerUsernamesByLinkedNotebookGuids.constBegin(),
+        end = m_linkedNotebookOwnerUsernamesByLinkedNotebookGuids.constEnd(); it != end; ++it)
+    {
+        out << it.key() << it.value();
+    }
+
+    // The tag items are written in the order of the model's rows, parents before children,
+    // so that on restoring each item can be put right into its place under its parent
+    QVector<const TagItem*> tagItems;
+    tagItems.reserve(static_cast<int>(m_data.size()));
+    if (m_fakeRootItem) {
+        collectTagItemsForSnapshot(*m_fakeRootItem, tagItems);
+    }
+
+    out << static_cast<qint32>(tagItems.size());
+    for(auto it = tagItems.constBegin(), end = tagItems.constEnd(); it != end; ++it) {
+        out << **it;
+    }
+
+    return writer.writeToFile(filePath, errorDescription);
+}
+
+bool TagModel::restoreFromSnapshot(const QString & filePath, ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("TagModel::restoreFromSnapshot: ") << filePath);
+
+    if (m_allTagsListed || !m_data.empty()) {
+        errorDescription.setBase(QT_TR_NOOP("Can't restore the snapshot of tags: the model already has tags"));
+        QNDEBUG(errorDescription);
+        return false;
+    }
+
+    ModelSnapshotReader reader;
+    if (!reader.open(filePath, TAG_MODEL_SNAPSHOT_VERSION, errorDescription)) {
+        return false;
+    }
+
+    QDataStream & in = reader.stream();
+
+    QHash<QString,QString> linkedNotebookOwnerUsernamesByLinkedNotebookGuids;
+    qint32 numLinkedNotebooks = 0;
+    in >> numLinkedNotebooks;
+    for(qint32 i = 0; (i < numLinkedNotebooks) && (in.status() == QDataStream::Ok); ++i)
+    {
+        QString linkedNotebookGuid;
+        QString username;
+        in >> linkedNotebookGuid >> username;
+        linkedNotebookOwnerUsernamesByLinkedNotebookGuids[linkedNotebookGuid] = username;
+    }
+
+    std::vector<TagItem> items;
+    qint32 numItems = 0;
+    in >> numItems;
+    for(qint32 i = 0; (i < numItems) && (in.status() == QDataStream::Ok); ++i) {
+        TagItem item;
+        in >> item;
+        items.push_back(item);
+    }
+
+    if (!reader.checkStatus(errorDescription)) {
+        return false;
+    }
+
+    for(auto it = linkedNotebookOwnerUsernamesByLinkedNotebookGuids.constBegin(),
+        end = linkedNotebookOwnerUsernamesByLinkedNotebookGuids.constEnd(); it != end; ++it)
+    {
+        if (!m_linkedNotebookOwnerUsernamesByLinkedNotebookGuids.contains(it.key())) {
+            Q_UNUSED(m_linkedNotebookOwnerUsernamesByLinkedNotebookGuids.insert(it.key(), it.value()))
+        }
+    }
+
+    const TagDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
+
+    for(auto it = items.begin(), end = items.end(); it != end; ++it)
+    {
+        const TagItem & item = *it;
+        if (item.localUid().isEmpty() || (localUidIndex.find(item.localUid()) != localUidIndex.end())) {
+            continue;
+        }
+
+        // NOTE: not using tagFromItem here as the restored tag must only have the fields which the item has non-empty,
+        // otherwise i.e. the empty parent local uid would prevent the placement of the tag under its linked notebook
+        Tag tag;
+        tag.setLocalUid(item.localUid());
+
+        if (!item.guid().isEmpty()) {
+            tag.setGuid(item.guid());
+        }
+
+        if (!item.linkedNotebookGuid().isEmpty()) {
+            tag.setLinkedNotebookGuid(item.linkedNotebookGuid());
+        }
+
+        if (!item.parentLocalUid().isEmpty()) {
+            tag.setParentLocalUid(item.parentLocalUid());
+        }
+
+        if (!item.parentGuid().isEmpty()) {
+            tag.setParentGuid(item.parentGuid());
+        }
+
+        tag.setName(item.name());
+        tag.setLocal(!item.isSynchronizable());
+        tag.setDirty(item.isDirty());
+        tag.setFavorited(item.isFavorited());
+
+        // NOTE: bypassing onTagAddedOrUpdated as the tag restored from the snapshot must not get into the tag cache
+        onTagAdded(tag);
+
+        if (item.numNotesPerTag() >= 0) {
+            setNoteCountForTagItem(item.localUid(), item.numNotesPerTag());
+        }
+
+        Q_UNUSED(m_restoredLocalUidsPendingReconciliation.insert(item.localUid()))
+    }
+
+    QNDEBUG(QStringLiteral("Restored ") << m_restoredLocalUidsPendingReconciliation.size()
+            << QStringLiteral(" tags from the snapshot"));
+    return true;
+}
+
 void TagModel::favoriteTag(const QModelIndex & index)
 {
     QNDEBUG(QStringLiteral("TagModel::favoriteTag: index: is valid = ")
@@ -339,6 +532,15 @@ int TagModel::rowCount(const QModelIndex & parent) const
     return (pParentItem ? pParentItem->numChildren() : 0);
 }
 
+bool TagModel::hasChildren(const QModelIndex & parent) const
+{
+    if (!linkedNotebookGuidPendingTagsListing(parent).isEmpty()) {
+        return true;
+    }
+
+    return (rowCount(parent) > 0);
+}
+
 int TagModel::columnCount(const QModelIndex & parent) const
 {
     if (parent.isValid() && (parent.column() != Columns::Name)) {
@@ -867,13 +1069,9 @@ bool TagModel::removeRows(int row, int count, const QModelIndex & parent)
 
         auto modelItemIt = m_modelItemsByLocalUid.find(tag.localUid());
         if (modelItemIt != m_modelItemsByLocalUid.end()) {
+            releaseIdForItem(modelItemIt.value());
             Q_UNUSED(m_modelItemsByLocalUid.erase(modelItemIt))
         }
-
-        auto indexIt = m_indexIdToLocalUidBimap.right.find(tag.localUid());
-        if (indexIt != m_indexIdToLocalUidBimap.right.end()) {
-            Q_UNUSED(m_indexIdToLocalUidBimap.right.erase(indexIt))
-        }
     }
     endRemoveRows();
 
@@ -954,6 +1152,49 @@ void TagModel::sort(int column, Qt::SortOrder order)
     QNDEBUG(QStringLiteral("Successfully sorted the tag model"));
 }
 
+bool TagModel::canFetchMore(const QModelIndex & parent) const
+{
+    return !linkedNotebookGuidPendingTagsListing(parent).isEmpty();
+}
+
+void TagModel::fetchMore(const QModelIndex & parent)
+{
+    QString linkedNotebookGuid = linkedNotebookGuidPendingTagsListing(parent);
+    if (linkedNotebookGuid.isEmpty()) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("TagModel::fetchMore: linked notebook guid = ") << linkedNotebookGuid);
+
+    int position = m_linkedNotebookGuidsPendingTagsListing.indexOf(linkedNotebookGuid);
+    if (position > 0) {
+        m_linkedNotebookGuidsPendingTagsListing.move(position, 0);
+    }
+
+    if (!m_ownTagsListed) {
+        QNDEBUG(QStringLiteral("The tags from the linked notebook would be listed right after the tags from user's own account"));
+        return;
+    }
+
+    if (m_listTagsPipeline.isActive())
+    {
+        if (m_listTagsLinkedNotebookGuid == linkedNotebookGuid) {
+            QNDEBUG(QStringLiteral("The tags from the linked notebook are already being listed"));
+            return;
+        }
+
+        // Postpone the listing of tags from another linked notebook, it would be resumed from where it has stopped
+        auto offsetIt = m_listTagsOffsetsByLinkedNotebookGuid.find(m_listTagsLinkedNotebookGuid);
+        if (offsetIt != m_listTagsOffsetsByLinkedNotebookGuid.end()) {
+            offsetIt.value() = m_listTagsPipeline.appliedOffset();
+        }
+
+        m_listTagsPipeline.stop();
+    }
+
+    requestTagsList();
+}
+
 QStringList TagModel::mimeTypes() const
 {
     QStringList list;
@@ -1208,7 +1449,6 @@ void TagModel::onAddTagComplete(Tag tag, QUuid requestId)
     }
 
     onTagAddedOrUpdated(tag);
-    requestNoteCountForTag(tag);
 }
 
 void TagModel::onAddTagFailed(Tag tag, ErrorString errorDescription, QUuid requestId)
@@ -1335,7 +1575,8 @@ void TagModel::onListTagsComplete(LocalStorageManager::ListObjectsOptions flag,
                                   LocalStorageManager::OrderDirection::type orderDirection,
                                   QString linkedNotebookGuid, QList<Tag> foundTags, QUuid requestId)
 {
-    if (requestId != m_listTagsRequestId) {
+    QList<Tag> readyTags;
+    if (!m_listTagsPipeline.onRequestComplete(requestId, foundTags, readyTags)) {
         return;
     }
 
@@ -1345,26 +1586,31 @@ void TagModel::onListTagsComplete(LocalStorageManager::ListObjectsOptions flag,
             << (linkedNotebookGuid.isNull() ? QStringLiteral("<null>") : linkedNotebookGuid)
             << QStringLiteral(", num found tags = ") << foundTags.size() << QStringLiteral(", request id = ") << requestId);
 
-    for(auto it = foundTags.constBegin(), end = foundTags.constEnd(); it != end; ++it) {
+    for(auto it = readyTags.constBegin(), end = readyTags.constEnd(); it != end; ++it) {
         onTagAddedOrUpdated(*it);
     }
 
-    m_listTagsRequestId = QUuid();
-
-    if (!foundTags.isEmpty()) {
-        QNTRACE(QStringLiteral("The number of found tags is greater than zero, requesting more tags from the local storage"));
-        m_listTagsOffset += static_cast<size_t>(foundTags.size());
+    if (m_listTagsPipeline.isActive()) {
+        QNTRACE(QStringLiteral("Not all tags are listed yet, requesting more tags from the local storage"));
         requestTagsList();
         return;
     }
 
-    m_allTagsListed = true;
-    requestNoteCountsPerAllTags();
+    if (m_listTagsLinkedNotebookGuid.isEmpty()) {
+        QNDEBUG(QStringLiteral("Listed all tags from user's own account"));
+        m_ownTagsListed = true;
+    }
+    else if (m_listTagsOffsetsByLinkedNotebookGuid.contains(m_listTagsLinkedNotebookGuid)) {
+        onAllTagsFromLinkedNotebookListed(m_listTagsLinkedNotebookGuid);
+    }
 
-    if (m_allLinkedNotebooksListed) {
-        Q_EMIT notifyAllTagsListed();
-        Q_EMIT notifyAllItemsListed();
+    if (!m_ownTagsListed || !m_linkedNotebookGuidsPendingTagsListing.isEmpty()) {
+        QNTRACE(QStringLiteral("Requesting more tags from the local storage"));
+        requestTagsList();
+        return;
     }
+
+    checkAndNotifyAllTagsListed();
 }
 
 void TagModel::onListTagsFailed(LocalStorageManager::ListObjectsOptions flag,
@@ -1373,7 +1619,7 @@ void TagModel::onListTagsFailed(LocalStorageManager::ListObjectsOptions flag,
                                 LocalStorageManager::OrderDirection::type orderDirection,
                                 QString linkedNotebookGuid, ErrorString errorDescription, QUuid requestId)
 {
-    if (requestId != m_listTagsRequestId) {
+    if (!m_listTagsPipeline.onRequestFailed(requestId)) {
         return;
     }
 
@@ -1383,9 +1629,17 @@ void TagModel::onListTagsFailed(LocalStorageManager::ListObjectsOptions flag,
             << (linkedNotebookGuid.isNull() ? QStringLiteral("<null>") : linkedNotebookGuid)
             << QStringLiteral(", error description = ") << errorDescription << QStringLiteral(", request id = ") << requestId);
 
-    m_listTagsRequestId = QUuid();
+    // Let the listing of tags from the linked notebook be resumed from where it has stopped on its root item's expansion
+    auto offsetIt = m_listTagsOffsetsByLinkedNotebookGuid.find(m_listTagsLinkedNotebookGuid);
+    if (offsetIt != m_listTagsOffsetsByLinkedNotebookGuid.end()) {
+        offsetIt.value() = m_listTagsPipeline.appliedOffset();
+    }
 
     Q_EMIT notifyError(errorDescription);
+
+    // The listing won't be resumed until the linked notebook's root item is expanded so the restored items
+    // not listed so far can't be reconciled anymore
+    removeUnreconciledRestoredItems();
 }
 
 void TagModel::onExpungeTagComplete(Tag tag, QStringList expungedChildTagLocalUids, QUuid requestId)
@@ -1394,6 +1648,13 @@ void TagModel::onExpungeTagComplete(Tag tag, QStringList expungedChildTagLocalUi
             << QStringLiteral("\nExpunged child tag local uids: ") << expungedChildTagLocalUids.join(QStringLiteral(", "))
             << QStringLiteral(", request id = ") << requestId);
 
+    Q_UNUSED(m_noteCountsByTagLocalUid.remove(tag.localUid()))
+    for(auto childIt = expungedChildTagLocalUids.constBegin(), childEnd = expungedChildTagLocalUids.constEnd();
+        childIt != childEnd; ++childIt)
+    {
+        Q_UNUSED(m_noteCountsByTagLocalUid.remove(*childIt))
+    }
+
     auto it = m_expungeTagRequestIds.find(requestId);
     if (it != m_expungeTagRequestIds.end()) {
         Q_UNUSED(m_expungeTagRequestIds.erase(it))
@@ -1420,86 +1681,6 @@ void TagModel::onExpungeTagFailed(Tag tag, ErrorString errorDescription, QUuid r
     onTagAddedOrUpdated(tag);
 }
 
-void TagModel::onGetNoteCountPerTagComplete(int noteCount, Tag tag, QUuid requestId)
-{
-    auto it = m_noteCountPerTagRequestIds.find(requestId);
-    if (it == m_noteCountPerTagRequestIds.end()) {
-        return;
-    }
-
-    QNDEBUG(QStringLiteral("TagModel::onGetNoteCountPerTagComplete: tag = ") << tag << QStringLiteral("\nRequest id = ")
-            << requestId << QStringLiteral(", note count = ") << noteCount);
-
-    Q_UNUSED(m_noteCountPerTagRequestIds.erase(it))
-
-    TagDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
-
-    auto itemIt = localUidIndex.find(tag.localUid());
-    if (Q_UNLIKELY(itemIt == localUidIndex.end())) {
-        ErrorString error(QT_TR_NOOP("No tag receiving the note count update was found in the model"));
-        QNWARNING(error << QStringLiteral(", tag: ") << tag);
-        Q_EMIT notifyError(error);
-        return;
-    }
-
-    auto modelItemIt = m_modelItemsByLocalUid.find(itemIt->localUid());
-    if (Q_UNLIKELY(modelItemIt == m_modelItemsByLocalUid.end())) {
-        ErrorString error(QT_TR_NOOP("No tag model item corresponding to a receiving the note count update "
-                                     "was found in the model"));
-        QNWARNING(error << QStringLiteral(", tag: ") << tag);
-        Q_EMIT notifyError(error);
-        return;
-    }
-
-    const TagModelItem * pModelItem = &(modelItemIt.value());
-    const TagModelItem * pParentItem = pModelItem->parent();
-    if (Q_UNLIKELY(!pParentItem)) {
-        ErrorString error(QT_TR_NOOP("The tag model item being updated with the note count "
-                                     "does not have a parent item linked with it"));
-        QNWARNING(error << QStringLiteral(", tag: ") << tag << QStringLiteral("\nTag item: ") << *itemIt);
-        Q_EMIT notifyError(error);
-        return;
-    }
-
-    int row = pParentItem->rowForChild(pModelItem);
-    if (Q_UNLIKELY(row < 0)) {
-        ErrorString error(QT_TR_NOOP("Can't find the row of tag model item being updated with the note count "
-                                     "within its parent"));
-        QNWARNING(error << QStringLiteral(", tag: ") << tag << QStringLiteral("\nTag model item: ") << *pModelItem);
-        Q_EMIT notifyError(error);
-        return;
-    }
-
-    TagItem itemCopy = *itemIt;
-    itemCopy.setNumNotesPerTag(noteCount);
-    Q_UNUSED(localUidIndex.replace(itemIt, itemCopy))
-
-    IndexId id = idForItem(*pModelItem);
-    QModelIndex index = createIndex(row, Columns::NumNotesPerTag, id);
-    Q_EMIT dataChanged(index, index);
-
-    // NOTE: in future, if/when sorting by note count is supported, will need to check if need to re-sort and Q_EMIT the layout changed signal
-}
-
-void TagModel::onGetNoteCountPerTagFailed(ErrorString errorDescription, Tag tag, QUuid requestId)
-{
-    auto it = m_noteCountPerTagRequestIds.find(requestId);
-    if (it == m_noteCountPerTagRequestIds.end()) {
-        return;
-    }
-
-    QNDEBUG(QStringLiteral("TagModel::onGetNoteCountPerTagFailed: error description = ") << errorDescription
-            << QStringLiteral(", tag = ") << tag << QStringLiteral(", request id = ") << requestId);
-
-    Q_UNUSED(m_noteCountPerTagRequestIds.erase(it))
-
-    ErrorString error(QT_TR_NOOP("Failed to get note count for one of tags"));
-    error.appendBase(errorDescription.base());
-    error.appendBase(errorDescription.additionalBases());
-    error.details() = errorDescription.details();
-    Q_EMIT notifyError(error);
-}
-
 void TagModel::onGetNoteCountsPerAllTagsComplete(QHash<QString, int> noteCountsPerTagLocalUid, QUuid requestId)
 {
     if (requestId != m_noteCountsPerAllTagsRequestId) {
@@ -1512,6 +1693,44 @@ void TagModel::onGetNoteCountsPerAllTagsComplete(QHash<QString, int> noteCountsP
 
     m_noteCountsPerAllTagsRequestId = QUuid();
 
+    bool driftDetected = false;
+    if (m_receivedNoteCountsForAllTags)
+    {
+        int numDriftedNoteCounts = 0;
+        for(auto it = noteCountsPerTagLocalUid.constBegin(), end = noteCountsPerTagLocalUid.constEnd(); it != end; ++it)
+        {
+            if (m_noteCountsByTagLocalUid.value(it.key(), 0) != it.value()) {
+                ++numDriftedNoteCounts;
+            }
+        }
+
+        for(auto it = m_noteCountsByTagLocalUid.constBegin(), end = m_noteCountsByTagLocalUid.constEnd(); it != end; ++it)
+        {
+            if ((it.value() != 0) && !noteCountsPerTagLocalUid.contains(it.key())) {
+                ++numDriftedNoteCounts;
+            }
+        }
+
+        if (numDriftedNoteCounts != 0) {
+            QNINFO(QStringLiteral("Delta-maintained note counts drifted from the local storage for ") << numDriftedNoteCounts
+                   << QStringLiteral(" tags, ") << m_numNoteCountDeltasSinceReconciliation
+                   << QStringLiteral(" deltas were applied since the previous reconciliation; scheduling the corrective recount"));
+            driftDetected = true;
+        }
+    }
+
+    m_noteCountsByTagLocalUid = noteCountsPerTagLocalUid;
+    m_receivedNoteCountsForAllTags = true;
+    m_numNoteCountDeltasSinceReconciliation = 0;
+
+    // NOTE: the drift means the deltas have missed some changes of notes, the recount following shortly
+    // makes sure these changes are not still in progress, otherwise the regular reconciliation is scheduled
+    m_noteCountsDriftDetected = driftDetected;
+    m_noteCountsReconciliationTimer.start((m_noteCountsDriftDetected
+                                           ? TAG_MODEL_NOTE_COUNTS_DRIFT_RECOUNT_DELAY
+                                           : TAG_MODEL_NOTE_COUNTS_RECONCILIATION_INTERVAL),
+                                          this);
+
     TagDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
     for(auto it = localUidIndex.begin(), end = localUidIndex.end(); it != end; ++it)
     {
@@ -1544,6 +1763,11 @@ void TagModel::onGetNoteCountsPerAllTagsComplete(QHash<QString, int> noteCountsP
     QModelIndex startIndex = index(0, Columns::NumNotesPerTag, QModelIndex());
     QModelIndex endIndex = index(rowCount(QModelIndex()), Columns::NumNotesPerTag, QModelIndex());
     Q_EMIT dataChanged(startIndex, endIndex);
+
+    if (m_noteCountsRecountPending) {
+        QNDEBUG(QStringLiteral("Notes have changed since the recount was requested, repeating it"));
+        requestNoteCountsPerAllTags();
+    }
 }
 
 void TagModel::onGetNoteCountsPerAllTagsFailed(ErrorString errorDescription, QUuid requestId)
@@ -1556,6 +1780,7 @@ void TagModel::onGetNoteCountsPerAllTagsFailed(ErrorString errorDescription, QUu
               << errorDescription << QStringLiteral(", request id = ") << requestId);
 
     m_noteCountsPerAllTagsRequestId = QUuid();
+    m_noteCountsRecountPending = false;
 
     ErrorString error(QT_TR_NOOP("Failed to get note counts for tags"));
     error.appendBase(errorDescription.base());
@@ -1665,7 +1890,12 @@ void TagModel::onAddNoteComplete(Note note, QUuid requestId)
 
     if (!note.hasTagLocalUids())
     {
-        if (note.hasTagGuids()) {
+        if (note.hasTagGuids() && !m_noteCountsPerAllTagsRequestId.isNull()) {
+            QNDEBUG(QStringLiteral("The note has tag guids but not tag local uids while the recount of notes per tag "
+                                   "is in progress, will repeat the recount instead of counting the note separately"));
+            m_noteCountsRecountPending = true;
+        }
+        else if (note.hasTagGuids()) {
             QNDEBUG(QStringLiteral("The note has tag guids but not tag local uids, need to request the proper list "
                                    "of tags from this note before their note counts can be updated"));
             requestTagsPerNote(note);
@@ -1682,16 +1912,13 @@ void TagModel::onAddNoteComplete(Note note, QUuid requestId)
         m_tagLocalUidsByNoteLocalUid[note.localUid()] = tagLocalUids;
     }
 
-    for(auto it = tagLocalUids.constBegin(), end = tagLocalUids.constEnd(); it != end; ++it) {
-        Tag dummy;
-        dummy.setLocalUid(*it);
-        requestNoteCountForTag(dummy);
-    }
+    applyNoteCountDeltas(QStringList(), tagLocalUids);
 }
 
 void TagModel::onUpdateNoteComplete(Note note, bool updateResources, bool updateTags, QUuid requestId)
 {
     if (!updateTags) {
+        applyNoteDeletionStateChange(note);
         return;
     }
 
@@ -1702,20 +1929,39 @@ void TagModel::onUpdateNoteComplete(Note note, bool updateResources, bool update
             << (updateTags ? QStringLiteral("true") : QStringLiteral("false"))
             << QStringLiteral(", request id = ") << requestId);
 
-    if (!m_receivedTagLocalUidsForAllNotes) {
-        // Tags might have been removed from the note so need to re-request the note count for all tags
+    if (!m_expectTagLocalUidsForAllNotes) {
+        // Tags might have been removed from the note but it's unknown which ones; the recount requests
+        // coming while the recount is in progress are coalesced into the single repeated one
+        QNDEBUG(QStringLiteral("The tag local uids of notes are not known, requesting the recount of notes per tag"));
         requestNoteCountsPerAllTags();
         return;
     }
 
+    if (!m_receivedTagLocalUidsForAllNotes) {
+        // Tags might have been removed from the note but it's unknown which ones; the note counts for all tags
+        // are to be re-requested once the tag local uids of all notes are known so that all the note updates
+        // coming before that lead to the single recount
+        QNDEBUG(QStringLiteral("The tag local uids of all notes are not known yet, deferring the recount of notes per tag"));
+        m_noteCountsRecountPending = true;
+        return;
+    }
+
+    // Deleted notes don't count towards the number of notes per tag
+    QStringList newTagLocalUids = ((note.hasTagLocalUids() && !note.hasDeletionTimestamp())
+                                   ? note.tagLocalUids()
+                                   : QStringList());
+
+    applyNoteTagsChange(note.localUid(), newTagLocalUids);
+}
+
+void TagModel::applyNoteTagsChange(const QString & noteLocalUid, const QStringList & newTagLocalUids)
+{
     QStringList oldTagLocalUids;
-    auto it = m_tagLocalUidsByNoteLocalUid.find(note.localUid());
+    auto it = m_tagLocalUidsByNoteLocalUid.find(noteLocalUid);
     if (it != m_tagLocalUidsByNoteLocalUid.end()) {
         oldTagLocalUids = it.value();
     }
 
-    QStringList newTagLocalUids = (note.hasTagLocalUids() ? note.tagLocalUids() : QStringList());
-
     bool sameTags = (oldTagLocalUids.size() == newTagLocalUids.size());
     if (sameTags)
     {
@@ -1738,18 +1984,24 @@ void TagModel::onUpdateNoteComplete(Note note, bool updateResources, bool update
     QNTRACE(QStringLiteral("Old tags: ") << oldTagLocalUids.join(QStringLiteral(", "))
             << QStringLiteral("; new tags: ") << newTagLocalUids.join(QStringLiteral(", ")));
 
-    QStringList tagsToUpdate = oldTagLocalUids;
-    tagsToUpdate << newTagLocalUids;
-    Q_UNUSED(tagsToUpdate.removeDuplicates())
-    QNTRACE(QStringLiteral("Local uids of tags for which the update of note count is needed: ")
-            << tagsToUpdate.join(QStringLiteral(", ")));
+    QStringList removedFromTagLocalUids;
+    for(auto oldTagIt = oldTagLocalUids.constBegin(), end = oldTagLocalUids.constEnd(); oldTagIt != end; ++oldTagIt)
+    {
+        if (!newTagLocalUids.contains(*oldTagIt)) {
+            removedFromTagLocalUids << *oldTagIt;
+        }
+    }
 
-    for(auto tagIt = tagsToUpdate.constBegin(), end = tagsToUpdate.constEnd(); tagIt != end; ++tagIt) {
-        Tag dummy;
-        dummy.setLocalUid(*tagIt);
-        requestNoteCountForTag(dummy);
+    QStringList addedToTagLocalUids;
+    for(auto newTagIt = newTagLocalUids.constBegin(), end = newTagLocalUids.constEnd(); newTagIt != end; ++newTagIt)
+    {
+        if (!oldTagLocalUids.contains(*newTagIt)) {
+            addedToTagLocalUids << *newTagIt;
+        }
     }
 
+    applyNoteCountDeltas(removedFromTagLocalUids, addedToTagLocalUids);
+
     // Finally, update tag local uids per note local uid in our own hash
     if (it != m_tagLocalUidsByNoteLocalUid.end())
     {
@@ -1762,57 +2014,68 @@ void TagModel::onUpdateNoteComplete(Note note, bool updateResources, bool update
     }
     else if (!newTagLocalUids.isEmpty())
     {
-        m_tagLocalUidsByNoteLocalUid[note.localUid()] = newTagLocalUids;
+        m_tagLocalUidsByNoteLocalUid[noteLocalUid] = newTagLocalUids;
     }
 }
 
-void TagModel::onExpungeNoteComplete(Note note, QUuid requestId)
+void TagModel::applyNoteDeletionStateChange(const Note & note)
 {
-    QNDEBUG(QStringLiteral("TagModel::onExpungeNoteComplete: note = ") << note
-            << QStringLiteral("\nRequest id = ") << requestId);
+    if (!m_receivedTagLocalUidsForAllNotes) {
+        // Without the tag local uids of all notes it's unknown whether the note has been counted towards its tags
+        // before the update, the periodic reconciliation would catch the change if there was any
+        return;
+    }
 
-    if (note.hasTagLocalUids())
+    // Only the notes counted towards some tags are present within the hash
+    bool noteWasCounted = m_tagLocalUidsByNoteLocalUid.contains(note.localUid());
+
+    if (note.hasDeletionTimestamp())
     {
-        const QStringList & tagLocalUids = note.tagLocalUids();
-        for(auto it = tagLocalUids.constBegin(), end = tagLocalUids.constEnd(); it != end; ++it)
-        {
-            const QString & tagLocalUid = *it;
-            Tag tag;
-            tag.setLocalUid(tagLocalUid);
-            requestNoteCountForTag(tag);
+        if (noteWasCounted) {
+            QNDEBUG(QStringLiteral("The note has been moved to the trash, it no longer counts towards its tags: ")
+                    << note.localUid());
+            applyNoteTagsChange(note.localUid(), QStringList());
         }
 
         return;
     }
 
-    QNDEBUG(QStringLiteral("Note has no tag local uids"));
+    if (!noteWasCounted && note.hasTagLocalUids() && !note.tagLocalUids().isEmpty()) {
+        QNDEBUG(QStringLiteral("The note has been restored from the trash, it counts towards its tags again: ")
+                << note.localUid());
+        applyNoteTagsChange(note.localUid(), note.tagLocalUids());
+    }
+}
+
+void TagModel::onExpungeNoteComplete(Note note, QUuid requestId)
+{
+    QNDEBUG(QStringLiteral("TagModel::onExpungeNoteComplete: note = ") << note
+            << QStringLiteral("\nRequest id = ") << requestId);
 
     if (m_receivedTagLocalUidsForAllNotes)
     {
+        // The cached tag local uids are those the note was counted for, the expunged note itself
+        // might have been deleted before and hence not counted towards any tag at the moment
         auto it = m_tagLocalUidsByNoteLocalUid.find(note.localUid());
-        if (it != m_tagLocalUidsByNoteLocalUid.end())
-        {
-            const QStringList & tagLocalUids = it.value();
-            QNTRACE(QStringLiteral("Last known tag local uids for the expunged note: ")
-                    << tagLocalUids.join(QStringLiteral(", ")));
-
-            for(auto tagIt = tagLocalUids.constBegin(), end = tagLocalUids.constEnd(); tagIt != end; ++tagIt) {
-                Tag dummy;
-                dummy.setLocalUid(*tagIt);
-                requestNoteCountForTag(dummy);
-            }
-
-            // Finally, erasing the entry for this note from our hash since the note was expunged
-            Q_UNUSED(m_tagLocalUidsByNoteLocalUid.erase(it))
-        }
-        else
-        {
+        if (it == m_tagLocalUidsByNoteLocalUid.end()) {
             QNDEBUG(QStringLiteral("Found no cached tag local uids for this note"));
+            return;
         }
+
+        QNTRACE(QStringLiteral("Last known tag local uids for the expunged note: ")
+                << it.value().join(QStringLiteral(", ")));
+
+        QStringList tagLocalUids = it.value();
+        Q_UNUSED(m_tagLocalUidsByNoteLocalUid.erase(it))
+        applyNoteCountDeltas(tagLocalUids, QStringList());
+        return;
     }
-    else
-    {
-        QNDEBUG(QStringLiteral("Haven't received the tag local uids for all notes yet"));
+
+    QNDEBUG(QStringLiteral("Haven't received the tag local uids for all notes yet"));
+
+    if (note.hasTagLocalUids() && !note.hasDeletionTimestamp()) {
+        applyNoteCountDeltas(note.tagLocalUids(), QStringList());
+        return;
     }
 
     // Inefficient fallback which should be used rarely if at all
@@ -1846,6 +2109,17 @@ void TagModel::onExpungeLinkedNotebookComplete(LinkedNotebook linkedNotebook, QU
 
     const QString & linkedNotebookGuid = linkedNotebook.guid();
 
+    if (m_listTagsOffsetsByLinkedNotebookGuid.contains(linkedNotebookGuid)) {
+        QNDEBUG(QStringLiteral("The expunged linked notebook's tags were pending listing, won't list them"));
+        Q_UNUSED(m_linkedNotebookGuidsPendingTagsListing.removeAll(linkedNotebookGuid))
+        Q_UNUSED(m_listTagsOffsetsByLinkedNotebookGuid.remove(linkedNotebookGuid))
+
+        if (m_listTagsPipeline.isActive() && (m_listTagsLinkedNotebookGuid == linkedNotebookGuid)) {
+            m_listTagsPipeline.stop();
+            requestTagsList();
+        }
+    }
+
     QStringList expungedTagLocalUids;
     const TagDataByLinkedNotebookGuid & linkedNotebookGuidIndex = m_data.get<ByLinkedNotebookGuid>();
     auto range = linkedNotebookGuidIndex.equal_range(linkedNotebookGuid);
@@ -1875,6 +2149,7 @@ void TagModel::onExpungeLinkedNotebookComplete(LinkedNotebook linkedNotebook, QU
             }
         }
 
+        releaseIdForItem(modelItemIt.value());
         Q_UNUSED(m_modelItemsByLinkedNotebookGuid.erase(modelItemIt))
     }
 
@@ -1883,10 +2158,7 @@ void TagModel::onExpungeLinkedNotebookComplete(LinkedNotebook linkedNotebook, QU
         Q_UNUSED(m_linkedNotebookItems.erase(linkedNotebookItemIt))
     }
 
-    auto indexIt = m_indexIdToLinkedNotebookGuidBimap.right.find(linkedNotebookGuid);
-    if (indexIt != m_indexIdToLinkedNotebookGuidBimap.right.end()) {
-        Q_UNUSED(m_indexIdToLinkedNotebookGuidBimap.right.erase(indexIt))
-    }
+    checkAndNotifyAllTagsListed();
 }
 
 void TagModel::onListAllTagsPerNoteComplete(QList<Tag> foundTags, Note note,
@@ -1907,9 +2179,23 @@ void TagModel::onListAllTagsPerNoteComplete(QList<Tag> foundTags, Note note,
             << QStringLiteral(", order direction = ") << orderDirection << QStringLiteral(", request id = ")
             << requestId);
 
-    for(auto it = foundTags.constBegin(), end = foundTags.constEnd(); it != end; ++it) {
-        requestNoteCountForTag(*it);
+    Q_UNUSED(m_listTagsPerNoteRequestIds.erase(it))
+
+    QStringList tagLocalUids;
+    tagLocalUids.reserve(foundTags.size());
+    for(auto tagIt = foundTags.constBegin(), end = foundTags.constEnd(); tagIt != end; ++tagIt) {
+        tagLocalUids << tagIt->localUid();
+    }
+
+    if (m_receivedTagLocalUidsForAllNotes) {
+        // NOTE: the note's tags might have already been counted if the update of the note came before this reply
+        // or if the note was among the ones the tag local uids of all notes were built from, hence applying
+        // only the difference with the tags known for this note
+        applyNoteTagsChange(note.localUid(), tagLocalUids);
+        return;
     }
+
+    applyNoteCountDeltas(QStringList(), tagLocalUids);
 }
 
 void TagModel::onListAllTagsPerNoteFailed(Note note, LocalStorageManager::ListObjectsOptions flag,
@@ -1923,6 +2209,8 @@ void TagModel::onListAllTagsPerNoteFailed(Note note, LocalStorageManager::ListOb
         return;
     }
 
+    Q_UNUSED(m_listTagsPerNoteRequestIds.erase(it))
+
     QNWARNING(QStringLiteral("TagModel::onListAllTagsPerNoteFailed: note = ") << note
               << QStringLiteral("\nFlag = ") << flag << QStringLiteral(", limit = ") << limit
               << QStringLiteral(", offset = ") << offset << QStringLiteral(", order = ") << order
@@ -1939,7 +2227,8 @@ void TagModel::onListAllLinkedNotebooksComplete(size_t limit, size_t offset,
                                                 QList<LinkedNotebook> foundLinkedNotebooks,
                                                 QUuid requestId)
 {
-    if (requestId != m_listLinkedNotebooksRequestId) {
+    QList<LinkedNotebook> readyLinkedNotebooks;
+    if (!m_listLinkedNotebooksPipeline.onRequestComplete(requestId, foundLinkedNotebooks, readyLinkedNotebooks)) {
         return;
     }
 
@@ -1948,26 +2237,29 @@ void TagModel::onListAllLinkedNotebooksComplete(size_t limit, size_t offset,
             << order << QStringLiteral(", order direction = ") << orderDirection
             << QStringLiteral(", request id = ") << requestId);
 
-    for(auto it = foundLinkedNotebooks.constBegin(), end = foundLinkedNotebooks.constEnd(); it != end; ++it) {
-        onLinkedNotebookAddedOrUpdated(*it);
+    for(auto it = readyLinkedNotebooks.constBegin(), end = readyLinkedNotebooks.constEnd(); it != end; ++it)
+    {
+        const LinkedNotebook & linkedNotebook = *it;
+        onLinkedNotebookAddedOrUpdated(linkedNotebook);
+
+        if (linkedNotebook.hasGuid()) {
+            enqueueLinkedNotebookTagsListing(linkedNotebook.guid());
+        }
     }
 
-    m_listLinkedNotebooksRequestId = QUuid();
+    if (m_ownTagsListed && !m_listTagsPipeline.isActive() && !m_linkedNotebookGuidsPendingTagsListing.isEmpty()) {
+        QNDEBUG(QStringLiteral("Starting the listing of tags from linked notebooks"));
+        requestTagsList();
+    }
 
-    if (!foundLinkedNotebooks.isEmpty()) {
-        QNTRACE(QStringLiteral("The number of found linked notebooks is not empty, requesting more "
-                               "linked notebooks from the local storage"));
-        m_listLinkedNotebooksOffset += static_cast<size_t>(foundLinkedNotebooks.size());
+    if (m_listLinkedNotebooksPipeline.isActive()) {
+        QNTRACE(QStringLiteral("Not all linked notebooks are listed yet, requesting more linked notebooks from the local storage"));
         requestLinkedNotebooksList();
         return;
     }
 
     m_allLinkedNotebooksListed = true;
-
-    if (m_allTagsListed) {
-        Q_EMIT notifyAllTagsListed();
-        Q_EMIT notifyAllItemsListed();
-    }
+    checkAndNotifyAllTagsListed();
 }
 
 void TagModel::onListAllLinkedNotebooksFailed(size_t limit, size_t offset,
@@ -1975,7 +2267,7 @@ void TagModel::onListAllLinkedNotebooksFailed(size_t limit, size_t offset,
                                               LocalStorageManager::OrderDirection::type orderDirection,
                                               ErrorString errorDescription, QUuid requestId)
 {
-    if (requestId != m_listLinkedNotebooksRequestId) {
+    if (!m_listLinkedNotebooksPipeline.onRequestFailed(requestId)) {
         return;
     }
 
@@ -1984,16 +2276,17 @@ void TagModel::onListAllLinkedNotebooksFailed(size_t limit, size_t offset,
             << QStringLiteral(", order direction = ") << orderDirection << QStringLiteral(", error description = ")
             << errorDescription << QStringLiteral(", request id = ") << requestId);
 
-    m_listLinkedNotebooksRequestId = QUuid();
-
     Q_EMIT notifyError(errorDescription);
+
+    // Without the linked notebooks listed the listing of tags won't complete
+    removeUnreconciledRestoredItems();
 }
 
 void TagModel::createConnections(const NoteModel & noteModel, LocalStorageManagerAsync & localStorageManagerAsync)
 {
     QNDEBUG(QStringLiteral("TagModel::createConnections"));
 
-    if (!noteModel.allNotesListed()) {
+    if (m_expectTagLocalUidsForAllNotes && !noteModel.allNotesListed()) {
         QObject::connect(&noteModel, QNSIGNAL(NoteModel,notifyAllNotesListed),
                          this, QNSLOT(TagModel,onAllNotesListed));
     }
@@ -2014,8 +2307,6 @@ void TagModel::createConnections(const NoteModel & noteModel, LocalStorageManage
                      &localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onExpungeTagRequest,Tag,QUuid));
     QObject::connect(this, QNSIGNAL(TagModel,findNotebook,Notebook,QUuid),
                      &localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onFindNotebookRequest,Notebook,QUuid));
-    QObject::connect(this, QNSIGNAL(TagModel,requestNoteCountPerTag,Tag,QUuid),
-                     &localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onGetNoteCountPerTagRequest,Tag,QUuid));
     QObject::connect(this, QNSIGNAL(TagModel,requestNoteCountsForAllTags,QUuid),
                      &localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onGetNoteCountsPerAllTagsRequest,QUuid));
     QObject::connect(this, QNSIGNAL(TagModel,listAllTagsPerNote,Note,LocalStorageManager::ListObjectsOptions,size_t,size_t,
@@ -2057,10 +2348,6 @@ void TagModel::createConnections(const NoteModel & noteModel, LocalStorageManage
                      this, QNSLOT(TagModel,onExpungeTagComplete,Tag,QStringList,QUuid));
     QObject::connect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,expungeTagFailed,Tag,ErrorString,QUuid),
                      this, QNSLOT(TagModel,onExpungeTagFailed,Tag,ErrorString,QUuid));
-    QObject::connect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,getNoteCountPerTagComplete,int,Tag,QUuid),
-                     this, QNSLOT(TagModel,onGetNoteCountPerTagComplete,int,Tag,QUuid));
-    QObject::connect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,getNoteCountPerTagFailed,ErrorString,Tag,QUuid),
-                     this, QNSLOT(TagModel,onGetNoteCountPerTagFailed,ErrorString,Tag,QUuid));
     QObject::connect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,getNoteCountsPerAllTagsComplete,QHash<QString,int>,QUuid),
                      this, QNSLOT(TagModel,onGetNoteCountsPerAllTagsComplete,QHash<QString,int>,QUuid));
     QObject::connect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,getNoteCountsPerAllTagsFailed,ErrorString,QUuid),
@@ -2110,26 +2397,38 @@ void TagModel::createConnections(const NoteModel & noteModel, LocalStorageManage
 
 void TagModel::requestTagsList()
 {
-    QNDEBUG(QStringLiteral("TagModel::requestTagsList: offset = ") << m_listTagsOffset);
+    if (!m_listTagsPipeline.isActive())
+    {
+        if (!m_ownTagsListed) {
+            // NOTE: empty but not null linked notebook guid means listing the tags from user's own account only
+            m_listTagsLinkedNotebookGuid = QStringLiteral("");
+            m_listTagsPipeline.start();
+        }
+        else if (!m_linkedNotebookGuidsPendingTagsListing.isEmpty()) {
+            m_listTagsLinkedNotebookGuid = m_linkedNotebookGuidsPendingTagsListing.front();
+            m_listTagsPipeline.start(m_listTagsOffsetsByLinkedNotebookGuid.value(m_listTagsLinkedNotebookGuid, 0));
+        }
+        else {
+            QNDEBUG(QStringLiteral("TagModel::requestTagsList: no tags are pending listing"));
+            return;
+        }
+    }
+
+    QNDEBUG(QStringLiteral("TagModel::requestTagsList: offset = ") << m_listTagsPipeline.appliedOffset()
+            << QStringLiteral(", linked notebook guid = ") << m_listTagsLinkedNotebookGuid);
 
     LocalStorageManager::ListObjectsOptions flags = LocalStorageManager::ListAll;
     LocalStorageManager::ListTagsOrder::type order = LocalStorageManager::ListTagsOrder::NoOrder;
     LocalStorageManager::OrderDirection::type direction = LocalStorageManager::OrderDirection::Ascending;
 
-    m_listTagsRequestId = QUuid::createUuid();
-    QNTRACE(QStringLiteral("Emitting the request to list tags: offset = ") << m_listTagsOffset << QStringLiteral(", request id = ")
-            << m_listTagsRequestId);
-    Q_EMIT listTags(flags, TAG_LIST_LIMIT, m_listTagsOffset, order, direction, QString(), m_listTagsRequestId);
-}
-
-void TagModel::requestNoteCountForTag(const Tag & tag)
-{
-    QNDEBUG(QStringLiteral("TagModel::requestNoteCountForTag: ") << tag);
-
-    QUuid requestId = QUuid::createUuid();
-    Q_UNUSED(m_noteCountPerTagRequestIds.insert(requestId))
-    QNTRACE(QStringLiteral("Emitting the request to compute the number of notes per tag, request id = ") << requestId);
-    Q_EMIT requestNoteCountPerTag(tag, requestId);
+    QList<ListTagsPipeline::Request> requests = m_listTagsPipeline.takeRequestsToSend();
+    for(auto it = requests.constBegin(), end = requests.constEnd(); it != end; ++it)
+    {
+        const ListTagsPipeline::Request & request = *it;
+        QNTRACE(QStringLiteral("Emitting the request to list tags: offset = ") << request.m_offset << QStringLiteral(", limit = ")
+                << request.m_limit << QStringLiteral(", request id = ") << request.m_requestId);
+        Q_EMIT listTags(flags, request.m_limit, request.m_offset, order, direction, m_listTagsLinkedNotebookGuid, request.m_requestId);
+    }
 }
 
 void TagModel::requestTagsPerNote(const Note & note)
@@ -2148,27 +2447,128 @@ void TagModel::requestNoteCountsPerAllTags()
 {
     QNDEBUG(QStringLiteral("TagModel::requestNoteCountsPerAllTags"));
 
+    if (!m_noteCountsPerAllTagsRequestId.isNull()) {
+        // The request in flight might have been processed before the change which caused this request
+        QNDEBUG(QStringLiteral("The recount of notes per tag is in progress, will repeat it once it's finished"));
+        m_noteCountsRecountPending = true;
+        return;
+    }
+
+    m_noteCountsRecountPending = false;
     m_noteCountsPerAllTagsRequestId = QUuid::createUuid();
     Q_EMIT requestNoteCountsForAllTags(m_noteCountsPerAllTagsRequestId);
 }
 
+void TagModel::applyNoteCountDeltas(const QStringList & removedFromTagLocalUids, const QStringList & addedToTagLocalUids)
+{
+    QNDEBUG(QStringLiteral("TagModel::applyNoteCountDeltas: removed from tags: ")
+            << removedFromTagLocalUids.join(QStringLiteral(", ")) << QStringLiteral("; added to tags: ")
+            << addedToTagLocalUids.join(QStringLiteral(", ")));
+
+    if (!m_noteCountsPerAllTagsRequestId.isNull()) {
+        // The counts are going to be replaced with the ones from the recount in progress which might or might not
+        // include this change, hence the recount needs to be repeated instead of applying the deltas
+        QNDEBUG(QStringLiteral("The recount of notes per tag is in progress, will repeat it instead of applying the deltas"));
+        m_noteCountsRecountPending = true;
+        return;
+    }
+
+    const TagDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
+    bool driftDetected = false;
+
+    for(auto it = removedFromTagLocalUids.constBegin(), end = removedFromTagLocalUids.constEnd(); it != end; ++it)
+    {
+        const QString & tagLocalUid = *it;
+
+        auto countIt = m_noteCountsByTagLocalUid.find(tagLocalUid);
+        if ((countIt == m_noteCountsByTagLocalUid.end()) || (countIt.value() <= 0))
+        {
+            // It's fine for the expunged tags or the tags not listed yet but not for the tags within the model
+            if (m_receivedNoteCountsForAllTags && (localUidIndex.find(tagLocalUid) != localUidIndex.end())) {
+                QNDEBUG(QStringLiteral("The note count for tag ") << tagLocalUid << QStringLiteral(" would become negative"));
+                driftDetected = true;
+            }
+
+            continue;
+        }
+
+        int noteCount = --countIt.value();
+        ++m_numNoteCountDeltasSinceReconciliation;
+
+        if (m_receivedNoteCountsForAllTags) {
+            setNoteCountForTagItem(tagLocalUid, noteCount);
+        }
+    }
+
+    for(auto it = addedToTagLocalUids.constBegin(), end = addedToTagLocalUids.constEnd(); it != end; ++it)
+    {
+        const QString & tagLocalUid = *it;
+
+        int noteCount = ++m_noteCountsByTagLocalUid[tagLocalUid];
+        ++m_numNoteCountDeltasSinceReconciliation;
+
+        if (m_receivedNoteCountsForAllTags) {
+            setNoteCountForTagItem(tagLocalUid, noteCount);
+        }
+    }
+
+    if (driftDetected) {
+        QNINFO(QStringLiteral("Detected the drift of delta-maintained note counts per tag, requesting the full recount"));
+        requestNoteCountsPerAllTags();
+    }
+}
+
+void TagModel::setNoteCountForTagItem(const QString & tagLocalUid, const int noteCount)
+{
+    TagDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
+
+    auto itemIt = localUidIndex.find(tagLocalUid);
+    if (itemIt == localUidIndex.end()) {
+        QNTRACE(QStringLiteral("No tag item corresponding to local uid ") << tagLocalUid
+                << QStringLiteral(" is within the model yet, the note count would be set when it is added"));
+        return;
+    }
+
+    if (itemIt->numNotesPerTag() == noteCount) {
+        return;
+    }
+
+    TagItem itemCopy = *itemIt;
+    itemCopy.setNumNotesPerTag(noteCount);
+    Q_UNUSED(localUidIndex.replace(itemIt, itemCopy))
+
+    QModelIndex idx = indexForLocalUid(tagLocalUid);
+    if (idx.isValid()) {
+        idx = index(idx.row(), Columns::NumNotesPerTag, idx.parent());
+        Q_EMIT dataChanged(idx, idx);
+    }
+
+    // NOTE: in future, if/when sorting by note count is supported, will need to check if need to re-sort and Q_EMIT the layout changed signal
+}
+
 void TagModel::requestLinkedNotebooksList()
 {
-    QNDEBUG(QStringLiteral("TagModel::requestLinkedNotebooksList"));
+    QNDEBUG(QStringLiteral("TagModel::requestLinkedNotebooksList: offset = ") << m_listLinkedNotebooksPipeline.appliedOffset());
 
     LocalStorageManager::ListLinkedNotebooksOrder::type order = LocalStorageManager::ListLinkedNotebooksOrder::NoOrder;
     LocalStorageManager::OrderDirection::type direction = LocalStorageManager::OrderDirection::Ascending;
 
-    m_listLinkedNotebooksRequestId = QUuid::createUuid();
-    QNTRACE(QStringLiteral("Emitting the request to list linked notebooks: offset = ") << m_listLinkedNotebooksOffset
-            << QStringLiteral(", request id = ") << m_listLinkedNotebooksRequestId);
-    Q_EMIT listAllLinkedNotebooks(LINKED_NOTEBOOK_LIST_LIMIT, m_listLinkedNotebooksOffset, order, direction, m_listLinkedNotebooksRequestId);
+    QList<ListLinkedNotebooksPipeline::Request> requests = m_listLinkedNotebooksPipeline.takeRequestsToSend();
+    for(auto it = requests.constBegin(), end = requests.constEnd(); it != end; ++it)
+    {
+        const ListLinkedNotebooksPipeline::Request & request = *it;
+        QNTRACE(QStringLiteral("Emitting the request to list linked notebooks: offset = ") << request.m_offset
+                << QStringLiteral(", limit = ") << request.m_limit << QStringLiteral(", request id = ") << request.m_requestId);
+        Q_EMIT listAllLinkedNotebooks(request.m_limit, request.m_offset, order, direction, request.m_requestId);
+    }
 }
 
 void TagModel::onTagAddedOrUpdated(const Tag & tag)
 {
     TagDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
 
+    Q_UNUSED(m_restoredLocalUidsPendingReconciliation.remove(tag.localUid()))
+
     m_cache.put(tag.localUid(), tag);
 
     auto itemIt = localUidIndex.find(tag.localUid());
@@ -2229,6 +2629,10 @@ void TagModel::onTagAdded(const Tag & tag)
     TagItem item;
     tagToItem(tag, item);
 
+    if (m_receivedNoteCountsForAllTags) {
+        item.setNumNotesPerTag(m_noteCountsByTagLocalUid.value(item.localUid(), 0));
+    }
+
     checkAndFindLinkedNotebookRestrictions(item);
 
     // The new item is going to be inserted into the last row of the parent item
@@ -2540,67 +2944,85 @@ void TagModel::onLinkedNotebookAddedOrUpdated(const LinkedNotebook & linkedNoteb
 
 const TagModelItem * TagModel::itemForId(const IndexId id) const
 {
-    QNDEBUG(QStringLiteral("TagModel::itemForId: ") << id);
-
-    auto localUidIt = m_indexIdToLocalUidBimap.left.find(id);
-    if (localUidIt == m_indexIdToLocalUidBimap.left.end())
-    {
-        auto linkedNotebookGuidIt = m_indexIdToLinkedNotebookGuidBimap.left.find(id);
-        if (linkedNotebookGuidIt == m_indexIdToLinkedNotebookGuidBimap.left.end()) {
-            QNDEBUG(QStringLiteral("Found no tag model item corresponding to model index internal id"));
-            return Q_NULLPTR;
-        }
-
-        const QString & linkedNotebookGuid = linkedNotebookGuidIt->second;
-        auto linkedNotebookModelItemIt = m_modelItemsByLinkedNotebookGuid.find(linkedNotebookGuid);
-        if (linkedNotebookModelItemIt == m_modelItemsByLinkedNotebookGuid.end()) {
-            QNDEBUG(QStringLiteral("Found no tag linked notebook root model item corresponding to the linked notebook guid "
-                                   "corresponding to model index internal id"));
-            return Q_NULLPTR;
-        }
+    QNTRACE(QStringLiteral("TagModel::itemForId: ") << id);
 
-        return &(linkedNotebookModelItemIt.value());
+    int slotIndex = static_cast<int>(id & TAG_MODEL_INDEX_ID_SLOT_MASK) - 1;
+    if ((slotIndex < 0) || (slotIndex >= m_indexIdSlots.size())) {
+        QNDEBUG(QStringLiteral("Found no tag model item corresponding to model index internal id ") << id);
+        return Q_NULLPTR;
     }
 
-    const QString & localUid = localUidIt->second;
-    QNTRACE(QStringLiteral("Found tag local uid corresponding to model index internal id: ") << localUid);
-
-    auto itemIt = m_modelItemsByLocalUid.find(localUid);
-    if (itemIt != m_modelItemsByLocalUid.end()) {
-        QNTRACE(QStringLiteral("Found tag model item corresponding to local uid: ") << *itemIt);
-        return &(*itemIt);
+    const IndexIdSlot & slot = m_indexIdSlots[slotIndex];
+    if (!slot.m_pItem || ((id >> TAG_MODEL_INDEX_ID_SLOT_BITS) != slot.m_generation)) {
+        QNDEBUG(QStringLiteral("Model index internal id ") << id
+                << QStringLiteral(" refers to the tag model item which has already been removed"));
+        return Q_NULLPTR;
     }
 
-    QNTRACE(QStringLiteral("Found no tag item corresponding to local uid"));
-    return Q_NULLPTR;
+    return slot.m_pItem;
 }
 
 TagModel::IndexId TagModel::idForItem(const TagModelItem & item) const
 {
-    if (item.tagItem())
-    {
-        auto it = m_indexIdToLocalUidBimap.right.find(item.tagItem()->localUid());
-        if (it == m_indexIdToLocalUidBimap.right.end()) {
-            IndexId id = m_lastFreeIndexId++;
-            Q_UNUSED(m_indexIdToLocalUidBimap.insert(IndexIdToLocalUidBimap::value_type(id, item.tagItem()->localUid())))
-            return id;
-        }
+    if (!item.tagItem() && !item.tagLinkedNotebookItem()) {
+        return 0;
+    }
+
+    IndexId id = static_cast<IndexId>(item.indexId());
+    if (id != 0) {
+        return id;
+    }
 
-        return it->second;
+    int slotIndex = -1;
+    if (!m_freeIndexIdSlots.isEmpty())
+    {
+        slotIndex = m_freeIndexIdSlots.back();
+        m_freeIndexIdSlots.pop_back();
     }
-    else if (item.tagLinkedNotebookItem())
+    else
     {
-        auto it = m_indexIdToLinkedNotebookGuidBimap.right.find(item.tagLinkedNotebookItem()->linkedNotebookGuid());
-        if (it == m_indexIdToLinkedNotebookGuidBimap.right.end()) {
-            IndexId id = m_lastFreeIndexId++;
-            Q_UNUSED(m_indexIdToLinkedNotebookGuidBimap.insert(IndexIdToLinkedNotebookGuidBimap::value_type(id, item.tagLinkedNotebookItem()->linkedNotebookGuid())))
-            return id;
+        if (Q_UNLIKELY(static_cast<IndexId>(m_indexIdSlots.size()) >= TAG_MODEL_INDEX_ID_SLOT_MASK)) {
+            QNWARNING(QStringLiteral("Can't assign the model index internal id to tag model item: all the slots are taken: ")
+                      << item);
+            return 0;
         }
 
-        return it->second;
+        slotIndex = m_indexIdSlots.size();
+        m_indexIdSlots.push_back(IndexIdSlot());
     }
 
-    return 0;
+    IndexIdSlot & slot = m_indexIdSlots[slotIndex];
+    slot.m_pItem = &item;
+
+    id = (slot.m_generation << TAG_MODEL_INDEX_ID_SLOT_BITS) | static_cast<IndexId>(slotIndex + 1);
+    item.setIndexId(id);
+    return id;
+}
+
+void TagModel::releaseIdForItem(const TagModelItem & item)
+{
+    IndexId id = static_cast<IndexId>(item.indexId());
+    if (id == 0) {
+        return;
+    }
+
+    item.setIndexId(0);
+
+    int slotIndex = static_cast<int>(id & TAG_MODEL_INDEX_ID_SLOT_MASK) - 1;
+    if (Q_UNLIKELY((slotIndex < 0) || (slotIndex >= m_indexIdSlots.size()) ||
+                   (m_indexIdSlots[slotIndex].m_pItem != &item)))
+    {
+        QNWARNING(QStringLiteral("Internal inconsistency detected in TagModel: the model index internal id ") << id
+                  << QStringLiteral(" of the item being removed doesn't refer to that item: ") << item);
+        return;
+    }
+
+    IndexIdSlot & slot = m_indexIdSlots[slotIndex];
+    slot.m_pItem = Q_NULLPTR;
+
+    // The generation wraps around within the bits left free by the slot index
+    slot.m_generation = (slot.m_generation + 1) & (~IndexId(0) >> TAG_MODEL_INDEX_ID_SLOT_BITS);
+    m_freeIndexIdSlots.push_back(slotIndex);
 }
 
 QVariant TagModel::dataImpl(const TagModelItem & item, const Columns::type column) const
@@ -3582,26 +4004,19 @@ QString TagModel::nameForNewTag(const QString & linkedNotebookGuid) const
 {
     QString baseName = tr("New tag");
     const TagDataByNameUpper & nameIndex = m_data.get<ByNameUpper>();
-    QSet<QString> tagNames;
-    for(auto it = nameIndex.begin(), end = nameIndex.end(); it != end; ++it)
-    {
-        if (it->linkedNotebookGuid() != linkedNotebookGuid) {
-            continue;
-        }
-
-        Q_UNUSED(tagNames.insert(it->nameUpper()))
-    }
 
     int & lastNewTagNameCounter = (linkedNotebookGuid.isEmpty()
                                    ? m_lastNewTagNameCounter
                                    : m_lastNewTagNameCounterByLinkedNotebookGuid[linkedNotebookGuid]);
-    return newItemName<QSet<QString> >(tagNames, lastNewTagNameCounter, baseName);
+    return newItemName(nameIndex, lastNewTagNameCounter, baseName, LinkedNotebookGuidMatcher<TagItem>(linkedNotebookGuid));
 }
 
 void TagModel::removeItemByLocalUid(const QString & localUid)
 {
     QNDEBUG(QStringLiteral("TagModel::removeItemByLocalUid: ") << localUid);
 
+    Q_UNUSED(m_restoredLocalUidsPendingReconciliation.remove(localUid))
+
     TagDataByLocalUid & localUidIndex = m_data.get<ByLocalUid>();
     auto itemIt = localUidIndex.find(localUid);
     if (Q_UNLIKELY(itemIt == localUidIndex.end())) {
@@ -3654,11 +4069,7 @@ void TagModel::removeItemByLocalUid(const QString & localUid)
     Q_UNUSED(pParentItem->takeChild(row))
     endRemoveRows();
 
-    auto indexIt = m_indexIdToLocalUidBimap.right.find(itemIt->localUid());
-    if (indexIt != m_indexIdToLocalUidBimap.right.end()) {
-        Q_UNUSED(m_indexIdToLocalUidBimap.right.erase(indexIt))
-    }
-
+    releaseIdForItem(modelItemIt.value());
     Q_UNUSED(m_modelItemsByLocalUid.erase(modelItemIt))
     Q_UNUSED(localUidIndex.erase(itemIt))
 
@@ -3924,31 +4335,15 @@ void TagModel::buildTagLocalUidsByNoteLocalUidsHash(const NoteModel & noteModel)
 {
     QNDEBUG(QStringLiteral("TagModel::buildTagLocalUidsByNoteLocalUidsHash"));
 
-    m_tagLocalUidsByNoteLocalUid.clear();
+    m_tagLocalUidsByNoteLocalUid = noteModel.tagLocalUidsByNoteLocalUids();
+    QNTRACE(QStringLiteral("Tag local uids are known for ") << m_tagLocalUidsByNoteLocalUid.size() << QStringLiteral(" notes"));
 
-    int numNotes = noteModel.rowCount(QModelIndex());
-    for(int i = 0; i < numNotes; ++i)
-    {
-        const NoteModelItem * pNoteModelItem = noteModel.itemAtRow(i);
-        if (Q_UNLIKELY(!pNoteModelItem)) {
-            QNWARNING(QStringLiteral("Can't find note model item at row ") << i << QStringLiteral(" even though there are ")
-                      << numNotes << QStringLiteral(" rows within the model"));
-            continue;
-        }
-
-        const QStringList & tagLocalUids = pNoteModelItem->tagLocalUids();
-        if (tagLocalUids.isEmpty()) {
-            QNTRACE(QStringLiteral("Note ") << pNoteModelItem->localUid() << QStringLiteral(" has no tags"));
-            continue;
-        }
-
-        QNTRACE(QStringLiteral("Tag local uids for note local uid ") << pNoteModelItem->localUid()
-                << QStringLiteral(": ") << tagLocalUids.join(QStringLiteral(", ")));
+    m_receivedTagLocalUidsForAllNotes = true;
 
-        m_tagLocalUidsByNoteLocalUid[pNoteModelItem->localUid()] = tagLocalUids;
+    if (m_noteCountsRecountPending) {
+        QNDEBUG(QStringLiteral("Performing the recount of notes per tag deferred until the tag local uids of all notes are known"));
+        requestNoteCountsPerAllTags();
     }
-
-    m_receivedTagLocalUidsForAllNotes = true;
 }
 
 const TagModelItem & TagModel::findOrCreateLinkedNotebookModelItem(const QString & linkedNotebookGuid)
@@ -4089,18 +4484,18 @@ void TagModel::checkAndRemoveEmptyLinkedNotebookRootItem(const TagModelItem & mo
         return;
     }
 
-    QNDEBUG(QStringLiteral("Removed the last child from the linked notebook root item, will remove that item as well"));
-    removeModelItemFromParent(modelItem);
-
     QString linkedNotebookGuid = modelItem.tagLinkedNotebookItem()->linkedNotebookGuid();
-
-    auto indexIt = m_indexIdToLinkedNotebookGuidBimap.right.find(linkedNotebookGuid);
-    if (indexIt != m_indexIdToLinkedNotebookGuidBimap.right.end()) {
-        Q_UNUSED(m_indexIdToLinkedNotebookGuidBimap.right.erase(indexIt))
+    if (m_listTagsOffsetsByLinkedNotebookGuid.contains(linkedNotebookGuid)) {
+        QNDEBUG(QStringLiteral("The tags from the linked notebook are not listed yet, won't remove its root item"));
+        return;
     }
 
+    QNDEBUG(QStringLiteral("The linked notebook root item has no children, will remove it"));
+    removeModelItemFromParent(modelItem);
+
     auto modelItemIt = m_modelItemsByLinkedNotebookGuid.find(linkedNotebookGuid);
     if (modelItemIt != m_modelItemsByLinkedNotebookGuid.end()) {
+        releaseIdForItem(modelItemIt.value());
         Q_UNUSED(m_modelItemsByLinkedNotebookGuid.erase(modelItemIt))
     }
 
@@ -4110,6 +4505,115 @@ void TagModel::checkAndRemoveEmptyLinkedNotebookRootItem(const TagModelItem & mo
     }
 }
 
+QString TagModel::linkedNotebookGuidPendingTagsListing(const QModelIndex & index) const
+{
+    if (!index.isValid() || m_listTagsOffsetsByLinkedNotebookGuid.isEmpty()) {
+        return QString();
+    }
+
+    const TagModelItem * pItem = itemForIndex(index);
+    if (!pItem || (pItem->type() != TagModelItem::Type::LinkedNotebook) || !pItem->tagLinkedNotebookItem()) {
+        return QString();
+    }
+
+    const QString & linkedNotebookGuid = pItem->tagLinkedNotebookItem()->linkedNotebookGuid();
+    if (!m_listTagsOffsetsByLinkedNotebookGuid.contains(linkedNotebookGuid)) {
+        return QString();
+    }
+
+    return linkedNotebookGuid;
+}
+
+void TagModel::enqueueLinkedNotebookTagsListing(const QString & linkedNotebookGuid)
+{
+    if (m_listTagsOffsetsByLinkedNotebookGuid.contains(linkedNotebookGuid)) {
+        return;
+    }
+
+    QNTRACE(QStringLiteral("TagModel::enqueueLinkedNotebookTagsListing: ") << linkedNotebookGuid);
+
+    m_linkedNotebookGuidsPendingTagsListing << linkedNotebookGuid;
+    Q_UNUSED(m_listTagsOffsetsByLinkedNotebookGuid.insert(linkedNotebookGuid, 0))
+
+    // Create the linked notebook root item right away so that its tags can be fetched on its expansion
+    Q_UNUSED(findOrCreateLinkedNotebookModelItem(linkedNotebookGuid))
+}
+
+void TagModel::onAllTagsFromLinkedNotebookListed(const QString & linkedNotebookGuid)
+{
+    QNDEBUG(QStringLiteral("TagModel::onAllTagsFromLinkedNotebookListed: ") << linkedNotebookGuid);
+
+    Q_UNUSED(m_linkedNotebookGuidsPendingTagsListing.removeAll(linkedNotebookGuid))
+    Q_UNUSED(m_listTagsOffsetsByLinkedNotebookGuid.remove(linkedNotebookGuid))
+
+    auto modelItemIt = m_modelItemsByLinkedNotebookGuid.find(linkedNotebookGuid);
+    if (modelItemIt != m_modelItemsByLinkedNotebookGuid.end()) {
+        checkAndRemoveEmptyLinkedNotebookRootItem(modelItemIt.value());
+    }
+}
+
+void TagModel::checkAndNotifyAllTagsListed()
+{
+    if (m_allTagsListed) {
+        return;
+    }
+
+    if (!m_ownTagsListed || !m_allLinkedNotebooksListed || m_listTagsPipeline.isActive() ||
+        !m_linkedNotebookGuidsPendingTagsListing.isEmpty())
+    {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("TagModel::checkAndNotifyAllTagsListed: all tags are listed"));
+
+    removeUnreconciledRestoredItems();
+
+    m_allTagsListed = true;
+    requestNoteCountsPerAllTags();
+
+    Q_EMIT notifyAllTagsListed();
+    Q_EMIT notifyAllItemsListed();
+}
+
+void TagModel::collectTagItemsForSnapshot(const TagModelItem & modelItem, QVector<const TagItem*> & tagItems) const
+{
+    int numChildren = modelItem.numChildren();
+    for(int i = 0; i < numChildren; ++i)
+    {
+        const TagModelItem * pChildItem = modelItem.childAtRow(i);
+        if (Q_UNLIKELY(!pChildItem)) {
+            continue;
+        }
+
+        if ((pChildItem->type() == TagModelItem::Type::Tag) && pChildItem->tagItem()) {
+            tagItems << pChildItem->tagItem();
+        }
+
+        collectTagItemsForSnapshot(*pChildItem, tagItems);
+    }
+}
+
+void TagModel::removeUnreconciledRestoredItems()
+{
+    if (m_restoredLocalUidsPendingReconciliation.isEmpty()) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("Removing ") << m_restoredLocalUidsPendingReconciliation.size()
+            << QStringLiteral(" restored tag items which no longer exist in the local storage"));
+
+    QSet<QString> localUids = m_restoredLocalUidsPendingReconciliation;
+    m_restoredLocalUidsPendingReconciliation.clear();
+
+    Q_EMIT aboutToRemoveTags();
+
+    for(auto it = localUids.constBegin(), end = localUids.constEnd(); it != end; ++it) {
+        removeItemByLocalUid(*it);
+    }
+
+    Q_EMIT removedTags();
+}
+
 void TagModel::checkAndFindLinkedNotebookRestrictions(const TagItem & tagItem)
 {
     QNTRACE(QStringLiteral("TagModel::checkAndFindLinkedNotebookRestrictions: ") << tagItem);
@@ -22,6 +22,7 @@
 #include "ItemModel.h"
 #include "TagModelItem.h"
 #include "TagCache.h"
+#include "ListRequestPipeline.hpp"
 #include <quentier/types/Tag.h>
 #include <quentier/types/Notebook.h>
 #include <quentier/types/Account.h>
@@ -32,6 +33,8 @@
 #include <QSet>
 #include <QHash>
 #include <QStringList>
+#include <QBasicTimer>
+#include <QVector>
 
 // NOTE: Workaround a bug in Qt4 which may prevent building with some boost versions
 #ifndef Q_MOC_RUN
@@ -158,6 +161,28 @@ public:
      */
     bool allTagsListed() const;
 
+    /**
+     * @brief saveSnapshot - writes all the model's tag items into the snapshot file so that the next instance
+     * of the model for the same account could show them before they are listed from the local storage
+     * @param filePath - the path to the snapshot file
+     * @param errorDescription - the textual description of the error if the snapshot was not saved
+     * @return false if not all tags have been listed yet or if the snapshot could not be written
+     */
+    bool saveSnapshot(const QString & filePath, ErrorString & errorDescription) const;
+
+    /**
+     * @brief restoreFromSnapshot - fills the model with the tag items from the snapshot file written by saveSnapshot
+     *
+     * The restored items are reconciled with the tags being listed from the local storage: they are updated
+     * as the corresponding tags are listed and the ones not listed by the end of the listing are removed
+     * from the model before notifyAllTagsListed is emitted
+     *
+     * @param filePath - the path to the snapshot file
+     * @param errorDescription - the textual description of the error if the snapshot was not restored
+     * @return false if the model already has some tags or if the snapshot could not be read
+     */
+    bool restoreFromSnapshot(const QString & filePath, ErrorString & errorDescription);
+
     /**
      * @brief favoriteTag - marks the tag pointed to by the index as favorited
      *
@@ -202,6 +227,7 @@ public:
     virtual int columnCount(const QModelIndex & parent = QModelIndex()) const Q_DECL_OVERRIDE;
     virtual QModelIndex index(int row, int column, const QModelIndex & parent = QModelIndex()) const Q_DECL_OVERRIDE;
     virtual QModelIndex parent(const QModelIndex & index) const Q_DECL_OVERRIDE;
+    virtual bool hasChildren(const QModelIndex & parent = QModelIndex()) const Q_DECL_OVERRIDE;
 
     virtual bool setHeaderData(int section, Qt::Orientation orientation, const QVariant & value, int role = Qt::EditRole) Q_DECL_OVERRIDE;
     virtual bool setData(const QModelIndex & index, const QVariant & value, int role = Qt::EditRole) Q_DECL_OVERRIDE;
@@ -210,6 +236,14 @@ public:
 
     virtual void sort(int column, Qt::SortOrder order) Q_DECL_OVERRIDE;
 
+    /**
+     * The tags from linked notebooks are listed after the tags from user's own account, one linked notebook
+     * at a time; the linked notebook root items are created before their tags are listed and can be fetched
+     * more for which moves the listing of the tags from the corresponding linked notebook ahead of the others
+     */
+    virtual bool canFetchMore(const QModelIndex & parent) const Q_DECL_OVERRIDE;
+    virtual void fetchMore(const QModelIndex & parent) Q_DECL_OVERRIDE;
+
     // Drag-n-drop interfaces
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
     virtual Qt::DropActions supportedDragActions() const Q_DECL_OVERRIDE { return Qt::MoveAction; }
@@ -252,7 +286,6 @@ Q_SIGNALS:
                   QString linkedNotebookGuid, QUuid requestId);
     void expungeTag(Tag tag, QUuid requestId);
     void findNotebook(Notebook notebook, QUuid requestId);
-    void requestNoteCountPerTag(Tag tag, QUuid requestId);
     void requestNoteCountsForAllTags(QUuid requestId);
     void listAllTagsPerNote(Note note, LocalStorageManager::ListObjectsOptions flag,
                             size_t limit, size_t offset,
@@ -263,6 +296,10 @@ Q_SIGNALS:
                                 const LocalStorageManager::ListLinkedNotebooksOrder::type order,
                                 const LocalStorageManager::OrderDirection::type orderDirection, QUuid requestId);
 
+protected:
+    // Periodically reconciles the delta-maintained note counts per tag with the local storage
+    virtual void timerEvent(QTimerEvent * pEvent) Q_DECL_OVERRIDE;
+
 private Q_SLOTS:
     // Slot for NoteModel's notifyAllNotesListed signal
     void onAllNotesListed();
@@ -286,8 +323,6 @@ private Q_SLOTS:
                           QString linkedNotebookGuid, ErrorString errorDescription, QUuid requestId);
     void onExpungeTagComplete(Tag tag, QStringList expungedChildTagLocalUids, QUuid requestId);
     void onExpungeTagFailed(Tag tag, ErrorString errorDescription, QUuid requestId);
-    void onGetNoteCountPerTagComplete(int noteCount, Tag tag, QUuid requestId);
-    void onGetNoteCountPerTagFailed(ErrorString errorDescription, Tag tag, QUuid requestId);
     void onGetNoteCountsPerAllTagsComplete(QHash<QString, int> noteCountsPerTagLocalUid, QUuid requestId);
     void onGetNoteCountsPerAllTagsFailed(ErrorString errorDescription, QUuid requestId);
 
@@ -331,7 +366,6 @@ private Q_SLOTS:
 private:
     void createConnections(const NoteModel & noteModel, LocalStorageManagerAsync & localStorageManagerAsync);
     void requestTagsList();
-    void requestNoteCountForTag(const Tag & tag);
     void requestTagsPerNote(const Note & note);
     void requestNoteCountsPerAllTags();
     void requestLinkedNotebooksList();
@@ -365,11 +399,46 @@ private:
 
     void buildTagLocalUidsByNoteLocalUidsHash(const NoteModel & noteModel);
 
+    /**
+     * @brief applyNoteCountDeltas - adjusts the in-memory note counts per tag after some note has been
+     * removed from or added to the specified tags and reflects the new counts within the model items
+     *
+     * If the decrement of some tag's note count is detected to go below zero, the counts are considered
+     * to have drifted from the local storage and the full recount of notes per all tags is requested
+     */
+    void applyNoteCountDeltas(const QStringList & removedFromTagLocalUids, const QStringList & addedToTagLocalUids);
+
+    /**
+     * @brief applyNoteTagsChange - applies the note count deltas for the difference between the tags known
+     * for the note and its new tags and remembers the new tags of the note
+     */
+    void applyNoteTagsChange(const QString & noteLocalUid, const QStringList & newTagLocalUids);
+
+    /**
+     * @brief applyNoteDeletionStateChange - applies the note count deltas for the note updated without its tags
+     * if the note has been moved to or restored from the trash: deleted notes don't count towards the number
+     * of notes per tag
+     */
+    void applyNoteDeletionStateChange(const Note & note);
+    void setNoteCountForTagItem(const QString & tagLocalUid, const int noteCount);
+
     const TagModelItem & findOrCreateLinkedNotebookModelItem(const QString & linkedNotebookGuid);
     const TagModelItem & modelItemForTagItem(const TagItem & tagItem);
 
     void checkAndRemoveEmptyLinkedNotebookRootItem(const TagModelItem & modelItem);
 
+    /**
+     * @return the guid of the linked notebook corresponding to the passed in linked notebook root item index
+     * if the tags from that linked notebook are not listed yet, empty string otherwise
+     */
+    QString linkedNotebookGuidPendingTagsListing(const QModelIndex & index) const;
+    void enqueueLinkedNotebookTagsListing(const QString & linkedNotebookGuid);
+    void onAllTagsFromLinkedNotebookListed(const QString & linkedNotebookGuid);
+    void checkAndNotifyAllTagsListed();
+
+    void collectTagItemsForSnapshot(const TagModelItem & modelItem, QVector<const TagItem*> & tagItems) const;
+    void removeUnreconciledRestoredItems();
+
     void checkAndFindLinkedNotebookRestrictions(const TagItem & tagItem);
 
 private:
@@ -391,7 +460,7 @@ private:
             >,
             boost::multi_index::ordered_non_unique<
                 boost::multi_index::tag<ByNameUpper>,
-                boost::multi_index::const_mem_fun<TagItem,QString,&TagItem::nameUpper>
+                boost::multi_index::const_mem_fun<TagItem,const QString&,&TagItem::nameUpper>
             >,
             boost::multi_index::ordered_non_unique<
                 boost::multi_index::tag<ByLinkedNotebookGuid>,
@@ -411,8 +480,19 @@ private:
     typedef quintptr IndexId;
 #endif
 
-    typedef boost::bimap<IndexId, QString> IndexIdToLocalUidBimap;
-    typedef boost::bimap<IndexId, QString> IndexIdToLinkedNotebookGuidBimap;
+    /**
+     * @brief The IndexIdSlot struct is the entry of the dense table of model items referenced
+     * from QModelIndex's internal ids: the internal id encodes the index of the slot
+     * along with the slot's generation which is bumped each time the slot is released
+     * so that the ids of the removed items can't resolve to the items reusing the slot
+     */
+    struct IndexIdSlot
+    {
+        IndexIdSlot() : m_pItem(Q_NULLPTR), m_generation(0) {}
+
+        const TagModelItem *    m_pItem;
+        IndexId                 m_generation;
+    };
 
     struct LessByName
     {
@@ -427,6 +507,9 @@ private:
     };
 
     typedef QMap<QString, TagModelItem> ModelItems;
+
+    typedef ListRequestPipeline<Tag> ListTagsPipeline;
+    typedef ListRequestPipeline<LinkedNotebook> ListLinkedNotebooksPipeline;
     typedef QMap<QString, TagLinkedNotebookRootItem> LinkedNotebookItems;
 
     class RemoveRowsScopeGuard
@@ -454,6 +537,7 @@ private:
 
     const TagModelItem * itemForId(const IndexId id) const;
     IndexId idForItem(const TagModelItem & item) const;
+    void releaseIdForItem(const TagModelItem & item);
 
 private:
     Account                 m_account;
@@ -467,21 +551,42 @@ private:
 
     LinkedNotebookItems     m_linkedNotebookItems;
 
-    mutable IndexIdToLocalUidBimap              m_indexIdToLocalUidBimap;
-    mutable IndexIdToLinkedNotebookGuidBimap    m_indexIdToLinkedNotebookGuidBimap;
-    mutable IndexId                             m_lastFreeIndexId;
+    mutable QVector<IndexIdSlot>    m_indexIdSlots;
+    mutable QVector<int>            m_freeIndexIdSlots;
 
-    size_t                  m_listTagsOffset;
-    QUuid                   m_listTagsRequestId;
+    ListTagsPipeline        m_listTagsPipeline;
+    QString                 m_listTagsLinkedNotebookGuid;
+    bool                    m_ownTagsListed;
+
+    // Guids of linked notebooks which tags are not listed yet, in the order in which they would be listed,
+    // and the offsets reached by the listing of tags from each of them
+    QStringList             m_linkedNotebookGuidsPendingTagsListing;
+    QHash<QString, size_t>  m_listTagsOffsetsByLinkedNotebookGuid;
     QSet<QUuid>             m_tagItemsNotYetInLocalStorageUids;
 
+    // Local uids of the tag items restored from the snapshot which have not been listed from the local storage yet
+    QSet<QString>           m_restoredLocalUidsPendingReconciliation;
+
     QSet<QUuid>             m_addTagRequestIds;
     QSet<QUuid>             m_updateTagRequestIds;
     QSet<QUuid>             m_expungeTagRequestIds;
 
-    QSet<QUuid>             m_noteCountPerTagRequestIds;
     QUuid                   m_noteCountsPerAllTagsRequestId;
 
+    // Note counts per tag local uid, received from the local storage once and then
+    // maintained from the note add, update and expunge events
+    QHash<QString, int>     m_noteCountsByTagLocalUid;
+    bool                    m_receivedNoteCountsForAllTags;
+    quint64                 m_numNoteCountDeltasSinceReconciliation;
+    QBasicTimer             m_noteCountsReconciliationTimer;
+
+    // The recount of notes per tag needs to be (re)requested: the notes have changed while the recount
+    // was in progress or while the tag local uids of all notes were not known yet
+    bool                    m_noteCountsRecountPending;
+
+    // The last reconciliation has found the note counts to have drifted, the corrective recount follows shortly
+    bool                    m_noteCountsDriftDetected;
+
     QSet<QUuid>             m_findTagToRestoreFailedUpdateRequestIds;
     QSet<QUuid>             m_findTagToPerformUpdateRequestIds;
     QSet<QUuid>             m_findTagAfterNotelessTagsErasureRequestIds;
@@ -489,8 +594,7 @@ private:
     QSet<QUuid>             m_listTagsPerNoteRequestIds;
 
     QHash<QString,QString>  m_linkedNotebookOwnerUsernamesByLinkedNotebookGuids;
-    size_t                  m_listLinkedNotebooksOffset;
-    QUuid                   m_listLinkedNotebooksRequestId;
+    ListLinkedNotebooksPipeline     m_listLinkedNotebooksPipeline;
 
     Columns::type           m_sortedColumn;
     Qt::SortOrder           m_sortOrder;
@@ -498,6 +602,10 @@ private:
     QHash<QString, QStringList>     m_tagLocalUidsByNoteLocalUid;
     bool                            m_receivedTagLocalUidsForAllNotes;
 
+    // The note model in Windowed listing mode doesn't have all the notes to collect their tag local uids from,
+    // the note counts then come from the local storage only
+    bool                            m_expectTagLocalUidsForAllNotes;
+
     struct Restrictions
     {
         Restrictions() :
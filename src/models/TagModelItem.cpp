@@ -17,6 +17,7 @@
  */
 
 #include "TagModelItem.h"
+#include <algorithm>
 
 namespace quentier {
 
@@ -27,6 +28,8 @@ TagModelItem::TagModelItem(const Type::type type, const TagItem * pTagItem,
     m_pTagItem(pTagItem),
     m_pTagLinkedNotebookRootItem(pTagLinkedNotebookRootItem),
     m_pParent(pParent),
+    m_row(-1),
+    m_indexId(0),
     m_children()
 {
     if (m_pParent) {
@@ -58,7 +61,16 @@ const TagModelItem * TagModelItem::childAtRow(const int row) const
 
 int TagModelItem::rowForChild(const TagModelItem * child) const
 {
-    return m_children.indexOf(child);
+    if (Q_UNLIKELY(!child) || (child->m_pParent != this)) {
+        return -1;
+    }
+
+    int row = child->m_row;
+    if ((row < 0) || (row >= m_children.size()) || (m_children[row] != child)) {
+        return -1;
+    }
+
+    return row;
 }
 
 void TagModelItem::insertChild(const int row, const TagModelItem * pItem) const
@@ -69,6 +81,7 @@ void TagModelItem::insertChild(const int row, const TagModelItem * pItem) const
 
     pItem->m_pParent = this;
     m_children.insert(row, pItem);
+    updateChildRows(row);
 }
 
 void TagModelItem::addChild(const TagModelItem * pItem) const
@@ -78,6 +91,7 @@ void TagModelItem::addChild(const TagModelItem * pItem) const
     }
 
     pItem->m_pParent = this;
+    pItem->m_row = m_children.size();
     m_children.push_back(pItem);
 }
 
@@ -90,6 +104,7 @@ bool TagModelItem::swapChildren(const int sourceRow, const int destRow) const
     }
 
     m_children.swap(sourceRow, destRow);
+    updateChildRows(std::min(sourceRow, destRow));
     return true;
 }
 
@@ -100,13 +115,28 @@ const TagModelItem * TagModelItem::takeChild(const int row) const
     }
 
     const TagModelItem * pItem = m_children.takeAt(row);
-    if (pItem) {
+    if (pItem && (pItem->m_pParent == this)) {
         pItem->m_pParent = Q_NULLPTR;
+        pItem->m_row = -1;
     }
 
+    updateChildRows(row);
     return pItem;
 }
 
+void TagModelItem::updateChildRows(const int firstRow) const
+{
+    // NOTE: the copies of the item share the pointers to children with the original
+    // so only the rows of children actually belonging to this item are updated
+    for(int i = std::max(firstRow, 0), size = m_children.size(); i < size; ++i)
+    {
+        const TagModelItem * pChild = m_children[i];
+        if (pChild && (pChild->m_pParent == this)) {
+            pChild->m_row = i;
+        }
+    }
+}
+
 QTextStream & TagModelItem::print(QTextStream & strm) const
 {
     strm << QStringLiteral("Tag model item (")
@@ -56,6 +56,19 @@ public:
     const TagModelItem * parent() const { return m_pParent; }
     void setParent(const TagModelItem * parent) const;
 
+    /**
+     * @return the row of this item within its parent item or -1 if the item has no parent; the row is cached
+     * within the item and kept up to date by all the methods changing the parent's children
+     */
+    int row() const { return m_row; }
+
+    /**
+     * @return the handle under which the owning model refers to this item in QModelIndex's internal id
+     * or 0 if no such handle was assigned to the item yet; the handle is managed by the model
+     */
+    quintptr indexId() const { return m_indexId; }
+    void setIndexId(const quintptr indexId) const { m_indexId = indexId; }
+
     const TagModelItem * childAtRow(const int row) const;
     int rowForChild(const TagModelItem * child) const;
 
@@ -72,6 +85,7 @@ public:
     void sortChildren(Comparator comparator) const
     {
         qSort(m_children.begin(), m_children.end(), comparator);
+        updateChildRows(0);
     }
 
     virtual QTextStream & print(QTextStream & strm) const Q_DECL_OVERRIDE;
@@ -79,6 +93,9 @@ public:
     friend QDataStream & operator<<(QDataStream & out, const TagModelItem & item);
     friend QDataStream & operator>>(QDataStream & in, TagModelItem & item);
 
+private:
+    void updateChildRows(const int firstRow) const;
+
 private:
     Type::type                          m_type;
     const TagItem *                     m_pTagItem;
@@ -90,6 +107,8 @@ private:
     // however, these pointers to parent and children don't really affect
     // that container's indices
     mutable const TagModelItem *          m_pParent;
+    mutable int                           m_row;
+    mutable quintptr                      m_indexId;
     mutable QList<const TagModelItem*>    m_children;
 };
 
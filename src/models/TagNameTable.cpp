@@ -0,0 +1,109 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TagNameTable.h"
+
+namespace quentier {
+
+TagNameTable::TagNameTable() :
+    m_names(),
+    m_idsByTagLocalUid(),
+    m_emptyName()
+{}
+
+qint32 TagNameTable::idForTagLocalUid(const QString & tagLocalUid)
+{
+    auto it = m_idsByTagLocalUid.constFind(tagLocalUid);
+    if (it != m_idsByTagLocalUid.constEnd()) {
+        return it.value();
+    }
+
+    qint32 id = static_cast<qint32>(m_names.size());
+    m_names << QString();
+    Q_UNUSED(m_idsByTagLocalUid.insert(tagLocalUid, id))
+    return id;
+}
+
+qint32 TagNameTable::findId(const QString & tagLocalUid) const
+{
+    auto it = m_idsByTagLocalUid.constFind(tagLocalUid);
+    if (it == m_idsByTagLocalUid.constEnd()) {
+        return -1;
+    }
+
+    return it.value();
+}
+
+const QString & TagNameTable::name(const qint32 id) const
+{
+    if ((id < 0) || (id >= m_names.size())) {
+        return m_emptyName;
+    }
+
+    return m_names.at(id);
+}
+
+bool TagNameTable::setName(const qint32 id, const QString & name)
+{
+    if ((id < 0) || (id >= m_names.size())) {
+        return false;
+    }
+
+    QString & currentName = m_names[id];
+    if (currentName == name) {
+        return false;
+    }
+
+    currentName = name;
+    return true;
+}
+
+QStringList TagNameTable::names(const QVector<qint32> & ids) const
+{
+    QStringList result;
+    result.reserve(ids.size());
+
+    for(auto it = ids.constBegin(), end = ids.constEnd(); it != end; ++it)
+    {
+        const QString & tagName = name(*it);
+        if (!tagName.isEmpty()) {
+            result << tagName;
+        }
+    }
+
+    return result;
+}
+
+void TagNameTable::remove(const QString & tagLocalUid)
+{
+    auto it = m_idsByTagLocalUid.find(tagLocalUid);
+    if (it == m_idsByTagLocalUid.end()) {
+        return;
+    }
+
+    m_names[it.value()] = QString();
+    Q_UNUSED(m_idsByTagLocalUid.erase(it))
+}
+
+void TagNameTable::clear()
+{
+    m_names.clear();
+    m_idsByTagLocalUid.clear();
+}
+
+} // namespace quentier
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUENTIER_MODELS_TAG_NAME_TABLE_H
+#define QUENTIER_MODELS_TAG_NAME_TABLE_H
+
+#include <quentier/utility/Macros.h>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+
+namespace quentier {
+
+/**
+ * @brief The TagNameTable class holds the names of tags shared by many note model items: the items refer
+ * to the tags by the integer ids assigned by the table and the names are resolved through the table
+ * when they are needed, so that renaming a tag is a single write into the table regardless of the number
+ * of notes labeled with it
+ *
+ * The ids are never reused within the table's lifetime: the id of the removed tag keeps resolving
+ * to the empty name
+ */
+class TagNameTable
+{
+public:
+    TagNameTable();
+
+    /**
+     * @return the id of the tag with the given local uid, assigning the new one with the empty name
+     * if the tag has no id yet
+     */
+    qint32 idForTagLocalUid(const QString & tagLocalUid);
+
+    /**
+     * @return the id of the tag with the given local uid or -1 if the tag has no id
+     */
+    qint32 findId(const QString & tagLocalUid) const;
+
+    /**
+     * @return the name of the tag with the given id or the empty string if the id is unknown
+     * or the tag's name is not known yet
+     */
+    const QString & name(const qint32 id) const;
+
+    /**
+     * @brief setName - sets the name of the tag with the given id
+     * @return true if the name was changed, false if the tag already had this name or the id is unknown
+     */
+    bool setName(const qint32 id, const QString & name);
+
+    /**
+     * @return the non-empty names of the tags with the given ids, in the same order as the ids
+     */
+    QStringList names(const QVector<qint32> & ids) const;
+
+    /**
+     * @brief remove - forgets the tag with the given local uid: its id resolves to the empty name
+     * from now on and the tag gets the new id if it is looked up again
+     */
+    void remove(const QString & tagLocalUid);
+
+    void clear();
+
+    int size() const { return m_names.size(); }
+
+private:
+    QVector<QString>        m_names;
+    QHash<QString, qint32>  m_idsByTagLocalUid;
+    QString                 m_emptyName;
+};
+
+} // namespace quentier
+
+#endif // QUENTIER_MODELS_TAG_NAME_TABLE_H
@@ -0,0 +1,478 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ModelSnapshotTestHelper.h"
+#include "../../models/NoteModel.h"
+#include "../../models/NotebookModel.h"
+#include "../../models/TagModel.h"
+#include "../../models/SavedSearchModel.h"
+#include "../../models/FavoritesModel.h"
+#include "../../models/ModelSnapshot.h"
+#include "TestMacros.h"
+#include <quentier/logging/QuentierLogger.h>
+#include <quentier/utility/SysInfo.h>
+#include <quentier/utility/UidGenerator.h>
+#include <quentier/exception/IQuentierException.h>
+#include <QThread>
+#include <QFile>
+#include <QDateTime>
+
+// The number of models which snapshots are restored within the test
+#define NUM_SNAPSHOT_TEST_MODELS (5)
+
+namespace quentier {
+
+static void collectModelRows(const QAbstractItemModel & model, const QModelIndex & parent, const QString & parentPath,
+                             const QVector<int> & columns, QStringList & rows)
+{
+    for(int row = 0, numRows = model.rowCount(parent); row < numRows; ++row)
+    {
+        QString rowData = parentPath;
+        for(auto it = columns.constBegin(), end = columns.constEnd(); it != end; ++it) {
+            rowData += QStringLiteral(" | ") + model.data(model.index(row, *it, parent), Qt::DisplayRole).toString();
+        }
+
+        rows << rowData;
+
+        // The path of the child rows includes the parent row's first column so that the rows compare equal
+        // only within the same hierarchy
+        QModelIndex index = model.index(row, 0, parent);
+        if (model.hasChildren(index)) {
+            collectModelRows(model, index, parentPath + QStringLiteral("/") + model.data(index, Qt::DisplayRole).toString(),
+                             columns, rows);
+        }
+    }
+}
+
+static QStringList modelRows(const QAbstractItemModel & model, const QVector<int> & columns)
+{
+    QStringList rows;
+    collectModelRows(model, QModelIndex(), QString(), columns, rows);
+    return rows;
+}
+
+static QStringList modelRows(const QAbstractItemModel & model)
+{
+    QVector<int> columns;
+    for(int column = 0, numColumns = model.columnCount(QModelIndex()); column < numColumns; ++column) {
+        columns << column;
+    }
+
+    return modelRows(model, columns);
+}
+
+static bool writeBrokenSnapshotCopy(const QString & filePath, const QString & copyFilePath,
+                                    const bool anotherItemsVersion, QString & error)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = QStringLiteral("Can't open the snapshot file: ") + file.errorString();
+        return false;
+    }
+
+    QByteArray data = file.readAll();
+    file.close();
+
+    // The items version is the third big endian 32 bit number within the snapshot's header
+    if (data.size() < 12) {
+        error = QStringLiteral("The snapshot file is too small: ") + QString::number(data.size());
+        return false;
+    }
+
+    if (anotherItemsVersion) {
+        data[11] = static_cast<char>(data[11] + 1);
+    }
+    else {
+        data.chop(1);
+    }
+
+    QFile copyFile(copyFilePath);
+    if (!copyFile.open(QIODevice::WriteOnly | QIODevice::Truncate) || (copyFile.write(data) != data.size())) {
+        error = QStringLiteral("Can't write the broken copy of the snapshot file: ") + copyFile.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+ModelSnapshotTestHelper::ModelSnapshotTestHelper(LocalStorageManagerAsync * pLocalStorageManagerAsync,
+                                                 QThread * pLocalStorageManagerThread,
+                                                 QObject * parent) :
+    QObject(parent),
+    m_pLocalStorageManagerAsync(pLocalStorageManagerAsync),
+    m_pLocalStorageManagerThread(pLocalStorageManagerThread),
+    m_account(QStringLiteral("Default user"), Account::Type::Local),
+    m_noteCache(10),
+    m_notebookCache(5),
+    m_tagCache(5),
+    m_savedSearchCache(5),
+    m_pNoteModel(Q_NULLPTR),
+    m_pNotebookModel(Q_NULLPTR),
+    m_pTagModel(Q_NULLPTR),
+    m_pSavedSearchModel(Q_NULLPTR),
+    m_pFavoritesModel(Q_NULLPTR),
+    m_expungedNoteLocalUid(),
+    m_expungedNotebookLocalUid(),
+    m_expungedTagLocalUid(),
+    m_expungedSavedSearchLocalUid(),
+    m_savedRowsByModelName(),
+    m_listedRowsByModelName(),
+    m_numListedModels(0)
+{}
+
+ModelSnapshotTestHelper::~ModelSnapshotTestHelper()
+{
+    // The models counting notes refer to the note model
+    delete m_pFavoritesModel;
+    delete m_pSavedSearchModel;
+    delete m_pTagModel;
+    delete m_pNotebookModel;
+    delete m_pNoteModel;
+}
+
+template <class T>
+bool ModelSnapshotTestHelper::checkRestoration(T & model, const QString & modelName, QString & error)
+{
+    const QString filePath = snapshotFilePath(modelName);
+    ErrorString errorDescription;
+
+    const QString anotherVersionFilePath = filePath + QStringLiteral(".anotherVersion");
+    if (!writeBrokenSnapshotCopy(filePath, anotherVersionFilePath, /* another items version = */ true, error)) {
+        return false;
+    }
+
+    if (model.restoreFromSnapshot(anotherVersionFilePath, errorDescription) || (model.rowCount(QModelIndex()) != 0)) {
+        error = QStringLiteral("The model restored the snapshot of another items version: ") + modelName;
+        return false;
+    }
+
+    const QString truncatedFilePath = filePath + QStringLiteral(".truncated");
+    if (!writeBrokenSnapshotCopy(filePath, truncatedFilePath, /* another items version = */ false, error)) {
+        return false;
+    }
+
+    if (model.restoreFromSnapshot(truncatedFilePath, errorDescription) || (model.rowCount(QModelIndex()) != 0)) {
+        error = QStringLiteral("The model restored the truncated snapshot: ") + modelName;
+        return false;
+    }
+
+    Q_UNUSED(QFile::remove(anotherVersionFilePath))
+    Q_UNUSED(QFile::remove(truncatedFilePath))
+
+    if (!model.restoreFromSnapshot(filePath, errorDescription)) {
+        error = QStringLiteral("The model failed to restore the snapshot: ") + modelName + QStringLiteral(": ") +
+                errorDescription.nonLocalizedString();
+        return false;
+    }
+
+    QStringList rows = modelRows(model);
+    const QStringList & savedRows = m_savedRowsByModelName[modelName];
+    if (rows != savedRows) {
+        error = QStringLiteral("The rows of the model restored from the snapshot differ from the saved ones: ") +
+                modelName + QStringLiteral(": restored: ") + rows.join(QStringLiteral("; ")) +
+                QStringLiteral("; saved: ") + savedRows.join(QStringLiteral("; "));
+        return false;
+    }
+
+    return true;
+}
+
+template <class T>
+void ModelSnapshotTestHelper::checkListing(const T & model, const QString & modelName, const QVector<int> & columns,
+                                           const QStringList & expungedItemLocalUids)
+{
+    for(auto it = expungedItemLocalUids.constBegin(), end = expungedItemLocalUids.constEnd(); it != end; ++it)
+    {
+        if (model.indexForLocalUid(*it).isValid()) {
+            FAIL(QStringLiteral("The restored item missing from the local storage is still within the model by the end ")
+                 << QStringLiteral("of the listing: ") << modelName << QStringLiteral(", local uid = ") << *it);
+        }
+    }
+
+    QStringList rows = modelRows(model, columns);
+    const QStringList & listedRows = m_listedRowsByModelName[modelName];
+    if (rows != listedRows) {
+        FAIL(QStringLiteral("The rows of the model which has listed the items differ from the expected ones: ")
+             << modelName << QStringLiteral(": listed: ") << rows.join(QStringLiteral("; "))
+             << QStringLiteral("; expected: ") << listedRows.join(QStringLiteral("; ")));
+    }
+
+    ++m_numListedModels;
+    if (m_numListedModels == NUM_SNAPSHOT_TEST_MODELS) {
+        Q_EMIT success();
+    }
+}
+
+void ModelSnapshotTestHelper::launchTest()
+{
+    QNDEBUG(QStringLiteral("ModelSnapshotTestHelper::launchTest"));
+
+    ErrorString errorDescription;
+
+    try
+    {
+        Notebook firstNotebook;
+        firstNotebook.setName(QStringLiteral("First notebook"));
+        firstNotebook.setLocal(true);
+        firstNotebook.setDirty(false);
+        firstNotebook.setFavorited(true);
+
+        Notebook secondNotebook;
+        secondNotebook.setGuid(UidGenerator::Generate());
+        secondNotebook.setName(QStringLiteral("Second notebook"));
+        secondNotebook.setStack(QStringLiteral("Stack"));
+        secondNotebook.setLocal(false);
+        secondNotebook.setDirty(true);
+
+        Notebook thirdNotebook;
+        thirdNotebook.setName(QStringLiteral("Third notebook"));
+        thirdNotebook.setLocal(true);
+        thirdNotebook.setDirty(false);
+        thirdNotebook.setFavorited(true);
+
+        m_pLocalStorageManagerAsync->onAddNotebookRequest(firstNotebook, QUuid());
+        m_pLocalStorageManagerAsync->onAddNotebookRequest(secondNotebook, QUuid());
+        m_pLocalStorageManagerAsync->onAddNotebookRequest(thirdNotebook, QUuid());
+
+        Tag firstTag;
+        firstTag.setGuid(UidGenerator::Generate());
+        firstTag.setName(QStringLiteral("First tag"));
+        firstTag.setLocal(false);
+        firstTag.setDirty(false);
+
+        Tag secondTag;
+        secondTag.setGuid(UidGenerator::Generate());
+        secondTag.setName(QStringLiteral("Second tag"));
+        secondTag.setLocal(false);
+        secondTag.setDirty(true);
+        secondTag.setParentGuid(firstTag.guid());
+        secondTag.setParentLocalUid(firstTag.localUid());
+
+        Tag thirdTag;
+        thirdTag.setGuid(UidGenerator::Generate());
+        thirdTag.setName(QStringLiteral("Third tag"));
+        thirdTag.setLocal(false);
+        thirdTag.setDirty(true);
+        thirdTag.setParentGuid(firstTag.guid());
+        thirdTag.setParentLocalUid(firstTag.localUid());
+        thirdTag.setFavorited(true);
+
+        m_pLocalStorageManagerAsync->onAddTagRequest(firstTag, QUuid());
+        m_pLocalStorageManagerAsync->onAddTagRequest(secondTag, QUuid());
+        m_pLocalStorageManagerAsync->onAddTagRequest(thirdTag, QUuid());
+
+        SavedSearch firstSavedSearch;
+        firstSavedSearch.setName(QStringLiteral("First search"));
+        firstSavedSearch.setQuery(QStringLiteral("First search query"));
+        firstSavedSearch.setLocal(true);
+        firstSavedSearch.setDirty(false);
+
+        SavedSearch secondSavedSearch;
+        secondSavedSearch.setName(QStringLiteral("Second search"));
+        secondSavedSearch.setQuery(QStringLiteral("Second search query"));
+        secondSavedSearch.setLocal(true);
+        secondSavedSearch.setDirty(true);
+        secondSavedSearch.setFavorited(true);
+
+        m_pLocalStorageManagerAsync->onAddSavedSearchRequest(firstSavedSearch, QUuid());
+        m_pLocalStorageManagerAsync->onAddSavedSearchRequest(secondSavedSearch, QUuid());
+
+        const qint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+
+        Note firstNote;
+        firstNote.setTitle(QStringLiteral("First note"));
+        firstNote.setContent(QStringLiteral("<en-note><h1>First note</h1></en-note>"));
+        firstNote.setCreationTimestamp(timestamp);
+        firstNote.setModificationTimestamp(timestamp);
+        firstNote.setNotebookLocalUid(firstNotebook.localUid());
+        firstNote.setTagLocalUids(QStringList() << firstTag.localUid());
+        firstNote.setTagGuids(QStringList() << firstTag.guid());
+        firstNote.setLocal(true);
+        firstNote.setDirty(false);
+        firstNote.setFavorited(true);
+
+        Note secondNote;
+        secondNote.setGuid(UidGenerator::Generate());
+        secondNote.setTitle(QStringLiteral("Second note"));
+        secondNote.setContent(QStringLiteral("<en-note><h1>Second note</h1></en-note>"));
+        secondNote.setCreationTimestamp(timestamp + 1);
+        secondNote.setModificationTimestamp(timestamp + 1);
+        secondNote.setNotebookLocalUid(secondNotebook.localUid());
+        secondNote.setNotebookGuid(secondNotebook.guid());
+        secondNote.setTagLocalUids(QStringList() << secondTag.localUid());
+        secondNote.setTagGuids(QStringList() << secondTag.guid());
+        secondNote.setLocal(false);
+        secondNote.setDirty(true);
+
+        Note thirdNote;
+        thirdNote.setTitle(QStringLiteral("Third note"));
+        thirdNote.setContent(QStringLiteral("<en-note><h1>Third note</h1></en-note>"));
+        thirdNote.setCreationTimestamp(timestamp + 2);
+        thirdNote.setModificationTimestamp(timestamp + 2);
+        thirdNote.setNotebookLocalUid(firstNotebook.localUid());
+        thirdNote.setTagLocalUids(QStringList() << thirdTag.localUid());
+        thirdNote.setTagGuids(QStringList() << thirdTag.guid());
+        thirdNote.setLocal(true);
+        thirdNote.setDirty(true);
+        thirdNote.setFavorited(true);
+
+        m_pLocalStorageManagerAsync->onAddNoteRequest(firstNote, QUuid());
+        m_pLocalStorageManagerAsync->onAddNoteRequest(secondNote, QUuid());
+        m_pLocalStorageManagerAsync->onAddNoteRequest(thirdNote, QUuid());
+
+        m_expungedNoteLocalUid = thirdNote.localUid();
+        m_expungedNotebookLocalUid = thirdNotebook.localUid();
+        m_expungedTagLocalUid = thirdTag.localUid();
+        m_expungedSavedSearchLocalUid = secondSavedSearch.localUid();
+
+        // The local storage manager still works in this thread, so the models list all items right away
+        {
+            NoteCache noteCache(10);
+            NotebookCache notebookCache(5);
+            TagCache tagCache(5);
+            SavedSearchCache savedSearchCache(5);
+
+            NoteModel noteModel(m_account, *m_pLocalStorageManagerAsync, noteCache, notebookCache);
+            NotebookModel notebookModel(m_account, noteModel, *m_pLocalStorageManagerAsync, notebookCache);
+            TagModel tagModel(m_account, noteModel, *m_pLocalStorageManagerAsync, tagCache);
+            SavedSearchModel savedSearchModel(m_account, *m_pLocalStorageManagerAsync, savedSearchCache);
+            FavoritesModel favoritesModel(m_account, noteModel, *m_pLocalStorageManagerAsync, noteCache,
+                                          notebookCache, tagCache, savedSearchCache);
+
+            if (!noteModel.saveSnapshot(snapshotFilePath(QStringLiteral("notes")), errorDescription) ||
+                !notebookModel.saveSnapshot(snapshotFilePath(QStringLiteral("notebooks")), errorDescription) ||
+                !tagModel.saveSnapshot(snapshotFilePath(QStringLiteral("tags")), errorDescription) ||
+                !savedSearchModel.saveSnapshot(snapshotFilePath(QStringLiteral("savedSearches")), errorDescription) ||
+                !favoritesModel.saveSnapshot(snapshotFilePath(QStringLiteral("favorites")), errorDescription))
+            {
+                FAIL(QStringLiteral("Failed to save the model snapshot: ") << errorDescription.nonLocalizedString());
+            }
+
+            m_savedRowsByModelName[QStringLiteral("notes")] = modelRows(noteModel);
+            m_savedRowsByModelName[QStringLiteral("notebooks")] = modelRows(notebookModel);
+            m_savedRowsByModelName[QStringLiteral("tags")] = modelRows(tagModel);
+            m_savedRowsByModelName[QStringLiteral("savedSearches")] = modelRows(savedSearchModel);
+            m_savedRowsByModelName[QStringLiteral("favorites")] = modelRows(favoritesModel);
+
+            // The items expunged after saving the snapshots are restored from them but not listed then
+            m_pLocalStorageManagerAsync->onExpungeNoteRequest(thirdNote, QUuid());
+            m_pLocalStorageManagerAsync->onExpungeNotebookRequest(thirdNotebook, QUuid());
+            m_pLocalStorageManagerAsync->onExpungeTagRequest(thirdTag, QUuid());
+            m_pLocalStorageManagerAsync->onExpungeSavedSearchRequest(secondSavedSearch, QUuid());
+
+            m_listedRowsByModelName[QStringLiteral("notes")] =
+                modelRows(noteModel, QVector<int>() << NoteModel::Columns::Title);
+            m_listedRowsByModelName[QStringLiteral("notebooks")] =
+                modelRows(notebookModel, QVector<int>() << NotebookModel::Columns::Name);
+            m_listedRowsByModelName[QStringLiteral("tags")] =
+                modelRows(tagModel, QVector<int>() << TagModel::Columns::Name);
+            m_listedRowsByModelName[QStringLiteral("savedSearches")] =
+                modelRows(savedSearchModel, QVector<int>() << SavedSearchModel::Columns::Name);
+            m_listedRowsByModelName[QStringLiteral("favorites")] =
+                modelRows(favoritesModel, QVector<int>() << FavoritesModel::Columns::Type
+                                                         << FavoritesModel::Columns::DisplayName);
+        }
+
+        m_pLocalStorageManagerAsync->moveToThread(m_pLocalStorageManagerThread);
+
+        m_pNoteModel = new NoteModel(m_account, *m_pLocalStorageManagerAsync, m_noteCache, m_notebookCache);
+        m_pNotebookModel = new NotebookModel(m_account, *m_pNoteModel, *m_pLocalStorageManagerAsync, m_notebookCache);
+        m_pTagModel = new TagModel(m_account, *m_pNoteModel, *m_pLocalStorageManagerAsync, m_tagCache);
+        m_pSavedSearchModel = new SavedSearchModel(m_account, *m_pLocalStorageManagerAsync, m_savedSearchCache);
+        m_pFavoritesModel = new FavoritesModel(m_account, *m_pNoteModel, *m_pLocalStorageManagerAsync, m_noteCache,
+                                               m_notebookCache, m_tagCache, m_savedSearchCache);
+
+        QObject::connect(m_pNoteModel, QNSIGNAL(NoteModel,notifyAllNotesListed),
+                         this, QNSLOT(ModelSnapshotTestHelper,onAllNotesListed));
+        QObject::connect(m_pNotebookModel, QNSIGNAL(NotebookModel,notifyAllNotebooksListed),
+                         this, QNSLOT(ModelSnapshotTestHelper,onAllNotebooksListed));
+        QObject::connect(m_pTagModel, QNSIGNAL(TagModel,notifyAllTagsListed),
+                         this, QNSLOT(ModelSnapshotTestHelper,onAllTagsListed));
+        QObject::connect(m_pSavedSearchModel, QNSIGNAL(SavedSearchModel,notifyAllSavedSearchesListed),
+                         this, QNSLOT(ModelSnapshotTestHelper,onAllSavedSearchesListed));
+        QObject::connect(m_pFavoritesModel, QNSIGNAL(FavoritesModel,notifyAllItemsListed),
+                         this, QNSLOT(ModelSnapshotTestHelper,onAllFavoritesListed));
+
+        // The listing requests of the new models are queued to the local storage manager's thread and their results
+        // are not processed until the control returns to the event loop, so the snapshots are restored before that
+        QString error;
+        if (!checkRestoration(*m_pNoteModel, QStringLiteral("notes"), error) ||
+            !checkRestoration(*m_pNotebookModel, QStringLiteral("notebooks"), error) ||
+            !checkRestoration(*m_pTagModel, QStringLiteral("tags"), error) ||
+            !checkRestoration(*m_pSavedSearchModel, QStringLiteral("savedSearches"), error) ||
+            !checkRestoration(*m_pFavoritesModel, QStringLiteral("favorites"), error))
+        {
+            FAIL(error);
+        }
+
+        // Will continue in the slots connected to the models' signals notifying about the end of the listing
+        return;
+    }
+    CATCH_EXCEPTION()
+
+    Q_EMIT failure(errorDescription);
+}
+
+void ModelSnapshotTestHelper::onAllNotesListed()
+{
+    QNDEBUG(QStringLiteral("ModelSnapshotTestHelper::onAllNotesListed"));
+
+    checkListing(*m_pNoteModel, QStringLiteral("notes"), QVector<int>() << NoteModel::Columns::Title,
+                 QStringList() << m_expungedNoteLocalUid);
+}
+
+void ModelSnapshotTestHelper::onAllNotebooksListed()
+{
+    QNDEBUG(QStringLiteral("ModelSnapshotTestHelper::onAllNotebooksListed"));
+
+    checkListing(*m_pNotebookModel, QStringLiteral("notebooks"), QVector<int>() << NotebookModel::Columns::Name,
+                 QStringList() << m_expungedNotebookLocalUid);
+}
+
+void ModelSnapshotTestHelper::onAllTagsListed()
+{
+    QNDEBUG(QStringLiteral("ModelSnapshotTestHelper::onAllTagsListed"));
+
+    checkListing(*m_pTagModel, QStringLiteral("tags"), QVector<int>() << TagModel::Columns::Name,
+                 QStringList() << m_expungedTagLocalUid);
+}
+
+void ModelSnapshotTestHelper::onAllSavedSearchesListed()
+{
+    QNDEBUG(QStringLiteral("ModelSnapshotTestHelper::onAllSavedSearchesListed"));
+
+    checkListing(*m_pSavedSearchModel, QStringLiteral("savedSearches"), QVector<int>() << SavedSearchModel::Columns::Name,
+                 QStringList() << m_expungedSavedSearchLocalUid);
+}
+
+void ModelSnapshotTestHelper::onAllFavoritesListed()
+{
+    QNDEBUG(QStringLiteral("ModelSnapshotTestHelper::onAllFavoritesListed"));
+
+    checkListing(*m_pFavoritesModel, QStringLiteral("favorites"),
+                 QVector<int>() << FavoritesModel::Columns::Type << FavoritesModel::Columns::DisplayName,
+                 QStringList() << m_expungedNoteLocalUid << m_expungedNotebookLocalUid << m_expungedTagLocalUid
+                               << m_expungedSavedSearchLocalUid);
+}
+
+QString ModelSnapshotTestHelper::snapshotFilePath(const QString & modelName) const
+{
+    return modelSnapshotFilePath(m_account, QStringLiteral("ModelSnapshotTestHelper_") + modelName);
+}
+
+} // namespace quentier
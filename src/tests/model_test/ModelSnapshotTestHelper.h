@@ -0,0 +1,125 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of Quentier.
+ *
+ * Quentier is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * Quentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Quentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUENTIER_TESTS_MODEL_TEST_MODEL_SNAPSHOT_TEST_HELPER_H
+#define QUENTIER_TESTS_MODEL_TEST_MODEL_SNAPSHOT_TEST_HELPER_H
+
+#include "../../models/NoteCache.h"
+#include "../../models/NotebookCache.h"
+#include "../../models/TagCache.h"
+#include "../../models/SavedSearchCache.h"
+#include <quentier/local_storage/LocalStorageManagerAsync.h>
+#include <quentier/types/Account.h>
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+
+QT_FORWARD_DECLARE_CLASS(QThread)
+
+namespace quentier {
+
+QT_FORWARD_DECLARE_CLASS(NoteModel)
+QT_FORWARD_DECLARE_CLASS(NotebookModel)
+QT_FORWARD_DECLARE_CLASS(TagModel)
+QT_FORWARD_DECLARE_CLASS(SavedSearchModel)
+QT_FORWARD_DECLARE_CLASS(FavoritesModel)
+
+/**
+ * @brief The ModelSnapshotTestHelper class saves the snapshots of the note, notebook, tag, saved search
+ * and favorites models, restores them into the new instances of the models while these list their items
+ * from the local storage and checks that the restored items which the listing doesn't confirm are removed
+ * by the end of the listing
+ *
+ * The new models need to list the items asynchronously to be able to restore the snapshots before
+ * the listing ends, hence the helper moves the local storage manager to the passed in thread once
+ * the snapshots are saved
+ */
+class ModelSnapshotTestHelper: public QObject
+{
+    Q_OBJECT
+public:
+    explicit ModelSnapshotTestHelper(LocalStorageManagerAsync * pLocalStorageManagerAsync,
+                                     QThread * pLocalStorageManagerThread,
+                                     QObject * parent = Q_NULLPTR);
+    virtual ~ModelSnapshotTestHelper();
+
+Q_SIGNALS:
+    void failure(ErrorString errorDescription);
+    void success();
+
+public Q_SLOTS:
+    void launchTest();
+
+private Q_SLOTS:
+    void onAllNotesListed();
+    void onAllNotebooksListed();
+    void onAllTagsListed();
+    void onAllSavedSearchesListed();
+    void onAllFavoritesListed();
+
+private:
+    /**
+     * @brief checkRestoration - checks that the model rejects the snapshot of another items version
+     * and the truncated snapshot, then restores the model from the snapshot and compares its rows
+     * with the rows of the model which saved the snapshot
+     */
+    template <class T>
+    bool checkRestoration(T & model, const QString & modelName, QString & error);
+
+    /**
+     * @brief checkListing - checks that the model which has just listed all its items doesn't have the expunged ones
+     * and compares its rows with the rows of the model which saved the snapshot after these items were expunged
+     */
+    template <class T>
+    void checkListing(const T & model, const QString & modelName, const QVector<int> & columns,
+                      const QStringList & expungedItemLocalUids);
+
+    QString snapshotFilePath(const QString & modelName) const;
+
+private:
+    LocalStorageManagerAsync *      m_pLocalStorageManagerAsync;
+    QThread *                       m_pLocalStorageManagerThread;
+    Account                         m_account;
+
+    NoteCache                       m_noteCache;
+    NotebookCache                   m_notebookCache;
+    TagCache                        m_tagCache;
+    SavedSearchCache                m_savedSearchCache;
+
+    NoteModel *                     m_pNoteModel;
+    NotebookModel *                 m_pNotebookModel;
+    TagModel *                      m_pTagModel;
+    SavedSearchModel *              m_pSavedSearchModel;
+    FavoritesModel *                m_pFavoritesModel;
+
+    QString                         m_expungedNoteLocalUid;
+    QString                         m_expungedNotebookLocalUid;
+    QString                         m_expungedTagLocalUid;
+    QString                         m_expungedSavedSearchLocalUid;
+
+    // The rows of the models which saved the snapshots: all columns as of saving the snapshots
+    // and the identifying columns after the expunging of some items
+    QHash<QString, QStringList>     m_savedRowsByModelName;
+    QHash<QString, QStringList>     m_listedRowsByModelName;
+
+    int                             m_numListedModels;
+};
+
+} // namespace quentier
+
+#endif // QUENTIER_TESTS_MODEL_TEST_MODEL_SNAPSHOT_TEST_HELPER_H
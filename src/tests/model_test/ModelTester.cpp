@@ -1,11 +1,24 @@
 #include "ModelTester.h"
 #include "../../models/SavedSearchModel.h"
 #include "../../models/TagModel.h"
+#include "../../models/NoteModel.h"
+#include "../../models/NoteModelItem.h"
+#include "../../models/NoteFilterModel.h"
+#include "../../models/StringPool.h"
+#include "../../models/TagNameTable.h"
+#include "../../models/LogLineParser.h"
+#include "../../models/LogViewerFilterIndex.h"
+#include "../../models/Collator.h"
+#include "../../models/TagItem.h"
+#include "../../models/AdaptivePageSize.h"
+#include "../../models/ListRequestPipeline.hpp"
+#include "../../models/ParallelSort.h"
 #include "SavedSearchModelTestHelper.h"
 #include "TagModelTestHelper.h"
 #include "NotebookModelTestHelper.h"
 #include "NoteModelTestHelper.h"
 #include "FavoritesModelTestHelper.h"
+#include "ModelSnapshotTestHelper.h"
 #include <quentier/exception/IQuentierException.h>
 #include <quentier/utility/SysInfo.h>
 #include <quentier/utility/EventLoopWithExitStatus.h>
@@ -19,11 +32,41 @@
 #include <QStringListModel>
 #include <QSortFilterProxyModel>
 #include <QApplication>
+#include <QThread>
 #include <QByteArray>
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/mem_fun.hpp>
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 // 10 minutes, the timeout for async stuff to complete
 #define MAX_ALLOWED_MILLISECONDS 600000
 
+// The number of notes within the windowed note model test, more than the model lists on startup
+// and on the first fetchMore
+#define WINDOWED_TEST_NUM_NOTES (500)
+
+// Parameters of the synthetic account used for benchmarking the memory usage of note model items
+#define BENCHMARK_NUM_NOTES (100000)
+#define BENCHMARK_NUM_NOTEBOOKS (50)
+#define BENCHMARK_NUM_TAGS (1000)
+#define BENCHMARK_MAX_TAGS_PER_NOTE (5)
+#define BENCHMARK_PREVIEW_TEXT_SIZE (200)
+
+// The number of note model items filtered within the note filter model benchmark
+#define BENCHMARK_NUM_FILTERED_NOTES (20000)
+
+// The number of tag items put into the name index within the tag name index benchmark
+#define BENCHMARK_NUM_NAME_INDEX_TAGS (50000)
+
+// The number of lines in the synthetic log parsed within the log line parsing benchmark
+#define BENCHMARK_NUM_LOG_LINES (1000000)
+
+// The approximate size of the header of Qt's implicitly shared container data
+#define QT_CONTAINER_HEADER_SIZE (3 * sizeof(void*))
+
 #define qnPrintable(string) QString::fromUtf8(string).toLocal8Bit().constData()
 
 ModelTester::ModelTester(QObject * parent) :
@@ -172,6 +215,52 @@ void ModelTester::testNotebookModel()
     }
 }
 
+void ModelTester::testNotebookModelNoteCounts()
+{
+    using namespace quentier;
+
+    QString error;
+    int res = -1;
+    {
+        QTimer timer;
+        timer.setInterval(MAX_ALLOWED_MILLISECONDS);
+        timer.setSingleShot(true);
+
+        delete m_pLocalStorageManagerAsync;
+        Account account(QStringLiteral("ModelTester_notebook_model_note_counts_test_fake_user"), Account::Type::Evernote, 501);
+        m_pLocalStorageManagerAsync = new quentier::LocalStorageManagerAsync(account, /* start from scratch = */ true,
+                                                                             /* override lock = */ false, this);
+        m_pLocalStorageManagerAsync->init();
+
+        NotebookModelTestHelper notebookModelTestHelper(m_pLocalStorageManagerAsync);
+
+        EventLoopWithExitStatus loop;
+        loop.connect(&timer, SIGNAL(timeout()), SLOT(exitAsTimeout()));
+        loop.connect(&notebookModelTestHelper, SIGNAL(success()), SLOT(exitAsSuccess()));
+        loop.connect(&notebookModelTestHelper, SIGNAL(failure(ErrorString)), SLOT(exitAsFailureWithErrorString(ErrorString)));
+
+        QTimer slotInvokingTimer;
+        slotInvokingTimer.setInterval(500);
+        slotInvokingTimer.setSingleShot(true);
+
+        timer.start();
+        slotInvokingTimer.singleShot(0, &notebookModelTestHelper, SLOT(testNoteCounts()));
+        res = loop.exec();
+        error = loop.errorDescription().nonLocalizedString();
+    }
+
+    if (res == -1) {
+        QFAIL("Internal error: incorrect return status from notebook model note counts async tester");
+    }
+    else if (res == EventLoopWithExitStatus::ExitStatus::Failure) {
+        error.prepend(QStringLiteral("Detected failure during the asynchronous loop processing in notebook model note counts async tester: "));
+        QFAIL(qPrintable(error));
+    }
+    else if (res == EventLoopWithExitStatus::ExitStatus::Timeout) {
+        QFAIL("Notebook model note counts async tester failed to finish in time");
+    }
+}
+
 void ModelTester::testNoteModel()
 {
     using namespace quentier;
@@ -218,6 +307,303 @@ void ModelTester::testNoteModel()
     }
 }
 
+static bool checkWindowedNoteModelRows(const quentier::NoteModel & model, const QStringList & expectedLocalUids,
+                                       QString & error)
+{
+    for(int row = 0, numRows = model.rowCount(QModelIndex()); row < numRows; ++row)
+    {
+        const quentier::NoteModelItem * pItem = model.itemAtRow(row);
+        if (Q_UNLIKELY(!pItem)) {
+            error = QStringLiteral("No note model item at row ") + QString::number(row);
+            return false;
+        }
+
+        if ((row >= expectedLocalUids.size()) || (pItem->localUid() != expectedLocalUids[row])) {
+            error = QStringLiteral("Unexpected note at row ") + QString::number(row) + QStringLiteral(": ")
+                    + pItem->title();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void ModelTester::testNoteModelWindowedListing()
+{
+    using namespace quentier;
+
+    delete m_pLocalStorageManagerAsync;
+    Account account(QStringLiteral("ModelTester_windowed_note_model_test_fake_user"), Account::Type::Evernote, 701);
+    m_pLocalStorageManagerAsync = new quentier::LocalStorageManagerAsync(account, /* start from scratch = */ true,
+                                                                         /* override lock = */ false, this);
+    m_pLocalStorageManagerAsync->init();
+
+    Notebook notebook;
+    notebook.setName(QStringLiteral("Notebook"));
+    notebook.setLocal(true);
+    notebook.setDirty(false);
+    m_pLocalStorageManagerAsync->onAddNotebookRequest(notebook, QUuid());
+
+    // The titles of the notes go in the order opposite to the modification timestamps and to the sizes
+    // so that the storage order and the orders built by the sort key index differ
+    QStringList localUidsByTitle;
+    localUidsByTitle.reserve(WINDOWED_TEST_NUM_NOTES);
+
+    const qint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+    for(int i = 0; i < WINDOWED_TEST_NUM_NOTES; ++i)
+    {
+        Note note;
+        note.setTitle(QStringLiteral("Windowed note ") + QString::number(i).rightJustified(3, QChar::fromLatin1('0')));
+        note.setContent(QStringLiteral("<en-note><div>") + QString(WINDOWED_TEST_NUM_NOTES - i, QChar::fromLatin1('x'))
+                        + QStringLiteral("</div></en-note>"));
+        note.setCreationTimestamp(timestamp - i);
+        note.setModificationTimestamp(timestamp - i);
+        note.setNotebookLocalUid(notebook.localUid());
+        note.setLocal(true);
+        note.setDirty(false);
+        m_pLocalStorageManagerAsync->onAddNoteRequest(note, QUuid());
+        localUidsByTitle << note.localUid();
+    }
+
+    QStringList reversedLocalUidsByTitle;
+    reversedLocalUidsByTitle.reserve(WINDOWED_TEST_NUM_NOTES);
+    for(int i = WINDOWED_TEST_NUM_NOTES - 1; i >= 0; --i) {
+        reversedLocalUidsByTitle << localUidsByTitle[i];
+    }
+
+    NoteCache noteCache(20);
+    NotebookCache notebookCache(3);
+    NoteModel model(account, *m_pLocalStorageManagerAsync, noteCache, notebookCache, Q_NULLPTR,
+                    NoteModel::IncludedNotes::NonDeleted, NoteModel::ListingMode::Windowed);
+
+    QString error;
+
+    // Only the window of notes at the top of the default sorting by modification timestamp is listed on startup
+    int numRows = model.rowCount(QModelIndex());
+    QVERIFY2(numRows > 0, qnPrintable("Windowed note model listed no notes on startup"));
+    QVERIFY2(numRows < WINDOWED_TEST_NUM_NOTES, qnPrintable("Windowed note model listed all notes on startup"));
+    QVERIFY2(model.canFetchMore(QModelIndex()), qnPrintable("Windowed note model can't fetch more notes"));
+    QVERIFY2(checkWindowedNoteModelRows(model, reversedLocalUidsByTitle, error), qPrintable(error));
+
+    // The rows within the viewport stay in place as the thumbnails are released for the rest of them
+    QVector<int> viewportRows;
+    for(int row = 0; row < 10; ++row) {
+        viewportRows << row;
+    }
+
+    model.setViewportRows(viewportRows);
+    QVERIFY2(model.rowCount(QModelIndex()) == numRows, qnPrintable("The number of rows changed after setting the viewport"));
+    QVERIFY2(checkWindowedNoteModelRows(model, reversedLocalUidsByTitle, error), qPrintable(error));
+
+    model.fetchMore(QModelIndex());
+    QVERIFY2(model.rowCount(QModelIndex()) > numRows, qnPrintable("Windowed note model fetched no more notes"));
+    QVERIFY2(checkWindowedNoteModelRows(model, reversedLocalUidsByTitle, error), qPrintable(error));
+
+    // The local storage can't list notes by title so the window is found via the sort key index
+    model.sort(NoteModel::Columns::Title, Qt::AscendingOrder);
+    numRows = model.rowCount(QModelIndex());
+    QVERIFY2(numRows > 0, qnPrintable("Windowed note model has no notes after sorting by title"));
+    QVERIFY2(numRows < WINDOWED_TEST_NUM_NOTES, qnPrintable("Windowed note model listed all notes after sorting by title"));
+    QVERIFY2(model.canFetchMore(QModelIndex()), qnPrintable("Windowed note model can't fetch more notes sorted by title"));
+    QVERIFY2(checkWindowedNoteModelRows(model, localUidsByTitle, error), qPrintable(error));
+
+    model.fetchMore(QModelIndex());
+    QVERIFY2(model.rowCount(QModelIndex()) > numRows,
+             qnPrintable("Windowed note model fetched no more notes sorted by title"));
+    QVERIFY2(checkWindowedNoteModelRows(model, localUidsByTitle, error), qPrintable(error));
+    numRows = model.rowCount(QModelIndex());
+
+    // The new note sorted within the window gets into the model, the one sorted beyond it doesn't
+    Note firstNote;
+    firstNote.setTitle(QStringLiteral("A windowed note"));
+    firstNote.setNotebookLocalUid(notebook.localUid());
+    firstNote.setLocal(true);
+    m_pLocalStorageManagerAsync->onAddNoteRequest(firstNote, QUuid());
+
+    Note lastNote;
+    lastNote.setTitle(QStringLiteral("Z windowed note"));
+    lastNote.setNotebookLocalUid(notebook.localUid());
+    lastNote.setLocal(true);
+    m_pLocalStorageManagerAsync->onAddNoteRequest(lastNote, QUuid());
+
+    QVERIFY2(model.rowCount(QModelIndex()) == (numRows + 1),
+             qnPrintable("Unexpected number of rows after adding the notes to the windowed note model"));
+    QVERIFY2(model.indexForLocalUid(firstNote.localUid()).row() == 0,
+             qnPrintable("The note added to the top of the window is not at the first row"));
+    QVERIFY2(!model.indexForLocalUid(lastNote.localUid()).isValid(),
+             qnPrintable("The note added beyond the window got into the windowed note model"));
+
+    localUidsByTitle.prepend(firstNote.localUid());
+    localUidsByTitle << lastNote.localUid();
+    QVERIFY2(checkWindowedNoteModelRows(model, localUidsByTitle, error), qPrintable(error));
+
+    // The reversed sort order reuses the sort key index
+    model.sort(NoteModel::Columns::Title, Qt::DescendingOrder);
+    QVERIFY2(model.rowCount(QModelIndex()) < localUidsByTitle.size(),
+             qnPrintable("Windowed note model listed all notes after reversing the sort order"));
+
+    reversedLocalUidsByTitle.clear();
+    for(int i = localUidsByTitle.size() - 1; i >= 0; --i) {
+        reversedLocalUidsByTitle << localUidsByTitle[i];
+    }
+
+    QVERIFY2(checkWindowedNoteModelRows(model, reversedLocalUidsByTitle, error), qPrintable(error));
+
+    // The larger notes have the lower numbers within the titles; the notes without content go first
+    model.sort(NoteModel::Columns::Size, Qt::AscendingOrder);
+    QStringList localUidsBySize;
+    localUidsBySize << firstNote.localUid() << lastNote.localUid();
+    for(int i = localUidsByTitle.size() - 2; i >= 1; --i) {
+        localUidsBySize << localUidsByTitle[i];
+    }
+
+    QVERIFY2(model.rowCount(QModelIndex()) < localUidsBySize.size(),
+             qnPrintable("Windowed note model listed all notes after sorting by size"));
+
+    // The notes of the same size might go in any order relative to each other
+    const NoteModelItem * pFirstItem = model.itemAtRow(0);
+    const NoteModelItem * pSecondItem = model.itemAtRow(1);
+    QVERIFY2(pFirstItem && pSecondItem && (pFirstItem->sizeInBytes() == 0) && (pSecondItem->sizeInBytes() == 0),
+             qnPrintable("The notes without content are not at the top of the windowed note model sorted by size"));
+    localUidsBySize[0] = pFirstItem->localUid();
+    localUidsBySize[1] = pSecondItem->localUid();
+    QVERIFY2(checkWindowedNoteModelRows(model, localUidsBySize, error), qPrintable(error));
+
+    while(model.canFetchMore(QModelIndex())) {
+        model.fetchMore(QModelIndex());
+    }
+
+    QVERIFY2(model.rowCount(QModelIndex()) == localUidsBySize.size(),
+             qnPrintable("Windowed note model doesn't contain all notes after fetching all of them"));
+    QVERIFY2(checkWindowedNoteModelRows(model, localUidsBySize, error), qPrintable(error));
+}
+
+static int tagModelNoteCount(const quentier::TagModel & model, const QString & tagLocalUid)
+{
+    QModelIndex itemIndex = model.indexForLocalUid(tagLocalUid);
+    if (!itemIndex.isValid()) {
+        return -1;
+    }
+
+    itemIndex = model.index(itemIndex.row(), quentier::TagModel::Columns::NumNotesPerTag, itemIndex.parent());
+    return model.data(itemIndex).toInt();
+}
+
+static bool checkTagModelNoteCounts(const quentier::TagModel & model, const QStringList & tagLocalUids,
+                                    const QVector<int> & expectedNoteCounts, const QString & step, QString & error)
+{
+    for(int i = 0, size = tagLocalUids.size(); i < size; ++i)
+    {
+        int noteCount = tagModelNoteCount(model, tagLocalUids[i]);
+        if (noteCount != expectedNoteCounts[i]) {
+            error = QStringLiteral("Unexpected number of notes per tag #") + QString::number(i) + QStringLiteral(" ")
+                    + step + QStringLiteral(": expected ") + QString::number(expectedNoteCounts[i])
+                    + QStringLiteral(", got ") + QString::number(noteCount);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void ModelTester::testTagModelNoteCounts()
+{
+    using namespace quentier;
+
+    delete m_pLocalStorageManagerAsync;
+    Account account(QStringLiteral("ModelTester_tag_model_note_counts_test_fake_user"), Account::Type::Evernote, 702);
+    m_pLocalStorageManagerAsync = new quentier::LocalStorageManagerAsync(account, /* start from scratch = */ true,
+                                                                         /* override lock = */ false, this);
+    m_pLocalStorageManagerAsync->init();
+
+    Notebook notebook;
+    notebook.setName(QStringLiteral("Notebook"));
+    notebook.setLocal(true);
+    notebook.setDirty(false);
+    m_pLocalStorageManagerAsync->onAddNotebookRequest(notebook, QUuid());
+
+    QStringList tagLocalUids;
+    for(int i = 0; i < 3; ++i)
+    {
+        Tag tag;
+        tag.setName(QStringLiteral("Tag #") + QString::number(i));
+        tag.setLocal(true);
+        tag.setDirty(false);
+        m_pLocalStorageManagerAsync->onAddTagRequest(tag, QUuid());
+        tagLocalUids << tag.localUid();
+    }
+
+    Note firstNote;
+    firstNote.setTitle(QStringLiteral("First note"));
+    firstNote.setNotebookLocalUid(notebook.localUid());
+    firstNote.setTagLocalUids(QStringList() << tagLocalUids[0]);
+    firstNote.setLocal(true);
+    m_pLocalStorageManagerAsync->onAddNoteRequest(firstNote, QUuid());
+
+    Note secondNote;
+    secondNote.setTitle(QStringLiteral("Second note"));
+    secondNote.setNotebookLocalUid(notebook.localUid());
+    secondNote.setTagLocalUids(QStringList() << tagLocalUids[0] << tagLocalUids[1]);
+    secondNote.setLocal(true);
+    m_pLocalStorageManagerAsync->onAddNoteRequest(secondNote, QUuid());
+
+    NoteCache noteCache(5);
+    NotebookCache notebookCache(3);
+    NoteModel noteModel(account, *m_pLocalStorageManagerAsync, noteCache, notebookCache);
+
+    TagCache tagCache(5);
+    TagModel model(account, noteModel, *m_pLocalStorageManagerAsync, tagCache);
+
+    // The note counts per all tags come from the local storage once all tags are listed
+    QString error;
+    QVERIFY2(checkTagModelNoteCounts(model, tagLocalUids, QVector<int>() << 2 << 1 << 0,
+                                     QStringLiteral("after listing the tags"), error), qPrintable(error));
+
+    // From now on the note counts are maintained by the deltas without querying the local storage
+    QSignalSpy noteCountPerTagSpy(m_pLocalStorageManagerAsync, SIGNAL(getNoteCountPerTagComplete(int,Tag,QUuid)));
+    QSignalSpy noteCountPerTagFailedSpy(m_pLocalStorageManagerAsync, SIGNAL(getNoteCountPerTagFailed(ErrorString,Tag,QUuid)));
+    QSignalSpy noteCountsForAllTagsSpy(&model, SIGNAL(requestNoteCountsForAllTags(QUuid)));
+
+    Note thirdNote;
+    thirdNote.setTitle(QStringLiteral("Third note"));
+    thirdNote.setNotebookLocalUid(notebook.localUid());
+    thirdNote.setTagLocalUids(QStringList() << tagLocalUids[1] << tagLocalUids[2]);
+    thirdNote.setLocal(true);
+    m_pLocalStorageManagerAsync->onAddNoteRequest(thirdNote, QUuid());
+    QVERIFY2(checkTagModelNoteCounts(model, tagLocalUids, QVector<int>() << 2 << 2 << 1,
+                                     QStringLiteral("after adding the note"), error), qPrintable(error));
+
+    firstNote.setTagLocalUids(QStringList() << tagLocalUids[2]);
+    m_pLocalStorageManagerAsync->onUpdateNoteRequest(firstNote, /* update resources = */ false,
+                                                     /* update tags = */ true, QUuid());
+    QVERIFY2(checkTagModelNoteCounts(model, tagLocalUids, QVector<int>() << 1 << 2 << 2,
+                                     QStringLiteral("after changing the tags of the note"), error), qPrintable(error));
+
+    // The note model updates the deleted note without its tags
+    QVERIFY2(noteModel.deleteNote(secondNote.localUid()), qnPrintable("Failed to delete the note via the note model"));
+    QVERIFY2(checkTagModelNoteCounts(model, tagLocalUids, QVector<int>() << 0 << 1 << 2,
+                                     QStringLiteral("after deleting the note"), error), qPrintable(error));
+
+    // The deleted note doesn't count towards its tags so its expunging changes nothing
+    m_pLocalStorageManagerAsync->onExpungeNoteRequest(secondNote, QUuid());
+    QVERIFY2(checkTagModelNoteCounts(model, tagLocalUids, QVector<int>() << 0 << 1 << 2,
+                                     QStringLiteral("after expunging the deleted note"), error), qPrintable(error));
+
+    m_pLocalStorageManagerAsync->onExpungeNoteRequest(thirdNote, QUuid());
+    QVERIFY2(checkTagModelNoteCounts(model, tagLocalUids, QVector<int>() << 0 << 0 << 1,
+                                     QStringLiteral("after expunging the note"), error), qPrintable(error));
+
+    QVERIFY2(noteCountPerTagSpy.isEmpty() && noteCountPerTagFailedSpy.isEmpty(),
+             qnPrintable("Tag model queried the local storage for the note count per single tag"));
+    QVERIFY2(noteCountsForAllTagsSpy.isEmpty(),
+             qnPrintable("Tag model re-requested the note counts per all tags instead of applying the deltas"));
+
+    // The delta-maintained note counts match the ones the new model gets from the local storage
+    TagModel recountedModel(account, noteModel, *m_pLocalStorageManagerAsync, tagCache);
+    QVERIFY2(checkTagModelNoteCounts(recountedModel, tagLocalUids, QVector<int>() << 0 << 0 << 1,
+                                     QStringLiteral("within the new model"), error), qPrintable(error));
+}
+
 void ModelTester::testFavoritesModel()
 {
     using namespace quentier;
@@ -264,6 +650,63 @@ void ModelTester::testFavoritesModel()
     }
 }
 
+void ModelTester::testModelSnapshots()
+{
+    using namespace quentier;
+
+    QString error;
+    int res = -1;
+
+    // The models restored from the snapshots need to list the items asynchronously, hence the local storage manager
+    // is moved to its own thread in the middle of the test; it is deleted within that thread once it finishes
+    QThread localStorageManagerThread;
+    localStorageManagerThread.start();
+
+    Account account(QStringLiteral("ModelTester_model_snapshot_test_fake_user"), Account::Type::Evernote, 900);
+    LocalStorageManagerAsync * pLocalStorageManagerAsync =
+        new LocalStorageManagerAsync(account, /* start from scratch = */ true, /* override lock = */ false);
+    pLocalStorageManagerAsync->init();
+
+    QObject::connect(&localStorageManagerThread, QNSIGNAL(QThread,finished),
+                     pLocalStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,deleteLater));
+
+    {
+        QTimer timer;
+        timer.setInterval(MAX_ALLOWED_MILLISECONDS);
+        timer.setSingleShot(true);
+
+        ModelSnapshotTestHelper modelSnapshotTestHelper(pLocalStorageManagerAsync, &localStorageManagerThread);
+
+        EventLoopWithExitStatus loop;
+        QObject::connect(&timer, QNSIGNAL(QTimer,timeout), &loop, QNSLOT(EventLoopWithExitStatus,exitAsTimeout));
+        QObject::connect(&modelSnapshotTestHelper, QNSIGNAL(ModelSnapshotTestHelper,success), &loop, QNSLOT(EventLoopWithExitStatus,exitAsSuccess));
+        QObject::connect(&modelSnapshotTestHelper, QNSIGNAL(ModelSnapshotTestHelper,failure,ErrorString), &loop, QNSLOT(EventLoopWithExitStatus,exitAsFailureWithErrorString,ErrorString));
+
+        QTimer slotInvokingTimer;
+        slotInvokingTimer.setInterval(500);
+        slotInvokingTimer.setSingleShot(true);
+
+        timer.start();
+        slotInvokingTimer.singleShot(0, &modelSnapshotTestHelper, SLOT(launchTest()));
+        res = loop.exec();
+        error = loop.errorDescription().nonLocalizedString();
+    }
+
+    localStorageManagerThread.quit();
+    localStorageManagerThread.wait();
+
+    if (res == -1) {
+        QFAIL("Internal error: incorrect return status from model snapshot async tester");
+    }
+    else if (res == EventLoopWithExitStatus::ExitStatus::Failure) {
+        error.prepend(QStringLiteral("Detected failure during the asynchronous loop processing in model snapshot async tester: "));
+        QFAIL(qPrintable(error));
+    }
+    else if (res == EventLoopWithExitStatus::ExitStatus::Timeout) {
+        QFAIL("Model snapshot async tester failed to finish in time");
+    }
+}
+
 void ModelTester::testTagModelItemSerialization()
 {
     using namespace quentier;
@@ -297,6 +740,954 @@ void ModelTester::testTagModelItemSerialization()
     QVERIFY2(restoredItem.tagItem() == &item, qnPrintable("Wrong pointer to the tag item"));
 }
 
+static bool checkTagModelItemChildRows(const quentier::TagModelItem & parentItem, QString & error)
+{
+    for(int i = 0, numChildren = parentItem.numChildren(); i < numChildren; ++i)
+    {
+        const quentier::TagModelItem * pChildItem = parentItem.childAtRow(i);
+        if ((pChildItem->row() != i) || (parentItem.rowForChild(pChildItem) != i)) {
+            error = QStringLiteral("Wrong row for child item at row ") + QString::number(i) + QStringLiteral(": ")
+                    + QString::number(pChildItem->row());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+struct TagModelItemGreaterByName
+{
+    bool operator()(const quentier::TagModelItem * pLhs, const quentier::TagModelItem * pRhs) const
+    { return pLhs->tagItem()->name() > pRhs->tagItem()->name(); }
+};
+
+void ModelTester::testTagModelItemChildRows()
+{
+    using namespace quentier;
+
+    const int numChildren = 10;
+
+    TagItem parentTagItem(UidGenerator::Generate());
+    TagModelItem parentItem(TagModelItem::Type::Tag, &parentTagItem);
+
+    QVector<TagItem> childTagItems;
+    childTagItems.reserve(numChildren);
+    for(int i = 0; i < numChildren; ++i) {
+        childTagItems << TagItem(UidGenerator::Generate(), QString(), QString(), QStringLiteral("Tag #") + QString::number(i));
+    }
+
+    QVector<TagModelItem> childItems;
+    childItems.reserve(numChildren);
+    for(int i = 0; i < numChildren; ++i) {
+        childItems << TagModelItem(TagModelItem::Type::Tag, &childTagItems[i]);
+    }
+
+    QString error;
+
+    for(int i = 0; i < numChildren; i += 2) {
+        parentItem.addChild(&childItems[i]);
+    }
+
+    for(int i = 1; i < numChildren; i += 2) {
+        parentItem.insertChild(i, &childItems[i]);
+    }
+
+    QVERIFY2(checkTagModelItemChildRows(parentItem, error), qPrintable(QStringLiteral("After insertion: ") + error));
+
+    QVERIFY2(parentItem.swapChildren(2, 7), qnPrintable("Failed to swap child items"));
+    QVERIFY2(checkTagModelItemChildRows(parentItem, error), qPrintable(QStringLiteral("After swapping: ") + error));
+
+    parentItem.sortChildren(TagModelItemGreaterByName());
+    QVERIFY2(checkTagModelItemChildRows(parentItem, error), qPrintable(QStringLiteral("After sorting: ") + error));
+
+    const TagModelItem * pTakenItem = parentItem.takeChild(3);
+    QVERIFY2(pTakenItem != Q_NULLPTR, qnPrintable("Failed to take the child item"));
+    QVERIFY2((pTakenItem->row() == -1) && (parentItem.rowForChild(pTakenItem) == -1),
+             qnPrintable("The taken child item still has a row within its former parent"));
+    QVERIFY2(checkTagModelItemChildRows(parentItem, error), qPrintable(QStringLiteral("After taking a child: ") + error));
+}
+
+void ModelTester::testAdaptivePageSize()
+{
+    using namespace quentier;
+
+    AdaptivePageSize pageSize(40, 20, 160, 100);
+    QVERIFY2(pageSize.pageSize() == 40, qnPrintable("Unexpected initial page size"));
+
+    // Round trip within the target but not well below it doesn't change the page size
+    pageSize.adjust(70);
+    QVERIFY2(pageSize.pageSize() == 40, qnPrintable("Page size changed for the round trip close to the target"));
+
+    // Fast round trips grow the page size up to the max one
+    pageSize.adjust(10);
+    QVERIFY2(pageSize.pageSize() == 80, qnPrintable("Page size didn't grow after the fast round trip"));
+    pageSize.adjust(10);
+    pageSize.adjust(10);
+    QVERIFY2(pageSize.pageSize() == 160, qnPrintable("Page size grew beyond the max one"));
+
+    // Slow round trips shrink the page size down to the min one
+    pageSize.adjust(500);
+    QVERIFY2(pageSize.pageSize() == 80, qnPrintable("Page size didn't shrink after the slow round trip"));
+    pageSize.adjust(500);
+    pageSize.adjust(500);
+    pageSize.adjust(500);
+    QVERIFY2(pageSize.pageSize() == 20, qnPrintable("Page size shrank below the min one"));
+
+    AdaptivePageSize clampedPageSize(1000, 20, 160, 100);
+    QVERIFY2(clampedPageSize.pageSize() == 160, qnPrintable("Initial page size was not clamped to the max one"));
+}
+
+void ModelTester::testListRequestPipeline()
+{
+    using namespace quentier;
+
+    typedef ListRequestPipeline<int> Pipeline;
+
+    // Fixed page size so that the adaptation to the timings doesn't affect the offsets of the requests
+    Pipeline pipeline(10, 10, 10, 100, 4);
+    QVERIFY2(!pipeline.isActive(), qnPrintable("Pipeline is active before the start"));
+    QVERIFY2(pipeline.takeRequestsToSend().isEmpty(), qnPrintable("Pipeline emitted requests before the start"));
+
+    pipeline.start();
+
+    QList<Pipeline::Request> requests = pipeline.takeRequestsToSend();
+    QVERIFY2(requests.size() == 1, qnPrintable("Unexpected number of requests in the initial window"));
+    QVERIFY2(requests[0].m_offset == 0, qnPrintable("Unexpected offset of the first request"));
+    QVERIFY2(requests[0].m_limit == 10, qnPrintable("Unexpected limit of the first request"));
+
+    QList<int> page;
+    for(int i = 0; i < 10; ++i) {
+        page << i;
+    }
+
+    QList<int> readyItems;
+    QVERIFY2(!pipeline.onRequestComplete(QUuid::createUuid(), page, readyItems),
+             qnPrintable("Pipeline accepted the result of foreign request"));
+    QVERIFY2(pipeline.onRequestComplete(requests[0].m_requestId, page, readyItems),
+             qnPrintable("Pipeline didn't accept the result of its own request"));
+    QVERIFY2(readyItems == page, qnPrintable("Unexpected items handed out for the first page"));
+    QVERIFY2(pipeline.appliedOffset() == 10, qnPrintable("Unexpected applied offset after the first page"));
+    QVERIFY2(pipeline.isActive(), qnPrintable("Pipeline is not active after the full page"));
+
+    // No requests are issued beyond the end offset
+    QVERIFY2(pipeline.takeRequestsToSend(10).isEmpty(), qnPrintable("Pipeline emitted the request beyond the end offset"));
+
+    // The request which didn't wait in the queue at all widens the window of requests in flight
+    requests = pipeline.takeRequestsToSend();
+    QVERIFY2(requests.size() == 2, qnPrintable("The window of requests in flight didn't grow"));
+    QVERIFY2((requests[0].m_offset == 10) && (requests[1].m_offset == 20), qnPrintable("Unexpected offsets of the requests"));
+
+    // The page received out of order is held back until the preceding page is received
+    QList<int> secondPage;
+    for(int i = 20; i < 30; ++i) {
+        secondPage << i;
+    }
+
+    QList<int> firstPage;
+    for(int i = 10; i < 20; ++i) {
+        firstPage << i;
+    }
+
+    readyItems.clear();
+    QVERIFY2(pipeline.onRequestComplete(requests[1].m_requestId, secondPage, readyItems),
+             qnPrintable("Pipeline didn't accept the result of the second request"));
+    QVERIFY2(readyItems.isEmpty(), qnPrintable("Pipeline handed out the page received out of order"));
+
+    QVERIFY2(pipeline.onRequestComplete(requests[0].m_requestId, firstPage, readyItems),
+             qnPrintable("Pipeline didn't accept the result of the first request"));
+    QVERIFY2(readyItems == (firstPage + secondPage), qnPrintable("Pipeline didn't hand out the pages in order"));
+    QVERIFY2(pipeline.appliedOffset() == 30, qnPrintable("Unexpected applied offset after the pages received out of order"));
+
+    // Stopping the pipeline preserves the applied offset
+    requests = pipeline.takeRequestsToSend();
+    QVERIFY2(!requests.isEmpty(), qnPrintable("Pipeline didn't emit more requests"));
+
+    pipeline.stop();
+    QVERIFY2(!pipeline.isActive(), qnPrintable("Pipeline is active after the stop"));
+    QVERIFY2(pipeline.appliedOffset() == 30, qnPrintable("Applied offset was not preserved after the stop"));
+
+    QList<int> staleItems;
+    QVERIFY2(!pipeline.onRequestComplete(requests[0].m_requestId, page, staleItems),
+             qnPrintable("Pipeline accepted the result of the request sent before the stop"));
+
+    pipeline.start(pipeline.appliedOffset());
+    requests = pipeline.takeRequestsToSend();
+    QVERIFY2(!requests.isEmpty(), qnPrintable("Pipeline didn't emit requests after the restart"));
+    QVERIFY2(requests[0].m_offset == 30, qnPrintable("Pipeline didn't resume from the applied offset"));
+
+    // The short page finishes the listing
+    QList<int> shortPage;
+    shortPage << 30 << 31 << 32;
+
+    readyItems.clear();
+    QVERIFY2(pipeline.onRequestComplete(requests[0].m_requestId, shortPage, readyItems),
+             qnPrintable("Pipeline didn't accept the result of its own request after the restart"));
+
+    for(int i = 1, size = requests.size(); i < size; ++i) {
+        QList<int> items;
+        QVERIFY2(!pipeline.onRequestComplete(requests[i].m_requestId, page, items),
+                 qnPrintable("Pipeline accepted the result of the request beyond the last page"));
+    }
+
+    QVERIFY2(readyItems == shortPage, qnPrintable("Unexpected items handed out for the last page"));
+    QVERIFY2(pipeline.appliedOffset() == 33, qnPrintable("Unexpected applied offset after the last page"));
+    QVERIFY2(pipeline.isFinished(), qnPrintable("Pipeline is not finished after the short page"));
+    QVERIFY2(pipeline.takeRequestsToSend().isEmpty(), qnPrintable("Pipeline emitted requests after finishing"));
+
+    // The failure stops the listing
+    pipeline.start();
+    requests = pipeline.takeRequestsToSend();
+    QVERIFY2(pipeline.onRequestFailed(requests[0].m_requestId), qnPrintable("Pipeline didn't recognize its own failed request"));
+    QVERIFY2(!pipeline.isActive() && !pipeline.isFinished(), qnPrintable("Unexpected pipeline state after the failed request"));
+}
+
+struct KeyOnlyLess
+{
+    bool operator()(const std::pair<int, int> & lhs, const std::pair<int, int> & rhs) const
+    { return lhs.first < rhs.first; }
+};
+
+void ModelTester::testParallelSort()
+{
+    // The sizes below, at and well above the threshold for sorting in parallel
+    std::vector<int> sizes;
+    sizes.push_back(0);
+    sizes.push_back(17);
+    sizes.push_back(PARALLEL_SORT_MIN_CHUNK_SIZE * 2 + 13);
+    sizes.push_back(PARALLEL_SORT_MIN_CHUNK_SIZE * 9 + 5);
+
+    qsrand(42);
+
+    for(auto sizeIt = sizes.begin(), sizesEnd = sizes.end(); sizeIt != sizesEnd; ++sizeIt)
+    {
+        const int size = *sizeIt;
+
+        // Few distinct keys so that there are lots of equal ones; the second member is the original position
+        // of the element which should not affect the sorting
+        std::vector<std::pair<int, int> > input;
+        input.reserve(static_cast<size_t>(size));
+        for(int i = 0; i < size; ++i) {
+            input.push_back(std::pair<int, int>(qrand() % 50, i));
+        }
+
+        std::vector<std::pair<int, int> > expected = input;
+        std::stable_sort(expected.begin(), expected.end(), KeyOnlyLess());
+
+        std::vector<std::pair<int, int> > sorted = input;
+        parallelSort(sorted.begin(), sorted.end(), KeyOnlyLess());
+
+        // The parallel sort is not stable, hence only the order of keys must match the one of the stable sort
+        bool sameKeys = true;
+        for(size_t i = 0, numItems = sorted.size(); i < numItems; ++i)
+        {
+            if (sorted[i].first != expected[i].first) {
+                sameKeys = false;
+                break;
+            }
+        }
+
+        QVERIFY2(sameKeys, qPrintable(QStringLiteral("The order of keys after the parallel sort differs from the one "
+                                                     "after the stable sort, number of items = ") + QString::number(size)));
+
+        // ... while the sorted elements must be the permutation of the input ones
+        std::sort(sorted.begin(), sorted.end());
+        std::sort(expected.begin(), expected.end());
+        QVERIFY2(sorted == expected,
+                 qPrintable(QStringLiteral("The parallel sort has lost or duplicated some elements, number of items = ") +
+                            QString::number(size)));
+    }
+}
+
+struct CollationKeyLess
+{
+    bool operator()(const quentier::CollationKey & lhs, const quentier::CollationKey & rhs) const
+    { return lhs.compare(rhs) < 0; }
+};
+
+void ModelTester::testCollationKeys()
+{
+    using namespace quentier;
+
+    QStringList strings;
+    strings << QStringLiteral("Zebra") << QStringLiteral("apple") << QStringLiteral("Apple")
+            << QStringLiteral("banana") << QStringLiteral("10 things") << QStringLiteral("9 things")
+            << QString() << QStringLiteral("\u00e9clair") << QStringLiteral("eclair");
+
+    Collator collator;
+    QVector<CollationKey> keys;
+    keys.reserve(strings.size());
+    for(auto it = strings.constBegin(), end = strings.constEnd(); it != end; ++it) {
+        keys << collator.sortKey(*it);
+    }
+
+    // NOTE: the exact order of strings depends on the platform's collation implementation and the current locale
+    // so only the consistency of the collation keys with each other and with the collator is checked
+    for(int i = 0, size = strings.size(); i < size; ++i)
+    {
+        QVERIFY2(!keys[i].isNull(), qnPrintable("Collation key built for a string is null"));
+        QVERIFY2(keys[i].compare(keys[i]) == 0, qPrintable(QStringLiteral("Collation key for string \"%1\" doesn't "
+                                                                          "compare equal to itself").arg(strings[i])));
+
+        for(int j = 0; j < size; ++j)
+        {
+            int sign = keys[i].compare(keys[j]);
+            sign = (sign < 0 ? -1 : (sign > 0 ? 1 : 0));
+
+            int reverseSign = keys[j].compare(keys[i]);
+            reverseSign = (reverseSign < 0 ? -1 : (reverseSign > 0 ? 1 : 0));
+
+            QVERIFY2(sign == -reverseSign,
+                     qPrintable(QStringLiteral("Collation keys comparison is not antisymmetric for strings \"%1\" "
+                                               "and \"%2\"").arg(strings[i], strings[j])));
+
+            int collatorSign = collator.compare(strings[i], strings[j]);
+            collatorSign = (collatorSign < 0 ? -1 : (collatorSign > 0 ? 1 : 0));
+
+            QVERIFY2(sign == collatorSign,
+                     qPrintable(QStringLiteral("Collation keys comparison result doesn't match the collator's "
+                                               "comparison of strings \"%1\" and \"%2\"").arg(strings[i], strings[j])));
+        }
+    }
+
+    // The order established by the collation keys must be transitive: sorting by the keys needs to give
+    // the sequence in which each key is not greater than any of the following ones
+    QVector<CollationKey> sortedKeys = keys;
+    std::sort(sortedKeys.begin(), sortedKeys.end(), CollationKeyLess());
+    for(int i = 0, size = sortedKeys.size(); i < size; ++i)
+    {
+        for(int j = i + 1; j < size; ++j) {
+            QVERIFY2(sortedKeys[i].compare(sortedKeys[j]) <= 0,
+                     qnPrintable("Collation keys sorted by their comparison are not ordered"));
+        }
+    }
+
+    CollationKey nullKey;
+    QVERIFY2(nullKey.isNull(), qnPrintable("Default constructed collation key is not null"));
+    QVERIFY2(nullKey.compare(CollationKey()) == 0, qnPrintable("Null collation keys don't compare equal"));
+    QVERIFY2(nullKey.compare(keys[0]) < 0, qnPrintable("Null collation key doesn't compare less than non-null one"));
+    QVERIFY2(keys[0].compare(nullKey) > 0, qnPrintable("Non-null collation key doesn't compare greater than null one"));
+}
+
+void ModelTester::testTagNameTable()
+{
+    using namespace quentier;
+
+    TagNameTable table;
+    QVERIFY2(table.findId(QStringLiteral("tag1")) < 0, qnPrintable("Empty table has the id for the tag"));
+
+    qint32 firstId = table.idForTagLocalUid(QStringLiteral("tag1"));
+    qint32 secondId = table.idForTagLocalUid(QStringLiteral("tag2"));
+    QVERIFY2(firstId != secondId, qnPrintable("Different tags got the same id"));
+    QVERIFY2(table.idForTagLocalUid(QStringLiteral("tag1")) == firstId, qnPrintable("Tag got another id on repeated lookup"));
+    QVERIFY2(table.name(firstId).isEmpty(), qnPrintable("Tag has the name before it was set"));
+
+    QVERIFY2(table.setName(firstId, QStringLiteral("First")), qnPrintable("Setting the tag name reported no change"));
+    QVERIFY2(!table.setName(firstId, QStringLiteral("First")), qnPrintable("Setting the same tag name reported the change"));
+    Q_UNUSED(table.setName(secondId, QStringLiteral("Second")))
+
+    QVector<qint32> ids;
+    ids << secondId << firstId;
+    QVERIFY2(table.names(ids) == (QStringList() << QStringLiteral("Second") << QStringLiteral("First")),
+             qnPrintable("Unexpected tag names resolved by ids"));
+
+    // Renaming the tag is seen through its id
+    Q_UNUSED(table.setName(firstId, QStringLiteral("Renamed")))
+    QVERIFY2(table.name(firstId) == QStringLiteral("Renamed"), qnPrintable("Renamed tag's name was not resolved by id"));
+
+    // The id of the removed tag resolves to nothing and is not reused
+    table.remove(QStringLiteral("tag1"));
+    QVERIFY2(table.name(firstId).isEmpty(), qnPrintable("Removed tag's id still resolves to the name"));
+    QVERIFY2(table.findId(QStringLiteral("tag1")) < 0, qnPrintable("Removed tag still has the id"));
+    QVERIFY2(table.idForTagLocalUid(QStringLiteral("tag1")) != firstId, qnPrintable("Removed tag's id was reused"));
+    QVERIFY2(table.names(ids) == (QStringList() << QStringLiteral("Second")),
+             qnPrintable("Removed tag's name was resolved by id"));
+    QVERIFY2(table.name(-1).isEmpty() && table.name(table.size()).isEmpty(), qnPrintable("Unknown id resolved to the name"));
+}
+
+void ModelTester::testLogLineParser()
+{
+    using namespace quentier;
+
+    LogLineParser::Fields fields;
+    QByteArray line("2017-09-21 21:33:39.507 MSK src/models/NoteModel.cpp @ 123 [Debug]: Message @ 5 [Info]: text");
+    QVERIFY2(LogLineParser::parse(line.constData(), line.size(), fields), qnPrintable("Failed to parse the valid log line"));
+
+    QVERIFY2(line.mid(fields.m_timestampOffset, fields.m_timestampSize) == QByteArray("2017-09-21 21:33:39.507"),
+             qnPrintable("Unexpected timestamp parsed from the log line"));
+    QVERIFY2(line.mid(fields.m_timeZoneOffset, fields.m_timeZoneSize) == QByteArray("MSK"),
+             qnPrintable("Unexpected timezone parsed from the log line"));
+    QVERIFY2(line.mid(fields.m_sourceFileNameOffset, fields.m_sourceFileNameSize) == QByteArray("src/models/NoteModel.cpp"),
+             qnPrintable("Unexpected source file name parsed from the log line"));
+    QVERIFY2(fields.m_sourceFileLineNumber == 123, qnPrintable("Unexpected source file line number parsed from the log line"));
+    QVERIFY2(fields.m_logLevel == LogLevel::DebugLevel, qnPrintable("Unexpected log level parsed from the log line"));
+    QVERIFY2(line.mid(fields.m_messageOffset, fields.m_messageSize) == QByteArray("Message @ 5 [Info]: text"),
+             qnPrintable("Unexpected message parsed from the log line"));
+
+    QByteArray continuationLine("    continuation of the multiline message");
+    QVERIFY2(!LogLineParser::parse(continuationLine.constData(), continuationLine.size(), fields),
+             qnPrintable("Parsed the continuation line as the log entry's start"));
+
+    QByteArray unknownLogLevelLine("2017-09-21 21:33:39.507 MSK src/models/NoteModel.cpp @ 123 [Fatal]: Message");
+    QVERIFY2(!LogLineParser::parse(unknownLogLevelLine.constData(), unknownLogLevelLine.size(), fields),
+             qnPrintable("Parsed the log line with unknown log level"));
+
+    QByteArray emptyMessageLine("2017-09-21 21:33:39.507 MSK src/models/NoteModel.cpp @ 123 [Info]: ");
+    QVERIFY2(!LogLineParser::parse(emptyMessageLine.constData(), emptyMessageLine.size(), fields),
+             qnPrintable("Parsed the log line without the message"));
+}
+
+void ModelTester::testLogViewerFilterIndex()
+{
+    using namespace quentier;
+
+    LogViewerFilterIndex index;
+    index.setTextIndexingEnabled(true);
+
+    index.addEntry(LogLevel::DebugLevel, QStringLiteral("src/models/NoteModel.cpp"), QStringLiteral("Fetched note from the local storage"));
+    index.addEntry(LogLevel::WarnLevel, QStringLiteral("src/models/TagModel.cpp"), QStringLiteral("Failed to find tag"));
+    index.addUnparsedEntry();
+    index.addEntry(LogLevel::ErrorLevel, QStringLiteral("src/MainWindow.cpp"), QStringLiteral("Failed to fetch NOTE"));
+
+    QVERIFY2(index.numIndexedRows() == 4, qnPrintable("Unexpected number of indexed rows"));
+    QVERIFY2(index.rowHasLogLevel(0, LogLevel::DebugLevel) && !index.rowHasLogLevel(0, LogLevel::WarnLevel),
+             qnPrintable("Unexpected log level of the indexed row"));
+    QVERIFY2(index.rowHasLogLevel(1, LogLevel::WarnLevel), qnPrintable("Unexpected log level of the indexed row"));
+    for(int i = 0; i < LOG_VIEWER_FILTER_INDEX_NUM_LOG_LEVELS; ++i) {
+        QVERIFY2(!index.rowHasLogLevel(2, i), qnPrintable("Unparsed row has the log level"));
+    }
+
+    QRegExp filter(QStringLiteral("fetch*note"), Qt::CaseInsensitive, QRegExp::Wildcard);
+    QVector<quint64> trigrams = LogViewerFilterIndex::literalTrigrams(filter);
+    QVERIFY2(!trigrams.isEmpty(), qnPrintable("No trigrams collected from the wildcard filter"));
+
+    QBitArray candidateRows;
+    index.findCandidateRows(trigrams, 0, candidateRows);
+    QVERIFY2(candidateRows.size() == 4, qnPrintable("Unexpected size of candidate rows bit array"));
+    QVERIFY2(candidateRows.testBit(0) && !candidateRows.testBit(1) && !candidateRows.testBit(2) && candidateRows.testBit(3),
+             qnPrintable("Unexpected candidate rows for the wildcard filter"));
+
+    QRegExp unknownFilter(QStringLiteral("synchronization"), Qt::CaseSensitive, QRegExp::FixedString);
+    index.findCandidateRows(LogViewerFilterIndex::literalTrigrams(unknownFilter), 0, candidateRows);
+    QVERIFY2(candidateRows.count(true) == 0, qnPrintable("Found candidate rows for the text absent from the log"));
+
+    QVERIFY2(LogViewerFilterIndex::literalTrigrams(QRegExp(QStringLiteral("*a?"), Qt::CaseSensitive, QRegExp::Wildcard)).isEmpty(),
+             qnPrintable("Collected trigrams from the filter without literals of three characters"));
+    QVERIFY2(LogViewerFilterIndex::literalTrigrams(QRegExp(QStringLiteral("note.*tag"))).isEmpty(),
+             qnPrintable("Collected trigrams from the regular expression filter"));
+
+    // Truncated rows are indexed anew as the last log entry grows
+    index.truncate(3);
+    QVERIFY2(index.numIndexedRows() == 3, qnPrintable("Unexpected number of indexed rows after truncation"));
+    QVERIFY2(!index.rowHasLogLevel(3, LogLevel::ErrorLevel), qnPrintable("Truncated row still has the log level"));
+
+    index.addEntry(LogLevel::InfoLevel, QStringLiteral("src/MainWindow.cpp"), QStringLiteral("Started synchronization"));
+    index.findCandidateRows(trigrams, 0, candidateRows);
+    QVERIFY2(candidateRows.testBit(0) && !candidateRows.testBit(3), qnPrintable("Unexpected candidate rows after truncation"));
+
+    index.findCandidateRows(LogViewerFilterIndex::literalTrigrams(unknownFilter), 2, candidateRows);
+    QVERIFY2(candidateRows.testBit(3), qnPrintable("Re-indexed row is not the candidate for its text"));
+
+    // The row added without its text only has the log level
+    index.addEntry(LogLevel::WarnLevel);
+    QVERIFY2((index.numIndexedRows() == 5) && index.rowHasLogLevel(4, LogLevel::WarnLevel),
+             qnPrintable("Unexpected log level of the row added without its text"));
+    index.findCandidateRows(trigrams, 0, candidateRows);
+    QVERIFY2(!candidateRows.testBit(4), qnPrintable("The row added without its text is the candidate for the filter"));
+
+    // The postings are only kept for the window of the most recent rows, the older rows are all candidates
+    index.clear();
+    index.addEntry(LogLevel::DebugLevel, QStringLiteral("src/models/NoteModel.cpp"), QStringLiteral("Fetched note from the local storage"));
+    for(int i = 0; i < LOG_VIEWER_FILTER_INDEX_MAX_TEXT_INDEXED_ROWS; ++i) {
+        index.addEntry(LogLevel::InfoLevel, QStringLiteral("src/MainWindow.cpp"), QStringLiteral("Started synchronization"));
+    }
+
+    const int numRows = LOG_VIEWER_FILTER_INDEX_MAX_TEXT_INDEXED_ROWS + 1;
+    QVERIFY2(index.numIndexedRows() == numRows, qnPrintable("Unexpected number of indexed rows"));
+
+    index.findCandidateRows(trigrams, 0, candidateRows);
+    int numCandidateRows = candidateRows.count(true);
+    QVERIFY2(candidateRows.testBit(0), qnPrintable("The row before the window of text indexed rows is not the candidate"));
+    QVERIFY2((numCandidateRows > 0) && (numCandidateRows < numRows) && !candidateRows.testBit(numRows - 1),
+             qPrintable(QStringLiteral("Unexpected number of candidate rows with the postings evicted: ") +
+                        QString::number(numCandidateRows)));
+    for(int i = 0; i < numCandidateRows; ++i) {
+        QVERIFY2(candidateRows.testBit(i), qnPrintable("The candidate rows are not the ones before the window"));
+    }
+
+    // Disabling the text indexing keeps the log levels while enabling it only drops the rows within the window
+    index.setTextIndexingEnabled(false);
+    QVERIFY2(index.numIndexedRows() == numRows, qnPrintable("Disabling the text indexing removed the indexed rows"));
+    QVERIFY2(index.rowHasLogLevel(0, LogLevel::DebugLevel), qnPrintable("Disabling the text indexing removed the log levels"));
+
+    index.setTextIndexingEnabled(true);
+    QVERIFY2(index.numIndexedRows() == (numRows - LOG_VIEWER_FILTER_INDEX_MAX_TEXT_INDEXED_ROWS),
+             qnPrintable("Unexpected number of indexed rows after enabling the text indexing"));
+    QVERIFY2(index.rowHasLogLevel(0, LogLevel::DebugLevel),
+             qnPrintable("Enabling the text indexing removed the rows before the window"));
+}
+
+static quint64 stringHeapBytes(const QString & str, QSet<const void*> & countedData)
+{
+    if (str.isEmpty()) {
+        return 0;
+    }
+
+    // Implicitly shared strings are only counted once
+    const void * pData = str.constData();
+    if (countedData.contains(pData)) {
+        return 0;
+    }
+
+    Q_UNUSED(countedData.insert(pData))
+    return static_cast<quint64>(QT_CONTAINER_HEADER_SIZE + (str.capacity() + 1) * sizeof(QChar));
+}
+
+static quint64 stringListHeapBytes(const QStringList & strings, QSet<const void*> & countedData)
+{
+    if (strings.isEmpty()) {
+        return 0;
+    }
+
+    quint64 bytes = static_cast<quint64>(QT_CONTAINER_HEADER_SIZE + strings.size() * sizeof(void*));
+    for(auto it = strings.constBegin(), end = strings.constEnd(); it != end; ++it) {
+        bytes += stringHeapBytes(*it, countedData);
+    }
+
+    return bytes;
+}
+
+static quint64 noteModelItemsMemoryUsage(const QVector<quentier::NoteModelItem> & items)
+{
+    QSet<const void*> countedData;
+    quint64 bytes = static_cast<quint64>(items.size() * sizeof(quentier::NoteModelItem));
+
+    for(auto it = items.constBegin(), end = items.constEnd(); it != end; ++it)
+    {
+        const quentier::NoteModelItem & item = *it;
+        bytes += stringHeapBytes(item.localUid(), countedData);
+        bytes += stringHeapBytes(item.guid(), countedData);
+        bytes += stringHeapBytes(item.notebookLocalUid(), countedData);
+        bytes += stringHeapBytes(item.notebookGuid(), countedData);
+        bytes += stringHeapBytes(item.title(), countedData);
+        bytes += stringHeapBytes(item.previewText(), countedData);
+        bytes += stringHeapBytes(item.notebookName(), countedData);
+        bytes += stringListHeapBytes(item.tagLocalUids(), countedData);
+        bytes += stringListHeapBytes(item.tagGuids(), countedData);
+
+        const QVector<qint32> & tagNameIds = item.tagNameIds();
+        if (!tagNameIds.isEmpty()) {
+            bytes += static_cast<quint64>(QT_CONTAINER_HEADER_SIZE + tagNameIds.capacity() * sizeof(qint32));
+        }
+    }
+
+    return bytes;
+}
+
+static QString deepCopy(const QString & str)
+{
+    return QString(str.constData(), str.size());
+}
+
+static void fillSyntheticNoteModelItems(QVector<quentier::NoteModelItem> & items, quentier::StringPool * pStringPool)
+{
+    using namespace quentier;
+
+    QStringList notebookLocalUids, notebookGuids, notebookNames;
+    for(int i = 0; i < BENCHMARK_NUM_NOTEBOOKS; ++i) {
+        notebookLocalUids << UidGenerator::Generate();
+        notebookGuids << UidGenerator::Generate();
+        notebookNames << QStringLiteral("Notebook #") + QString::number(i);
+    }
+
+    QStringList tagLocalUids, tagGuids;
+    for(int i = 0; i < BENCHMARK_NUM_TAGS; ++i) {
+        tagLocalUids << UidGenerator::Generate();
+        tagGuids << UidGenerator::Generate();
+    }
+
+    QString previewText(BENCHMARK_PREVIEW_TEXT_SIZE, QChar::fromLatin1('a'));
+
+    items.clear();
+    items.reserve(BENCHMARK_NUM_NOTES);
+
+    for(int i = 0; i < BENCHMARK_NUM_NOTES; ++i)
+    {
+        NoteModelItem item;
+        item.setLocalUid(UidGenerator::Generate());
+        item.setGuid(UidGenerator::Generate());
+        item.setTitle(QStringLiteral("Note #") + QString::number(i));
+
+        // Emulate the preview text coming from a separate note
+        previewText[0] = QChar::fromLatin1(static_cast<char>('a' + (i % 26)));
+        item.setPreviewText(deepCopy(previewText));
+
+        // Emulate the strings coming from separately loaded notes: each note holds its own copy of them
+        int notebookIndex = i % BENCHMARK_NUM_NOTEBOOKS;
+        QString notebookLocalUid = deepCopy(notebookLocalUids[notebookIndex]);
+        QString notebookGuid = deepCopy(notebookGuids[notebookIndex]);
+
+        item.setNotebookLocalUid(pStringPool ? pStringPool->intern(notebookLocalUid) : notebookLocalUid);
+        item.setNotebookGuid(pStringPool ? pStringPool->intern(notebookGuid) : notebookGuid);
+
+        // Notebook and tag names come from the note model's own notebook and tag data
+        item.setNotebookName(notebookNames[notebookIndex]);
+
+        // Tag names are referred to by the ids within the note model's tag name table
+        QStringList itemTagLocalUids, itemTagGuids;
+        QVector<qint32> itemTagNameIds;
+        int numTags = i % (BENCHMARK_MAX_TAGS_PER_NOTE + 1);
+        for(int j = 0; j < numTags; ++j) {
+            int tagIndex = (i * 7 + j * 13) % BENCHMARK_NUM_TAGS;
+            itemTagLocalUids << deepCopy(tagLocalUids[tagIndex]);
+            itemTagGuids << deepCopy(tagGuids[tagIndex]);
+            itemTagNameIds << static_cast<qint32>(tagIndex);
+        }
+
+        item.setTagLocalUids(pStringPool ? pStringPool->intern(itemTagLocalUids) : itemTagLocalUids);
+        item.setTagGuids(pStringPool ? pStringPool->intern(itemTagGuids) : itemTagGuids);
+        item.setTagNameIds(itemTagNameIds);
+
+        item.setCreationTimestamp(i);
+        item.setModificationTimestamp(i);
+        item.setSynchronizable(true);
+        item.setDirty((i % 2) == 0);
+        item.setFavorited((i % 10) == 0);
+
+        items << item;
+    }
+}
+
+void ModelTester::benchmarkNoteModelItemMemoryUsage()
+{
+    using namespace quentier;
+
+    quint64 nonInternedBytes = 0;
+    {
+        QVector<NoteModelItem> items;
+        fillSyntheticNoteModelItems(items, Q_NULLPTR);
+        nonInternedBytes = noteModelItemsMemoryUsage(items);
+    }
+
+    quint64 internedBytes = 0;
+    int numInternedStrings = 0;
+    {
+        StringPool stringPool;
+        QVector<NoteModelItem> items;
+        fillSyntheticNoteModelItems(items, &stringPool);
+        internedBytes = noteModelItemsMemoryUsage(items);
+        numInternedStrings = stringPool.size();
+    }
+
+    QNINFO(QStringLiteral("Note model items memory usage for ") << BENCHMARK_NUM_NOTES
+           << QStringLiteral(" notes: sizeof(NoteModelItem) = ") << sizeof(NoteModelItem)
+           << QStringLiteral(" bytes; without interning: ") << (nonInternedBytes / BENCHMARK_NUM_NOTES)
+           << QStringLiteral(" bytes per note; with interning: ") << (internedBytes / BENCHMARK_NUM_NOTES)
+           << QStringLiteral(" bytes per note, ") << numInternedStrings << QStringLiteral(" interned strings"));
+
+    QVERIFY2(numInternedStrings == 2 * (BENCHMARK_NUM_NOTEBOOKS + BENCHMARK_NUM_TAGS),
+             qPrintable(QStringLiteral("Unexpected number of interned strings: ") + QString::number(numInternedStrings)));
+    QVERIFY2(internedBytes < nonInternedBytes, qnPrintable("Interning strings didn't reduce the memory usage"));
+}
+
+void ModelTester::benchmarkNoteFilterModelFiltering_data()
+{
+    QTest::addColumn<QString>("filterType");
+    QTest::addColumn<int>("filterSize");
+
+    const int filterSizes[] = { 10, 1000, 20000 };
+    const int numFilterSizes = static_cast<int>(sizeof(filterSizes) / sizeof(filterSizes[0]));
+
+    for(int i = 0; i < numFilterSizes; ++i)
+    {
+        int filterSize = filterSizes[i];
+        QTest::newRow(qPrintable(QStringLiteral("note local uids, ") + QString::number(filterSize)))
+            << QStringLiteral("noteLocalUids") << filterSize;
+        QTest::newRow(qPrintable(QStringLiteral("notebook local uids, ") + QString::number(filterSize)))
+            << QStringLiteral("notebookLocalUids") << filterSize;
+        QTest::newRow(qPrintable(QStringLiteral("tag names, ") + QString::number(filterSize)))
+            << QStringLiteral("tagNames") << filterSize;
+    }
+}
+
+void ModelTester::benchmarkNoteFilterModelFiltering()
+{
+    using namespace quentier;
+
+    QFETCH(QString, filterType);
+    QFETCH(int, filterSize);
+
+    QVector<NoteModelItem> items;
+    items.reserve(BENCHMARK_NUM_FILTERED_NOTES);
+
+    QStringList filter;
+    filter.reserve(filterSize);
+
+    TagNameTable tagNameTable;
+
+    for(int i = 0; i < BENCHMARK_NUM_FILTERED_NOTES; ++i)
+    {
+        NoteModelItem item;
+        item.setLocalUid(UidGenerator::Generate());
+        item.setNotebookLocalUid(UidGenerator::Generate());
+
+        QString tagLocalUid = UidGenerator::Generate();
+        qint32 tagNameId = tagNameTable.idForTagLocalUid(tagLocalUid);
+        Q_UNUSED(tagNameTable.setName(tagNameId, QStringLiteral("Tag #") + QString::number(i)))
+        item.setTagLocalUids(QStringList() << tagLocalUid);
+        item.setTagNameIds(QVector<qint32>() << tagNameId);
+        items << item;
+
+        // Every other item is filtered in until the filter is full
+        if (((i % 2) != 0) || (filter.size() >= filterSize)) {
+            continue;
+        }
+
+        if (filterType == QStringLiteral("noteLocalUids")) {
+            filter << item.localUid();
+        }
+        else if (filterType == QStringLiteral("notebookLocalUids")) {
+            filter << item.notebookLocalUid();
+        }
+        else {
+            filter << tagNameTable.name(item.tagNameIds().first());
+        }
+    }
+
+    while(filter.size() < filterSize) {
+        filter << UidGenerator::Generate();
+    }
+
+    NoteFilterModel model;
+    if (filterType == QStringLiteral("noteLocalUids")) {
+        model.setNoteLocalUids(filter);
+    }
+    else if (filterType == QStringLiteral("notebookLocalUids")) {
+        model.setNotebookLocalUids(filter);
+    }
+    else {
+        model.setTagNames(filter);
+    }
+
+    int numAcceptedItems = 0;
+    QBENCHMARK {
+        numAcceptedItems = 0;
+        for(auto it = items.constBegin(), end = items.constEnd(); it != end; ++it) {
+            if (model.acceptsNoteItem(*it, tagNameTable)) {
+                ++numAcceptedItems;
+            }
+        }
+    }
+
+    int expectedNumAcceptedItems = std::min(filterSize, (BENCHMARK_NUM_FILTERED_NOTES + 1) / 2);
+    QVERIFY2(numAcceptedItems == expectedNumAcceptedItems,
+             qPrintable(QStringLiteral("Unexpected number of accepted note items: ") + QString::number(numAcceptedItems)));
+}
+
+namespace {
+
+// Reproduces the key extraction of the tag name index prior to storing the upper case name within the item
+struct FoldingTagNameUpperExtractor
+{
+    typedef QString result_type;
+    QString operator()(const quentier::TagItem & item) const { return item.name().toUpper(); }
+};
+
+struct ByNameUpper{};
+
+typedef boost::multi_index_container<
+    quentier::TagItem,
+    boost::multi_index::indexed_by<
+        boost::multi_index::ordered_non_unique<
+            boost::multi_index::tag<ByNameUpper>,
+            boost::multi_index::const_mem_fun<quentier::TagItem,const QString&,&quentier::TagItem::nameUpper>
+        >
+    >
+> StoredKeyTagNameIndex;
+
+typedef boost::multi_index_container<
+    quentier::TagItem,
+    boost::multi_index::indexed_by<
+        boost::multi_index::ordered_non_unique<
+            boost::multi_index::tag<ByNameUpper>,
+            FoldingTagNameUpperExtractor
+        >
+    >
+> FoldingKeyTagNameIndex;
+
+} // namespace
+
+template <class TagNameIndex>
+static void fillTagNameIndex(TagNameIndex & index, const std::vector<quentier::TagItem> & items)
+{
+    for(auto it = items.begin(), end = items.end(); it != end; ++it) {
+        Q_UNUSED(index.insert(*it))
+    }
+}
+
+template <class TagNameIndex>
+static int benchmarkTagNameIndexOperation(const std::vector<quentier::TagItem> & items,
+                                          const QStringList & lookupKeys, const bool insert)
+{
+    int result = 0;
+
+    if (insert)
+    {
+        QBENCHMARK {
+            TagNameIndex index;
+            fillTagNameIndex(index, items);
+            result = static_cast<int>(index.size());
+        }
+
+        return result;
+    }
+
+    TagNameIndex index;
+    fillTagNameIndex(index, items);
+
+    QBENCHMARK {
+        result = 0;
+        for(auto it = lookupKeys.constBegin(), end = lookupKeys.constEnd(); it != end; ++it) {
+            if (index.find(*it) != index.end()) {
+                ++result;
+            }
+        }
+    }
+
+    return result;
+}
+
+void ModelTester::benchmarkTagNameIndex_data()
+{
+    QTest::addColumn<bool>("insert");
+    QTest::addColumn<bool>("storedKey");
+
+    QTest::newRow("insert, folding key") << true << false;
+    QTest::newRow("insert, stored key") << true << true;
+    QTest::newRow("lookup, folding key") << false << false;
+    QTest::newRow("lookup, stored key") << false << true;
+}
+
+void ModelTester::benchmarkTagNameIndex()
+{
+    using namespace quentier;
+
+    QFETCH(bool, insert);
+    QFETCH(bool, storedKey);
+
+    std::vector<TagItem> items;
+    items.reserve(BENCHMARK_NUM_NAME_INDEX_TAGS);
+
+    QStringList lookupKeys;
+    lookupKeys.reserve(BENCHMARK_NUM_NAME_INDEX_TAGS);
+
+    for(int i = 0; i < BENCHMARK_NUM_NAME_INDEX_TAGS; ++i)
+    {
+        // Shuffle the numbers a bit so that the items are not inserted in the sorted order
+        int number = static_cast<int>((static_cast<qint64>(i) * 7919) % BENCHMARK_NUM_NAME_INDEX_TAGS);
+        QString name = QStringLiteral("Tag name #") + QString::number(number);
+
+        TagItem item;
+        item.setLocalUid(UidGenerator::Generate());
+        item.setName(name);
+        items.push_back(item);
+
+        lookupKeys << name.toUpper();
+    }
+
+    int result = 0;
+    if (storedKey) {
+        result = benchmarkTagNameIndexOperation<StoredKeyTagNameIndex>(items, lookupKeys, insert);
+    }
+    else {
+        result = benchmarkTagNameIndexOperation<FoldingKeyTagNameIndex>(items, lookupKeys, insert);
+    }
+
+    QVERIFY2(result == BENCHMARK_NUM_NAME_INDEX_TAGS,
+             qPrintable(QStringLiteral("Unexpected number of tag items found within the name index: ") + QString::number(result)));
+}
+
+void ModelTester::benchmarkLogLineParsing_data()
+{
+    QTest::addColumn<bool>("useRegex");
+
+    QTest::newRow("regex") << true;
+    QTest::newRow("hand-written parser") << false;
+}
+
+void ModelTester::benchmarkLogLineParsing()
+{
+    using namespace quentier;
+
+    QFETCH(bool, useRegex);
+
+    // Every tenth line continues the previous multiline log entry
+    static const char * logLevels[] = { "Trace", "Debug", "Info", "Warn", "Error" };
+    QByteArray log;
+    log.reserve(BENCHMARK_NUM_LOG_LINES * 120);
+    int expectedNumEntries = 0;
+    for(int i = 0; i < BENCHMARK_NUM_LOG_LINES; ++i)
+    {
+        if ((i % 10) == 9) {
+            log += "    continuation of the multiline log entry #";
+            log += QByteArray::number(expectedNumEntries);
+            log += '\n';
+            continue;
+        }
+
+        log += "2017-09-21 21:33:39.";
+        log += QByteArray::number(100 + (i % 900));
+        log += " MSK src/models/LogViewerModel.cpp @ ";
+        log += QByteArray::number(i % 1000);
+        log += " [";
+        log += logLevels[i % 5];
+        log += "]: Log entry #";
+        log += QByteArray::number(i);
+        log += '\n';
+        ++expectedNumEntries;
+    }
+
+    QRegExp regex(QStringLiteral("^(\\d{4}-\\d{2}-\\d{2}\\s+\\d{2}:\\d{2}:\\d{2}.\\d{3})\\s+(\\w+)\\s+(.+)\\s+@\\s+(\\d+)\\s+\\[(\\w+)\\]:\\s(.+$)"),
+                  Qt::CaseInsensitive, QRegExp::RegExp);
+
+    const char * pLog = log.constData();
+    const int logSize = log.size();
+
+    int numEntries = 0;
+    QBENCHMARK {
+        numEntries = 0;
+
+        int lineStart = 0;
+        while(lineStart < logSize)
+        {
+            const void * pLineFeed = std::memchr(pLog + lineStart, '\n', static_cast<size_t>(logSize - lineStart));
+            int lineEnd = (pLineFeed ? static_cast<int>(static_cast<const char*>(pLineFeed) - pLog) : logSize);
+
+            if (useRegex)
+            {
+                QString line = QString::fromUtf8(pLog + lineStart, lineEnd - lineStart);
+                if (regex.indexIn(line) >= 0) {
+                    QStringList capturedTexts = regex.capturedTexts();
+                    if (capturedTexts.size() == 7) {
+                        ++numEntries;
+                    }
+                }
+            }
+            else
+            {
+                LogLineParser::Fields fields;
+                if (LogLineParser::parse(pLog + lineStart, lineEnd - lineStart, fields)) {
+                    ++numEntries;
+                }
+            }
+
+            lineStart = lineEnd + 1;
+        }
+    }
+
+    QVERIFY2(numEntries == expectedNumEntries,
+             qPrintable(QStringLiteral("Unexpected number of parsed log entries: ") + QString::number(numEntries)));
+}
+
 int main(int argc, char *argv[])
 {
     QApplication app(argc, argv);
@@ -33,9 +33,28 @@ private Q_SLOTS:
     void testSavedSearchModel();
     void testTagModel();
     void testNotebookModel();
+    void testNotebookModelNoteCounts();
     void testNoteModel();
+    void testNoteModelWindowedListing();
+    void testTagModelNoteCounts();
     void testFavoritesModel();
+    void testModelSnapshots();
     void testTagModelItemSerialization();
+    void testTagModelItemChildRows();
+    void testAdaptivePageSize();
+    void testListRequestPipeline();
+    void testParallelSort();
+    void testCollationKeys();
+    void testTagNameTable();
+    void testLogLineParser();
+    void testLogViewerFilterIndex();
+    void benchmarkNoteModelItemMemoryUsage();
+    void benchmarkNoteFilterModelFiltering_data();
+    void benchmarkNoteFilterModelFiltering();
+    void benchmarkTagNameIndex_data();
+    void benchmarkTagNameIndex();
+    void benchmarkLogLineParsing_data();
+    void benchmarkLogLineParsing();
 
 private:
     quentier::LocalStorageManagerAsync *    m_pLocalStorageManagerAsync;
@@ -36,7 +36,8 @@ NoteModelTestHelper::NoteModelTestHelper(LocalStorageManagerAsync * pLocalStorag
     m_expectingNewNoteFromLocalStorage(false),
     m_expectingNoteUpdateFromLocalStorage(false),
     m_expectingNoteDeletionFromLocalStorage(false),
-    m_expectingNoteExpungeFromLocalStorage(false)
+    m_expectingNoteExpungeFromLocalStorage(false),
+    m_dataChangedRowRanges()
 {
     QObject::connect(pLocalStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,addNoteComplete,Note,QUuid),
                      this, QNSLOT(NoteModelTestHelper,onAddNoteComplete,Note,QUuid));
@@ -425,6 +426,84 @@ void NoteModelTestHelper::launchTest()
             checkSorting(*model);
         }
 
+        // The changes of notes coming from the local storage within the batch should be coalesced and applied
+        // at once with a single dataChanged signal for the contiguous range of updated rows
+        model->sort(NoteModel::Columns::Title, Qt::AscendingOrder);
+
+        QModelIndex sixthIndex = model->indexForLocalUid(sixthNote.localUid());
+        QModelIndex thirdIndex = model->indexForLocalUid(thirdNote.localUid());
+        if (!sixthIndex.isValid() || !thirdIndex.isValid()) {
+            FAIL(QStringLiteral("Can't get the valid note model item indices for the notes to be updated within the batch"));
+        }
+
+        if (thirdIndex.row() != (sixthIndex.row() + 1)) {
+            FAIL(QStringLiteral("The notes to be updated within the batch are not in the adjacent rows: ")
+                 << sixthIndex.row() << QStringLiteral(" and ") << thirdIndex.row());
+        }
+
+        const quint64 numBatchedNoteChanges = model->numBatchedNoteChanges();
+        const quint64 numCoalescedNoteChanges = model->numCoalescedNoteChanges();
+        const quint64 numAppliedNoteChangesBatches = model->numAppliedNoteChangesBatches();
+
+        m_dataChangedRowRanges.clear();
+        QObject::connect(model, QNSIGNAL(NoteModel,dataChanged,QModelIndex,QModelIndex),
+                         this, QNSLOT(NoteModelTestHelper,onModelDataChanged,QModelIndex,QModelIndex));
+
+        model->beginNoteChangesBatch();
+
+        sixthNote.setContent(QStringLiteral("<en-note><h1>Sixth note</h1><div>First update</div></en-note>"));
+        m_pLocalStorageManagerAsync->onUpdateNoteRequest(sixthNote, /* update resources = */ false,
+                                                         /* update tags = */ false, QUuid());
+        thirdNote.setContent(QStringLiteral("<en-note><h1>Third note</h1><div>First update</div></en-note>"));
+        m_pLocalStorageManagerAsync->onUpdateNoteRequest(thirdNote, /* update resources = */ false,
+                                                         /* update tags = */ false, QUuid());
+        sixthNote.setContent(QStringLiteral("<en-note><h1>Sixth note</h1><div>Second update</div></en-note>"));
+        m_pLocalStorageManagerAsync->onUpdateNoteRequest(sixthNote, /* update resources = */ false,
+                                                         /* update tags = */ false, QUuid());
+        thirdNote.setContent(QStringLiteral("<en-note><h1>Third note</h1><div>Second update</div></en-note>"));
+        m_pLocalStorageManagerAsync->onUpdateNoteRequest(thirdNote, /* update resources = */ false,
+                                                         /* update tags = */ false, QUuid());
+
+        if (!m_dataChangedRowRanges.isEmpty()) {
+            FAIL(QStringLiteral("The note model has applied the note changes before the end of the batch"));
+        }
+
+        model->endNoteChangesBatch();
+
+        QObject::disconnect(model, QNSIGNAL(NoteModel,dataChanged,QModelIndex,QModelIndex),
+                            this, QNSLOT(NoteModelTestHelper,onModelDataChanged,QModelIndex,QModelIndex));
+
+        if (model->numBatchedNoteChanges() != (numBatchedNoteChanges + 4)) {
+            FAIL(QStringLiteral("Unexpected number of batched note changes: expected ") << (numBatchedNoteChanges + 4)
+                 << QStringLiteral(", got ") << model->numBatchedNoteChanges());
+        }
+
+        if (model->numCoalescedNoteChanges() != (numCoalescedNoteChanges + 2)) {
+            FAIL(QStringLiteral("Unexpected number of coalesced note changes: expected ") << (numCoalescedNoteChanges + 2)
+                 << QStringLiteral(", got ") << model->numCoalescedNoteChanges());
+        }
+
+        if (model->numAppliedNoteChangesBatches() != (numAppliedNoteChangesBatches + 1)) {
+            FAIL(QStringLiteral("Unexpected number of applied batches of note changes: expected ")
+                 << (numAppliedNoteChangesBatches + 1) << QStringLiteral(", got ") << model->numAppliedNoteChangesBatches());
+        }
+
+        if (m_dataChangedRowRanges.size() != 1) {
+            FAIL(QStringLiteral("Expected the single dataChanged signal for the batch of note changes, got ")
+                 << m_dataChangedRowRanges.size());
+        }
+
+        if ((m_dataChangedRowRanges[0].first != sixthIndex.row()) || (m_dataChangedRowRanges[0].second != thirdIndex.row())) {
+            FAIL(QStringLiteral("Unexpected rows range of dataChanged signal for the batch of note changes: ")
+                 << m_dataChangedRowRanges[0].first << QStringLiteral(" - ") << m_dataChangedRowRanges[0].second
+                 << QStringLiteral(", expected ") << sixthIndex.row() << QStringLiteral(" - ") << thirdIndex.row());
+        }
+
+        const NoteModelItem * pThirdItem = model->itemForLocalUid(thirdNote.localUid());
+        if (Q_UNLIKELY(!pThirdItem) || !pThirdItem->previewText().contains(QStringLiteral("Second update"))) {
+            FAIL(QStringLiteral("The note model item doesn't reflect the last change of the note within the batch"));
+        }
+
         m_model = model;
         m_firstNotebook = firstNotebook;
         m_noteToExpungeLocalUid = secondNote.localUid();
@@ -683,6 +762,11 @@ void NoteModelTestHelper::onAddTagFailed(Tag tag, ErrorString errorDescription,
     notifyFailureWithStackTrace(errorDescription);
 }
 
+void NoteModelTestHelper::onModelDataChanged(const QModelIndex & topLeft, const QModelIndex & bottomRight)
+{
+    m_dataChangedRowRanges << std::pair<int, int>(topLeft.row(), bottomRight.row());
+}
+
 void NoteModelTestHelper::checkSorting(const NoteModel & model)
 {
     int numRows = model.rowCount(QModelIndex());
@@ -20,6 +20,9 @@
 #define QUENTIER_TESTS_MODEL_TEST_NOTE_MODEL_TEST_HELPER_H
 
 #include <quentier/local_storage/LocalStorageManagerAsync.h>
+#include <QModelIndex>
+#include <QVector>
+#include <utility>
 
 namespace quentier {
 
@@ -59,6 +62,8 @@ private Q_SLOTS:
 
     void onAddTagFailed(Tag tag, ErrorString errorDescription, QUuid requestId);
 
+    void onModelDataChanged(const QModelIndex & topLeft, const QModelIndex & bottomRight);
+
 private:
     void checkSorting(const NoteModel & model);
     void notifyFailureWithStackTrace(ErrorString errorDescription);
@@ -163,6 +168,9 @@ private:
     bool                                m_expectingNoteUpdateFromLocalStorage;
     bool                                m_expectingNoteDeletionFromLocalStorage;
     bool                                m_expectingNoteExpungeFromLocalStorage;
+
+    // The row ranges of dataChanged signals emitted by the model while applying the batch of note changes
+    QVector<std::pair<int, int> >       m_dataChangedRowRanges;
 };
 
 } // namespace quentier
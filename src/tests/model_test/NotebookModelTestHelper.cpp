@@ -31,7 +31,10 @@ namespace quentier {
 NotebookModelTestHelper::NotebookModelTestHelper(LocalStorageManagerAsync * pLocalStorageManagerAsync,
                                                  QObject * parent) :
     QObject(parent),
-    m_pLocalStorageManagerAsync(pLocalStorageManagerAsync)
+    m_pLocalStorageManagerAsync(pLocalStorageManagerAsync),
+    m_numNoteCountPerNotebookRequests(0),
+    m_updateNoteOnNoteCount(false),
+    m_noteToUpdateOnNoteCount()
 {
     QObject::connect(pLocalStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,addNotebookFailed,Notebook,ErrorString,QUuid),
                      this, QNSLOT(NotebookModelTestHelper,onAddNotebookFailed,Notebook,ErrorString,QUuid));
@@ -736,6 +739,214 @@ void NotebookModelTestHelper::test()
     Q_EMIT failure(errorDescription);
 }
 
+static bool checkNotebookModelNoteCounts(const NotebookModel & model, const QStringList & notebookLocalUids,
+                                         const QVector<int> & expectedNoteCounts, QString & error)
+{
+    for(int i = 0, size = notebookLocalUids.size(); i < size; ++i)
+    {
+        QModelIndex itemIndex = model.indexForLocalUid(notebookLocalUids[i]);
+        if (!itemIndex.isValid()) {
+            error = QStringLiteral("Can't get the valid notebook model item index for local uid ") + notebookLocalUids[i];
+            return false;
+        }
+
+        itemIndex = model.index(itemIndex.row(), NotebookModel::Columns::NumNotesPerNotebook, itemIndex.parent());
+        int noteCount = model.data(itemIndex).toInt();
+        if (noteCount != expectedNoteCounts[i]) {
+            error = QStringLiteral("Unexpected number of notes per notebook #") + QString::number(i)
+                    + QStringLiteral(": expected ") + QString::number(expectedNoteCounts[i])
+                    + QStringLiteral(", got ") + QString::number(noteCount);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void NotebookModelTestHelper::testNoteCounts()
+{
+    QNDEBUG(QStringLiteral("NotebookModelTestHelper::testNoteCounts"));
+
+    ErrorString errorDescription;
+
+    try {
+        Notebook first;
+        first.setName(QStringLiteral("First"));
+        first.setLocal(true);
+        first.setDirty(false);
+
+        Notebook second;
+        second.setName(QStringLiteral("Second"));
+        second.setLocal(true);
+        second.setDirty(false);
+
+        m_pLocalStorageManagerAsync->onAddNotebookRequest(first, QUuid());
+        m_pLocalStorageManagerAsync->onAddNotebookRequest(second, QUuid());
+
+        QStringList notebookLocalUids;
+        notebookLocalUids << first.localUid() << second.localUid();
+
+        Note firstNote;
+        firstNote.setTitle(QStringLiteral("First note"));
+        firstNote.setNotebookLocalUid(first.localUid());
+        firstNote.setLocal(true);
+
+        Note secondNote;
+        secondNote.setTitle(QStringLiteral("Second note"));
+        secondNote.setNotebookLocalUid(first.localUid());
+        secondNote.setLocal(true);
+
+        Note thirdNote;
+        thirdNote.setTitle(QStringLiteral("Third note"));
+        thirdNote.setNotebookLocalUid(second.localUid());
+        thirdNote.setLocal(true);
+
+        // NOTE: exploiting the direct connection used in the current test environment:
+        // after the following lines the local storage would be filled with the test objects
+        m_pLocalStorageManagerAsync->onAddNoteRequest(firstNote, QUuid());
+        m_pLocalStorageManagerAsync->onAddNoteRequest(secondNote, QUuid());
+        m_pLocalStorageManagerAsync->onAddNoteRequest(thirdNote, QUuid());
+
+        NotebookCache cache(5);
+        NoteCache noteCache(10);
+        Account account(QStringLiteral("Default user"), Account::Type::Local);
+        QString error;
+
+        {
+            NoteModel noteModel(account, *m_pLocalStorageManagerAsync, noteCache, cache);
+            NotebookModel model(account, noteModel, *m_pLocalStorageManagerAsync, cache);
+
+            if (!checkNotebookModelNoteCounts(model, notebookLocalUids, QVector<int>() << 2 << 1, error)) {
+                FAIL(QStringLiteral("Wrong note counts after listing the notebooks: ") << error);
+            }
+
+            // The notebooks of all notes are known so the note counts are maintained by the deltas
+            // without querying the local storage
+            QObject::connect(&model, QNSIGNAL(NotebookModel,requestNoteCountPerNotebook,Notebook,QUuid),
+                             this, QNSLOT(NotebookModelTestHelper,onRequestNoteCountPerNotebook,Notebook,QUuid));
+            m_numNoteCountPerNotebookRequests = 0;
+
+            Note fourthNote;
+            fourthNote.setTitle(QStringLiteral("Fourth note"));
+            fourthNote.setNotebookLocalUid(second.localUid());
+            fourthNote.setLocal(true);
+            m_pLocalStorageManagerAsync->onAddNoteRequest(fourthNote, QUuid());
+
+            if (!checkNotebookModelNoteCounts(model, notebookLocalUids, QVector<int>() << 2 << 2, error)) {
+                FAIL(QStringLiteral("Wrong note counts after adding the note: ") << error);
+            }
+
+            noteModel.moveNoteToNotebook(firstNote.localUid(), second.name());
+
+            if (!checkNotebookModelNoteCounts(model, notebookLocalUids, QVector<int>() << 1 << 3, error)) {
+                FAIL(QStringLiteral("Wrong note counts after moving the note to another notebook: ") << error);
+            }
+
+            m_pLocalStorageManagerAsync->onExpungeNoteRequest(thirdNote, QUuid());
+
+            if (!checkNotebookModelNoteCounts(model, notebookLocalUids, QVector<int>() << 1 << 2, error)) {
+                FAIL(QStringLiteral("Wrong note counts after expunging the note: ") << error);
+            }
+
+            if (m_numNoteCountPerNotebookRequests != 0) {
+                FAIL(QStringLiteral("Notebook model requested the note counts from the local storage instead of applying the deltas: ")
+                     << m_numNoteCountPerNotebookRequests << QStringLiteral(" requests"));
+            }
+
+            // The notifications about expunging the note the model hasn't counted drive the delta-maintained
+            // note count below zero; such a drift from the local storage is fixed by the recount for the notebook
+            Note uncountedNote;
+            uncountedNote.setNotebookLocalUid(first.localUid());
+
+            for(int i = 0; i < 2; ++i)
+            {
+                bool res = QMetaObject::invokeMethod(m_pLocalStorageManagerAsync, "expungeNoteComplete", Qt::DirectConnection,
+                                                     Q_ARG(Note, uncountedNote), Q_ARG(QUuid, QUuid()));
+                if (!res) {
+                    FAIL(QStringLiteral("Failed to notify the notebook model about the expunged note"));
+                }
+            }
+
+            if (m_numNoteCountPerNotebookRequests != 1) {
+                FAIL(QStringLiteral("Notebook model didn't request the note count for the notebook with the drifted note count: ")
+                     << m_numNoteCountPerNotebookRequests << QStringLiteral(" requests"));
+            }
+
+            if (!checkNotebookModelNoteCounts(model, notebookLocalUids, QVector<int>() << 1 << 2, error)) {
+                FAIL(QStringLiteral("Wrong note counts after the recount of the drifted note count: ") << error);
+            }
+        }
+
+        {
+            // The windowed note model doesn't provide the notebooks of all notes so the update of any note
+            // leads to the recount of notes for all notebooks
+            NoteModel noteModel(account, *m_pLocalStorageManagerAsync, noteCache, cache, Q_NULLPTR,
+                                NoteModel::IncludedNotes::NonDeleted, NoteModel::ListingMode::Windowed);
+            NotebookModel model(account, noteModel, *m_pLocalStorageManagerAsync, cache);
+
+            if (!checkNotebookModelNoteCounts(model, notebookLocalUids, QVector<int>() << 1 << 2, error)) {
+                FAIL(QStringLiteral("Wrong note counts after listing the notebooks along with the windowed note model: ")
+                     << error);
+            }
+
+            QObject::connect(&model, QNSIGNAL(NotebookModel,requestNoteCountPerNotebook,Notebook,QUuid),
+                             this, QNSLOT(NotebookModelTestHelper,onRequestNoteCountPerNotebook,Notebook,QUuid));
+            m_numNoteCountPerNotebookRequests = 0;
+
+            secondNote.setTitle(QStringLiteral("Updated second note"));
+            m_pLocalStorageManagerAsync->onUpdateNoteRequest(secondNote, /* update resources = */ false,
+                                                             /* update tags = */ false, QUuid());
+
+            if (m_numNoteCountPerNotebookRequests != notebookLocalUids.size()) {
+                FAIL(QStringLiteral("Notebook model didn't recount the notes for all notebooks after the note update: ")
+                     << m_numNoteCountPerNotebookRequests << QStringLiteral(" requests"));
+            }
+
+            if (!checkNotebookModelNoteCounts(model, notebookLocalUids, QVector<int>() << 1 << 2, error)) {
+                FAIL(QStringLiteral("Wrong note counts after the recount of notes for all notebooks: ") << error);
+            }
+
+            // The note update coming while the recount is in progress makes the model repeat the recount
+            // once it's finished
+            QObject::connect(m_pLocalStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,getNoteCountPerNotebookComplete,
+                                                                   int,Notebook,QUuid),
+                             this, QNSLOT(NotebookModelTestHelper,onGetNoteCountPerNotebookComplete,int,Notebook,QUuid));
+            m_numNoteCountPerNotebookRequests = 0;
+
+            m_noteToUpdateOnNoteCount = secondNote;
+            m_noteToUpdateOnNoteCount.setTitle(QStringLiteral("Second note updated during the recount"));
+            m_updateNoteOnNoteCount = true;
+
+            secondNote.setTitle(QStringLiteral("Second note updated again"));
+            m_pLocalStorageManagerAsync->onUpdateNoteRequest(secondNote, /* update resources = */ false,
+                                                             /* update tags = */ false, QUuid());
+
+            QObject::disconnect(m_pLocalStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,getNoteCountPerNotebookComplete,
+                                                                      int,Notebook,QUuid),
+                                this, QNSLOT(NotebookModelTestHelper,onGetNoteCountPerNotebookComplete,int,Notebook,QUuid));
+
+            if (m_updateNoteOnNoteCount) {
+                FAIL(QStringLiteral("The note wasn't updated during the recount of notes for all notebooks"));
+            }
+
+            if (m_numNoteCountPerNotebookRequests != 2 * notebookLocalUids.size()) {
+                FAIL(QStringLiteral("Notebook model didn't repeat the recount of notes for all notebooks after the note update "
+                                    "during the recount: ") << m_numNoteCountPerNotebookRequests << QStringLiteral(" requests"));
+            }
+
+            if (!checkNotebookModelNoteCounts(model, notebookLocalUids, QVector<int>() << 1 << 2, error)) {
+                FAIL(QStringLiteral("Wrong note counts after the repeated recount of notes for all notebooks: ") << error);
+            }
+        }
+
+        Q_EMIT success();
+        return;
+    }
+    CATCH_EXCEPTION()
+
+    Q_EMIT failure(errorDescription);
+}
+
 void NotebookModelTestHelper::onAddNotebookFailed(Notebook notebook, ErrorString errorDescription, QUuid requestId)
 {
     QNDEBUG(QStringLiteral("NotebookModelTestHelper::onAddNotebookFailed: notebook = ") << notebook
@@ -781,6 +992,28 @@ void NotebookModelTestHelper::onExpungeNotebookFailed(Notebook notebook, ErrorSt
     notifyFailureWithStackTrace(errorDescription);
 }
 
+void NotebookModelTestHelper::onRequestNoteCountPerNotebook(Notebook notebook, QUuid requestId)
+{
+    QNDEBUG(QStringLiteral("NotebookModelTestHelper::onRequestNoteCountPerNotebook: notebook = ") << notebook
+            << QStringLiteral("\nRequest id = ") << requestId);
+
+    ++m_numNoteCountPerNotebookRequests;
+}
+
+void NotebookModelTestHelper::onGetNoteCountPerNotebookComplete(int noteCount, Notebook notebook, QUuid requestId)
+{
+    QNDEBUG(QStringLiteral("NotebookModelTestHelper::onGetNoteCountPerNotebookComplete: note count = ") << noteCount
+            << QStringLiteral(", notebook = ") << notebook << QStringLiteral("\nRequest id = ") << requestId);
+
+    if (!m_updateNoteOnNoteCount) {
+        return;
+    }
+
+    m_updateNoteOnNoteCount = false;
+    m_pLocalStorageManagerAsync->onUpdateNoteRequest(m_noteToUpdateOnNoteCount, /* update resources = */ false,
+                                                     /* update tags = */ false, QUuid());
+}
+
 bool NotebookModelTestHelper::checkSorting(const NotebookModel & model, const NotebookModelItem * rootItem) const
 {
     if (!rootItem) {
@@ -39,6 +39,7 @@ Q_SIGNALS:
 
 public Q_SLOTS:
     void test();
+    void testNoteCounts();
 
 private Q_SLOTS:
     void onAddNotebookFailed(Notebook notebook, ErrorString errorDescription, QUuid requestId);
@@ -50,6 +51,9 @@ private Q_SLOTS:
                                QString linkedNotebookGuid, ErrorString errorDescription, QUuid requestId);
     void onExpungeNotebookFailed(Notebook notebook, ErrorString errorDescription, QUuid requestId);
 
+    void onRequestNoteCountPerNotebook(Notebook notebook, QUuid requestId);
+    void onGetNoteCountPerNotebookComplete(int noteCount, Notebook notebook, QUuid requestId);
+
 private:
     bool checkSorting(const NotebookModel & model, const NotebookModelItem * item) const;
     void notifyFailureWithStackTrace(ErrorString errorDescription);
@@ -66,6 +70,12 @@ private:
 
 private:
     LocalStorageManagerAsync *   m_pLocalStorageManagerAsync;
+
+    int                          m_numNoteCountPerNotebookRequests;
+
+    // The note to update in the local storage on receiving the next note count per notebook
+    bool                         m_updateNoteOnNoteCount;
+    Note                         m_noteToUpdateOnNoteCount;
 };
 
 } // namespace quentier
@@ -27,8 +27,14 @@
 #include <QItemSelectionModel>
 #include <QMenu>
 #include <QMouseEvent>
+#include <QResizeEvent>
 #include <QTimer>
 #include <iterator>
+#include <algorithm>
+
+// The number of rows around the visible ones for which the note model in windowed listing mode is asked
+// to keep the thumbnails so that they are ready by the time the rows get visible
+#define NOTE_LIST_VIEW_VIEWPORT_MARGIN (50)
 
 #define REPORT_ERROR(error) \
     { \
@@ -235,6 +241,12 @@ void NoteListView::dataChanged(const QModelIndex & topLeft, const QModelIndex &
 #else
                                , roles);
 #endif
+
+    // QListView only repaints the single changed item if it belongs to the view's model column
+    // but the note's thumbnail is painted along with the other data of the note
+    if ((topLeft == bottomRight) && (topLeft.column() == NoteModel::Columns::ThumbnailImage)) {
+        update(topLeft.sibling(topLeft.row(), modelColumn()));
+    }
 }
 
 void NoteListView::rowsAboutToBeRemoved(const QModelIndex & parent, int start, int end)
@@ -883,6 +895,18 @@ void NoteListView::mousePressEvent(QMouseEvent * pEvent)
     }
 }
 
+void NoteListView::resizeEvent(QResizeEvent * pEvent)
+{
+    QListView::resizeEvent(pEvent);
+    updateNoteModelViewport();
+}
+
+void NoteListView::scrollContentsBy(int dx, int dy)
+{
+    QListView::scrollContentsBy(dx, dy);
+    updateNoteModelViewport();
+}
+
 const NotebookItem * NoteListView::currentNotebookItem()
 {
     QNDEBUG(QStringLiteral("NoteListView::currentNotebookItem"));
@@ -918,4 +942,44 @@ const NotebookItem * NoteListView::currentNotebookItem()
     return pNotebookItem;
 }
 
+void NoteListView::updateNoteModelViewport()
+{
+    const NoteFilterModel * pNoteFilterModel = qobject_cast<const NoteFilterModel*>(model());
+    if (!pNoteFilterModel) {
+        return;
+    }
+
+    NoteModel * pNoteModel = qobject_cast<NoteModel*>(pNoteFilterModel->sourceModel());
+    if (!pNoteModel || (pNoteModel->listingMode() != NoteModel::ListingMode::Windowed)) {
+        return;
+    }
+
+    QModelIndex firstVisibleIndex = indexAt(viewport()->rect().topLeft());
+    if (!firstVisibleIndex.isValid()) {
+        return;
+    }
+
+    int numRows = pNoteFilterModel->rowCount();
+
+    QModelIndex lastVisibleIndex = indexAt(viewport()->rect().bottomLeft());
+    int lastVisibleRow = (lastVisibleIndex.isValid() ? lastVisibleIndex.row() : (numRows - 1));
+
+    int firstRow = std::max(firstVisibleIndex.row() - NOTE_LIST_VIEW_VIEWPORT_MARGIN, 0);
+    int lastRow = std::min(lastVisibleRow + NOTE_LIST_VIEW_VIEWPORT_MARGIN, numRows - 1);
+
+    // NOTE: the filter model may order the rows differently from the source model and skip some of them
+    // so each row needs to be mapped to the source one
+    QVector<int> sourceRows;
+    sourceRows.reserve(std::max(lastRow - firstRow + 1, 0));
+    for(int row = firstRow; row <= lastRow; ++row)
+    {
+        QModelIndex sourceIndex = pNoteFilterModel->mapToSource(pNoteFilterModel->index(row, 0));
+        if (sourceIndex.isValid()) {
+            sourceRows << sourceIndex.row();
+        }
+    }
+
+    pNoteModel->setViewportRows(sourceRows);
+}
+
 } // namespace quentier
@@ -135,9 +135,17 @@ protected:
     virtual void currentChanged(const QModelIndex & current,
                                 const QModelIndex & previous) Q_DECL_OVERRIDE;
     virtual void mousePressEvent(QMouseEvent * pEvent) Q_DECL_OVERRIDE;
+    virtual void resizeEvent(QResizeEvent * pEvent) Q_DECL_OVERRIDE;
+    virtual void scrollContentsBy(int dx, int dy) Q_DECL_OVERRIDE;
 
     const NotebookItem * currentNotebookItem();
 
+    /**
+     * Informs the note model working in windowed listing mode about the range of its rows
+     * currently visible within the view
+     */
+    void updateNoteModelViewport();
+
 protected:
     void showContextMenuAtPoint(const QPoint & pos, const QPoint & globalPos);
     void showSingleNoteContextMenu(const QPoint & pos, const QPoint & globalPos,
@@ -38,7 +38,6 @@
 #include <set>
 
 #define QUENTIER_NUM_LOG_LEVELS (5)
-#define FETCHING_MORE_TIMER_PERIOD (200)
 #define DELAY_SECTION_RESIZE_TIMER_PERIOD (500)
 
 namespace quentier {
@@ -49,7 +48,6 @@ LogViewerWidget::LogViewerWidget(QWidget * parent) :
     m_logFilesFolderWatcher(),
     m_pLogViewerModel(new LogViewerModel(this)),
     m_pLogViewerFilterModel(new LogViewerFilterModel(this)),
-    m_modelFetchingMoreTimer(),
     m_delayedSectionResizeTimer(),
     m_logLevelEnabledCheckboxPtrs(),
     m_pLogEntriesContextMenu(Q_NULLPTR),
@@ -197,10 +195,6 @@ void LogViewerWidget::setupLogFiles()
 
     m_pLogViewerModel->setLogFileName(logFileName);
     resizeLogEntriesViewColumns();
-
-    if (!m_modelFetchingMoreTimer.isActive()) {
-        m_modelFetchingMoreTimer.start(FETCHING_MORE_TIMER_PERIOD, this);
-    }
 }
 
 void LogViewerWidget::startWatchingForLogFilesFolderChanges()
@@ -265,7 +259,8 @@ void LogViewerWidget::onFilterByContentEditingFinished()
     m_pUi->statusBarLineEdit->clear();
     m_pUi->statusBarLineEdit->hide();
 
-    m_pLogViewerFilterModel->setFilterWildcard(m_pUi->filterByContentLineEdit->text());
+    m_pLogViewerFilterModel->setContentFilter(QRegExp(m_pUi->filterByContentLineEdit->text(),
+                                                      Qt::CaseSensitive, QRegExp::Wildcard));
     scheduleLogEntriesViewColumnsResize();
 }
 
@@ -626,7 +621,6 @@ void LogViewerWidget::clear()
 {
     m_pUi->logFileComboBox->clear();
     m_pLogViewerModel->clear();
-    m_modelFetchingMoreTimer.stop();
 
     m_pUi->statusBarLineEdit->clear();
     m_pUi->statusBarLineEdit->hide();
@@ -700,17 +694,7 @@ void LogViewerWidget::timerEvent(QTimerEvent * pEvent)
         return;
     }
 
-    if (pEvent->timerId() == m_modelFetchingMoreTimer.timerId())
-    {
-        if (m_pLogViewerModel->canFetchMore(QModelIndex())) {
-            m_pLogViewerModel->fetchMore(QModelIndex());
-            scheduleLogEntriesViewColumnsResize();
-        }
-        else {
-            m_modelFetchingMoreTimer.stop();
-        }
-    }
-    else if (pEvent->timerId() == m_delayedSectionResizeTimer.timerId())
+    if (pEvent->timerId() == m_delayedSectionResizeTimer.timerId())
     {
         resizeLogEntriesViewColumns();
         m_delayedSectionResizeTimer.stop();
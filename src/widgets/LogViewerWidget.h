@@ -99,7 +99,6 @@ private:
     LogViewerModel *        m_pLogViewerModel;
     LogViewerFilterModel *  m_pLogViewerFilterModel;
 
-    QBasicTimer             m_modelFetchingMoreTimer;
     QBasicTimer             m_delayedSectionResizeTimer;
 
     QCheckBox *             m_logLevelEnabledCheckboxPtrs[6];